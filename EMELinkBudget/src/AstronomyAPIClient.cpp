@@ -1,6 +1,13 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include "AstronomyAPIClient.h"
 #include "SimpleHttpClient.h"
+#include "DataCache.h"
+#include "HorizonsTable.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <iomanip>
 #include <iostream>
@@ -188,118 +195,238 @@ bool AstronomyAPIClient::extractNestedValue(
     return false;
 }
 
-bool AstronomyAPIClient::parseResponse(
+bool AstronomyAPIClient::extractDataSection(
     const std::string& response,
-    MoonData& result) {
+    std::string& text,
+    std::size_t& begin,
+    std::size_t& end) {
 
     if (response.empty()) {
         m_lastError = "Empty response from API";
         return false;
     }
 
-    std::string dataText = response;
-
     if (response[0] == '{') {
-        std::string resultValue;
-        if (extractJsonValue(response, "result", resultValue)) {
-            dataText = resultValue;
-        } else {
+        if (!extractJsonValue(response, "result", text)) {
             m_lastError = "Could not extract 'result' field from JSON response";
             return false;
         }
+    } else {
+        text = response;
     }
 
-    size_t soePos = dataText.find("$$SOE");
-    size_t eoePos = dataText.find("$$EOE");
+    size_t soePos = text.find("$$SOE");
+    size_t eoePos = text.find("$$EOE");
 
-    if (soePos == std::string::npos || eoePos == std::string::npos) {
+    if (soePos == std::string::npos || eoePos == std::string::npos || eoePos < soePos) {
         m_lastError = "Could not find data markers ($$SOE/$$EOE) in response";
         return false;
     }
 
-    std::string dataSection = dataText.substr(soePos + 5, eoePos - soePos - 5);
+    begin = soePos + 5;
+    end = eoePos;
+    return true;
+}
 
-    std::istringstream dataStream(dataSection);
-    std::string dataLine;
-    while (std::getline(dataStream, dataLine)) {
-        size_t start = dataLine.find_first_not_of(" \t\r\n");
-        if (start != std::string::npos) {
-            dataLine = dataLine.substr(start);
-            if (!dataLine.empty() && dataLine[0] != '#') {
-                break;
-            }
+namespace {
+
+const char* const MONTHS[12] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+std::int64_t daysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return static_cast<std::int64_t>(era) * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+// "2026-Feb-09 14:17:00.000", as produced by CAL_FORMAT='CAL'.
+bool parseCalendarTime(const char* begin, const char* end, std::time_t& time) {
+    std::string field(begin, end);
+    int year, day, hour, minute;
+    double second;
+    char month[4] = {};
+    if (std::sscanf(field.c_str(), " %d-%3s-%d %d:%d:%lf", &year, month, &day, &hour, &minute, &second) != 6) {
+        return false;
+    }
+    for (unsigned m = 0; m < 12; ++m) {
+        if (std::strcmp(month, MONTHS[m]) == 0) {
+            time = static_cast<std::time_t>(daysFromCivil(year, m + 1, static_cast<unsigned>(day)) * 86400 +
+                                            hour * 3600 + minute * 60 + std::llround(second));
+            return true;
         }
     }
+    return false;
+}
 
-    if (dataLine.empty()) {
-        m_lastError = "No data found in response";
-        return false;
+// One CSV data row: date, two marker columns, then RA, DEC, delta, deldot
+// and the two libration angles. Fields are located in place; nothing is
+// copied except the date.
+bool parseRow(const char* begin, const char* end, std::time_t* time,
+              AstronomyAPIClient::MoonData& result, std::string& error) {
+    const char* fields[12];
+    const char* fieldEnds[12];
+    size_t count = 0;
+    const char* p = begin;
+    while (count < 12) {
+        const char* comma = std::find(p, end, ',');
+        fields[count] = p;
+        fieldEnds[count] = comma;
+        ++count;
+        if (comma == end) {
+            break;
+        }
+        p = comma + 1;
+    }
+    // A trailing comma leaves an empty last field, as in the old splitter.
+    if (count > 0 && fields[count - 1] == end) {
+        --count;
     }
 
-    std::istringstream lineStream(dataLine);
-    std::string field;
-    std::vector<std::string> fields;
+    if (count < 6) {
+        error = "Insufficient fields in CSV response";
+        return false;
+    }
 
-    while (std::getline(lineStream, field, ',')) {
-        size_t start = field.find_first_not_of(" \t");
-        size_t end = field.find_last_not_of(" \t");
-        if (start != std::string::npos && end != std::string::npos) {
-            fields.push_back(field.substr(start, end - start + 1));
-        } else {
-            fields.push_back("");
+    auto number = [&](size_t i, double& value) {
+        char* stop = nullptr;
+        value = std::strtod(fields[i], &stop);
+        if (stop == fields[i]) {
+            return false;
+        }
+        while (stop < fieldEnds[i] && (*stop == ' ' || *stop == '\t' || *stop == '\r')) {
+            ++stop;
         }
+        return stop == fieldEnds[i];
+    };
+
+    bool ok = number(3, result.ra_deg) && number(4, result.dec_deg) && number(5, result.distance_km);
+    if (ok && count >= 7) {
+        ok = number(6, result.range_rate_km_s);
+    }
+    if (ok && count >= 9) {
+        ok = number(7, result.libration_lon_deg) && number(8, result.libration_lat_deg);
+    }
+    if (ok && count >= 11) {
+        ok = number(9, result.libration_lon_rate_deg_day) && number(10, result.libration_lat_rate_deg_day);
+    }
+    if (!ok) {
+        error = "Failed to parse numeric values";
+        return false;
+    }
+    if (time && !parseCalendarTime(fields[0], fieldEnds[0], *time)) {
+        error = "Failed to parse row time";
+        return false;
     }
 
-    if (fields.size() < 6) {
-        m_lastError = "Insufficient fields in CSV response";
+    if (result.ra_deg < 0 || result.ra_deg > 360) {
+        error = "RA out of valid range (0-360)";
         return false;
     }
 
-    try {
-        result.ra_deg = std::stod(fields[3]);
-        result.dec_deg = std::stod(fields[4]);
-        result.distance_km = std::stod(fields[5]);
+    if (result.dec_deg < -90 || result.dec_deg > 90) {
+        error = "DEC out of valid range (-90 to 90)";
+        return false;
+    }
 
-        if (fields.size() >= 7) {
-            result.range_rate_km_s = std::stod(fields[6]);
-        }
+    if (result.distance_km < 300000 || result.distance_km > 500000) {
+        error = "Distance out of reasonable range (300000-500000 km)";
+        return false;
+    }
 
-        if (fields.size() >= 9) {
-            result.libration_lon_deg = std::stod(fields[7]);
-            result.libration_lat_deg = std::stod(fields[8]);
-        }
+    result.azimuth_deg = 0.0;
+    result.elevation_deg = 0.0;
+    result.source = "JPL Horizons";
+    result.valid = true;
+    return true;
+}
 
-        if (fields.size() >= 11) {
-            result.libration_lon_rate_deg_day = std::stod(fields[9]);
-            result.libration_lat_rate_deg_day = std::stod(fields[10]);
+// Next non-blank, non-comment line in [p, end); advances p past it.
+bool nextDataLine(const char*& p, const char* end, const char*& lineBegin, const char*& lineEnd) {
+    while (p < end) {
+        const char* eol = std::find(p, end, '\n');
+        const char* first = p;
+        while (first < eol && (*first == ' ' || *first == '\t' || *first == '\r')) {
+            ++first;
         }
-
-        if (result.ra_deg < 0 || result.ra_deg > 360) {
-            m_lastError = "RA out of valid range (0-360)";
-            return false;
+        p = eol == end ? end : eol + 1;
+        if (first < eol && *first != '#') {
+            lineBegin = first;
+            lineEnd = eol;
+            while (lineEnd > lineBegin && (lineEnd[-1] == '\r' || lineEnd[-1] == ' ')) {
+                --lineEnd;
+            }
+            return true;
         }
+    }
+    return false;
+}
+
+} // namespace
+
+bool AstronomyAPIClient::parseResponse(
+    const std::string& response,
+    MoonData& result) {
+
+    std::string dataText;
+    size_t begin = 0, end = 0;
+    if (!extractDataSection(response, dataText, begin, end)) {
+        return false;
+    }
+
+    const char* p = dataText.data() + begin;
+    const char* lineBegin = nullptr;
+    const char* lineEnd = nullptr;
+    if (!nextDataLine(p, dataText.data() + end, lineBegin, lineEnd)) {
+        m_lastError = "No data found in response";
+        return false;
+    }
+
+    return parseRow(lineBegin, lineEnd, nullptr, result, m_lastError);
+}
+
+bool AstronomyAPIClient::parseRangeResponse(
+    const std::string& response,
+    HorizonsTable& table) {
 
-        if (result.dec_deg < -90 || result.dec_deg > 90) {
-            m_lastError = "DEC out of valid range (-90 to 90)";
+    std::string dataText;
+    size_t begin = 0, end = 0;
+    if (!extractDataSection(response, dataText, begin, end)) {
+        return false;
+    }
+
+    // The range query carries no libration columns; like the single-time
+    // path in the interactive program, it comes from the analytic theory.
+    LunarEphemeris ephemeris;
+    table.clear();
+    const char* p = dataText.data() + begin;
+    const char* stop = dataText.data() + end;
+    const char* lineBegin = nullptr;
+    const char* lineEnd = nullptr;
+    while (nextDataLine(p, stop, lineBegin, lineEnd)) {
+        std::time_t time = 0;
+        MoonData row;
+        if (!parseRow(lineBegin, lineEnd, &time, row, m_lastError)) {
             return false;
         }
-
-        if (result.distance_km < 300000 || result.distance_km > 500000) {
-            m_lastError = "Distance out of reasonable range (300000-500000 km)";
+        if (row.libration_lon_deg == 0.0 && row.libration_lat_deg == 0.0) {
+            const LunarPosition position = ephemeris.calculate(time);
+            row.libration_lon_deg = position.librationLon_deg;
+            row.libration_lat_deg = position.librationLat_deg;
+        }
+        if (!table.append(time, row)) {
+            m_lastError = "Rows out of time order in response";
             return false;
         }
+    }
 
-        result.azimuth_deg = 0.0;
-        result.elevation_deg = 0.0;
-        result.source = "JPL Horizons";
-        result.valid = true;
-
-        return true;
-
-    } catch (const std::exception& e) {
-        m_lastError = std::string("Failed to parse numeric values: ") + e.what();
+    if (table.empty()) {
+        m_lastError = "No data found in response";
         return false;
     }
+    return true;
 }
 
 //========== Fetch Moon Position ==========
@@ -313,6 +440,10 @@ bool AstronomyAPIClient::fetchMoonPosition(
     m_lastError.clear();
     result.valid = false;
 
+    if (m_cache && m_cache->loadMoon(observationTime, observerLat_deg, observerLon_deg, result)) {
+        return true;
+    }
+
     // Build API URL
     std::string url = buildAPIUrl(observationTime, observerLat_deg, observerLon_deg);
 
@@ -322,6 +453,11 @@ bool AstronomyAPIClient::fetchMoonPosition(
     std::string response;
     if (!SimpleHttpClient::fetchUrl(url, response)) {
         m_lastError = "Failed to fetch data from API (network error or API unavailable)";
+        if (m_cache && m_cache->loadMoon(observationTime, observerLat_deg, observerLon_deg, result, true)) {
+            std::cout << "[!] Horizons request failed, using expired cached position" << std::endl;
+            m_lastError.clear();
+            return true;
+        }
         return false;
     }
 
@@ -335,5 +471,82 @@ bool AstronomyAPIClient::fetchMoonPosition(
         return false;
     }
 
+    if (m_cache) {
+        m_cache->storeMoon(observationTime, observerLat_deg, observerLon_deg, result);
+    }
+    return true;
+}
+
+//========== Fetch Moon Range ==========
+
+std::string AstronomyAPIClient::buildRangeUrl(
+    std::time_t start,
+    std::time_t stop,
+    std::time_t step_s) {
+
+    std::ostringstream url;
+
+    url << "https://ssd.jpl.nasa.gov/api/horizons.api?";
+
+    url << "COMMAND='301'";
+
+    // Geocentric apparent place; sites are reduced locally.
+    url << "&CENTER='500@399'";
+
+    url << "&START_TIME='" << formatTime(start) << "'";
+    url << "&STOP_TIME='" << formatTime(stop) << "'";
+    url << "&STEP_SIZE='" << step_s / 60 << "m'";
+
+    url << "&QUANTITIES='2,20'";
+
+    url << "&CSV_FORMAT='YES'";
+    url << "&CAL_FORMAT='CAL'";
+    url << "&TIME_DIGITS='FRACSEC'";
+    url << "&ANG_FORMAT='DEG'";
+    url << "&RANGE_UNITS='KM'";
+    url << "&EXTRA_PREC='YES'";
+
+    return url.str();
+}
+
+bool AstronomyAPIClient::fetchMoonRange(
+    std::time_t start,
+    std::time_t stop,
+    std::time_t step_s,
+    HorizonsTable& table) {
+
+    m_lastError.clear();
+    table.clear();
+
+    if (step_s < 60 || step_s % 60 != 0 || stop < start) {
+        m_lastError = "Range query needs start <= stop and a step of whole minutes";
+        return false;
+    }
+
+    if (m_cache && m_cache->loadMoonRange(start, stop, step_s, table)) {
+        return true;
+    }
+
+    std::string url = buildRangeUrl(start, stop, step_s);
+
+    std::string response;
+    if (!SimpleHttpClient::fetchUrl(url, response)) {
+        m_lastError = "Failed to fetch data from API (network error or API unavailable)";
+        if (m_cache && m_cache->loadMoonRange(start, stop, step_s, table, true)) {
+            std::cout << "[!] Horizons request failed, using expired cached range" << std::endl;
+            m_lastError.clear();
+            return true;
+        }
+        return false;
+    }
+
+    if (!parseRangeResponse(response, table)) {
+        table.clear();
+        return false;
+    }
+
+    if (m_cache) {
+        m_cache->storeMoonRange(start, stop, step_s, table);
+    }
     return true;
 }
@@ -2,6 +2,11 @@
 
 #include <string>
 #include <ctime>
+#include <cstddef>
+#include <memory>
+
+class DataCache;
+class HorizonsTable;
 
 // ========== Astronomy API Client ==========
 
@@ -38,18 +43,49 @@ struct MoonData {
 
     std::string getLastError() const { return m_lastError; }
 
-private:
-std::string m_lastError;
-
-std::string buildAPIUrl(
+    std::string buildAPIUrl(
         std::time_t time,
         double lat,
         double lon);
 
+    // Whole pass in one request: geocentric apparent rows every step_s
+    // seconds (whole minutes) from start to stop, parsed in a single pass
+    // into a time-indexed table. Per-timestep and per-site values then come
+    // from HorizonsTable::interpolate() / topocentric() without further
+    // requests.
+    bool fetchMoonRange(
+        std::time_t start,
+        std::time_t stop,
+        std::time_t step_s,
+        HorizonsTable& table);
+
+    std::string buildRangeUrl(
+        std::time_t start,
+        std::time_t stop,
+        std::time_t step_s);
+
+    // Cache hits skip the network; stale entries are used only when the fetch fails.
+    void setCache(std::shared_ptr<DataCache> cache) { m_cache = std::move(cache); }
+
+private:
+std::string m_lastError;
+std::shared_ptr<DataCache> m_cache;
+
     bool parseResponse(
         const std::string& response,
         MoonData& result);
 
+    bool parseRangeResponse(
+        const std::string& response,
+        HorizonsTable& table);
+
+    // Text between $$SOE and $$EOE, unwrapping the JSON envelope if present.
+    bool extractDataSection(
+        const std::string& response,
+        std::string& text,
+        std::size_t& begin,
+        std::size_t& end);
+
     bool extractJsonValue(
         const std::string& json,
         const std::string& key,
@@ -0,0 +1,544 @@
+#include "DataCache.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr char MAGIC[4] = {'E', 'M', 'E', 'C'};
+constexpr std::uint32_t FORMAT_VERSION = 1;
+constexpr const char* ENTRY_EXTENSION = ".emec";
+
+std::uint32_t checksum(const char* data, std::size_t size) {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+class PayloadWriter {
+public:
+    explicit PayloadWriter(std::vector<char>& out) : m_out(out) {}
+
+    template <typename T>
+    void put(const T& value) {
+        putBytes(&value, sizeof(T));
+    }
+
+    void putBytes(const void* data, std::size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        m_out.insert(m_out.end(), bytes, bytes + size);
+    }
+
+    void putString(const std::string& value) {
+        put(static_cast<std::uint32_t>(value.size()));
+        putBytes(value.data(), value.size());
+    }
+
+private:
+    std::vector<char>& m_out;
+};
+
+class PayloadReader {
+public:
+    PayloadReader(const char* data, std::size_t size) : m_p(data), m_end(data + size) {}
+
+    template <typename T>
+    bool get(T& value) {
+        return getBytes(&value, sizeof(T));
+    }
+
+    bool getBytes(void* out, std::size_t size) {
+        if (static_cast<std::size_t>(m_end - m_p) < size) {
+            return false;
+        }
+        std::memcpy(out, m_p, size);
+        m_p += size;
+        return true;
+    }
+
+    bool getString(std::string& value) {
+        std::uint32_t size = 0;
+        if (!get(size) || static_cast<std::size_t>(m_end - m_p) < size) {
+            return false;
+        }
+        value.assign(m_p, size);
+        m_p += size;
+        return true;
+    }
+
+    bool atEnd() const { return m_p == m_end; }
+
+private:
+    const char* m_p;
+    const char* m_end;
+};
+
+} // namespace
+
+// ========== Constructor ==========
+
+DataCache::DataCache(const std::string& directory, std::int64_t ttl_seconds, std::uint64_t maxBytes)
+    : m_directory(directory), m_usable(false), m_ttl(ttl_seconds), m_maxBytes(maxBytes) {
+    std::error_code ec;
+    fs::create_directories(m_directory, ec);
+    m_usable = fs::is_directory(m_directory, ec);
+}
+
+std::string DataCache::defaultDirectory() {
+    if (const char* dir = std::getenv("EME_CACHE_DIR")) {
+        return dir;
+    }
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME")) {
+        return (fs::path(xdg) / "emelinkbudget").string();
+    }
+#ifdef _WIN32
+    if (const char* local = std::getenv("LOCALAPPDATA")) {
+        return (fs::path(local) / "EMELinkBudget" / "cache").string();
+    }
+#else
+    if (const char* home = std::getenv("HOME")) {
+        return (fs::path(home) / ".cache" / "emelinkbudget").string();
+    }
+#endif
+    return (fs::temp_directory_path() / "emelinkbudget").string();
+}
+
+std::string DataCache::hashName(const std::string& key) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash));
+    return buf;
+}
+
+// ========== Keys ==========
+
+std::string DataCache::glotecKey(const std::tm& slot) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "glotec/%04d-%02d-%02dT%02d:%02d",
+                  slot.tm_year + 1900, slot.tm_mon + 1, slot.tm_mday, slot.tm_hour, slot.tm_min);
+    return buf;
+}
+
+std::string DataCache::moonKey(std::time_t time, double lat_deg, double lon_deg) {
+    // Same precision as the Horizons SITE_COORD parameter.
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "moon/%lld/%.6f/%.6f",
+                  static_cast<long long>(time), lat_deg, lon_deg);
+    return buf;
+}
+
+std::string DataCache::moonRangeKey(std::time_t start, std::time_t stop, std::time_t step_s) {
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "moonrange/%lld/%lld/%lld",
+                  static_cast<long long>(start), static_cast<long long>(stop),
+                  static_cast<long long>(step_s));
+    return buf;
+}
+
+std::string DataCache::entryPath(const std::string& key) const {
+    return (fs::path(m_directory) / (hashName(key) + ENTRY_EXTENSION)).string();
+}
+
+// ========== GLOTEC Grids ==========
+
+bool DataCache::loadGlotec(const std::tm& slot, GlotecData& data, bool allowStale) {
+    std::vector<char> payload;
+    if (!load(Kind::GLOTEC, glotecKey(slot), payload, allowStale)) {
+        return false;
+    }
+
+    PayloadReader in(payload.data(), payload.size());
+    GlotecData decoded;
+    std::int32_t numLon = 0, numLat = 0;
+    std::int32_t fields[6] = {};
+    std::uint64_t count = 0;
+
+    bool ok = in.get(numLon) && in.get(numLat) &&
+              in.get(decoded.lonStart) && in.get(decoded.latStart) &&
+              in.get(decoded.lonStep) && in.get(decoded.latStep) &&
+              in.getBytes(fields, sizeof(fields)) && in.get(count) &&
+              count == static_cast<std::uint64_t>(numLon) * static_cast<std::uint64_t>(numLat);
+    if (ok) {
+        decoded.tecValues.resize(count);
+        ok = in.getBytes(decoded.tecValues.data(), count * sizeof(float)) && in.atEnd();
+    }
+    if (!ok) {
+        return false;
+    }
+
+    decoded.numLon = numLon;
+    decoded.numLat = numLat;
+    decoded.timestamp.tm_year = fields[0];
+    decoded.timestamp.tm_mon = fields[1];
+    decoded.timestamp.tm_mday = fields[2];
+    decoded.timestamp.tm_hour = fields[3];
+    decoded.timestamp.tm_min = fields[4];
+    decoded.timestamp.tm_sec = fields[5];
+    decoded.isValid = true;
+
+    data = std::move(decoded);
+    return true;
+}
+
+bool DataCache::storeGlotec(const std::tm& slot, const GlotecData& data) {
+    if (!data.isValid) {
+        return false;
+    }
+
+    std::vector<char> payload;
+    payload.reserve(96 + data.tecValues.size() * sizeof(float));
+    PayloadWriter out(payload);
+
+    const std::int32_t fields[6] = {
+        data.timestamp.tm_year, data.timestamp.tm_mon, data.timestamp.tm_mday,
+        data.timestamp.tm_hour, data.timestamp.tm_min, data.timestamp.tm_sec
+    };
+    out.put(static_cast<std::int32_t>(data.numLon));
+    out.put(static_cast<std::int32_t>(data.numLat));
+    out.put(data.lonStart);
+    out.put(data.latStart);
+    out.put(data.lonStep);
+    out.put(data.latStep);
+    out.putBytes(fields, sizeof(fields));
+    out.put(static_cast<std::uint64_t>(data.tecValues.size()));
+    out.putBytes(data.tecValues.data(), data.tecValues.size() * sizeof(float));
+
+    return store(Kind::GLOTEC, glotecKey(slot), payload);
+}
+
+// ========== Moon Records ==========
+
+bool DataCache::loadMoon(std::time_t time, double lat_deg, double lon_deg,
+                         AstronomyAPIClient::MoonData& data, bool allowStale) {
+    std::vector<char> payload;
+    if (!load(Kind::MOON, moonKey(time, lat_deg, lon_deg), payload, allowStale)) {
+        return false;
+    }
+
+    PayloadReader in(payload.data(), payload.size());
+    AstronomyAPIClient::MoonData decoded;
+    bool ok = in.get(decoded.ra_deg) && in.get(decoded.dec_deg) &&
+              in.get(decoded.distance_km) && in.get(decoded.azimuth_deg) &&
+              in.get(decoded.elevation_deg) && in.get(decoded.range_rate_km_s) &&
+              in.get(decoded.libration_lon_deg) && in.get(decoded.libration_lat_deg) &&
+              in.get(decoded.libration_lon_rate_deg_day) && in.get(decoded.libration_lat_rate_deg_day) &&
+              in.getString(decoded.source) && in.atEnd();
+    if (!ok) {
+        return false;
+    }
+
+    decoded.valid = true;
+    data = std::move(decoded);
+    return true;
+}
+
+bool DataCache::storeMoon(std::time_t time, double lat_deg, double lon_deg,
+                          const AstronomyAPIClient::MoonData& data) {
+    if (!data.valid) {
+        return false;
+    }
+
+    std::vector<char> payload;
+    PayloadWriter out(payload);
+    out.put(data.ra_deg);
+    out.put(data.dec_deg);
+    out.put(data.distance_km);
+    out.put(data.azimuth_deg);
+    out.put(data.elevation_deg);
+    out.put(data.range_rate_km_s);
+    out.put(data.libration_lon_deg);
+    out.put(data.libration_lat_deg);
+    out.put(data.libration_lon_rate_deg_day);
+    out.put(data.libration_lat_rate_deg_day);
+    out.putString(data.source);
+
+    return store(Kind::MOON, moonKey(time, lat_deg, lon_deg), payload);
+}
+
+bool DataCache::loadMoonRange(std::time_t start, std::time_t stop, std::time_t step_s,
+                              HorizonsTable& table, bool allowStale) {
+    std::vector<char> payload;
+    if (!load(Kind::MOON_RANGE, moonRangeKey(start, stop, step_s), payload, allowStale)) {
+        return false;
+    }
+
+    PayloadReader in(payload.data(), payload.size());
+    HorizonsTable decoded;
+    std::uint64_t count = 0;
+    bool ok = in.get(count) && count <= payload.size() / sizeof(HorizonsTable::Row);
+    if (ok) {
+        decoded.reserve(count);
+    }
+    for (std::uint64_t i = 0; ok && i < count; ++i) {
+        std::int64_t time = 0;
+        AstronomyAPIClient::MoonData row;
+        ok = in.get(time) && in.get(row.ra_deg) && in.get(row.dec_deg) &&
+             in.get(row.distance_km) && in.get(row.range_rate_km_s) &&
+             in.get(row.libration_lon_deg) && in.get(row.libration_lat_deg);
+        row.valid = true;
+        ok = ok && decoded.append(static_cast<std::time_t>(time), row);
+    }
+    if (!ok || !in.atEnd() || decoded.empty()) {
+        return false;
+    }
+
+    table = std::move(decoded);
+    return true;
+}
+
+bool DataCache::storeMoonRange(std::time_t start, std::time_t stop, std::time_t step_s,
+                               const HorizonsTable& table) {
+    if (table.empty()) {
+        return false;
+    }
+
+    std::vector<char> payload;
+    payload.reserve(8 + table.size() * 7 * 8);
+    PayloadWriter out(payload);
+    out.put(static_cast<std::uint64_t>(table.size()));
+    for (const HorizonsTable::Row& row : table.rows()) {
+        out.put(static_cast<std::int64_t>(row.time));
+        out.put(row.ra_deg);
+        out.put(row.dec_deg);
+        out.put(row.distance_km);
+        out.put(row.range_rate_km_s);
+        out.put(row.libration_lon_deg);
+        out.put(row.libration_lat_deg);
+    }
+
+    return store(Kind::MOON_RANGE, moonRangeKey(start, stop, step_s), payload);
+}
+
+// ========== Entry I/O ==========
+
+bool DataCache::load(Kind kind, const std::string& key, std::vector<char>& payload, bool allowStale) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_usable) {
+        ++m_stats.misses;
+        return false;
+    }
+
+    const std::string path = entryPath(key);
+    bool valid = false;
+    bool expired = false;
+    {
+        MappedFile file(path);
+        if (!file.isOpen()) {
+            ++m_stats.misses;
+            return false;
+        }
+
+        PayloadReader in(file.data(), file.size());
+        char magic[4];
+        std::uint32_t version = 0, storedKind = 0, keySize = 0, storedChecksum = 0;
+        std::int64_t created = 0;
+        std::uint64_t payloadSize = 0;
+
+        valid = in.getBytes(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                in.get(version) && version == FORMAT_VERSION &&
+                in.get(storedKind) && storedKind == static_cast<std::uint32_t>(kind) &&
+                in.get(created) && in.get(keySize) && in.get(payloadSize) && in.get(storedChecksum);
+
+        std::string storedKey;
+        if (valid && keySize < file.size()) {
+            storedKey.resize(keySize);
+            valid = in.getBytes(storedKey.data(), keySize);
+        } else {
+            valid = false;
+        }
+
+        if (valid && storedKey != key) {
+            // Hash collision: a different entry owns this file name.
+            ++m_stats.misses;
+            return false;
+        }
+
+        if (valid && payloadSize <= file.size()) {
+            payload.resize(payloadSize);
+            valid = in.getBytes(payload.data(), payloadSize) && in.atEnd() &&
+                    checksum(payload.data(), payload.size()) == storedChecksum;
+        } else {
+            valid = false;
+        }
+
+        const std::time_t now = m_clock ? m_clock() : std::time(nullptr);
+        expired = valid && m_ttl > 0 && now - created > m_ttl;
+    }
+
+    std::error_code ec;
+    if (!valid) {
+        fs::remove(path, ec);
+        ++m_stats.misses;
+        return false;
+    }
+
+    if (expired) {
+        ++m_stats.expired;
+        if (!allowStale) {
+            ++m_stats.misses;
+            return false;
+        }
+    }
+
+    // Mark as recently used for the size limit.
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    ++m_stats.hits;
+    return true;
+}
+
+bool DataCache::store(Kind kind, const std::string& key, const std::vector<char>& payload) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_usable) {
+        return false;
+    }
+
+    const std::string path = entryPath(key);
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+
+        const std::time_t now = m_clock ? m_clock() : std::time(nullptr);
+        std::vector<char> header;
+        header.reserve(36 + key.size());
+        PayloadWriter writer(header);
+        writer.putBytes(MAGIC, sizeof(MAGIC));
+        writer.put(FORMAT_VERSION);
+        writer.put(static_cast<std::uint32_t>(kind));
+        writer.put(static_cast<std::int64_t>(now));
+        writer.put(static_cast<std::uint32_t>(key.size()));
+        writer.put(static_cast<std::uint64_t>(payload.size()));
+        writer.put(checksum(payload.data(), payload.size()));
+        writer.putBytes(key.data(), key.size());
+
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+        out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        if (!out) {
+            out.close();
+            std::error_code ec;
+            fs::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    // Rename so concurrent readers never see a partially written entry.
+    std::error_code ec;
+    fs::rename(tmpPath, path, ec);
+    if (ec) {
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+
+    ++m_stats.stores;
+    enforceSizeLimitLocked(path);
+    return true;
+}
+
+// ========== Budget Control ==========
+
+void DataCache::enforceSizeLimitLocked(const std::string& keep) {
+    if (m_maxBytes == 0) {
+        return;
+    }
+
+    struct FileInfo {
+        fs::file_time_type lastUse;
+        std::uint64_t size;
+        fs::path path;
+    };
+
+    std::vector<FileInfo> files;
+    std::uint64_t total = 0;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(m_directory, ec)) {
+        if (!entry.is_regular_file(ec) || entry.path().extension() != ENTRY_EXTENSION) {
+            continue;
+        }
+        FileInfo info{entry.last_write_time(ec), entry.file_size(ec), entry.path()};
+        total += info.size;
+        files.push_back(std::move(info));
+    }
+
+    if (total <= m_maxBytes) {
+        return;
+    }
+
+    std::sort(files.begin(), files.end(),
+              [](const FileInfo& a, const FileInfo& b) { return a.lastUse < b.lastUse; });
+
+    // The entry just written is always kept, even if it alone exceeds the limit.
+    for (const auto& file : files) {
+        if (total <= m_maxBytes) {
+            break;
+        }
+        if (file.path == keep) {
+            continue;
+        }
+        if (fs::remove(file.path, ec)) {
+            total -= file.size;
+            ++m_stats.evictions;
+        }
+    }
+}
+
+void DataCache::setTtl(std::int64_t seconds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ttl = seconds;
+}
+
+void DataCache::setMaxBytes(std::uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxBytes = bytes;
+    enforceSizeLimitLocked(std::string());
+}
+
+void DataCache::setClock(std::function<std::time_t()> clock) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_clock = std::move(clock);
+}
+
+std::uint64_t DataCache::diskUsage() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::uint64_t total = 0;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(m_directory, ec)) {
+        if (entry.is_regular_file(ec) && entry.path().extension() == ENTRY_EXTENSION) {
+            total += entry.file_size(ec);
+        }
+    }
+    return total;
+}
+
+void DataCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::error_code ec;
+    std::vector<fs::path> entries;
+    for (const auto& entry : fs::directory_iterator(m_directory, ec)) {
+        if (entry.path().extension() == ENTRY_EXTENSION) {
+            entries.push_back(entry.path());
+        }
+    }
+    for (const auto& path : entries) {
+        fs::remove(path, ec);
+    }
+}
+
+DataCacheStats DataCache::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "NOAAGlotecReader.h"
+#include "AstronomyAPIClient.h"
+#include "HorizonsTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ========== Data Cache Statistics ==========
+
+struct DataCacheStats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t expired = 0;
+    std::size_t stores = 0;
+    std::size_t evictions = 0;
+};
+
+// ========== On-Disk Data Cache ==========
+// Content-addressed directory of decoded downloads. Each entry is one file
+// named by the 64-bit FNV-1a hash of its key (kind, timestamp, site) holding a
+// small binary header, the key itself and the raw payload:
+//
+//   "EMEC" | version u32 | kind u32 | created i64 | key bytes u32 |
+//   payload bytes u64 | payload checksum u32 | key | payload
+//
+// Entries older than the TTL are misses but stay on disk, so callers can fall
+// back to them when the network is unavailable (loadStale). The directory is
+// trimmed to the size limit, least recently used first, after every store.
+// Values are stored in host byte order.
+
+class DataCache {
+public:
+    static constexpr std::int64_t DEFAULT_TTL_SECONDS = 6 * 3600;
+    static constexpr std::uint64_t DEFAULT_MAX_BYTES = 256ull * 1024 * 1024;
+
+    enum class Kind : std::uint32_t {
+        GLOTEC = 1,
+        MOON = 2,
+        MOON_RANGE = 3
+    };
+
+    explicit DataCache(const std::string& directory,
+                       std::int64_t ttl_seconds = DEFAULT_TTL_SECONDS,
+                       std::uint64_t maxBytes = DEFAULT_MAX_BYTES);
+
+    // $EME_CACHE_DIR, else $XDG_CACHE_HOME/emelinkbudget, else ~/.cache/emelinkbudget.
+    static std::string defaultDirectory();
+
+    // Lower-case hex FNV-1a hash used for entry file names.
+    static std::string hashName(const std::string& key);
+
+    bool isUsable() const { return m_usable; }
+    const std::string& getDirectory() const { return m_directory; }
+
+    // GLOTEC grids keyed by the 5-minute product slot of the request time.
+    bool loadGlotec(const std::tm& slot, GlotecData& data, bool allowStale = false);
+    bool storeGlotec(const std::tm& slot, const GlotecData& data);
+
+    // Horizons records keyed by observation time and observer site.
+    bool loadMoon(std::time_t time, double lat_deg, double lon_deg,
+                  AstronomyAPIClient::MoonData& data, bool allowStale = false);
+    bool storeMoon(std::time_t time, double lat_deg, double lon_deg,
+                   const AstronomyAPIClient::MoonData& data);
+
+    // Geocentric Horizons tables keyed by the requested span and step.
+    bool loadMoonRange(std::time_t start, std::time_t stop, std::time_t step_s,
+                       HorizonsTable& table, bool allowStale = false);
+    bool storeMoonRange(std::time_t start, std::time_t stop, std::time_t step_s,
+                        const HorizonsTable& table);
+
+    // <= 0 disables expiry; 0 disables the size limit.
+    void setTtl(std::int64_t seconds);
+    void setMaxBytes(std::uint64_t bytes);
+
+    // Clock used for entry age, e.g. for replaying recorded sessions.
+    void setClock(std::function<std::time_t()> clock);
+
+    std::uint64_t diskUsage() const;
+    void clear();
+    DataCacheStats getStats() const;
+
+private:
+    std::string m_directory;
+    bool m_usable;
+    std::int64_t m_ttl;
+    std::uint64_t m_maxBytes;
+    std::function<std::time_t()> m_clock;
+
+    mutable std::mutex m_mutex;
+    DataCacheStats m_stats;
+
+    static std::string glotecKey(const std::tm& slot);
+    static std::string moonKey(std::time_t time, double lat_deg, double lon_deg);
+    static std::string moonRangeKey(std::time_t start, std::time_t stop, std::time_t step_s);
+
+    std::string entryPath(const std::string& key) const;
+    bool load(Kind kind, const std::string& key, std::vector<char>& payload, bool allowStale);
+    bool store(Kind kind, const std::string& key, const std::vector<char>& payload);
+    void enforceSizeLimitLocked(const std::string& keep);
+};
@@ -0,0 +1,213 @@
+#include "DataRegistry.h"
+#include "DataCache.h"
+#include <cstdio>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// ========== Constructor ==========
+
+DataRegistry::DataRegistry()
+    : m_skyMapPaths({
+          "data/haslam408_dsds_Remazeilles2014_ns2048.fits",
+          "EMELinkBudget/data/haslam408_dsds_Remazeilles2014_ns2048.fits",
+          "../data/haslam408_dsds_Remazeilles2014_ns2048.fits",
+          "../EMELinkBudget/data/haslam408_dsds_Remazeilles2014_ns2048.fits",
+          "../../EMELinkBudget/data/haslam408_dsds_Remazeilles2014_ns2048.fits"}),
+      m_wmmPaths({
+          "data/WMMHR.COF",
+          "EMELinkBudget/data/WMMHR.COF",
+          "../data/WMMHR.COF",
+          "../EMELinkBudget/data/WMMHR.COF"}),
+      m_calendarPaths({
+          "data/calendar.dat",
+          "EMELinkBudget/data/calendar.dat",
+          "../data/calendar.dat",
+          "../EMELinkBudget/data/calendar.dat"}),
+      m_skyModelCacheDirectory(DataCache::defaultDirectory()) {
+}
+
+DataRegistry& DataRegistry::shared() {
+    static DataRegistry registry;
+    return registry;
+}
+
+// ========== Configuration ==========
+
+void DataRegistry::setSkyMapPaths(const std::vector<std::string>& paths) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_skyMapPaths = paths;
+}
+
+void DataRegistry::setWmmPaths(const std::vector<std::string>& paths) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_wmmPaths = paths;
+}
+
+void DataRegistry::setCalendarPaths(const std::vector<std::string>& paths) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_calendarPaths = paths;
+}
+
+void DataRegistry::setSkySurveys(const std::vector<SkySurveyFile>& surveys) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_skySurveys = surveys;
+}
+
+void DataRegistry::setSkyModelCacheDirectory(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_skyModelCacheDirectory = directory;
+}
+
+std::vector<std::string> DataRegistry::candidates(const std::vector<std::string>& list,
+                                                  std::size_t DataRegistryStats::* counter) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++(m_stats.*counter);
+    return list;
+}
+
+// ========== Datasets ==========
+
+std::shared_ptr<const HaslamSkyMap> DataRegistry::skyMap() {
+    std::call_once(m_skyMapOnce, [this] {
+        for (const std::string& path : candidates(m_skyMapPaths, &DataRegistryStats::skyMapLoads)) {
+            auto map = std::make_shared<HaslamSkyMap>();
+            if (map->loadFITS(path)) {
+                m_skyMap = std::move(map);
+                break;
+            }
+        }
+    });
+    return m_skyMap;
+}
+
+std::shared_ptr<const SkySpectralModel> DataRegistry::skyModel() {
+    std::call_once(m_skyModelOnce, [this] {
+        std::vector<SkySurveyFile> surveys;
+        std::vector<std::string> referencePaths;
+        std::string cacheDirectory;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_stats.skyModelLoads;
+            surveys = m_skySurveys;
+            referencePaths = m_skyMapPaths;
+            cacheDirectory = m_skyModelCacheDirectory;
+        }
+        if (surveys.empty()) {
+            return;
+        }
+
+        // The key covers the reference map skyMap() would load.
+        std::vector<SkySurveyFile> sources;
+        for (const std::string& path : referencePaths) {
+            std::error_code ec;
+            if (fs::is_regular_file(path, ec)) {
+                sources.push_back({path, SkySpectralModel::REFERENCE_MHZ, HaslamSkyMap::SURVEY_BEAM_DEG});
+                break;
+            }
+        }
+        if (sources.empty()) {
+            return;
+        }
+        sources.insert(sources.end(), surveys.begin(), surveys.end());
+        const std::uint64_t key = SkySpectralModel::sourceKey(sources);
+        std::string cachePath;
+        if (!cacheDirectory.empty()) {
+            char name[40];
+            std::snprintf(name, sizeof(name), "skymodel-%016llx.bin", static_cast<unsigned long long>(key));
+            cachePath = (fs::path(cacheDirectory) / name).string();
+        }
+
+        auto model = std::make_shared<SkySpectralModel>();
+        if (!cachePath.empty() && model->open(cachePath, key)) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_stats.skyModelCacheHits;
+            m_skyModel = std::move(model);
+            return;
+        }
+
+        std::shared_ptr<const HaslamSkyMap> reference = skyMap();
+        if (!reference) {
+            return;
+        }
+        std::vector<HaslamSkyMap> maps(surveys.size());
+        std::vector<SkySurvey> loaded;
+        for (std::size_t i = 0; i < surveys.size(); ++i) {
+            if (maps[i].loadFITS(surveys[i].path, surveys[i].beam_deg)) {
+                loaded.push_back({&maps[i], surveys[i].frequency_MHz});
+            }
+        }
+        if (loaded.empty() || !model->build(*reference, loaded)) {
+            return;
+        }
+
+        if (!cachePath.empty()) {
+            std::error_code ec;
+            fs::create_directories(cacheDirectory, ec);
+            model->save(cachePath, key);
+        }
+        m_skyModel = std::move(model);
+    });
+    return m_skyModel;
+}
+
+std::shared_ptr<const WMMModel> DataRegistry::wmm() {
+    std::call_once(m_wmmOnce, [this] {
+        std::vector<std::string> files = candidates(m_wmmPaths, &DataRegistryStats::wmmLoads);
+        auto model = std::make_shared<WMMModel>();
+        bool loaded = model->loadEmbeddedModel();
+        for (const std::string& path : files) {
+            if (loaded) {
+                break;
+            }
+            loaded = model->loadCoefficientFile(path);
+        }
+        if (loaded) {
+            m_wmm = std::move(model);
+        }
+    });
+    return m_wmm;
+}
+
+std::shared_ptr<const MoonCalendarReader> DataRegistry::calendar() {
+    std::call_once(m_calendarOnce, [this] {
+        for (const std::string& path : candidates(m_calendarPaths, &DataRegistryStats::calendarLoads)) {
+            auto calendar = std::make_shared<MoonCalendarReader>();
+            if (calendar->loadCalendarFile(path)) {
+                m_calendar = std::move(calendar);
+                break;
+            }
+        }
+    });
+    return m_calendar;
+}
+
+std::shared_ptr<const IonexReader> DataRegistry::ionex(const std::string& filename) {
+    std::shared_ptr<IonexSlot> slot;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::shared_ptr<IonexSlot>& entry = m_ionex[filename];
+        if (!entry) {
+            entry = std::make_shared<IonexSlot>();
+        }
+        slot = entry;
+    }
+
+    // Other files stay available while this one is being decoded.
+    std::call_once(slot->once, [this, &slot, &filename] {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_stats.ionexLoads;
+        }
+        auto reader = std::make_shared<IonexReader>();
+        if (reader->open(filename) && reader->preloadAll()) {
+            slot->reader = std::move(reader);
+        }
+    });
+    return slot->reader;
+}
+
+DataRegistryStats DataRegistry::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "HaslamSkyMap.h"
+#include "IonexReader.h"
+#include "MoonCalendarReader.h"
+#include "SkySpectralModel.h"
+#include "WMMModel.h"
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ========== Data Registry Statistics ==========
+
+struct DataRegistryStats {
+    std::size_t skyMapLoads = 0;    // load attempts, successful or not
+    std::size_t wmmLoads = 0;
+    std::size_t calendarLoads = 0;
+    std::size_t ionexLoads = 0;
+    std::size_t skyModelLoads = 0;
+    std::size_t skyModelCacheHits = 0;  // model mapped without reading the surveys
+};
+
+// ========== Shared Data Registry ==========
+// Read-only datasets shared by every calculator in the process. Each one is
+// loaded the first time it is asked for, exactly once even when several
+// threads ask at the same time, and handed out as a shared_ptr to const, so
+// calculators read it without locking and constructing one costs nothing.
+// A dataset that could not be loaded stays null; the failure is remembered
+// rather than retried.
+
+class DataRegistry {
+public:
+    DataRegistry();
+
+    DataRegistry(const DataRegistry&) = delete;
+    DataRegistry& operator=(const DataRegistry&) = delete;
+
+    // Process-wide registry used by NoiseCalculator.
+    static DataRegistry& shared();
+
+    // Candidate files in order of preference. Only take effect if set
+    // before the first lookup of that dataset.
+    void setSkyMapPaths(const std::vector<std::string>& paths);
+    void setWmmPaths(const std::vector<std::string>& paths);
+    void setCalendarPaths(const std::vector<std::string>& paths);
+    // Maps at other frequencies for the per-pixel spectral index. None by
+    // default, in which case skyModel() is null.
+    void setSkySurveys(const std::vector<SkySurveyFile>& surveys);
+    // Where built sky models are cached; empty disables the cache. Defaults
+    // to DataCache::defaultDirectory().
+    void setSkyModelCacheDirectory(const std::string& directory);
+
+    std::shared_ptr<const HaslamSkyMap> skyMap();
+    // Mapped from the cache when it matches the source files, otherwise
+    // built from skyMap() and the surveys and written to the cache.
+    std::shared_ptr<const SkySpectralModel> skyModel();
+    // The compiled-in model when available, otherwise the first file found.
+    std::shared_ptr<const WMMModel> wmm();
+    std::shared_ptr<const MoonCalendarReader> calendar();
+
+    // IONEX files by path, preloaded so lookups go through getCube().
+    std::shared_ptr<const IonexReader> ionex(const std::string& filename);
+
+    DataRegistryStats getStats() const;
+
+private:
+    struct IonexSlot {
+        std::once_flag once;
+        std::shared_ptr<const IonexReader> reader;
+    };
+
+    mutable std::mutex m_mutex;  // paths, stats and the IONEX index
+    std::vector<std::string> m_skyMapPaths;
+    std::vector<std::string> m_wmmPaths;
+    std::vector<std::string> m_calendarPaths;
+    std::vector<SkySurveyFile> m_skySurveys;
+    std::string m_skyModelCacheDirectory;
+    DataRegistryStats m_stats;
+
+    std::once_flag m_skyMapOnce;
+    std::shared_ptr<const HaslamSkyMap> m_skyMap;
+    std::once_flag m_skyModelOnce;
+    std::shared_ptr<const SkySpectralModel> m_skyModel;
+    std::once_flag m_wmmOnce;
+    std::shared_ptr<const WMMModel> m_wmm;
+    std::once_flag m_calendarOnce;
+    std::shared_ptr<const MoonCalendarReader> m_calendar;
+    std::map<std::string, std::shared_ptr<IonexSlot>> m_ionex;
+
+    std::vector<std::string> candidates(const std::vector<std::string>& list, std::size_t DataRegistryStats::* counter);
+};
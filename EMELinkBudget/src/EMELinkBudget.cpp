@@ -118,6 +118,20 @@ LinkBudgetResults EMELinkBudget::calculate() {
             return m_lastResults;
         }
 
+        LunarPosition moonPosition;
+        if (m_horizonsTable && m_horizonsTable->calculate(m_params.observationTime, moonPosition)) {
+            LunarEphemeris::fillEphemeris(moonPosition, m_params.observationTime,
+                                          m_params.moonEphemeris, HorizonsTable::SOURCE_NAME);
+        } else if (m_spkEphemeris && m_spkEphemeris->calculate(m_params.observationTime, moonPosition)) {
+            LunarEphemeris::fillEphemeris(moonPosition, m_params.observationTime,
+                                          m_params.moonEphemeris, SpkEphemeris::SOURCE_NAME);
+        } else if (m_params.dataSources.useAnalyticEphemeris) {
+            LunarEphemeris::fillEphemeris(
+                m_lunarEphemeris.calculate(m_params.observationTime),
+                m_params.observationTime,
+                m_params.moonEphemeris);
+        }
+
         m_lastResults.geometry = calculateGeometry();
 
         m_lastResults.pathLoss = calculatePathLoss(m_lastResults.geometry);
@@ -144,3 +158,144 @@ LinkBudgetResults EMELinkBudget::calculate() {
 
     return m_lastResults;
 }
+
+// ========== Time Series ==========
+
+EMELinkBudget::PassInvariants EMELinkBudget::preparePass() {
+    PassInvariants pass;
+
+    pass.geometry = m_geometryCalc.preparePass(m_params.txSite, m_params.rxSite);
+    pass.hagforsRoughnessParam =
+        m_pathLossCalc.calculateHagforsRoughnessParameter(m_params.frequency_MHz);
+    pass.receiverNoiseTemp_K =
+        m_noiseCalc.calculateReceiverNoiseTemp(m_params.rxNoiseFigure_dB);
+
+    FadingMargin fadingAnalyzer;
+    pass.fadingMargin_dB = fadingAnalyzer.calculateMargin(m_params.frequency_MHz, 0.0);
+
+    return pass;
+}
+
+void EMELinkBudget::calculateStep(
+    const PassInvariants& pass,
+    const MoonEphemeris& moonEphem,
+    std::time_t observationTime,
+    LinkBudgetResults& results) {
+
+    results.geometry = m_geometryCalc.calculate(
+        m_params.txSite,
+        m_params.rxSite,
+        pass.geometry,
+        moonEphem,
+        observationTime,
+        m_params.frequency_MHz);
+
+    results.pathLoss = m_pathLossCalc.calculateWithRoughness(
+        m_params.frequency_MHz,
+        results.geometry.distance_TX_km,
+        results.geometry.distance_RX_km,
+        results.geometry.moonElevation_TX_deg,
+        results.geometry.moonElevation_RX_deg,
+        pass.hagforsRoughnessParam,
+        m_params.includeAtmosphericLoss,
+        m_params.useHagforsModel);
+
+    results.polarization = calculatePolarization(results.geometry);
+
+    results.noise = m_noiseCalc.calculateWithReceiverTemp(
+        m_params.frequency_MHz,
+        m_params.bandwidth_Hz,
+        m_params.rxGain_dBi,
+        m_params.rxFeedlineLoss_dB,
+        pass.receiverNoiseTemp_K,
+        results.geometry.moonElevation_RX_deg,
+        results.geometry.moonRA_deg,
+        results.geometry.moonDEC_deg,
+        m_params.physicalTemp_K,
+        m_params.includeGroundSpillover);
+
+    results.snr = m_snrCalc.calculate(
+        m_params.txPower_dBm,
+        m_params.txGain_dBi,
+        m_params.rxGain_dBi,
+        m_params.txFeedlineLoss_dB,
+        m_params.rxFeedlineLoss_dB,
+        results.pathLoss,
+        results.polarization,
+        results.noise,
+        -30.2,
+        pass.fadingMargin_dB);
+
+    results.totalLoss_dB =
+        results.pathLoss.totalPathLoss_dB +
+        results.polarization.polarizationLoss_dB;
+}
+
+LinkBudgetResultsBatch EMELinkBudget::calculateSeries(
+    std::time_t start,
+    std::time_t stop,
+    std::time_t step_s) {
+
+    LinkBudgetResultsBatch batch;
+    m_lastResults = LinkBudgetResults();
+    m_lastResults.calculationTime = std::time(nullptr);
+
+    if (step_s <= 0 || stop < start) {
+        m_lastResults.errorMessage = "Invalid time range for series calculation";
+        return batch;
+    }
+
+    const size_t steps = static_cast<size_t>((stop - start) / step_s) + 1;
+    batch.resize(steps);
+
+    std::string errorMsg;
+    if (!validateParameters(errorMsg)) {
+        m_lastResults.errorMessage = errorMsg;
+        for (size_t i = 0; i < steps; ++i) {
+            batch.set(i, m_lastResults, start + static_cast<std::time_t>(i) * step_s);
+        }
+        return batch;
+    }
+
+    const PassInvariants pass = preparePass();
+
+    // Hour angles must follow the clock, so drop any fixed values
+    MoonEphemeris moonEphem = m_params.moonEphemeris;
+    moonEphem.hourAngle_DX = 0.0;
+    moonEphem.hourAngle_Home = 0.0;
+
+    LunarPositionBatch moonPositions;
+    bool trackMoon = false;
+    const char* moonSource = LunarEphemeris::SOURCE_NAME;
+    if (m_horizonsTable && m_horizonsTable->calculateSeries(start, step_s, steps, moonPositions)) {
+        trackMoon = true;
+        moonSource = HorizonsTable::SOURCE_NAME;
+    } else if (m_spkEphemeris && m_spkEphemeris->calculateSeries(start, step_s, steps, moonPositions)) {
+        trackMoon = true;
+        moonSource = SpkEphemeris::SOURCE_NAME;
+    } else if (m_params.dataSources.useAnalyticEphemeris) {
+        m_lunarEphemeris.calculateSeries(start, step_s, steps, moonPositions);
+        trackMoon = true;
+    }
+
+    for (size_t i = 0; i < steps; ++i) {
+        const std::time_t t = start + static_cast<std::time_t>(i) * step_s;
+
+        if (trackMoon) {
+            LunarEphemeris::fillEphemeris(moonPositions.row(i), t, moonEphem, moonSource);
+        }
+
+        try {
+            calculateStep(pass, moonEphem, t, m_lastResults);
+            m_lastResults.calculationSuccess = true;
+            m_lastResults.errorMessage.clear();
+        } catch (const std::exception& e) {
+            m_lastResults.calculationSuccess = false;
+            m_lastResults.errorMessage = std::string("Calculation error: ") + e.what();
+        }
+
+        batch.set(i, m_lastResults, t);
+    }
+
+    return batch;
+}
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "LinkBudgetTypes.h"
+#include "LinkBudgetResultsBatch.h"
 #include "GeometryCalculator.h"
 #include "PathLossCalculator.h"
 #include "PolarizationModule.h"
 #include "NoiseCalculator.h"
 #include "SNRCalculator.h"
+#include "LunarEphemeris.h"
+#include "SpkEphemeris.h"
+#include "HorizonsTable.h"
 #include <memory>
 
 // ========== EME Link Budget Main Engine ==========
@@ -16,6 +20,20 @@ public:
 
     LinkBudgetResults calculate();
 
+    // Evaluates the link every step_s seconds from start to stop (inclusive).
+    // Hour angles are derived from each timestep; site trigonometry, the
+    // Hagfors roughness, receiver temperature and fading margin are computed
+    // once for the whole pass. With an SPK kernel attached (and covering the
+    // pass) or dataSources.useAnalyticEphemeris, the moon position for every
+    // step is computed up front in one batch; an attached Horizons table is
+    // interpolated the same way. getLastResults() holds the final timestep.
+    // An invalid range yields an empty batch with the reason in
+    // getLastResults().errorMessage.
+    LinkBudgetResultsBatch calculateSeries(
+        std::time_t start,
+        std::time_t stop,
+        std::time_t step_s);
+
     void setParameters(const LinkBudgetParameters& params);
     const LinkBudgetParameters& getParameters() const { return m_params; }
 
@@ -26,10 +44,31 @@ public:
     PolarizationModule& getPolarizationModule() { return m_polarizationModule; }
     NoiseCalculator& getNoiseCalculator() { return m_noiseCalc; }
     SNRCalculator& getSNRCalculator() { return m_snrCalc; }
+    const LunarEphemeris& getLunarEphemeris() const { return m_lunarEphemeris; }
+
+    // JPL DE kernel for the moon position, shared read-only between
+    // calculators. Takes precedence over the parameters and the analytic
+    // ephemeris wherever it covers the observation time.
+    void setSpkEphemeris(std::shared_ptr<const SpkEphemeris> ephemeris) { m_spkEphemeris = std::move(ephemeris); }
+    const std::shared_ptr<const SpkEphemeris>& getSpkEphemeris() const { return m_spkEphemeris; }
+
+    // Geocentric rows from AstronomyAPIClient::fetchMoonRange(). Where it
+    // covers the observation time it takes precedence over every other
+    // moon position source.
+    void setHorizonsTable(std::shared_ptr<const HorizonsTable> table) { m_horizonsTable = std::move(table); }
+    const std::shared_ptr<const HorizonsTable>& getHorizonsTable() const { return m_horizonsTable; }
 
     bool validateParameters(std::string& errorMsg) const;
 
 private:
+    // Quantities that do not change between timesteps of a pass.
+    struct PassInvariants {
+        PassGeometry geometry;
+        double hagforsRoughnessParam;
+        double receiverNoiseTemp_K;
+        double fadingMargin_dB;
+    };
+
     LinkBudgetParameters m_params;
     LinkBudgetResults m_lastResults;
 
@@ -38,6 +77,9 @@ private:
     PolarizationModule m_polarizationModule;
     NoiseCalculator m_noiseCalc;
     SNRCalculator m_snrCalc;
+    LunarEphemeris m_lunarEphemeris;
+    std::shared_ptr<const SpkEphemeris> m_spkEphemeris;
+    std::shared_ptr<const HorizonsTable> m_horizonsTable;
 
     GeometryResults calculateGeometry();
     PathLossResults calculatePathLoss(const GeometryResults& geometry);
@@ -47,4 +89,11 @@ private:
         const PathLossResults& pathLoss,
         const PolarizationResults& polarization,
         const NoiseResults& noise);
+
+    PassInvariants preparePass();
+    void calculateStep(
+        const PassInvariants& pass,
+        const MoonEphemeris& moonEphem,
+        std::time_t observationTime,
+        LinkBudgetResults& results);
 };
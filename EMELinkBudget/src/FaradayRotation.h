@@ -3,13 +3,11 @@
 #include "Parameters.h"
 #include "MaidenheadGrid.h"
 #include "IonospherePhysics.h"
+#include "PolarizationTrace.h"
 #include <complex>
 #include <array>
 #include <memory>
 
-using JonesVector = std::array<std::complex<double>, 2>;
-using Matrix2x2 = std::array<std::array<std::complex<double>, 2>, 2>;
-
 // ========== Faraday Rotation Calculator ==========
 class FaradayRotation {
 public:
@@ -31,6 +29,11 @@ public:
     CalculationResults calculate();
     const CalculationResults& getLastResults() const { return m_lastResults; }
 
+    // ========== Diagnostics ==========
+    // nullptr (the default) disables tracing.
+    void setTraceSink(std::shared_ptr<PolarizationTraceSink> sink) { m_traceSink = std::move(sink); }
+    const std::shared_ptr<PolarizationTraceSink>& getTraceSink() const { return m_traceSink; }
+
     // ========== Helper Calculations ==========
     double calculateParallacticAngle(
         double latitude, double declination, double hourAngle) const;
@@ -66,6 +69,7 @@ private:
     IonosphereData m_ionoData;
     MoonEphemeris m_moonEphem;
     CalculationResults m_lastResults;
+    std::shared_ptr<PolarizationTraceSink> m_traceSink;
 
     void calculateMoonElevation();
     double calculatePathLength() const;
@@ -0,0 +1,54 @@
+#include "FileHttpTransport.h"
+#include "DataCache.h"
+#include "MappedFile.h"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+FileHttpTransport::FileHttpTransport(const std::string& directory)
+    : m_directory(directory), m_requests(0) {
+    std::error_code ec;
+    fs::create_directories(m_directory, ec);
+}
+
+std::string FileHttpTransport::bodyPath(const std::string& url) const {
+    return (fs::path(m_directory) / (DataCache::hashName(url) + ".http")).string();
+}
+
+bool FileHttpTransport::put(const std::string& url, const std::string& body) const {
+    std::ofstream out(bodyPath(url), std::ios::binary | std::ios::trunc);
+    out.write(body.data(), static_cast<std::streamsize>(body.size()));
+    return static_cast<bool>(out);
+}
+
+bool FileHttpTransport::remove(const std::string& url) const {
+    std::error_code ec;
+    return fs::remove(bodyPath(url), ec);
+}
+
+bool FileHttpTransport::fetch(const std::string& url, std::string& response, int& statusCode, std::string& errorMsg) {
+    ++m_requests;
+    response.clear();
+
+    MappedFile file(bodyPath(url));
+    if (!file.isOpen()) {
+        statusCode = 404;
+        errorMsg = "HTTP status code: 404";
+        return false;
+    }
+
+    response.assign(file.data(), file.size());
+    statusCode = 200;
+    if (response.empty()) {
+        errorMsg = "Empty response received";
+        return false;
+    }
+    return true;
+}
+
+SimpleHttpClient::Transport FileHttpTransport::asTransport() {
+    return [this](const std::string& url, std::string& response, int& statusCode, std::string& errorMsg) {
+        return fetch(url, response, statusCode, errorMsg);
+    };
+}
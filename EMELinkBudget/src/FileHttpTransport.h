@@ -0,0 +1,34 @@
+#pragma once
+
+#include "SimpleHttpClient.h"
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+// ========== File-Backed HTTP Stand-In ==========
+// Serves response bodies from a directory instead of the network, one file per
+// URL named DataCache::hashName(url) + ".http". URLs without a file answer
+// 404, so retry and fallback paths can be exercised offline. Install with
+// SimpleHttpClient::setTransport(transport.asTransport()).
+
+class FileHttpTransport {
+public:
+    explicit FileHttpTransport(const std::string& directory);
+
+    // Records `body` as the 200 response for `url`.
+    bool put(const std::string& url, const std::string& body) const;
+    bool remove(const std::string& url) const;
+    std::string bodyPath(const std::string& url) const;
+
+    bool fetch(const std::string& url, std::string& response, int& statusCode, std::string& errorMsg);
+
+    // The returned transport refers to this object, which must outlive it.
+    SimpleHttpClient::Transport asTransport();
+
+    std::size_t getRequestCount() const { return m_requests.load(); }
+    void resetRequestCount() { m_requests = 0; }
+
+private:
+    std::string m_directory;
+    std::atomic<std::size_t> m_requests;
+};
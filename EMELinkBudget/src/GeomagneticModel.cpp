@@ -0,0 +1,269 @@
+#define _USE_MATH_DEFINES
+#include "GeomagneticModel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ========== Magnetic Field Batch ==========
+
+void MagneticFieldBatch::reset(std::size_t rows) {
+    for (AlignedColumn* column : {&X, &Y, &Z, &H, &F, &inclination, &declination}) {
+        column->assign(rows, 0.0);
+    }
+}
+
+MagneticFieldResult MagneticFieldBatch::row(std::size_t i) const {
+    return {X[i], Y[i], Z[i], H[i], F[i], inclination[i], declination[i]};
+}
+
+// ========== Constructor ==========
+
+GeomagneticModel::GeomagneticModel(double referenceRadius_km)
+    : m_loaded(false), m_maxDegree(0), m_referenceRadius(referenceRadius_km) {
+}
+
+void GeomagneticModel::configure(int maxDegree, const std::string& name) {
+    m_maxDegree = std::clamp(maxDegree, 0, SphericalHarmonicEngine::MAX_SUPPORTED_DEGREE);
+    m_modelName = name;
+    m_engine.setMaxDegree(m_maxDegree);
+
+    {
+        std::lock_guard<std::mutex> lock(m_snapshotMutex);
+        m_snapshot.reset();
+    }
+
+    m_loaded = m_maxDegree > 0;
+}
+
+// ========== Time-Evolved Coefficients ==========
+
+std::shared_ptr<const GeomagneticCoefficientSnapshot> GeomagneticModel::getSnapshot(double decimal_year) const {
+    std::lock_guard<std::mutex> lock(m_snapshotMutex);
+
+    if (m_snapshot && m_snapshot->decimalYear == decimal_year) {
+        return m_snapshot;
+    }
+
+    auto snapshot = std::make_shared<GeomagneticCoefficientSnapshot>();
+    snapshot->decimalYear = decimal_year;
+    snapshot->g.assign(termCount(m_maxDegree), 0.0);
+    snapshot->h.assign(termCount(m_maxDegree), 0.0);
+
+    if (m_loaded) {
+        evolveCoefficients(decimal_year, snapshot->g.data(), snapshot->h.data());
+    }
+    m_engine.pack(snapshot->g.data(), snapshot->h.data(), snapshot->packed);
+
+    m_snapshot = std::move(snapshot);
+    return m_snapshot;
+}
+
+// ========== Field Evaluation ==========
+
+void GeomagneticModel::geodeticToGeocentric(double lat_deg, double height_km,
+                                            double& lat_geocentric_deg,
+                                            double& radius_km) const {
+    double lat_rad = lat_deg * M_PI / 180.0;
+    double sin_lat = std::sin(lat_rad);
+    double cos_lat = std::cos(lat_rad);
+
+    double a = GeomagneticConstants::WGS84_A;
+    double e2 = GeomagneticConstants::WGS84_E2;
+
+    double N = a / std::sqrt(1.0 - e2 * sin_lat * sin_lat);
+
+    double x = (N + height_km) * cos_lat;
+    double z = (N * (1.0 - e2) + height_km) * sin_lat;
+
+    radius_km = std::sqrt(x * x + z * z);
+    lat_geocentric_deg = std::atan2(z, x) * 180.0 / M_PI;
+}
+
+void GeomagneticModel::rotateToGeodetic(double X_prime, double Z_prime,
+                                        double lat_geodetic, double lat_geocentric,
+                                        double& X, double& Z) const {
+    double psi = (lat_geodetic - lat_geocentric) * M_PI / 180.0;
+
+    double cos_psi = std::cos(psi);
+    double sin_psi = std::sin(psi);
+
+    X = X_prime * cos_psi - Z_prime * sin_psi;
+    Z = X_prime * sin_psi + Z_prime * cos_psi;
+}
+
+MagneticFieldResult GeomagneticModel::calculate(
+    double latitude_deg,
+    double longitude_deg,
+    double height_km,
+    double decimal_year) const {
+
+    MagneticFieldResult result = {};
+
+    if (!m_loaded) {
+        return result;
+    }
+
+    if (std::abs(latitude_deg) > 89.9) {
+        latitude_deg = (latitude_deg > 0) ? 89.9 : -89.9;
+    }
+
+    std::shared_ptr<const GeomagneticCoefficientSnapshot> coeffs = getSnapshot(decimal_year);
+
+    double lat_geocentric, radius_km;
+    geodeticToGeocentric(latitude_deg, height_km, lat_geocentric, radius_km);
+
+    double theta = (90.0 - lat_geocentric) * M_PI / 180.0;
+    double phi = longitude_deg * M_PI / 180.0;
+
+    double sin_theta = std::sin(theta);
+    if (std::abs(sin_theta) < 1e-10) {
+        sin_theta = 1e-10;
+    }
+
+    double cos_m_phi[SphericalHarmonicEngine::MAX_SUPPORTED_DEGREE + 1];
+    double sin_m_phi[SphericalHarmonicEngine::MAX_SUPPORTED_DEGREE + 1];
+    m_engine.longitudeTerms(phi, cos_m_phi, sin_m_phi);
+
+    double Br, Btheta, Bphi;
+    m_engine.evaluate(m_referenceRadius / radius_km, std::cos(theta), sin_theta,
+                      cos_m_phi, sin_m_phi, coeffs->packed.data(), Br, Btheta, Bphi);
+
+    double X_gc = Btheta;
+    double Y_gc = -Bphi;
+    double Z_gc = -Br;
+
+    double X, Z;
+    rotateToGeodetic(X_gc, Z_gc, latitude_deg, lat_geocentric, X, Z);
+
+    result.X = X;
+    result.Y = Y_gc;
+    result.Z = Z;
+    result.H = std::sqrt(X * X + Y_gc * Y_gc);
+    result.F = std::sqrt(X * X + Y_gc * Y_gc + Z * Z);
+    result.inclination = std::atan2(Z, result.H) * 180.0 / M_PI;
+    result.declination = std::atan2(Y_gc, X) * 180.0 / M_PI;
+
+    return result;
+}
+
+// ========== Batch Evaluation ==========
+
+bool GeomagneticModel::calculateBatch(
+    const std::vector<double>& latitude_deg,
+    const std::vector<double>& longitude_deg,
+    const std::vector<double>& height_km,
+    double decimal_year,
+    MagneticFieldBatch& results) const {
+
+    const std::size_t count = latitude_deg.size();
+    results.reset(count);
+
+    if (!m_loaded || longitude_deg.size() != count || height_km.size() != count) {
+        return false;
+    }
+
+    std::shared_ptr<const GeomagneticCoefficientSnapshot> coeffs = getSnapshot(decimal_year);
+
+    auto clampLat = [](double lat) { return std::max(-89.9, std::min(89.9, lat)); };
+    auto before = [&](std::uint32_t a, std::uint32_t b) {
+        const double la = clampLat(latitude_deg[a]);
+        const double lb = clampLat(latitude_deg[b]);
+        return la < lb || (la == lb && height_km[a] < height_km[b]);
+    };
+
+    std::vector<std::uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0u);
+    if (!std::is_sorted(order.begin(), order.end(), before)) {
+        std::stable_sort(order.begin(), order.end(), before);
+    }
+
+    std::vector<double> sums(SphericalHarmonicEngine::ORDER_SUM_STRIDE * (m_maxDegree + 1));
+
+    // Longitude series for up to CHUNK points at a time, laid out so the
+    // inner loop runs across points.
+    constexpr std::size_t CHUNK = 64;
+    double cos1[CHUNK], sin1[CHUNK], cosm[CHUNK], sinm[CHUNK];
+    double Br[CHUNK], Btheta[CHUNK], Bphi[CHUNK];
+
+    std::size_t begin = 0;
+    while (begin < count) {
+        const double lat = clampLat(latitude_deg[order[begin]]);
+        const double height = height_km[order[begin]];
+        std::size_t end = begin + 1;
+        while (end < count && clampLat(latitude_deg[order[end]]) == lat && height_km[order[end]] == height) {
+            ++end;
+        }
+
+        double lat_geocentric, radius_km;
+        geodeticToGeocentric(lat, height, lat_geocentric, radius_km);
+
+        const double theta = (90.0 - lat_geocentric) * M_PI / 180.0;
+        double sin_theta = std::sin(theta);
+        if (std::abs(sin_theta) < 1e-10) {
+            sin_theta = 1e-10;
+        }
+
+        const int orders = m_engine.orderSums(m_referenceRadius / radius_km, std::cos(theta), sin_theta,
+                                              coeffs->packed.data(), sums.data());
+
+        const double psi = (lat - lat_geocentric) * M_PI / 180.0;
+        const double cos_psi = std::cos(psi);
+        const double sin_psi = std::sin(psi);
+
+        for (std::size_t chunk = begin; chunk < end; chunk += CHUNK) {
+            const std::size_t k = std::min(CHUNK, end - chunk);
+
+            for (std::size_t j = 0; j < k; ++j) {
+                const double phi = longitude_deg[order[chunk + j]] * M_PI / 180.0;
+                cos1[j] = std::cos(phi);
+                sin1[j] = std::sin(phi);
+                cosm[j] = 1.0;
+                sinm[j] = 0.0;
+                Br[j] = sums[0];
+                Btheta[j] = sums[2];
+                Bphi[j] = 0.0;
+            }
+
+            for (int m = 1; m < orders; ++m) {
+                const double* o = sums.data() + SphericalHarmonicEngine::ORDER_SUM_STRIDE * m;
+                for (std::size_t j = 0; j < k; ++j) {
+                    const double c = cosm[j] * cos1[j] - sinm[j] * sin1[j];
+                    const double s = sinm[j] * cos1[j] + cosm[j] * sin1[j];
+                    cosm[j] = c;
+                    sinm[j] = s;
+                    Br[j] += o[0] * c + o[1] * s;
+                    Btheta[j] += o[2] * c + o[3] * s;
+                    Bphi[j] += o[4] * c + o[5] * s;
+                }
+            }
+
+            for (std::size_t j = 0; j < k; ++j) {
+                const std::uint32_t i = order[chunk + j];
+                const double X_gc = Btheta[j];
+                const double Y = -Bphi[j];
+                const double Z_gc = -Br[j];
+
+                const double X = X_gc * cos_psi - Z_gc * sin_psi;
+                const double Z = X_gc * sin_psi + Z_gc * cos_psi;
+                const double H = std::sqrt(X * X + Y * Y);
+
+                results.X[i] = X;
+                results.Y[i] = Y;
+                results.Z[i] = Z;
+                results.H[i] = H;
+                results.F[i] = std::sqrt(H * H + Z * Z);
+                results.inclination[i] = std::atan2(Z, H) * 180.0 / M_PI;
+                results.declination[i] = std::atan2(Y, X) * 180.0 / M_PI;
+            }
+        }
+
+        begin = end;
+    }
+
+    return true;
+}
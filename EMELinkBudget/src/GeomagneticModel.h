@@ -0,0 +1,145 @@
+#pragma once
+
+#include "SphericalHarmonicEngine.h"
+#include "LinkBudgetResultsBatch.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+
+// ========== Geomagnetic Constants ==========
+
+namespace GeomagneticConstants {
+    constexpr double WGS84_A = 6378.137;
+    constexpr double WGS84_F = 1.0 / 298.257223563;
+    constexpr double WGS84_B = WGS84_A * (1.0 - WGS84_F);
+    constexpr double WGS84_E2 = 2.0 * WGS84_F - WGS84_F * WGS84_F;
+
+    // Geomagnetic reference radius used by IGRF.
+    constexpr double REFERENCE_RADIUS = 6371.2;
+}
+
+// ========== Gauss Coefficient ==========
+
+struct GaussCoefficient {
+    int n;
+    int m;
+    double gnm;
+    double hnm;
+    double dgnm;
+    double dhnm;
+};
+
+// ========== Magnetic Field Result ==========
+
+struct MagneticFieldResult {
+    double X;
+    double Y;
+    double Z;
+    double H;
+    double F;
+    double inclination;
+    double declination;
+};
+
+// ========== Magnetic Field Batch ==========
+// Structure-of-arrays MagneticFieldResult, one row per input point.
+
+struct MagneticFieldBatch {
+    AlignedColumn X;
+    AlignedColumn Y;
+    AlignedColumn Z;
+    AlignedColumn H;
+    AlignedColumn F;
+    AlignedColumn inclination;
+    AlignedColumn declination;
+
+    std::size_t size() const { return X.size(); }
+
+    // Resizes every column and zeroes it.
+    void reset(std::size_t rows);
+    MagneticFieldResult row(std::size_t row) const;
+};
+
+// ========== Time-Evolved Coefficients ==========
+// Main-field g/h at one decimal year, flat triangular index n(n+1)/2 + m,
+// plus the order-major copy used by SphericalHarmonicEngine.
+
+struct GeomagneticCoefficientSnapshot {
+    double decimalYear;
+    std::vector<double> g;
+    std::vector<double> h;
+    std::vector<double> packed;
+};
+
+// ========== Geomagnetic Model ==========
+// Shared evaluation core for Gauss-coefficient main-field models. A derived
+// model supplies its coefficients at a decimal year; the base caches the
+// evolved set for the most recent year and evaluates it with
+// SphericalHarmonicEngine, per point or in latitude/height groups.
+// calculate() and calculateBatch() are safe to call concurrently.
+
+class GeomagneticModel {
+public:
+    virtual ~GeomagneticModel() = default;
+
+    bool isLoaded() const { return m_loaded; }
+    int getMaxDegree() const { return m_maxDegree; }
+    const std::string& getModelName() const { return m_modelName; }
+    double getReferenceRadius() const { return m_referenceRadius; }
+
+    MagneticFieldResult calculate(
+        double latitude_deg,
+        double longitude_deg,
+        double height_km,
+        double decimal_year) const;
+
+    // Evaluates many points at one epoch. Points are grouped by (latitude,
+    // height), which fixes colatitude and radius, so each group runs the
+    // degree recursion once and every point in it only sums the longitude
+    // series. Results keep the input order. Returns false (zeroed results)
+    // if no model is loaded or the input columns differ in length.
+    bool calculateBatch(
+        const std::vector<double>& latitude_deg,
+        const std::vector<double>& longitude_deg,
+        const std::vector<double>& height_km,
+        double decimal_year,
+        MagneticFieldBatch& results) const;
+
+    // Coefficients at decimal_year; reused while the year is unchanged.
+    std::shared_ptr<const GeomagneticCoefficientSnapshot> getSnapshot(double decimal_year) const;
+
+protected:
+    explicit GeomagneticModel(double referenceRadius_km);
+
+    GeomagneticModel(const GeomagneticModel&) = delete;
+    GeomagneticModel& operator=(const GeomagneticModel&) = delete;
+
+    // Called by loaders once coefficients are in place: sizes the engine for
+    // maxDegree (0 unloads) and drops the cached snapshot.
+    void configure(int maxDegree, const std::string& name);
+
+    // Main-field g and h at decimal_year, each termCount(maxDegree) long.
+    virtual void evolveCoefficients(double decimal_year, double* g, double* h) const = 0;
+
+    static int getIndex(int n, int m) { return n * (n + 1) / 2 + m; }
+    static int termCount(int maxDegree) { return (maxDegree + 1) * (maxDegree + 2) / 2; }
+
+private:
+    bool m_loaded;
+    int m_maxDegree;
+    double m_referenceRadius;
+    std::string m_modelName;
+    SphericalHarmonicEngine m_engine;
+
+    mutable std::mutex m_snapshotMutex;
+    mutable std::shared_ptr<const GeomagneticCoefficientSnapshot> m_snapshot;
+
+    void geodeticToGeocentric(double lat_deg, double height_km,
+                              double& lat_geocentric_deg,
+                              double& radius_km) const;
+
+    void rotateToGeodetic(double X_prime, double Z_prime,
+                          double lat_geodetic, double lat_geocentric,
+                          double& X, double& Z) const;
+};
@@ -30,8 +30,18 @@ void GeometryCalculator::calculateMoonPosition(
     double hourAngle,
     double& azimuth, double& elevation) {
 
-    double sinLat = std::sin(latitude);
-    double cosLat = std::cos(latitude);
+    calculateMoonPosition(
+        std::sin(latitude), std::cos(latitude),
+        moonDEC, hourAngle,
+        azimuth, elevation);
+}
+
+void GeometryCalculator::calculateMoonPosition(
+    double sinLat, double cosLat,
+    double moonDEC,
+    double hourAngle,
+    double& azimuth, double& elevation) const {
+
     double sinDec = std::sin(moonDEC);
     double cosDec = std::cos(moonDEC);
     double cosH = std::cos(hourAngle);
@@ -83,9 +93,35 @@ double GeometryCalculator::calculateHourAngle(
     return deg2rad(HA_deg);
 }
 
+PassGeometry GeometryCalculator::preparePass(
+    const SiteParameters& txSite,
+    const SiteParameters& rxSite) const {
+
+    PassGeometry pass;
+    pass.sinLat_TX = std::sin(txSite.latitude);
+    pass.cosLat_TX = std::cos(txSite.latitude);
+    pass.sinLat_RX = std::sin(rxSite.latitude);
+    pass.cosLat_RX = std::cos(rxSite.latitude);
+    return pass;
+}
+
+GeometryResults GeometryCalculator::calculate(
+    const SiteParameters& txSite,
+    const SiteParameters& rxSite,
+    const MoonEphemeris& moonEphem,
+    std::time_t observationTime,
+    double frequency_MHz) {
+
+    return calculate(
+        txSite, rxSite,
+        preparePass(txSite, rxSite),
+        moonEphem, observationTime, frequency_MHz);
+}
+
 GeometryResults GeometryCalculator::calculate(
     const SiteParameters& txSite,
     const SiteParameters& rxSite,
+    const PassGeometry& pass,
     const MoonEphemeris& moonEphem,
     std::time_t observationTime,
     double frequency_MHz) {
@@ -116,8 +152,8 @@ GeometryResults GeometryCalculator::calculate(
     results.hourAngle_RX_rad = hourAngle_RX;
 
     calculateMoonPosition(
-        txSite.latitude, txSite.longitude,
-        moonEphem.rightAscension, moonEphem.declination,
+        pass.sinLat_TX, pass.cosLat_TX,
+        moonEphem.declination,
         hourAngle_TX,
         results.moonAzimuth_TX_deg, results.moonElevation_TX_deg);
 
@@ -125,8 +161,8 @@ GeometryResults GeometryCalculator::calculate(
     results.moonElevation_TX_deg = rad2deg(results.moonElevation_TX_deg);
 
     calculateMoonPosition(
-        rxSite.latitude, rxSite.longitude,
-        moonEphem.rightAscension, moonEphem.declination,
+        pass.sinLat_RX, pass.cosLat_RX,
+        moonEphem.declination,
         hourAngle_RX,
         results.moonAzimuth_RX_deg, results.moonElevation_RX_deg);
 
@@ -6,6 +6,19 @@
 #include <cmath>
 #include <ctime>
 
+// ========== Pass Geometry ==========
+// Site trigonometry that stays constant while the moon moves over a pass.
+struct PassGeometry {
+    double sinLat_TX;
+    double cosLat_TX;
+    double sinLat_RX;
+    double cosLat_RX;
+
+    PassGeometry()
+        : sinLat_TX(0.0), cosLat_TX(1.0),
+          sinLat_RX(0.0), cosLat_RX(1.0) {}
+};
+
 // ========== Geometry Calculator ==========
 class GeometryCalculator {
 public:
@@ -18,12 +31,30 @@ public:
         std::time_t observationTime,
         double frequency_MHz = 432.0);
 
+    GeometryResults calculate(
+        const SiteParameters& txSite,
+        const SiteParameters& rxSite,
+        const PassGeometry& pass,
+        const MoonEphemeris& moonEphem,
+        std::time_t observationTime,
+        double frequency_MHz = 432.0);
+
+    PassGeometry preparePass(
+        const SiteParameters& txSite,
+        const SiteParameters& rxSite) const;
+
     void calculateMoonPosition(
         double latitude, double longitude,
         double moonRA, double moonDEC,
         double hourAngle,
         double& azimuth, double& elevation);
 
+    void calculateMoonPosition(
+        double sinLat, double cosLat,
+        double moonDEC,
+        double hourAngle,
+        double& azimuth, double& elevation) const;
+
     double calculateDistance(
         double stationLat, double stationLon,
         double moonRA, double moonDEC,
@@ -1,204 +1,470 @@
 #include "HaslamSkyMap.h"
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <fcntl.h>
-#include <unistd.h>
-#include <cstring>
+#include "MappedFile.h"
 #include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+constexpr std::size_t FITS_BLOCK = 2880;
+constexpr std::size_t FITS_CARD = 80;
+constexpr double HEALPIX_UNSEEN = -1.6375e30;
+
+// ========== FITS Header ==========
+
+struct FitsHeader {
+    std::map<std::string, std::string> values;
+    std::size_t dataOffset = 0;
+
+    bool has(const std::string& key) const { return values.count(key) != 0; }
+
+    std::string text(const std::string& key, const std::string& fallback = "") const {
+        auto it = values.find(key);
+        return it == values.end() ? fallback : it->second;
+    }
+
+    long long integer(const std::string& key, long long fallback = 0) const {
+        auto it = values.find(key);
+        return it == values.end() ? fallback : std::atoll(it->second.c_str());
+    }
+
+    double real(const std::string& key, double fallback = 0.0) const {
+        auto it = values.find(key);
+        return it == values.end() ? fallback : std::atof(it->second.c_str());
+    }
+};
 
-HaslamSkyMap::HaslamSkyMap()
-    : m_loaded(false), m_nside(0), m_npix(0), m_mapData(nullptr), m_fileSize(0), m_fd(-1) {
+std::string trim(std::string_view s) {
+    std::size_t b = s.find_first_not_of(' ');
+    if (b == std::string_view::npos) return std::string();
+    std::size_t e = s.find_last_not_of(' ');
+    return std::string(s.substr(b, e - b + 1));
 }
 
-HaslamSkyMap::~HaslamSkyMap() {
-    unload();
+// Value field of a "KEYWORD = value / comment" card, quotes removed.
+std::string cardValue(std::string_view field) {
+    std::size_t b = field.find_first_not_of(' ');
+    if (b == std::string_view::npos) return std::string();
+    if (field[b] == '\'') {
+        std::string out;
+        for (std::size_t i = b + 1; i < field.size(); ++i) {
+            if (field[i] == '\'') {
+                if (i + 1 < field.size() && field[i + 1] == '\'') {
+                    out += '\'';
+                    ++i;
+                    continue;
+                }
+                break;
+            }
+            out += field[i];
+        }
+        return trim(out);
+    }
+    return trim(field.substr(b, field.find('/', b) - b));
 }
 
-void HaslamSkyMap::unload() {
-    if (m_mapData != nullptr && m_mapData != MAP_FAILED) {
-        munmap(m_mapData, m_fileSize);
-        m_mapData = nullptr;
+// Header starting at `offset`; false if it has no END card.
+bool readHeader(const char* data, std::size_t size, std::size_t offset, FitsHeader& header) {
+    header.values.clear();
+    for (std::size_t pos = offset; pos + FITS_CARD <= size; pos += FITS_CARD) {
+        std::string_view card(data + pos, FITS_CARD);
+        std::string key = trim(card.substr(0, 8));
+        if (key == "END") {
+            std::size_t end = pos + FITS_CARD - offset;
+            header.dataOffset = offset + (end + FITS_BLOCK - 1) / FITS_BLOCK * FITS_BLOCK;
+            return true;
+        }
+        if (!key.empty() && card.substr(8, 2) == "= ") {
+            header.values[key] = cardValue(card.substr(10));
+        }
     }
-    if (m_fd >= 0) {
-        close(m_fd);
-        m_fd = -1;
+    return false;
+}
+
+// Bytes of data following a header, padded to whole blocks.
+std::size_t dataSize(const FitsHeader& header) {
+    long long naxis = header.integer("NAXIS");
+    if (naxis <= 0) return 0;
+    long long bytes = std::llabs(header.integer("BITPIX")) / 8;
+    for (long long i = 1; i <= naxis; ++i) {
+        bytes *= header.integer("NAXIS" + std::to_string(i));
     }
-    m_loaded = false;
+    bytes = (bytes + header.integer("PCOUNT")) * header.integer("GCOUNT", 1);
+    return (static_cast<std::size_t>(bytes) + FITS_BLOCK - 1) / FITS_BLOCK * FITS_BLOCK;
 }
 
-bool HaslamSkyMap::loadFITS(const std::string& filename) {
-    unload();
+// ========== Column Decoding ==========
 
-    m_fd = open(filename.c_str(), O_RDONLY);
-    if (m_fd < 0) {
-        return false;
+template <typename T>
+T readBigEndian(const char* p) {
+    unsigned char b[sizeof(T)];
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        b[i] = static_cast<unsigned char>(p[sizeof(T) - 1 - i]);
     }
+    T value;
+    std::memcpy(&value, b, sizeof(T));
+    return value;
+}
 
-    struct stat sb;
-    if (fstat(m_fd, &sb) < 0) {
-        close(m_fd);
-        m_fd = -1;
-        return false;
+int typeSize(char type) {
+    switch (type) {
+        case 'B': return 1;
+        case 'I': return 2;
+        case 'J': case 'E': return 4;
+        case 'K': case 'D': return 8;
+        default: return 0;
     }
+}
 
-    m_fileSize = sb.st_size;
+double decodeValue(const char* p, char type) {
+    switch (type) {
+        case 'B': return static_cast<unsigned char>(*p);
+        case 'I': return readBigEndian<int16_t>(p);
+        case 'J': return readBigEndian<int32_t>(p);
+        case 'K': return static_cast<double>(readBigEndian<int64_t>(p));
+        case 'E': return readBigEndian<float>(p);
+        default: return readBigEndian<double>(p);
+    }
+}
 
-    m_mapData = mmap(nullptr, m_fileSize, PROT_READ, MAP_PRIVATE, m_fd, 0);
-    if (m_mapData == MAP_FAILED) {
-        close(m_fd);
-        m_fd = -1;
-        m_mapData = nullptr;
-        return false;
+// Runs body(first, last) over [0, n) split across the hardware threads.
+template <typename Body>
+void parallelFor(int64_t n, Body body) {
+    const unsigned workers = std::max(1u, std::min(16u, std::thread::hardware_concurrency()));
+    const int64_t chunk = (n + workers - 1) / workers;
+    std::vector<std::thread> threads;
+    for (unsigned w = 1; w < workers; ++w) {
+        threads.emplace_back(body, std::min(n, w * chunk), std::min(n, (w + 1) * chunk));
+    }
+    body(0, std::min(n, chunk));
+    for (std::thread& t : threads) {
+        t.join();
     }
+}
 
-    madvise(m_mapData, m_fileSize, MADV_RANDOM);
+// Mean of the positive values among `count` children starting at `first`.
+float averageChildren(const std::vector<float>& fine, int64_t first, int64_t count) {
+    double sum = 0.0;
+    int64_t used = 0;
+    for (int64_t i = first; i < first + count; ++i) {
+        if (fine[i] > 0.0f) {
+            sum += fine[i];
+            ++used;
+        }
+    }
+    return used > 0 ? static_cast<float>(sum / used) : 0.0f;
+}
 
-    char* data = static_cast<char*>(m_mapData);
-    size_t offset = 0;
-    bool inBintable = false;
-    int temp_nside = 0;
+double pixelSize(int nside) {
+    return std::sqrt(4.0 * 3.14159265358979323846 / (12.0 * nside * nside));
+}
+
+}  // namespace
+
+// ========== Loading ==========
 
-    while (offset < m_fileSize) {
-        if (offset + 2880 > m_fileSize) break;
+HaslamSkyMap::HaslamSkyMap() : m_loaded(false) {
+}
+
+void HaslamSkyMap::unload() {
+    m_pixels.clear();
+    m_pixels.shrink_to_fit();
+    m_grid = HealpixGrid();
+    m_levels.clear();
+    m_loaded = false;
+}
 
-        char* header = data + offset;
+bool HaslamSkyMap::loadFITS(const std::string& filename, double surveyBeam_deg) {
+    unload();
 
-        if (!inBintable && strncmp(header, "XTENSION= 'BINTABLE'", 20) == 0) {
-            inBintable = true;
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+    const char* data = file.data();
+    const std::size_t size = file.size();
+
+    // First binary table extension after the primary HDU.
+    FitsHeader header;
+    std::size_t offset = 0;
+    bool found = false;
+    while (offset < size && readHeader(data, size, offset, header)) {
+        if (header.text("XTENSION") == "BINTABLE") {
+            found = true;
+            break;
         }
+        offset = header.dataOffset + dataSize(header);
+    }
+    if (!found || header.text("INDXSCHM", "IMPLICIT") != "IMPLICIT") {
+        return false;
+    }
 
-        if (inBintable) {
-            for (size_t i = 0; i < 2880; i += 80) {
-                if (strncmp(header + i, "NSIDE   =", 9) == 0) {
-                    char value[80];
-                    strncpy(value, header + i + 10, 70);
-                    value[70] = '\0';
-                    temp_nside = atoi(value);
-                }
-                if (strncmp(header + i, "END", 3) == 0) {
-                    offset += 2880;
-
-                    if (temp_nside > 0) {
-                        m_nside = temp_nside;
-                        m_npix = 12LL * m_nside * m_nside;
-                        m_loaded = true;
-                        return true;
-                    }
-                    inBintable = false;
-                    break;
+    HealpixGrid grid(static_cast<int>(header.integer("NSIDE")));
+    const std::string ordering = header.text("ORDERING", "RING");
+    const std::string coordsys = header.text("COORDSYS", "G");
+    const bool nested = ordering.compare(0, 4, "NEST") == 0;
+    const bool galactic = coordsys == "G" || coordsys == "GALACTIC";
+    if (!grid.isValid() || (!nested && ordering != "RING") ||
+        !(galactic || coordsys == "C" || coordsys == "Q" || coordsys == "CELESTIAL")) {
+        return false;
+    }
+
+    // First column: "<repeat><type>", e.g. "1024E" or "E".
+    const std::string form = header.text("TFORM1");
+    std::size_t letter = form.find_first_not_of("0123456789");
+    if (letter == std::string::npos) return false;
+    const long long repeat = letter == 0 ? 1 : std::atoll(form.substr(0, letter).c_str());
+    const char type = form[letter];
+    const int width = typeSize(type);
+    const long long rowBytes = header.integer("NAXIS1");
+    const long long rows = header.integer("NAXIS2");
+    if (width == 0 || repeat <= 0 || rows * repeat < grid.getNpix() || rowBytes < repeat * width ||
+        header.dataOffset + static_cast<std::size_t>(rowBytes * rows) > size) {
+        return false;
+    }
+
+    const bool integral = type != 'E' && type != 'D';
+    const double scale = header.real("TSCAL1", 1.0);
+    const double zero = header.real("TZERO1", 0.0);
+    const bool hasNull = header.has("TNULL1");
+    const long long nullValue = header.integer("TNULL1");
+    const double unit = header.text("TUNIT1").compare(0, 2, "mK") == 0 ? 1e-3 : 1.0;
+
+    // Decoded once into native floats in file order; unusable pixels are 0.
+    std::vector<float> source(static_cast<std::size_t>(grid.getNpix()));
+    const char* table = data + header.dataOffset;
+    for (int64_t k = 0; k < grid.getNpix(); ++k) {
+        const char* p = table + (k / repeat) * rowBytes + (k % repeat) * width;
+        double raw = decodeValue(p, type);
+        bool bad = integral ? (hasNull && static_cast<long long>(raw) == nullValue)
+                            : (!std::isfinite(raw) || std::abs(raw / HEALPIX_UNSEEN - 1.0) < 1e-5);
+        double value = (raw * scale + zero) * unit;
+        source[k] = bad || value < 0.0 ? 0.0f : static_cast<float>(value);
+    }
+
+    if (nested && !galactic) {
+        m_pixels.swap(source);
+    } else {
+        // Sample the source map at the centre of every equatorial pixel.
+        m_pixels.resize(source.size());
+        parallelFor(grid.getNpix(), [&](int64_t first, int64_t last) {
+            for (int64_t pix = first; pix < last; ++pix) {
+                double z, phi;
+                grid.pix2zphiNest(pix, z, phi);
+                const double sinTheta = std::sqrt(std::max(0.0, (1.0 - z) * (1.0 + z)));
+                double v[3] = {sinTheta * std::cos(phi), sinTheta * std::sin(phi), z};
+                if (galactic) {
+                    double g[3];
+                    equatorialToGalactic(v, g);
+                    std::copy(g, g + 3, v);
                 }
+                const double srcPhi = std::atan2(v[1], v[0]);
+                const int64_t src = nested ? grid.zphi2nest(v[2], srcPhi) : grid.zphi2ring(v[2], srcPhi);
+                m_pixels[pix] = source[src];
             }
-        }
-        offset += 2880;
+        });
     }
 
-    unload();
-    return false;
+    m_grid = grid;
+    buildPyramid(surveyBeam_deg);
+    m_loaded = true;
+    return true;
 }
 
-int64_t HaslamSkyMap::ang2pix_nest(double theta, double phi) const {
-    if (theta < 0.0 || theta > PI) return -1;
-
-    double z = std::cos(theta);
-    double za = std::abs(z);
-
-    if (phi < 0.0) phi += 2.0 * PI;
-    if (phi >= 2.0 * PI) phi -= 2.0 * PI;
-
-    double tt = phi / (0.5 * PI);
-
-    if (za <= 2.0 / 3.0) {
-        double temp1 = m_nside * (0.5 + tt);
-        double temp2 = m_nside * z * 0.75;
-        int jp = static_cast<int>(temp1 - temp2);
-        int jm = static_cast<int>(temp1 + temp2);
-
-        int ifp = jp / m_nside;
-        int ifm = jm / m_nside;
-
-        if (ifp == ifm) {
-            int face_num = (ifp == 4) ? 4 : ifp + 4;
-            int ix = jm & (m_nside - 1);
-            int iy = m_nside - (jp & (m_nside - 1)) - 1;
-            return xyf2nest(ix, iy, face_num);
-        } else if (ifp < ifm) {
-            int face_num = ifp;
-            int ix = jm & (m_nside - 1);
-            int iy = m_nside - (jp & (m_nside - 1)) - 1;
-            return xyf2nest(ix, iy, face_num);
-        } else {
-            int face_num = ifm + 8;
-            int ix = jm & (m_nside - 1);
-            int iy = m_nside - (jp & (m_nside - 1)) - 1;
-            return xyf2nest(ix, iy, face_num);
-        }
-    } else {
-        int ntt = static_cast<int>(tt);
-        if (ntt >= 4) ntt = 3;
+// ========== Beam Pyramid ==========
+
+void HaslamSkyMap::buildPyramid(double surveyBeam_deg) {
+    m_levels.clear();
 
-        double tp = tt - ntt;
-        double tmp = m_nside * std::sqrt(3.0 * (1.0 - za));
+    // Level 0: the map averaged down to at most BASE_NSIDE, carrying the
+    // survey's own resolution.
+    Level base;
+    base.grid = HealpixGrid(std::min(m_grid.getNside(), BASE_NSIDE));
+    base.fwhm_deg = std::max(surveyBeam_deg, 2.0 * pixelSize(base.grid.getNside()) * 180.0 / PI);
+    const int64_t children = m_grid.getNpix() / base.grid.getNpix();
+    base.pixels.resize(base.grid.getNpix());
+    for (int64_t pix = 0; pix < base.grid.getNpix(); ++pix) {
+        base.pixels[pix] = averageChildren(m_pixels, pix * children, children);
+    }
+    m_levels.push_back(std::move(base));
+
+    // Each further level halves NSIDE and doubles the beam. The coarser
+    // grid is the average of four children, then smoothed by the Gaussian
+    // that takes the previous beam to the new one (beams add in quadrature;
+    // the 4-pixel average contributes about pix^2/12).
+    while (m_levels.back().fwhm_deg < MAX_PYRAMID_BEAM_DEG && m_levels.back().grid.getNside() > 1) {
+        const Level& fine = m_levels.back();
+        Level level;
+        level.grid = HealpixGrid(fine.grid.getNside() / 2);
+        level.fwhm_deg = 2.0 * fine.fwhm_deg;
+
+        std::vector<float> degraded(level.grid.getNpix());
+        for (int64_t pix = 0; pix < level.grid.getNpix(); ++pix) {
+            degraded[pix] = averageChildren(fine.pixels, 4 * pix, 4);
+        }
 
-        int jp = static_cast<int>(tp * tmp);
-        int jm = static_cast<int>((1.0 - tp) * tmp);
+        const double step = pixelSize(level.grid.getNside());
+        const double sigmaFine = fine.fwhm_deg * PI / 180.0 / FWHM_PER_SIGMA;
+        const double sigmaLevel = level.fwhm_deg * PI / 180.0 / FWHM_PER_SIGMA;
+        const double sigma = std::sqrt(std::max(0.0, sigmaLevel * sigmaLevel - sigmaFine * sigmaFine - step * step / 12.0));
+        level.pixels = smooth(level.grid, degraded, sigma, step);
+        m_levels.push_back(std::move(level));
+    }
+}
 
-        jp = std::min(jp, m_nside - 1);
-        jm = std::min(jm, m_nside - 1);
+std::vector<float> HaslamSkyMap::smooth(const HealpixGrid& grid, const std::vector<float>& pixels,
+                                        double sigma, double step) {
+    if (sigma <= 0.0) {
+        return pixels;
+    }
 
-        if (z >= 0) {
-            return xyf2nest(m_nside - jm - 1, m_nside - jp - 1, ntt);
-        } else {
-            return xyf2nest(jp, jm, ntt + 8);
+    // Stencil on a square grid of the pixel size out to 3 sigma, placed by
+    // azimuthal equidistant projection around each pixel centre. Weights
+    // include the sin(d)/d area factor of that projection.
+    struct Tap { double cosD, east, north, weight; };
+    std::vector<Tap> taps;
+    const int reach = static_cast<int>(std::ceil(3.0 * sigma / step));
+    for (int i = -reach; i <= reach; ++i) {
+        for (int j = -reach; j <= reach; ++j) {
+            const double d = step * std::sqrt(static_cast<double>(i * i + j * j));
+            if (d > 3.0 * sigma || d >= PI) continue;
+            const double alpha = std::atan2(static_cast<double>(j), static_cast<double>(i));
+            const double area = d > 0.0 ? std::sin(d) / d : 1.0;
+            taps.push_back({std::cos(d), std::sin(d) * std::cos(alpha), std::sin(d) * std::sin(alpha),
+                            std::exp(-0.5 * d * d / (sigma * sigma)) * area});
         }
     }
+
+    std::vector<float> out(pixels.size());
+    parallelFor(grid.getNpix(), [&](int64_t first, int64_t last) {
+        for (int64_t pix = first; pix < last; ++pix) {
+            double z, phi;
+            grid.pix2zphiNest(pix, z, phi);
+            const double sinTheta = std::sqrt(std::max(0.0, (1.0 - z) * (1.0 + z)));
+            const double cp = std::cos(phi), sp = std::sin(phi);
+            const double c[3] = {sinTheta * cp, sinTheta * sp, z};
+            const double e[3] = {-sp, cp, 0.0};
+            const double n[3] = {-z * cp, -z * sp, sinTheta};
+
+            double sum = 0.0, norm = 0.0;
+            for (const Tap& tap : taps) {
+                double v[3];
+                for (int k = 0; k < 3; ++k) {
+                    v[k] = tap.cosD * c[k] + tap.east * e[k] + tap.north * n[k];
+                }
+                const float t = pixels[grid.zphi2nest(std::max(-1.0, std::min(1.0, v[2])), std::atan2(v[1], v[0]))];
+                if (t > 0.0f) {
+                    sum += tap.weight * t;
+                    norm += tap.weight;
+                }
+            }
+            out[pix] = norm > 0.0 ? static_cast<float>(sum / norm) : 0.0f;
+        }
+    });
+    return out;
 }
 
-int64_t HaslamSkyMap::xyf2nest(int ix, int iy, int face_num) const {
-    int64_t pix = face_num * m_nside * m_nside;
+// ========== Lookup ==========
 
-    for (int i = 0; i < 16; i++) {
-        int shift = 15 - i;
-        int64_t bit_x = (ix >> i) & 1;
-        int64_t bit_y = (iy >> i) & 1;
-        pix |= (bit_x << (2 * shift + 1)) | (bit_y << (2 * shift));
+void HaslamSkyMap::equatorialToGalactic(const double* equ, double* gal) {
+    static const double R[3][3] = {
+        {-0.0548755604162154, -0.8734370902348850, -0.4838350155487132},
+        { 0.4941094278755837, -0.4448296299600112,  0.7469822444972189},
+        {-0.8676661490190047, -0.1980763734312015,  0.4559837761750669}
+    };
+    for (int i = 0; i < 3; ++i) {
+        gal[i] = R[i][0] * equ[0] + R[i][1] * equ[1] + R[i][2] * equ[2];
     }
-
-    return pix;
 }
 
 double HaslamSkyMap::getTemperature(double ra_deg, double dec_deg) const {
     if (!m_loaded) return 0.0;
+    if (dec_deg < -90.0 || dec_deg > 90.0) return 0.0;
 
-    double theta = (90.0 - dec_deg) * PI / 180.0;
-    double phi = ra_deg * PI / 180.0;
-
-    int64_t pix = ang2pix_nest(theta, phi);
-    if (pix < 0 || pix >= m_npix) return 0.0;
-
-    char* data = static_cast<char*>(m_mapData);
-    size_t offset = 0;
+    const double z = std::sin(dec_deg * PI / 180.0);
+    const int64_t pix = m_grid.zphi2nest(z, ra_deg * PI / 180.0);
+    return m_pixels[pix];
+}
 
-    while (offset < m_fileSize) {
-        if (offset + 2880 > m_fileSize) break;
+double HaslamSkyMap::getInterpolatedTemperature(double ra_deg, double dec_deg) const {
+    if (!m_loaded) return 0.0;
+    if (dec_deg < -90.0 || dec_deg > 90.0) return 0.0;
+
+    int64_t pix[4];
+    double weight[4];
+    m_grid.getInterpolation(std::sin(dec_deg * PI / 180.0), ra_deg * PI / 180.0, pix, weight);
+
+    double sum = 0.0, norm = 0.0;
+    for (int k = 0; k < 4; ++k) {
+        const float t = m_pixels[pix[k]];
+        if (t > 0.0f) {
+            sum += weight[k] * t;
+            norm += weight[k];
+        }
+    }
+    return norm > 0.0 ? sum / norm : 0.0;
+}
 
-        char* header = data + offset;
+void HaslamSkyMap::getTemperatures(const double* ra_deg, const double* dec_deg, double* temperature,
+                                   std::size_t n, bool interpolate) const {
+    if (!m_loaded) {
+        std::fill(temperature, temperature + n, 0.0);
+        return;
+    }
+    if (interpolate) {
+        for (std::size_t i = 0; i < n; ++i) {
+            temperature[i] = getInterpolatedTemperature(ra_deg[i], dec_deg[i]);
+        }
+        return;
+    }
 
-        if (strncmp(header, "XTENSION= 'BINTABLE'", 20) == 0) {
-            for (size_t i = 0; i < 2880; i += 80) {
-                if (strncmp(header + i, "END", 3) == 0) {
-                    offset += 2880;
+    // Blocks small enough to stay in L1 between the passes.
+    constexpr std::size_t BLOCK = 256;
+    double z[BLOCK], phi[BLOCK];
+    int64_t pix[BLOCK];
+    for (std::size_t first = 0; first < n; first += BLOCK) {
+        const std::size_t count = std::min(BLOCK, n - first);
+        for (std::size_t i = 0; i < count; ++i) {
+            const double dec = std::max(-90.0, std::min(90.0, dec_deg[first + i]));
+            z[i] = std::sin(dec * PI / 180.0);
+            phi[i] = ra_deg[first + i] * PI / 180.0;
+        }
+        m_grid.zphi2nestBatch(z, phi, pix, count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const double dec = dec_deg[first + i];
+            temperature[first + i] = dec < -90.0 || dec > 90.0 ? 0.0 : m_pixels[pix[i]];
+        }
+    }
+}
 
-                    int16_t* pixelData = reinterpret_cast<int16_t*>(data + offset);
-                    int16_t rawValue = pixelData[pix];
-                    rawValue = __builtin_bswap16(rawValue);
+double HaslamSkyMap::getBeamTemperature(double ra_deg, double dec_deg, double fwhm_deg) const {
+    if (!m_loaded) return 0.0;
+    if (dec_deg < -90.0 || dec_deg > 90.0) return 0.0;
+    if (fwhm_deg <= m_levels.front().fwhm_deg) {
+        return getTemperature(ra_deg, dec_deg);
+    }
 
-                    return static_cast<double>(rawValue) / 1000.0;
-                }
-            }
-        }
-        offset += 2880;
+    const double z = std::sin(dec_deg * PI / 180.0);
+    const double phi = ra_deg * PI / 180.0;
+    std::size_t upper = std::min(m_levels.size() - 1,
+                                 static_cast<std::size_t>(std::ceil(std::log2(fwhm_deg / m_levels.front().fwhm_deg))));
+    if (fwhm_deg >= m_levels[upper].fwhm_deg) {
+        const Level& last = m_levels[upper];
+        return last.pixels[last.grid.zphi2nest(z, phi)];
     }
 
-    return 0.0;
+    // Blend the two bracketing levels linearly in 1/fwhm^2, which is exact
+    // both for diffuse emission and for sources much smaller than the beam.
+    const Level& a = m_levels[upper - 1];
+    const Level& b = m_levels[upper];
+    const double wa = 1.0 / (a.fwhm_deg * a.fwhm_deg);
+    const double wb = 1.0 / (b.fwhm_deg * b.fwhm_deg);
+    const double t = (1.0 / (fwhm_deg * fwhm_deg) - wa) / (wb - wa);
+    const double ta = a.pixels[a.grid.zphi2nest(z, phi)];
+    const double tb = b.pixels[b.grid.zphi2nest(z, phi)];
+    return ta + t * (tb - ta);
 }
-
@@ -1,33 +1,82 @@
 #pragma once
 
+#include "HealpixGrid.h"
 #include <string>
+#include <cstddef>
 #include <cstdint>
-#include <cmath>
+#include <vector>
+
+// ========== Haslam 408 MHz Sky Map ==========
+// All-sky HEALPix map in a FITS binary table (e.g. the Remazeilles et al.
+// 2014 reprocessing of the Haslam survey). The first column is decoded once
+// at load into native floats in kelvin and, for galactic maps, reprojected
+// onto an equatorial (J2000) grid of the same NSIDE by nearest-pixel
+// sampling. A lookup is then one ang2pix and one load.
+//
+// Load also builds a pyramid of coarser maps, each smoothed with a Gaussian
+// beam twice as wide as the one before, so a beam-averaged temperature
+// costs two lookups whatever the antenna beamwidth.
 
 class HaslamSkyMap {
 public:
     HaslamSkyMap();
-    ~HaslamSkyMap();
 
-    bool loadFITS(const std::string& filename);
+    // surveyBeam_deg is the survey's own resolution, used for the finest
+    // pyramid level (56' for Haslam).
+    bool loadFITS(const std::string& filename, double surveyBeam_deg = SURVEY_BEAM_DEG);
     void unload();
 
+    // Brightness temperature in K; 0 where the map has no data.
     double getTemperature(double ra_deg, double dec_deg) const;
 
+    // Bilinear in the four nearest pixels (HEALPix get_interpol); pixels
+    // without data are left out of the weighting.
+    double getInterpolatedTemperature(double ra_deg, double dec_deg) const;
+
+    // Temperatures for n directions at once, nearest pixel or interpolated.
+    void getTemperatures(const double* ra_deg, const double* dec_deg, double* temperature,
+                         std::size_t n, bool interpolate = false) const;
+
+    // Seen through a Gaussian beam of the given FWHM. Beams narrower than the
+    // finest pyramid level give getTemperature(); wider ones than the
+    // coarsest are clamped to it.
+    double getBeamTemperature(double ra_deg, double dec_deg, double fwhm_deg) const;
+
+    std::size_t getPyramidLevels() const { return m_levels.size(); }
+    double getLevelBeam(std::size_t level) const { return m_levels[level].fwhm_deg; }
+    int getLevelNside(std::size_t level) const { return m_levels[level].grid.getNside(); }
+    const std::vector<float>& getLevelPixels(std::size_t level) const { return m_levels[level].pixels; }
+
     bool isLoaded() const { return m_loaded; }
-    int getNside() const { return m_nside; }
+    int getNside() const { return m_grid.getNside(); }
+    const HealpixGrid& getGrid() const { return m_grid; }
+
+    // Equatorial map in NESTED order.
+    const std::vector<float>& getPixels() const { return m_pixels; }
+
+    // J2000 equatorial to galactic unit vector (Hipparcos definition).
+    static void equatorialToGalactic(const double* equ, double* gal);
+
+    static constexpr double SURVEY_BEAM_DEG = 56.0 / 60.0;  // Haslam et al. 1982
+    static constexpr double MAX_PYRAMID_BEAM_DEG = 60.0;
+    static constexpr int BASE_NSIDE = 256;
 
 private:
+    struct Level {
+        HealpixGrid grid;
+        double fwhm_deg = 0.0;
+        std::vector<float> pixels;  // NESTED
+    };
+
     bool m_loaded;
-    int m_nside;
-    int64_t m_npix;
-    void* m_mapData;
-    size_t m_fileSize;
-    int m_fd;
+    HealpixGrid m_grid;
+    std::vector<float> m_pixels;
+    std::vector<Level> m_levels;
 
-    int64_t ang2pix_nest(double theta, double phi) const;
-    void nest2xyf(int64_t pix, int* ix, int* iy, int* face_num) const;
-    int64_t xyf2nest(int ix, int iy, int face_num) const;
+    void buildPyramid(double surveyBeam_deg);
+    static std::vector<float> smooth(const HealpixGrid& grid, const std::vector<float>& pixels,
+                                     double sigma, double step);
 
     static constexpr double PI = 3.14159265358979323846;
+    static constexpr double FWHM_PER_SIGMA = 2.3548200450309493;
 };
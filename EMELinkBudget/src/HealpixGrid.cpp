@@ -0,0 +1,413 @@
+#include "HealpixGrid.h"
+#include <algorithm>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+constexpr double TWO_PI = 2.0 * PI;
+constexpr double HALF_PI = 0.5 * PI;
+
+// Base pixel row (in units of NSIDE) and longitude index of each face.
+constexpr int FACE_ROW[12] = {2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4};
+constexpr int FACE_COL[12] = {1, 3, 5, 7, 0, 2, 4, 6, 1, 3, 5, 7};
+
+// phi / (pi/2) reduced to [0, 4).
+inline double quadrant(double phi) {
+    double tt = phi / HALF_PI;
+    tt -= 4.0 * std::floor(tt * 0.25);
+    return tt >= 4.0 ? 0.0 : tt;
+}
+
+// Exact floor(sqrt(v)) for the pixel counts used here.
+inline int64_t isqrt(int64_t v) {
+    int64_t r = static_cast<int64_t>(std::sqrt(static_cast<double>(v) + 0.5));
+    while (r * r > v) --r;
+    while ((r + 1) * (r + 1) <= v) ++r;
+    return r;
+}
+
+}  // namespace
+
+// ========== Construction ==========
+
+HealpixGrid::HealpixGrid()
+    : m_nside(0), m_order(-1), m_npface(0), m_npix(0), m_ncap(0) {
+}
+
+HealpixGrid::HealpixGrid(int nside) : HealpixGrid() {
+    if (!isValidNside(nside)) {
+        return;
+    }
+    m_nside = nside;
+    m_order = 0;
+    while ((1 << m_order) < nside) {
+        ++m_order;
+    }
+    m_npface = static_cast<int64_t>(nside) * nside;
+    m_npix = 12 * m_npface;
+    m_ncap = 2 * static_cast<int64_t>(nside) * (nside - 1);
+}
+
+bool HealpixGrid::isValidNside(int nside) {
+    return nside > 0 && nside <= (1 << MAX_ORDER) && (nside & (nside - 1)) == 0;
+}
+
+// ========== Bit Interleaving ==========
+
+uint64_t HealpixGrid::spreadBits(uint32_t v) {
+#if defined(__BMI2__)
+    return _pdep_u64(v, 0x5555555555555555ull);
+#else
+    uint64_t x = v;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+#endif
+}
+
+uint32_t HealpixGrid::compressBits(uint64_t v) {
+#if defined(__BMI2__)
+    return static_cast<uint32_t>(_pext_u64(v, 0x5555555555555555ull));
+#else
+    uint64_t x = v & 0x5555555555555555ull;
+    x = (x | (x >> 1)) & 0x3333333333333333ull;
+    x = (x | (x >> 2)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x >> 4)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x >> 8)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x >> 16)) & 0x00000000FFFFFFFFull;
+    return static_cast<uint32_t>(x);
+#endif
+}
+
+int64_t HealpixGrid::xyf2nest(int ix, int iy, int face) const {
+    return face * m_npface + static_cast<int64_t>(spreadBits(ix) | (spreadBits(iy) << 1));
+}
+
+void HealpixGrid::nest2xyf(int64_t pix, int& ix, int& iy, int& face) const {
+    face = static_cast<int>(pix >> (2 * m_order));
+    uint64_t ipf = static_cast<uint64_t>(pix & (m_npface - 1));
+    ix = static_cast<int>(compressBits(ipf));
+    iy = static_cast<int>(compressBits(ipf >> 1));
+}
+
+// ========== Angle to Pixel ==========
+
+int64_t HealpixGrid::zphi2nest(double z, double phi) const {
+    const double za = std::abs(z);
+    const double tt = quadrant(phi);
+    const int64_t nside = m_nside;
+    int face, ix, iy;
+
+    if (za <= 2.0 / 3.0) {
+        // Equatorial belt: the faces are squares in (phi, z).
+        const double temp1 = nside * (0.5 + tt);
+        const double temp2 = nside * z * 0.75;
+        const int64_t jp = static_cast<int64_t>(temp1 - temp2);
+        const int64_t jm = static_cast<int64_t>(temp1 + temp2);
+        const int64_t ifp = jp >> m_order;
+        const int64_t ifm = jm >> m_order;
+        face = static_cast<int>(ifp == ifm ? (ifp | 4) : (ifp < ifm ? ifp : ifm + 8));
+        ix = static_cast<int>(jm & (nside - 1));
+        iy = static_cast<int>(nside - (jp & (nside - 1)) - 1);
+    } else {
+        // Polar caps.
+        int ntt = std::min(static_cast<int>(tt), 3);
+        const double tp = tt - ntt;
+        const double tmp = nside * std::sqrt(3.0 * (1.0 - za));
+        int64_t jp = std::min<int64_t>(static_cast<int64_t>(tp * tmp), nside - 1);
+        int64_t jm = std::min<int64_t>(static_cast<int64_t>((1.0 - tp) * tmp), nside - 1);
+        if (z >= 0.0) {
+            face = ntt;
+            ix = static_cast<int>(nside - jm - 1);
+            iy = static_cast<int>(nside - jp - 1);
+        } else {
+            face = ntt + 8;
+            ix = static_cast<int>(jp);
+            iy = static_cast<int>(jm);
+        }
+    }
+    return xyf2nest(ix, iy, face);
+}
+
+int64_t HealpixGrid::zphi2ring(double z, double phi) const {
+    const double za = std::abs(z);
+    const double tt = quadrant(phi);
+    const int64_t nside = m_nside;
+    const int64_t nl4 = 4 * nside;
+
+    if (za <= 2.0 / 3.0) {
+        const double temp1 = nside * (0.5 + tt);
+        const double temp2 = nside * z * 0.75;
+        const int64_t jp = static_cast<int64_t>(temp1 - temp2);
+        const int64_t jm = static_cast<int64_t>(temp1 + temp2);
+        const int64_t ir = nside + 1 + jp - jm;
+        const int64_t kshift = 1 - (ir & 1);
+        int64_t ip = (jp + jm - nside + kshift + 1) / 2;
+        ip = ((ip % nl4) + nl4) % nl4;
+        return m_ncap + (ir - 1) * nl4 + ip;
+    }
+
+    const double tp = tt - static_cast<int>(tt);
+    const double tmp = nside * std::sqrt(3.0 * (1.0 - za));
+    const int64_t jp = static_cast<int64_t>(tp * tmp);
+    const int64_t jm = static_cast<int64_t>((1.0 - tp) * tmp);
+    const int64_t ir = jp + jm + 1;
+    int64_t ip = static_cast<int64_t>(tt * ir);
+    ip %= 4 * ir;
+    return z > 0.0 ? 2 * ir * (ir - 1) + ip
+                   : m_npix - 2 * ir * (ir + 1) + ip;
+}
+
+void HealpixGrid::zphi2nestBatch(const double* z, const double* phi, int64_t* pix, std::size_t n) const {
+    // NSIDE <= 8192 keeps every intermediate, and the pixel number itself,
+    // within 32 bits, so the loop vectorises with plain SSE2 conversions.
+    const int32_t nside = m_nside;
+    const int32_t mask = nside - 1;
+    const int32_t order = m_order;
+    const int32_t npface = static_cast<int32_t>(m_npface);
+    const double dnside = nside;
+
+    auto spread = [](int32_t v) {
+        v = (v | (v << 8)) & 0x00FF00FF;
+        v = (v | (v << 4)) & 0x0F0F0F0F;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    };
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const double zi = z[i];
+        const double za = std::abs(zi);
+
+        // phi / (pi/2) reduced to [0, 4) with truncating conversions only.
+        double tt = phi[i] * (1.0 / HALF_PI);
+        const double quarter = tt * 0.25;
+        double turns = static_cast<double>(static_cast<int32_t>(quarter));
+        turns -= quarter < turns ? 1.0 : 0.0;
+        tt -= 4.0 * turns;
+        tt = tt >= 4.0 ? 0.0 : tt;
+
+        // Equatorial belt.
+        const double temp1 = dnside * (0.5 + tt);
+        const double temp2 = dnside * zi * 0.75;
+        const int32_t jpE = static_cast<int32_t>(temp1 - temp2);
+        const int32_t jmE = static_cast<int32_t>(temp1 + temp2);
+        const int32_t ifp = jpE >> order;
+        const int32_t ifm = jmE >> order;
+        const int32_t faceE = ifp == ifm ? (ifp | 4) : (ifp < ifm ? ifp : ifm + 8);
+        const int32_t ixE = jmE & mask;
+        const int32_t iyE = mask - (jpE & mask);
+
+        // Polar caps; the clamp keeps the square root finite in the belt.
+        const int32_t ntt = std::min(static_cast<int32_t>(tt), 3);
+        const double tp = tt - ntt;
+        const double tmp = dnside * std::sqrt(3.0 * std::max(0.0, 1.0 - za));
+        const int32_t jpP = std::min(static_cast<int32_t>(tp * tmp), mask);
+        const int32_t jmP = std::min(static_cast<int32_t>((1.0 - tp) * tmp), mask);
+        const bool north = zi >= 0.0;
+        const int32_t faceP = north ? ntt : ntt + 8;
+        const int32_t ixP = north ? mask - jmP : jpP;
+        const int32_t iyP = north ? mask - jpP : jmP;
+
+        const bool belt = za <= 2.0 / 3.0;
+        const int32_t face = belt ? faceE : faceP;
+        const int32_t ix = belt ? ixE : ixP;
+        const int32_t iy = belt ? iyE : iyP;
+        pix[i] = face * npface + (spread(ix) | (spread(iy) << 1));
+    }
+}
+
+// ========== Interpolation ==========
+
+int64_t HealpixGrid::ringAbove(double z) const {
+    const double za = std::abs(z);
+    if (za <= 2.0 / 3.0) {
+        return static_cast<int64_t>(m_nside * (2.0 - 1.5 * z));
+    }
+    const int64_t ring = static_cast<int64_t>(m_nside * std::sqrt(3.0 * (1.0 - za)));
+    return z > 0.0 ? ring : 4 * static_cast<int64_t>(m_nside) - ring - 1;
+}
+
+void HealpixGrid::ringInfo(int64_t ring, int64_t& startPix, int64_t& ringPix,
+                           double& theta, bool& shifted) const {
+    const int64_t nside = m_nside;
+    const int64_t northRing = ring > 2 * nside ? 4 * nside - ring : ring;
+    const double fact2 = 4.0 / m_npix;
+
+    if (northRing < nside) {
+        const double tmp = northRing * northRing * fact2;
+        theta = std::atan2(std::sqrt(tmp * (2.0 - tmp)), 1.0 - tmp);
+        ringPix = 4 * northRing;
+        shifted = true;
+        startPix = 2 * northRing * (northRing - 1);
+    } else {
+        theta = std::acos((2 * nside - northRing) * (2 * nside * fact2));
+        ringPix = 4 * nside;
+        shifted = ((northRing - nside) & 1) == 0;
+        startPix = m_ncap + (northRing - nside) * ringPix;
+    }
+
+    if (northRing != ring) {
+        theta = PI - theta;
+        startPix = m_npix - startPix - ringPix;
+    }
+}
+
+void HealpixGrid::getInterpolation(double z, double phi, int64_t pix[4], double weight[4]) const {
+    const int64_t nl4 = 4 * static_cast<int64_t>(m_nside);
+    const double theta = std::acos(std::max(-1.0, std::min(1.0, z)));
+    phi = quadrant(phi) * HALF_PI;
+
+    const int64_t ir1 = ringAbove(z);
+    const int64_t ir2 = ir1 + 1;
+    double theta1 = 0.0, theta2 = 0.0;
+
+    // Two neighbours along each ring, weighted by longitude.
+    auto alongRing = [&](int64_t ring, int64_t* p, double* w, double& ringTheta) {
+        int64_t start, count;
+        bool shifted;
+        ringInfo(ring, start, count, ringTheta, shifted);
+        const double dphi = TWO_PI / count;
+        const double tmp = phi / dphi - 0.5 * shifted;
+        int64_t i1 = tmp < 0.0 ? static_cast<int64_t>(tmp) - 1 : static_cast<int64_t>(tmp);
+        const double w1 = (phi - (i1 + 0.5 * shifted) * dphi) / dphi;
+        int64_t i2 = i1 + 1;
+        if (i1 < 0) i1 += count;
+        if (i2 >= count) i2 -= count;
+        p[0] = start + i1;
+        p[1] = start + i2;
+        w[0] = 1.0 - w1;
+        w[1] = w1;
+    };
+
+    if (ir1 > 0) {
+        alongRing(ir1, pix, weight, theta1);
+    }
+    if (ir2 < nl4) {
+        alongRing(ir2, pix + 2, weight + 2, theta2);
+    }
+
+    if (ir1 == 0) {
+        // North of the first ring: blend towards the four polar pixels.
+        const double wtheta = theta / theta2;
+        weight[2] *= wtheta;
+        weight[3] *= wtheta;
+        const double fac = (1.0 - wtheta) * 0.25;
+        weight[0] = fac;
+        weight[1] = fac;
+        weight[2] += fac;
+        weight[3] += fac;
+        pix[0] = (pix[2] + 2) & 3;
+        pix[1] = (pix[3] + 2) & 3;
+    } else if (ir2 == nl4) {
+        const double wtheta = (theta - theta1) / (PI - theta1);
+        weight[0] *= 1.0 - wtheta;
+        weight[1] *= 1.0 - wtheta;
+        const double fac = wtheta * 0.25;
+        weight[0] += fac;
+        weight[1] += fac;
+        weight[2] = fac;
+        weight[3] = fac;
+        pix[2] = ((pix[0] + 2) & 3) + m_npix - 4;
+        pix[3] = ((pix[1] + 2) & 3) + m_npix - 4;
+    } else {
+        const double wtheta = (theta - theta1) / (theta2 - theta1);
+        weight[0] *= 1.0 - wtheta;
+        weight[1] *= 1.0 - wtheta;
+        weight[2] *= wtheta;
+        weight[3] *= wtheta;
+    }
+
+    for (int k = 0; k < 4; ++k) {
+        pix[k] = ring2nest(pix[k]);
+    }
+}
+
+// ========== Scheme Conversion ==========
+
+int64_t HealpixGrid::ring2nest(int64_t ringPix) const {
+    const int64_t nside = m_nside;
+    const int64_t nl2 = 2 * nside;
+    int64_t iring, iphi, kshift, nr;
+    int face;
+
+    if (ringPix < m_ncap) {
+        iring = (1 + isqrt(1 + 2 * ringPix)) >> 1;
+        iphi = ringPix + 1 - 2 * iring * (iring - 1);
+        kshift = 0;
+        nr = iring;
+        face = static_cast<int>((iphi - 1) / nr);
+    } else if (ringPix < m_npix - m_ncap) {
+        const int64_t ip = ringPix - m_ncap;
+        const int64_t tmp = ip >> (m_order + 2);
+        iring = tmp + nside;
+        iphi = ip - tmp * 4 * nside + 1;
+        kshift = (iring + nside) & 1;
+        nr = nside;
+        const int64_t ire = tmp + 1;
+        const int64_t irm = nl2 + 1 - tmp;
+        const int64_t ifm = (iphi - (ire >> 1) + nside - 1) >> m_order;
+        const int64_t ifp = (iphi - (irm >> 1) + nside - 1) >> m_order;
+        face = static_cast<int>(ifp == ifm ? (ifp | 4) : (ifp < ifm ? ifp : ifm + 8));
+    } else {
+        const int64_t ip = m_npix - ringPix;
+        iring = (1 + isqrt(2 * ip - 1)) >> 1;
+        iphi = 4 * iring + 1 - (ip - 2 * iring * (iring - 1));
+        kshift = 0;
+        nr = iring;
+        iring = 2 * nl2 - iring;
+        face = static_cast<int>((iphi - 1) / nr) + 8;
+    }
+
+    const int64_t irt = iring - FACE_ROW[face] * nside + 1;
+    int64_t ipt = 2 * iphi - FACE_COL[face] * nr - kshift - 1;
+    if (ipt >= nl2) ipt -= 8 * nside;
+    return xyf2nest(static_cast<int>((ipt - irt) >> 1), static_cast<int>((-ipt - irt) >> 1), face);
+}
+
+// ========== Pixel to Angle ==========
+
+void HealpixGrid::pix2zphiNest(int64_t pix, double& z, double& phi) const {
+    int ix, iy, face;
+    nest2xyf(pix, ix, iy, face);
+
+    const int64_t nside = m_nside;
+    const int64_t nl4 = 4 * nside;
+    const double fact2 = 4.0 / m_npix;
+    const int64_t jr = FACE_ROW[face] * nside - ix - iy - 1;
+
+    int64_t nr, kshift;
+    if (jr < nside) {
+        nr = jr;
+        z = 1.0 - nr * nr * fact2;
+        kshift = 0;
+    } else if (jr > 3 * nside) {
+        nr = nl4 - jr;
+        z = nr * nr * fact2 - 1.0;
+        kshift = 0;
+    } else {
+        nr = nside;
+        z = (2 * nside - jr) * (2 * nside * fact2);
+        kshift = (jr - nside) & 1;
+    }
+
+    int64_t jp = (FACE_COL[face] * nr + ix - iy + 1 + kshift) / 2;
+    if (jp > nl4) jp -= nl4;
+    if (jp < 1) jp += nl4;
+
+    phi = (jp - (kshift + 1) * 0.5) * (HALF_PI / nr);
+    if (phi >= TWO_PI) phi -= TWO_PI;
+}
+
+void HealpixGrid::pix2angNest(int64_t pix, double& theta, double& phi) const {
+    double z;
+    pix2zphiNest(pix, z, phi);
+    theta = std::acos(std::max(-1.0, std::min(1.0, z)));
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ========== HEALPix Grid ==========
+// Pixel arithmetic for one HEALPix resolution (Gorski et al. 2005), in both
+// the NESTED and RING numbering schemes. theta is the colatitude and phi the
+// longitude, both in radians; z = cos(theta). NSIDE must be a power of two.
+
+class HealpixGrid {
+public:
+    static constexpr int MAX_ORDER = 13;  // NSIDE 8192
+
+    HealpixGrid();
+    explicit HealpixGrid(int nside);
+
+    bool isValid() const { return m_nside > 0; }
+    int getNside() const { return m_nside; }
+    int getOrder() const { return m_order; }
+    int64_t getNpix() const { return m_npix; }
+
+    static bool isValidNside(int nside);
+
+    int64_t ang2pixNest(double theta, double phi) const { return zphi2nest(std::cos(theta), phi); }
+    int64_t ang2pixRing(double theta, double phi) const { return zphi2ring(std::cos(theta), phi); }
+    int64_t zphi2nest(double z, double phi) const;
+    int64_t zphi2ring(double z, double phi) const;
+
+    // zphi2nest() for n directions. Both the polar-cap and equatorial
+    // branches are evaluated for every point and selected without jumps, so
+    // the loop has no data-dependent branches.
+    void zphi2nestBatch(const double* z, const double* phi, int64_t* pix, std::size_t n) const;
+
+    // The four pixels around a direction (two on the ring above, two on the
+    // ring below) and their bilinear weights, as HEALPix get_interpol().
+    // Pixel numbers are NESTED; the weights sum to 1.
+    void getInterpolation(double z, double phi, int64_t pix[4], double weight[4]) const;
+
+    int64_t ring2nest(int64_t ringPix) const;
+
+    // Pixel centre.
+    void pix2zphiNest(int64_t pix, double& z, double& phi) const;
+    void pix2angNest(int64_t pix, double& theta, double& phi) const;
+
+    int64_t xyf2nest(int ix, int iy, int face) const;
+    void nest2xyf(int64_t pix, int& ix, int& iy, int& face) const;
+
+    // Bit interleaving used by the NESTED scheme: x bits go to the even
+    // positions of the result, y bits to the odd ones. PDEP/PEXT when built
+    // with BMI2, shift-and-mask otherwise.
+    static uint64_t spreadBits(uint32_t v);
+    static uint32_t compressBits(uint64_t v);
+
+private:
+    // Index (1 .. 4 NSIDE - 1) of the ring at or north of z; 0 above the first.
+    int64_t ringAbove(double z) const;
+    void ringInfo(int64_t ring, int64_t& startPix, int64_t& ringPix, double& theta, bool& shifted) const;
+
+    int m_nside;
+    int m_order;
+    int64_t m_npface;
+    int64_t m_npix;
+    int64_t m_ncap;
+};
@@ -0,0 +1,274 @@
+#include "HorizonsTable.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+constexpr double DEG = M_PI / 180.0;
+constexpr int COLUMNS = 5;
+
+// WGS84 ellipsoid and the Earth's sidereal rotation rate.
+constexpr double EARTH_RADIUS_KM = 6378.137;
+constexpr double EARTH_FLATTENING = 1.0 / 298.257223563;
+constexpr double EARTH_ROTATION_RAD_S = 360.98564736629 * DEG / 86400.0;
+
+double column(const HorizonsTable::Row& row, int c) {
+    switch (c) {
+        case 0: return row.ra_deg;
+        case 1: return row.dec_deg;
+        case 2: return row.distance_km;
+        case 3: return row.libration_lon_deg;
+        default: return row.libration_lat_deg;
+    }
+}
+
+// Slope at row k of the parabola through k and its neighbours.
+double knotSlope(const std::vector<HorizonsTable::Row>& rows, std::size_t k, int c) {
+    const std::size_t n = rows.size();
+    if (c == 2) {
+        return rows[k].range_rate_km_s;
+    }
+    if (n == 2) {
+        return (column(rows[1], c) - column(rows[0], c)) / static_cast<double>(rows[1].time - rows[0].time);
+    }
+
+    const std::size_t i = k == 0 ? 1 : (k == n - 1 ? n - 2 : k);
+    const double h0 = static_cast<double>(rows[i].time - rows[i - 1].time);
+    const double h1 = static_cast<double>(rows[i + 1].time - rows[i].time);
+    const double d0 = (column(rows[i], c) - column(rows[i - 1], c)) / h0;
+    const double d1 = (column(rows[i + 1], c) - column(rows[i], c)) / h1;
+    if (k == 0) {
+        return d0 - (d1 - d0) * h0 / (h0 + h1);
+    }
+    if (k == n - 1) {
+        return d1 + (d1 - d0) * h1 / (h0 + h1);
+    }
+    return (d0 * h1 + d1 * h0) / (h0 + h1);
+}
+
+double wrap360(double deg) {
+    deg = std::fmod(deg, 360.0);
+    return deg < 0.0 ? deg + 360.0 : deg;
+}
+
+// Apparent sidereal time in radians: GMST as in GeometryCalculator plus
+// the equation of the equinoxes, since the rows are apparent places.
+double apparentSiderealTime(double time) {
+    // Days from J2000 taken directly from the Unix time to keep the
+    // sub-millisecond resolution a Julian day number would lose.
+    const double days = (time - 946728000.0) / 86400.0;
+    const double jd = 2451545.0 + days;
+    const double t = days / 36525.0;
+    const double gmst = 280.46061837 + 360.98564736629 * days
+                        + 0.000387933 * t * t - t * t * t / 38710000.0;
+
+    double dpsi, deps, eps0;
+    LunarEphemeris::nutation(jd + LunarEphemeris::deltaT(jd) / 86400.0, dpsi, deps, eps0);
+    return wrap360(gmst + dpsi * std::cos((eps0 + deps) * DEG)) * DEG;
+}
+
+} // namespace
+
+// ========== Rows ==========
+
+bool HorizonsTable::append(std::time_t time, const AstronomyAPIClient::MoonData& data) {
+    if (!data.valid || (!m_rows.empty() && time <= m_rows.back().time)) {
+        return false;
+    }
+
+    Row row;
+    row.time = time;
+    row.ra_deg = data.ra_deg;
+    if (!m_rows.empty()) {
+        row.ra_deg += 360.0 * std::round((m_rows.back().ra_deg - row.ra_deg) / 360.0);
+    }
+    row.dec_deg = data.dec_deg;
+    row.distance_km = data.distance_km;
+    row.range_rate_km_s = data.range_rate_km_s;
+    row.libration_lon_deg = std::remainder(data.libration_lon_deg, 360.0);
+    row.libration_lat_deg = data.libration_lat_deg;
+    m_rows.push_back(row);
+    return true;
+}
+
+bool HorizonsTable::covers(double time) const {
+    return !m_rows.empty() &&
+           time >= static_cast<double>(m_rows.front().time) &&
+           time <= static_cast<double>(m_rows.back().time);
+}
+
+// ========== Interpolation ==========
+
+bool HorizonsTable::sample(double time, Sample& out) const {
+    if (!covers(time)) {
+        return false;
+    }
+
+    if (m_rows.size() == 1) {
+        for (int c = 0; c < COLUMNS; ++c) {
+            out.value[c] = column(m_rows[0], c);
+            out.slope[c] = c == 2 ? m_rows[0].range_rate_km_s : 0.0;
+        }
+        return true;
+    }
+
+    auto next = std::upper_bound(m_rows.begin(), m_rows.end(), time,
+                                 [](double t, const Row& row) { return t < static_cast<double>(row.time); });
+    const std::size_t k = next == m_rows.end()
+        ? m_rows.size() - 2
+        : static_cast<std::size_t>(next - m_rows.begin()) - 1;
+    const Row& a = m_rows[k];
+    const Row& b = m_rows[k + 1];
+
+    const double h = static_cast<double>(b.time - a.time);
+    const double s = (time - static_cast<double>(a.time)) / h;
+    const double s2 = s * s, s3 = s2 * s;
+    const double h00 = 2.0 * s3 - 3.0 * s2 + 1.0, h10 = s3 - 2.0 * s2 + s;
+    const double h01 = -2.0 * s3 + 3.0 * s2, h11 = s3 - s2;
+    const double d00 = 6.0 * s2 - 6.0 * s, d10 = 3.0 * s2 - 4.0 * s + 1.0;
+    const double d01 = -d00, d11 = 3.0 * s2 - 2.0 * s;
+
+    for (int c = 0; c < COLUMNS; ++c) {
+        const double y0 = column(a, c), y1 = column(b, c);
+        const double m0 = knotSlope(m_rows, k, c), m1 = knotSlope(m_rows, k + 1, c);
+        out.value[c] = h00 * y0 + h10 * h * m0 + h01 * y1 + h11 * h * m1;
+        out.slope[c] = (d00 * y0 + d01 * y1) / h + d10 * m0 + d11 * m1;
+    }
+    return true;
+}
+
+bool HorizonsTable::interpolate(double time, AstronomyAPIClient::MoonData& geocentric) const {
+    Sample s;
+    if (!sample(time, s)) {
+        return false;
+    }
+    fill(s, geocentric);
+    return true;
+}
+
+void HorizonsTable::fill(const Sample& s, AstronomyAPIClient::MoonData& geocentric) {
+    geocentric.ra_deg = wrap360(s.value[0]);
+    geocentric.dec_deg = s.value[1];
+    geocentric.distance_km = s.value[2];
+    geocentric.range_rate_km_s = s.slope[2];
+    geocentric.libration_lon_deg = s.value[3];
+    geocentric.libration_lat_deg = s.value[4];
+    geocentric.libration_lon_rate_deg_day = s.slope[3] * 86400.0;
+    geocentric.libration_lat_rate_deg_day = s.slope[4] * 86400.0;
+    geocentric.azimuth_deg = 0.0;
+    geocentric.elevation_deg = 0.0;
+    geocentric.source = SOURCE_NAME;
+    geocentric.valid = true;
+}
+
+// ========== Site Values ==========
+
+bool HorizonsTable::topocentric(double time, double lat_deg, double lon_deg, double height_m,
+                                AstronomyAPIClient::MoonData& site) const {
+    Sample s;
+    if (!sample(time, s)) {
+        return false;
+    }
+    fill(s, site);
+
+    // Geocentric state in the equatorial frame of date.
+    const double ra = s.value[0] * DEG, dec = s.value[1] * DEG, d = s.value[2];
+    const double dra = s.slope[0] * DEG, ddec = s.slope[1] * DEG, dd = s.slope[2];
+    const double ca = std::cos(ra), sa = std::sin(ra), cd = std::cos(dec), sd = std::sin(dec);
+    const double r[3] = {d * cd * ca, d * cd * sa, d * sd};
+    const double v[3] = {
+        dd * cd * ca - d * (sd * ca * ddec + cd * sa * dra),
+        dd * cd * sa - d * (sd * sa * ddec - cd * ca * dra),
+        dd * sd + d * cd * ddec
+    };
+
+    // Site position and velocity from the WGS84 ellipsoid.
+    const double lat = lat_deg * DEG;
+    const double sinLat = std::sin(lat), cosLat = std::cos(lat);
+    const double e = 1.0 - EARTH_FLATTENING;
+    const double c = 1.0 / std::sqrt(cosLat * cosLat + e * e * sinLat * sinLat);
+    const double h = height_m / 1000.0;
+    const double rho = (EARTH_RADIUS_KM * c + h) * cosLat;
+    const double theta = apparentSiderealTime(time) + lon_deg * DEG;
+    const double p[3] = {rho * std::cos(theta), rho * std::sin(theta), (EARTH_RADIUS_KM * e * e * c + h) * sinLat};
+    const double pv[3] = {-EARTH_ROTATION_RAD_S * p[1], EARTH_ROTATION_RAD_S * p[0], 0.0};
+
+    const double t[3] = {r[0] - p[0], r[1] - p[1], r[2] - p[2]};
+    const double tv[3] = {v[0] - pv[0], v[1] - pv[1], v[2] - pv[2]};
+    const double range = std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+
+    const double topoRa = std::atan2(t[1], t[0]);
+    const double topoDec = std::asin(t[2] / range);
+    const double hourAngle = theta - topoRa;
+    const double cosDec = std::cos(topoDec), sinDec = std::sin(topoDec);
+
+    site.ra_deg = wrap360(topoRa / DEG);
+    site.dec_deg = topoDec / DEG;
+    site.distance_km = range;
+    site.range_rate_km_s = (t[0] * tv[0] + t[1] * tv[1] + t[2] * tv[2]) / range;
+    site.elevation_deg = std::asin(sinLat * sinDec + cosLat * cosDec * std::cos(hourAngle)) / DEG;
+    site.azimuth_deg = wrap360(std::atan2(-cosDec * std::sin(hourAngle),
+                                          sinDec * cosLat - cosDec * std::cos(hourAngle) * sinLat) / DEG);
+    return true;
+}
+
+// ========== Link Budget Positions ==========
+
+bool HorizonsTable::calculate(std::time_t utc, LunarPosition& position) const {
+    AstronomyAPIClient::MoonData data;
+    if (!interpolate(static_cast<double>(utc), data)) {
+        return false;
+    }
+
+    const double jd = LunarEphemeris::julianDay(utc);
+    double dpsi, deps, eps0;
+    LunarEphemeris::nutation(jd + LunarEphemeris::deltaT(jd) / 86400.0, dpsi, deps, eps0);
+    const double eps = (eps0 + deps) * DEG;
+
+    const double ra = data.ra_deg * DEG, dec = data.dec_deg * DEG;
+    position.rightAscension = ra;
+    position.declination = dec;
+    position.eclipticLongitude = std::atan2(std::sin(ra) * std::cos(eps) + std::tan(dec) * std::sin(eps),
+                                            std::cos(ra));
+    if (position.eclipticLongitude < 0.0) {
+        position.eclipticLongitude += 2.0 * M_PI;
+    }
+    position.eclipticLatitude = std::asin(std::sin(dec) * std::cos(eps) -
+                                          std::cos(dec) * std::sin(eps) * std::sin(ra));
+    position.distance_km = data.distance_km;
+    position.rangeRate_km_s = data.range_rate_km_s;
+    position.librationLon_deg = data.libration_lon_deg;
+    position.librationLat_deg = data.libration_lat_deg;
+    position.librationLonRate_deg_day = data.libration_lon_rate_deg_day;
+    position.librationLatRate_deg_day = data.libration_lat_rate_deg_day;
+    return true;
+}
+
+bool HorizonsTable::calculateSeries(std::time_t start, std::time_t step_s, std::size_t count,
+                                    LunarPositionBatch& out) const {
+    if (count > 0 && (!covers(static_cast<double>(start)) ||
+                      !covers(static_cast<double>(start + static_cast<std::time_t>(count - 1) * step_s)))) {
+        return false;
+    }
+
+    out.resize(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        LunarPosition p;
+        calculate(start + static_cast<std::time_t>(i) * step_s, p);
+        out.rightAscension[i] = p.rightAscension;
+        out.declination[i] = p.declination;
+        out.eclipticLongitude[i] = p.eclipticLongitude;
+        out.eclipticLatitude[i] = p.eclipticLatitude;
+        out.distance_km[i] = p.distance_km;
+        out.rangeRate_km_s[i] = p.rangeRate_km_s;
+        out.librationLon_deg[i] = p.librationLon_deg;
+        out.librationLat_deg[i] = p.librationLat_deg;
+        out.librationLonRate_deg_day[i] = p.librationLonRate_deg_day;
+        out.librationLatRate_deg_day[i] = p.librationLatRate_deg_day;
+    }
+    return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "AstronomyAPIClient.h"
+#include "LunarEphemeris.h"
+#include <cstddef>
+#include <ctime>
+#include <vector>
+
+// ========== Horizons Table ==========
+// Time-indexed geocentric moon rows from one Horizons range query (see
+// AstronomyAPIClient::fetchMoonRange). Lookups between rows use cubic
+// Hermite interpolation: the distance slope is the tabulated deldot, the
+// other columns take the slope of the parabola through neighbouring rows.
+// Site values are derived locally from the geocentric rows, so one query
+// serves any number of stations.
+
+class HorizonsTable {
+public:
+    struct Row {
+        std::time_t time;
+        double ra_deg;           // unwrapped, may leave [0, 360)
+        double dec_deg;
+        double distance_km;
+        double range_rate_km_s;
+        double libration_lon_deg;
+        double libration_lat_deg;
+    };
+
+    static constexpr const char* SOURCE_NAME = "JPL Horizons (interpolated)";
+
+    void clear() { m_rows.clear(); }
+    void reserve(std::size_t rows) { m_rows.reserve(rows); }
+
+    // Rows must arrive in increasing time order.
+    bool append(std::time_t time, const AstronomyAPIClient::MoonData& data);
+
+    std::size_t size() const { return m_rows.size(); }
+    bool empty() const { return m_rows.empty(); }
+    const std::vector<Row>& rows() const { return m_rows; }
+    std::time_t startTime() const { return m_rows.empty() ? 0 : m_rows.front().time; }
+    std::time_t endTime() const { return m_rows.empty() ? 0 : m_rows.back().time; }
+    bool covers(double time) const;
+
+    // Geocentric apparent place at any covered time; libration rates come
+    // from the interpolating polynomial.
+    bool interpolate(double time, AstronomyAPIClient::MoonData& geocentric) const;
+
+    // Topocentric place for a WGS84 site: parallax-corrected RA/Dec,
+    // azimuth (from north) and elevation, site distance and range rate
+    // including the site's rotation with the Earth.
+    bool topocentric(double time, double lat_deg, double lon_deg, double height_m,
+                     AstronomyAPIClient::MoonData& site) const;
+
+    bool calculate(std::time_t utc, LunarPosition& position) const;
+    // count UTC instants start, start + step_s, ...; false unless all covered.
+    bool calculateSeries(std::time_t start, std::time_t step_s, std::size_t count,
+                         LunarPositionBatch& out) const;
+
+private:
+    struct Sample {
+        double value[5];  // RA, Dec, distance, libration lon, lat
+        double slope[5];  // per second
+    };
+
+    std::vector<Row> m_rows;
+
+    bool sample(double time, Sample& out) const;
+    static void fill(const Sample& s, AstronomyAPIClient::MoonData& geocentric);
+};
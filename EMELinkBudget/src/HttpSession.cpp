@@ -0,0 +1,389 @@
+#include "HttpSession.h"
+#include "SimpleHttpClient.h"
+#include <curl/curl.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+static_assert(CURL_LOCK_DATA_LAST <= 8, "HttpSession::m_shareLocks too small");
+
+size_t writeBody(void* contents, size_t size, size_t nmemb, void* userp) {
+    static_cast<std::string*>(userp)->append(static_cast<char*>(contents), size * nmemb);
+    return size * nmemb;
+}
+
+void lockShare(CURL*, curl_lock_data data, curl_lock_access, void* locks) {
+    static_cast<std::mutex*>(locks)[data].lock();
+}
+
+void unlockShare(CURL*, curl_lock_data data, void* locks) {
+    static_cast<std::mutex*>(locks)[data].unlock();
+}
+
+void classify(HttpResult& result) {
+    result.ok = false;
+    if (result.statusCode != 200) {
+        result.errorMsg = "HTTP status code: " + std::to_string(result.statusCode);
+    } else if (result.body.empty()) {
+        result.errorMsg = "Empty response received";
+    } else {
+        result.errorMsg.clear();
+        result.ok = true;
+    }
+}
+
+} // namespace
+
+// ========== Transfer ==========
+
+struct HttpSession::Transfer {
+    CURL* easy = nullptr;
+    HttpResult* result = nullptr;
+    Clock::time_point startAt;
+    bool active = false;  // attached to the multi handle
+    bool done = false;
+};
+
+// ========== Construction ==========
+
+HttpSession::HttpSession()
+    : m_share(nullptr), m_timeout_s(30) {
+    static std::once_flag globalInit;
+    std::call_once(globalInit, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+
+    CURLSH* share = curl_share_init();
+    if (share) {
+        curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lockShare);
+        curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlockShare);
+        curl_share_setopt(share, CURLSHOPT_USERDATA, static_cast<void*>(m_shareLocks));
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+    m_share = share;
+}
+
+HttpSession::~HttpSession() {
+    for (void* multi : m_idleMultis) {
+        curl_multi_cleanup(static_cast<CURLM*>(multi));
+    }
+    if (m_share) {
+        curl_share_cleanup(static_cast<CURLSH*>(m_share));
+    }
+}
+
+HttpSession& HttpSession::shared() {
+    static HttpSession session;
+    return session;
+}
+
+// The most recently used handle, whose pool most likely still holds a
+// connection to the host just contacted.
+void* HttpSession::acquireMulti() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_idleMultis.empty()) {
+            void* multi = m_idleMultis.back();
+            m_idleMultis.pop_back();
+            return multi;
+        }
+    }
+    CURLM* multi = curl_multi_init();
+    if (multi) {
+        curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, 8L);
+        curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, 16L);
+    }
+    return multi;
+}
+
+void HttpSession::releaseMulti(void* multi) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_idleMultis.push_back(multi);
+}
+
+void HttpSession::setRetryPolicy(const HttpRetryPolicy& policy) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_retry = policy;
+    m_retry.maxAttempts = std::max(1, m_retry.maxAttempts);
+}
+
+void HttpSession::setTimeout(long seconds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_timeout_s = seconds;
+}
+
+HttpSessionStats HttpSession::getStats() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_stats;
+}
+
+void HttpSession::resetStats() {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats = HttpSessionStats();
+}
+
+// ========== Requests ==========
+
+HttpResult HttpSession::fetch(const std::string& url) {
+    std::vector<HttpResult> results;
+    run({url}, results, false);
+    return std::move(results.front());
+}
+
+std::vector<HttpResult> HttpSession::fetchAll(const std::vector<std::string>& urls) {
+    std::vector<HttpResult> results;
+    run(urls, results, false);
+    return results;
+}
+
+int HttpSession::fetchFirst(const std::vector<std::string>& urls, HttpResult& result) {
+    std::vector<HttpResult> results;
+    const int winner = run(urls, results, true);
+    if (winner >= 0) {
+        result = std::move(results[winner]);
+    } else if (!results.empty()) {
+        result = std::move(results.back());
+    } else {
+        result = HttpResult();
+        result.errorMsg = "No candidate URLs";
+    }
+    return winner;
+}
+
+bool HttpSession::shouldRetry(const HttpResult& result) const {
+    return !result.ok && !result.cancelled &&
+           (result.statusCode == 0 || result.statusCode == 429 || result.statusCode >= 500);
+}
+
+long HttpSession::backoff_ms(const HttpRetryPolicy& retry, int attempts) {
+    return static_cast<long>(retry.initialBackoff_ms * std::pow(retry.backoffFactor, attempts - 1));
+}
+
+// ========== Replacement Transport ==========
+
+int HttpSession::runTransport(const std::vector<std::string>& urls, std::vector<HttpResult>& results,
+                              bool firstOnly) {
+    const SimpleHttpClient::Transport transport = SimpleHttpClient::currentTransport();
+    HttpRetryPolicy retry;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        retry = m_retry;
+    }
+
+    int winner = -1;
+    for (size_t i = 0; i < urls.size(); ++i) {
+        HttpResult& r = results[i];
+        if (winner >= 0) {
+            r.cancelled = true;
+            r.errorMsg = "Cancelled";
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            ++m_stats.cancelled;
+            continue;
+        }
+
+        while (true) {
+            ++r.attempts;
+            {
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                ++m_stats.requests;
+            }
+            r.body.clear();
+            r.ok = transport(urls[i], r.body, r.statusCode, r.errorMsg);
+            if (r.ok || !shouldRetry(r) || r.attempts >= retry.maxAttempts) {
+                break;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                ++m_stats.retries;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(backoff_ms(retry, r.attempts)));
+        }
+
+        if (firstOnly && r.ok) {
+            winner = static_cast<int>(i);
+        }
+    }
+    return winner;
+}
+
+// ========== Multi Loop ==========
+
+int HttpSession::run(const std::vector<std::string>& urls, std::vector<HttpResult>& results, bool firstOnly) {
+    results.assign(urls.size(), HttpResult());
+    if (urls.empty()) {
+        return -1;
+    }
+    if (SimpleHttpClient::currentTransport()) {
+        return runTransport(urls, results, firstOnly);
+    }
+
+    HttpRetryPolicy retry;
+    long timeout_s;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        retry = m_retry;
+        timeout_s = m_timeout_s;
+    }
+
+    CURLM* multi = static_cast<CURLM*>(acquireMulti());
+    if (!multi) {
+        for (HttpResult& r : results) {
+            r.errorMsg = "curl_multi_init failed";
+        }
+        return -1;
+    }
+
+    std::vector<Transfer> transfers(urls.size());
+    size_t remaining = 0;
+    const Clock::time_point now = Clock::now();
+    for (size_t i = 0; i < urls.size(); ++i) {
+        Transfer& t = transfers[i];
+        t.result = &results[i];
+        t.startAt = now;
+        t.easy = curl_easy_init();
+        if (!t.easy) {
+            t.result->errorMsg = "curl_easy_init failed";
+            t.done = true;
+            continue;
+        }
+        ++remaining;
+
+        curl_easy_setopt(t.easy, CURLOPT_URL, urls[i].c_str());
+        curl_easy_setopt(t.easy, CURLOPT_USERAGENT, "Mutsumi Wakaba / 01.14");
+        curl_easy_setopt(t.easy, CURLOPT_TIMEOUT, timeout_s);
+        curl_easy_setopt(t.easy, CURLOPT_CONNECTTIMEOUT, 10L);
+        curl_easy_setopt(t.easy, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(t.easy, CURLOPT_ACCEPT_ENCODING, "");
+        curl_easy_setopt(t.easy, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(t.easy, CURLOPT_WRITEFUNCTION, writeBody);
+        curl_easy_setopt(t.easy, CURLOPT_WRITEDATA, &t.result->body);
+        curl_easy_setopt(t.easy, CURLOPT_PRIVATE, &t);
+        curl_easy_setopt(t.easy, CURLOPT_SSL_VERIFYPEER, 0L);
+        curl_easy_setopt(t.easy, CURLOPT_SSL_VERIFYHOST, 0L);
+        if (m_share) {
+            curl_easy_setopt(t.easy, CURLOPT_SHARE, static_cast<CURLSH*>(m_share));
+        }
+    }
+
+    auto finish = [&](Transfer& t) {
+        if (t.active) {
+            curl_multi_remove_handle(multi, t.easy);
+            t.active = false;
+        }
+        t.done = true;
+        --remaining;
+    };
+
+    int winner = -1;
+    while (remaining > 0) {
+        const Clock::time_point tick = Clock::now();
+        for (Transfer& t : transfers) {
+            if (!t.done && !t.active && tick >= t.startAt) {
+                t.result->body.clear();
+                ++t.result->attempts;
+                curl_multi_add_handle(multi, t.easy);
+                t.active = true;
+                std::lock_guard<std::mutex> statsLock(m_statsMutex);
+                ++m_stats.requests;
+            }
+        }
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+
+        int queued = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+            if (msg->msg != CURLMSG_DONE) {
+                continue;
+            }
+            Transfer* t = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&t));
+            HttpResult& r = *t->result;
+
+            long connects = 0;
+            curl_easy_getinfo(t->easy, CURLINFO_NUM_CONNECTS, &connects);
+            {
+                std::lock_guard<std::mutex> statsLock(m_statsMutex);
+                m_stats.newConnections += static_cast<size_t>(connects);
+            }
+
+            if (msg->data.result != CURLE_OK) {
+                r.ok = false;
+                r.statusCode = 0;
+                r.errorMsg = std::string("curl_easy_perform failed: ") + curl_easy_strerror(msg->data.result);
+            } else {
+                long httpCode = 0;
+                curl_easy_getinfo(t->easy, CURLINFO_RESPONSE_CODE, &httpCode);
+                r.statusCode = static_cast<int>(httpCode);
+                classify(r);
+            }
+
+            curl_multi_remove_handle(multi, t->easy);
+            t->active = false;
+            if (shouldRetry(r) && r.attempts < retry.maxAttempts) {
+                t->startAt = Clock::now() + std::chrono::milliseconds(backoff_ms(retry, r.attempts));
+                std::lock_guard<std::mutex> statsLock(m_statsMutex);
+                ++m_stats.retries;
+            } else {
+                finish(*t);
+            }
+        }
+
+        if (firstOnly && winner < 0) {
+            // Anything after the best success so far can no longer win; the
+            // best success wins once everything before it has failed.
+            size_t best = transfers.size();
+            for (size_t i = 0; i < transfers.size(); ++i) {
+                if (transfers[i].done && results[i].ok) {
+                    best = i;
+                    break;
+                }
+            }
+            bool decided = best < transfers.size();
+            for (size_t i = 0; i < best && decided; ++i) {
+                decided = transfers[i].done;
+            }
+            for (size_t i = 0; i < transfers.size(); ++i) {
+                Transfer& t = transfers[i];
+                if (!t.done && (i > best || decided)) {
+                    finish(t);
+                    results[i].cancelled = true;
+                    results[i].errorMsg = "Cancelled";
+                    std::lock_guard<std::mutex> statsLock(m_statsMutex);
+                    ++m_stats.cancelled;
+                }
+            }
+            if (decided) {
+                winner = static_cast<int>(best);
+            }
+        }
+
+        if (remaining == 0) {
+            break;
+        }
+
+        // Sleep until socket activity or the next scheduled retry.
+        long wait_ms = 1000;
+        const Clock::time_point after = Clock::now();
+        for (const Transfer& t : transfers) {
+            if (!t.done && !t.active) {
+                const long until = static_cast<long>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(t.startAt - after).count());
+                wait_ms = std::min(wait_ms, std::max(0L, until));
+            }
+        }
+        curl_multi_poll(multi, nullptr, 0, static_cast<int>(wait_ms), nullptr);
+    }
+
+    for (Transfer& t : transfers) {
+        if (t.easy) {
+            curl_easy_cleanup(t.easy);
+        }
+    }
+    releaseMulti(multi);
+    return winner;
+}
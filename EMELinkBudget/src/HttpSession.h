@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ========== HTTP Result ==========
+
+struct HttpResult {
+    std::string body;
+    int statusCode;
+    std::string errorMsg;
+    int attempts;
+    bool ok;        // non-empty 200 response
+    bool cancelled; // dropped by fetchFirst() once it could no longer win
+
+    HttpResult() : statusCode(0), attempts(0), ok(false), cancelled(false) {}
+};
+
+// ========== Retry Policy ==========
+// Transport errors, 429 and 5xx are retried; other statuses are final.
+
+struct HttpRetryPolicy {
+    int maxAttempts;
+    long initialBackoff_ms;
+    double backoffFactor;
+
+    HttpRetryPolicy() : maxAttempts(3), initialBackoff_ms(250), backoffFactor(2.0) {}
+};
+
+// ========== HTTP Session Statistics ==========
+
+struct HttpSessionStats {
+    std::size_t requests = 0;        // attempts sent, including retries
+    std::size_t retries = 0;
+    std::size_t cancelled = 0;
+    std::size_t newConnections = 0;  // the rest reused a pooled connection
+};
+
+// ========== HTTP Session ==========
+// Curl multi handles whose connection pools, together with a shared DNS
+// cache and TLS sessions, outlive individual requests, so repeated
+// downloads from the same host skip the TCP/TLS handshakes. The requests of
+// a batch run concurrently on one multi handle taken from a pool of idle
+// ones; batches from other threads take another handle and run alongside.
+//
+// When SimpleHttpClient has a replacement transport installed (e.g.
+// FileHttpTransport), requests go through it one after another instead,
+// with the same retry and candidate-selection rules.
+
+class HttpSession {
+public:
+    HttpSession();
+    ~HttpSession();
+
+    HttpSession(const HttpSession&) = delete;
+    HttpSession& operator=(const HttpSession&) = delete;
+
+    // Process-wide session used by SimpleHttpClient.
+    static HttpSession& shared();
+
+    void setRetryPolicy(const HttpRetryPolicy& policy);
+    void setTimeout(long seconds);
+
+    HttpResult fetch(const std::string& url);
+
+    // All URLs concurrently; results in input order.
+    std::vector<HttpResult> fetchAll(const std::vector<std::string>& urls);
+
+    // Candidates in order of preference, all requested at once. The winner
+    // is the first candidate that succeeds once every earlier one has
+    // failed; transfers that can no longer win are cancelled as soon as a
+    // preferred candidate succeeds. Returns the winner's index, or -1 with
+    // the last candidate's failure in `result`.
+    int fetchFirst(const std::vector<std::string>& urls, HttpResult& result);
+
+    HttpSessionStats getStats() const;
+    void resetStats();
+
+private:
+    struct Transfer;
+
+    std::mutex m_mutex;  // settings and the idle multi handles
+    std::vector<void*> m_idleMultis;  // CURLM, most recently used last
+    void* m_share;   // CURLSH: DNS cache and TLS sessions
+    std::mutex m_shareLocks[8];
+
+    HttpRetryPolicy m_retry;
+    long m_timeout_s;
+
+    mutable std::mutex m_statsMutex;
+    HttpSessionStats m_stats;
+
+    // firstOnly: stop at the first winner as described for fetchFirst().
+    int run(const std::vector<std::string>& urls, std::vector<HttpResult>& results, bool firstOnly);
+    int runTransport(const std::vector<std::string>& urls, std::vector<HttpResult>& results, bool firstOnly);
+
+    void* acquireMulti();
+    void releaseMulti(void* multi);
+
+    bool shouldRetry(const HttpResult& result) const;
+    static long backoff_ms(const HttpRetryPolicy& retry, int attempts);
+};
@@ -0,0 +1,156 @@
+#include "IGRFModel.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+
+// ========== Constructor ==========
+
+IGRFModel::IGRFModel() : GeomagneticModel(GeomagneticConstants::REFERENCE_RADIUS) {
+}
+
+// ========== Coefficient Loading ==========
+
+namespace {
+
+std::string_view nextToken(std::string_view& line) {
+    const std::size_t begin = line.find_first_not_of(" \t\r");
+    if (begin == std::string_view::npos) {
+        line = {};
+        return {};
+    }
+    std::size_t end = line.find_first_of(" \t\r", begin);
+    if (end == std::string_view::npos) {
+        end = line.size();
+    }
+    std::string_view token = line.substr(begin, end - begin);
+    line.remove_prefix(end);
+    return token;
+}
+
+template <typename T>
+bool parseToken(std::string_view token, T& value) {
+    auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+    return result.ec == std::errc() && result.ptr == token.data() + token.size();
+}
+
+struct IGRFRow {
+    bool isG;
+    int n;
+    int m;
+    std::vector<double> values;  // one per epoch, then secular variation
+};
+
+} // namespace
+
+bool IGRFModel::loadCoefficientFile(const std::string& filename) {
+    MappedFile file(filename);
+    return file.isOpen() && parseCoefficients(file.view());
+}
+
+bool IGRFModel::parseCoefficients(std::string_view text) {
+    std::vector<double> epochs;
+    std::vector<IGRFRow> rows;
+    int degree = 0;
+
+    while (!text.empty()) {
+        const std::size_t eol = text.find('\n');
+        std::string_view line = text.substr(0, eol);
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+
+        std::string_view first = nextToken(line);
+        if (first.empty() || first[0] == '#') {
+            continue;
+        }
+
+        // "g/h n m 1900.0 1905.0 ... 2025.0 2025-30": epochs, then the SV column.
+        if (first == "g/h") {
+            nextToken(line);
+            nextToken(line);
+            epochs.clear();
+            double epoch;
+            for (std::string_view token = nextToken(line); !token.empty(); token = nextToken(line)) {
+                if (parseToken(token, epoch)) {
+                    epochs.push_back(epoch);
+                }
+            }
+            continue;
+        }
+
+        if ((first != "g" && first != "h") || epochs.empty()) {
+            continue;
+        }
+
+        IGRFRow row;
+        row.isG = first == "g";
+        if (!parseToken(nextToken(line), row.n) || !parseToken(nextToken(line), row.m) ||
+            row.n < 1 || row.m < 0 || row.m > row.n || row.n > SphericalHarmonicEngine::MAX_SUPPORTED_DEGREE) {
+            continue;
+        }
+
+        double value;
+        for (std::string_view token = nextToken(line); !token.empty(); token = nextToken(line)) {
+            if (!parseToken(token, value)) {
+                break;
+            }
+            row.values.push_back(value);
+        }
+        if (row.values.size() != epochs.size() + 1) {
+            continue;
+        }
+
+        degree = std::max(degree, row.n);
+        rows.push_back(std::move(row));
+    }
+
+    if (rows.empty() || !std::is_sorted(epochs.begin(), epochs.end())) {
+        m_epochs.clear();
+        configure(0, "");
+        return false;
+    }
+
+    const std::size_t numEpochs = epochs.size();
+    const std::size_t terms = termCount(degree);
+    m_epochs = epochs;
+    m_g.assign(numEpochs * terms, 0.0);
+    m_h.assign(numEpochs * terms, 0.0);
+    m_dg.assign(numEpochs * terms, 0.0);
+    m_dh.assign(numEpochs * terms, 0.0);
+
+    for (const IGRFRow& row : rows) {
+        std::vector<double>& value = row.isG ? m_g : m_h;
+        std::vector<double>& rate = row.isG ? m_dg : m_dh;
+        const std::size_t idx = getIndex(row.n, row.m);
+        for (std::size_t e = 0; e < numEpochs; ++e) {
+            value[e * terms + idx] = row.values[e];
+            rate[e * terms + idx] = (e + 1 < numEpochs)
+                ? (row.values[e + 1] - row.values[e]) / (epochs[e + 1] - epochs[e])
+                : row.values[numEpochs];
+        }
+    }
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "IGRF %.0f-%.0f", epochs.front(), epochs.back());
+    configure(degree, name);
+    return isLoaded();
+}
+
+// ========== Epoch Interpolation ==========
+
+void IGRFModel::evolveCoefficients(double decimal_year, double* g, double* h) const {
+    const std::size_t terms = termCount(getMaxDegree());
+
+    // Last epoch at or before decimal_year; earlier years use the first epoch.
+    auto it = std::upper_bound(m_epochs.begin(), m_epochs.end(), decimal_year);
+    const std::size_t e = (it == m_epochs.begin()) ? 0 : static_cast<std::size_t>(it - m_epochs.begin()) - 1;
+    const double dt = std::max(0.0, decimal_year - m_epochs[e]);
+
+    const double* g0 = m_g.data() + e * terms;
+    const double* h0 = m_h.data() + e * terms;
+    const double* dg = m_dg.data() + e * terms;
+    const double* dh = m_dh.data() + e * terms;
+    for (std::size_t i = 0; i < terms; ++i) {
+        g[i] = g0[i] + dt * dg[i];
+        h[i] = h0[i] + dt * dh[i];
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "GeomagneticModel.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ========== IGRF Model ==========
+// International Geomagnetic Reference Field from the IAGA coefficient table
+// (igrf14coeffs.txt: one column per 5-year epoch plus a secular-variation
+// column). Every epoch is loaded once; the coefficients at a decimal year are
+// the linear blend of the two surrounding epochs, or the last epoch plus
+// secular variation beyond it. Years before the first epoch use the first.
+
+class IGRFModel : public GeomagneticModel {
+public:
+    IGRFModel();
+
+    bool loadCoefficientFile(const std::string& filename);
+    bool parseCoefficients(std::string_view text);
+
+    const std::vector<double>& getEpochs() const { return m_epochs; }
+
+protected:
+    void evolveCoefficients(double decimal_year, double* g, double* h) const override;
+
+private:
+    std::vector<double> m_epochs;
+
+    // Per epoch i: coefficients at m_epochs[i] and the rate of change
+    // until the next epoch (secular variation for the last one), each
+    // termCount(maxDegree) long and stored back to back.
+    std::vector<double> m_g;
+    std::vector<double> m_h;
+    std::vector<double> m_dg;
+    std::vector<double> m_dh;
+};
@@ -1,17 +1,131 @@
 #include "IonexReader.h"
-#include <sstream>
 #include <cmath>
+#include <cctype>
+#include <cstring>
+#include <charconv>
 #include <algorithm>
-#include <iomanip>
+
+namespace {
+
+// ========== Mapped Text Helpers ==========
+
+// Returns the next line (without terminator) and advances `offset` past it.
+bool nextLine(std::string_view text, std::size_t& offset, std::string_view& line) {
+    if (offset >= text.size()) {
+        return false;
+    }
+
+    const char* begin = text.data() + offset;
+    const void* nl = std::memchr(begin, '\n', text.size() - offset);
+    std::size_t length = nl ? static_cast<std::size_t>(static_cast<const char*>(nl) - begin)
+                            : text.size() - offset;
+
+    offset += length + (nl ? 1 : 0);
+    if (length > 0 && begin[length - 1] == '\r') {
+        --length;
+    }
+    line = std::string_view(begin, length);
+    return true;
+}
+
+// IONEX labels start in column 61; data records only have digits, signs or
+// blanks there, which keeps the check cheap for the bulk of the file.
+bool hasLabel(std::string_view line, std::string_view label) {
+    if (line.size() <= 60) {
+        return false;
+    }
+    const char first = line[60];
+    if (first != '#' && !std::isalpha(static_cast<unsigned char>(first))) {
+        return false;
+    }
+    return line.substr(60, label.size()) == label;
+}
+
+// Parses up to `count` numbers from the 60-column data part. Numbers may be
+// packed without separating blanks (e.g. "87.5-180.0 180.0").
+int parseNumbers(std::string_view line, double* out, int count) {
+    const char* p = line.data();
+    const char* end = p + std::min<std::size_t>(line.size(), 60);
+    int parsed = 0;
+
+    while (parsed < count) {
+        while (p < end && *p == ' ') ++p;
+        if (p >= end) break;
+
+        auto result = std::from_chars(p, end, out[parsed]);
+        if (result.ec != std::errc()) break;
+        p = result.ptr;
+        ++parsed;
+    }
+    return parsed;
+}
+
+bool parseEpoch(std::string_view line, std::tm& epoch) {
+    double fields[6];
+    if (parseNumbers(line, fields, 6) != 6) {
+        return false;
+    }
+
+    epoch = {};
+    epoch.tm_year = static_cast<int>(fields[0]) - 1900;
+    epoch.tm_mon = static_cast<int>(fields[1]) - 1;
+    epoch.tm_mday = static_cast<int>(fields[2]);
+    epoch.tm_hour = static_cast<int>(fields[3]);
+    epoch.tm_min = static_cast<int>(fields[4]);
+    epoch.tm_sec = static_cast<int>(fields[5]);
+    return true;
+}
+
+// Fixed-width I5 field; returns false for a blank field.
+bool parseI5(const char* field, int& value) {
+    const char* p = field;
+    const char* end = field + 5;
+
+    while (p < end && *p == ' ') ++p;
+    if (p == end) {
+        return false;
+    }
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    int v = 0;
+    bool digits = false;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + (*p - '0');
+        digits = true;
+        ++p;
+    }
+
+    value = negative ? -v : v;
+    return digits;
+}
+
+struct MapLabels {
+    IonexMapType type;
+    std::string_view start;
+    std::string_view end;
+};
+
+constexpr MapLabels MAP_LABELS[IONEX_MAP_TYPE_COUNT] = {
+    {IonexMapType::TEC, "START OF TEC MAP", "END OF TEC MAP"},
+    {IonexMapType::RMS, "START OF RMS MAP", "END OF RMS MAP"},
+    {IonexMapType::HEIGHT, "START OF HEIGHT MAP", "END OF HEIGHT MAP"},
+};
+
+} // namespace
 
 // ========== Constructors ==========
 
 IonexReader::IonexReader()
-    : m_filename(""), m_isOpen(false), m_header() {
+    : m_filename(""), m_isOpen(false), m_header(), m_preloaded(false) {
 }
 
 IonexReader::IonexReader(const std::string& filename)
-    : m_filename(filename), m_isOpen(false), m_header() {
+    : m_filename(filename), m_isOpen(false), m_header(), m_preloaded(false) {
     open(filename);
 }
 
@@ -20,18 +134,27 @@ IonexReader::IonexReader(const std::string& filename)
 bool IonexReader::open(const std::string& filename) {
     m_filename = filename;
     m_isOpen = false;
-    m_mapPositions.clear();
+    m_preloaded = false;
+    m_header = IonexHeader();
+    m_cache.clear();
+    for (int i = 0; i < IONEX_MAP_TYPE_COUNT; ++i) {
+        m_mapPositions[i].clear();
+        m_cubes[i] = TecCube();
+    }
 
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    if (!m_file.open(filename)) {
         return false;
     }
 
-    if (!parseHeader(file)) {
+    // Header and map index are built in a single pass over the mapping.
+    std::size_t offset = 0;
+    if (!parseHeader(offset)) {
+        m_file.close();
         return false;
     }
 
-    if (!buildMapIndex(file)) {
+    if (!buildMapIndex(offset)) {
+        m_file.close();
         return false;
     }
 
@@ -41,167 +164,163 @@ bool IonexReader::open(const std::string& filename) {
 
 // ========== Header Parsing ==========
 
-bool IonexReader::parseHeader(std::ifstream& file) {
-    std::string line;
-    bool foundEnd = false;
-
-    while (std::getline(file, line)) {
-        if (line.length() < 60) continue;
+bool IonexReader::parseHeader(std::size_t& offset) {
+    const std::string_view text = m_file.view();
+    std::string_view line;
+    double v[3];
 
-        std::string label = line.substr(60);
-
-        if (label.find("IONEX VERSION / TYPE") != std::string::npos) {
-            std::istringstream iss(line.substr(0, 60));
-            iss >> m_header.version;
+    while (nextLine(text, offset, line)) {
+        if (hasLabel(line, "IONEX VERSION / TYPE")) {
+            if (parseNumbers(line, v, 1) == 1) m_header.version = v[0];
         }
-        else if (label.find("EPOCH OF FIRST MAP") != std::string::npos) {
-            std::istringstream iss(line.substr(0, 60));
-            iss >> m_header.epochFirst.tm_year >> m_header.epochFirst.tm_mon
-                >> m_header.epochFirst.tm_mday >> m_header.epochFirst.tm_hour
-                >> m_header.epochFirst.tm_min >> m_header.epochFirst.tm_sec;
-            m_header.epochFirst.tm_year -= 1900;
-            m_header.epochFirst.tm_mon -= 1;
+        else if (hasLabel(line, "EPOCH OF FIRST MAP")) {
+            parseEpoch(line, m_header.epochFirst);
         }
-        else if (label.find("EPOCH OF LAST MAP") != std::string::npos) {
-            std::istringstream iss(line.substr(0, 60));
-            iss >> m_header.epochLast.tm_year >> m_header.epochLast.tm_mon
-                >> m_header.epochLast.tm_mday >> m_header.epochLast.tm_hour
-                >> m_header.epochLast.tm_min >> m_header.epochLast.tm_sec;
-            m_header.epochLast.tm_year -= 1900;
-            m_header.epochLast.tm_mon -= 1;
+        else if (hasLabel(line, "EPOCH OF LAST MAP")) {
+            parseEpoch(line, m_header.epochLast);
         }
-        else if (label.find("INTERVAL") != std::string::npos) {
-            std::istringstream iss(line.substr(0, 60));
-            iss >> m_header.interval;
+        else if (hasLabel(line, "INTERVAL")) {
+            if (parseNumbers(line, v, 1) == 1) m_header.interval = static_cast<int>(v[0]);
         }
-        else if (label.find("# OF MAPS IN FILE") != std::string::npos) {
-            std::istringstream iss(line.substr(0, 60));
-            iss >> m_header.numMaps;
+        else if (hasLabel(line, "# OF MAPS IN FILE")) {
+            if (parseNumbers(line, v, 1) == 1) m_header.numMaps = static_cast<int>(v[0]);
         }
-        else if (label.find("BASE RADIUS") != std::string::npos) {
-            std::istringstream iss(line.substr(0, 60));
-            iss >> m_header.baseRadius;
+        else if (hasLabel(line, "BASE RADIUS")) {
+            if (parseNumbers(line, v, 1) == 1) m_header.baseRadius = v[0];
         }
-        else if (label.find("HGT1 / HGT2 / DHGT") != std::string::npos) {
-            std::istringstream iss(line.substr(0, 60));
-            iss >> m_header.hgt1 >> m_header.hgt2 >> m_header.dhgt;
+        else if (hasLabel(line, "HGT1 / HGT2 / DHGT")) {
+            if (parseNumbers(line, v, 3) == 3) {
+                m_header.hgt1 = v[0];
+                m_header.hgt2 = v[1];
+                m_header.dhgt = v[2];
+                m_header.numHgt = m_header.dhgt != 0.0
+                    ? static_cast<int>(std::round((m_header.hgt2 - m_header.hgt1) / m_header.dhgt)) + 1
+                    : 1;
+            }
         }
-        else if (label.find("LAT1 / LAT2 / DLAT") != std::string::npos) {
-            std::istringstream iss(line.substr(0, 60));
-            iss >> m_header.lat1 >> m_header.lat2 >> m_header.dlat;
-            m_header.numLat = static_cast<int>((m_header.lat1 - m_header.lat2) / (-m_header.dlat)) + 1;
+        else if (hasLabel(line, "LAT1 / LAT2 / DLAT")) {
+            if (parseNumbers(line, v, 3) == 3) {
+                m_header.lat1 = v[0];
+                m_header.lat2 = v[1];
+                m_header.dlat = v[2];
+                m_header.numLat = static_cast<int>((m_header.lat1 - m_header.lat2) / (-m_header.dlat)) + 1;
+            }
         }
-        else if (label.find("LON1 / LON2 / DLON") != std::string::npos) {
-            std::istringstream iss(line.substr(0, 60));
-            iss >> m_header.lon1 >> m_header.lon2 >> m_header.dlon;
-            m_header.numLon = static_cast<int>((m_header.lon2 - m_header.lon1) / m_header.dlon) + 1;
+        else if (hasLabel(line, "LON1 / LON2 / DLON")) {
+            if (parseNumbers(line, v, 3) == 3) {
+                m_header.lon1 = v[0];
+                m_header.lon2 = v[1];
+                m_header.dlon = v[2];
+                m_header.numLon = static_cast<int>((m_header.lon2 - m_header.lon1) / m_header.dlon) + 1;
+            }
         }
-        else if (label.find("EXPONENT") != std::string::npos) {
-            std::istringstream iss(line.substr(0, 60));
-            iss >> m_header.exponent;
+        else if (hasLabel(line, "EXPONENT")) {
+            if (parseNumbers(line, v, 1) == 1) m_header.exponent = static_cast<int>(v[0]);
         }
-        else if (label.find("END OF HEADER") != std::string::npos) {
-            foundEnd = true;
-            break;
+        else if (hasLabel(line, "END OF HEADER")) {
+            return true;
         }
     }
 
-    return foundEnd;
+    return false;
 }
 
 // ========== Map Index Building ==========
 
-bool IonexReader::buildMapIndex(std::ifstream& file) {
-    std::string line;
-    std::streamoff currentPos = file.tellg();
-
-    while (std::getline(file, line)) {
-        if (line.find("START OF TEC MAP") != std::string::npos) {
-            std::streamoff mapStartPos = currentPos;
-
-            if (std::getline(file, line) && line.find("EPOCH OF CURRENT MAP") != std::string::npos) {
-                std::tm epoch = {};
-                std::istringstream iss(line.substr(0, 60));
-                iss >> epoch.tm_year >> epoch.tm_mon >> epoch.tm_mday
-                    >> epoch.tm_hour >> epoch.tm_min >> epoch.tm_sec;
-                epoch.tm_year -= 1900;
-                epoch.tm_mon -= 1;
-                epoch.tm_isdst = -1;
-
-                std::time_t t = std::mktime(&epoch);
-                m_mapPositions[t] = static_cast<long>(mapStartPos);
+bool IonexReader::buildMapIndex(std::size_t offset) {
+    const std::string_view text = m_file.view();
+    std::string_view line;
+
+    std::size_t lineStart = offset;
+    while (nextLine(text, offset, line)) {
+        for (const MapLabels& labels : MAP_LABELS) {
+            if (!hasLabel(line, labels.start)) {
+                continue;
+            }
+
+            std::size_t mapStartPos = lineStart;
+            std::tm epoch = {};
+            if (nextLine(text, offset, line) &&
+                hasLabel(line, "EPOCH OF CURRENT MAP") &&
+                parseEpoch(line, epoch)) {
+                m_mapPositions[static_cast<int>(labels.type)][tmToTime(epoch)] = mapStartPos;
             }
+            break;
         }
-        currentPos = file.tellg();
+        lineStart = offset;
     }
 
-    return !m_mapPositions.empty();
+    return hasMaps(IonexMapType::TEC);
 }
 
-// ========== TEC Map Loading ==========
+// ========== Map Loading ==========
 
-bool IonexReader::loadTecMap(std::ifstream& file, long position, TecMap& tecMap) {
-    file.clear();
-    file.seekg(position);
+bool IonexReader::loadTecMap(IonexMapType type, std::size_t position, TecMap& tecMap) const {
+    const MapLabels& labels = MAP_LABELS[static_cast<int>(type)];
+    const std::string_view text = m_file.view();
+    std::size_t offset = position;
+    std::string_view line;
 
-    std::string line;
-    if (!std::getline(file, line) || line.find("START OF TEC MAP") == std::string::npos) {
+    if (!nextLine(text, offset, line) || !hasLabel(line, labels.start)) {
         return false;
     }
 
-    if (!std::getline(file, line) || line.find("EPOCH OF CURRENT MAP") == std::string::npos) {
+    if (!nextLine(text, offset, line) || !hasLabel(line, "EPOCH OF CURRENT MAP")) {
         return false;
     }
+    parseEpoch(line, tecMap.epoch);
 
-    std::istringstream iss(line.substr(0, 60));
-    iss >> tecMap.epoch.tm_year >> tecMap.epoch.tm_mon >> tecMap.epoch.tm_mday
-        >> tecMap.epoch.tm_hour >> tecMap.epoch.tm_min >> tecMap.epoch.tm_sec;
-    tecMap.epoch.tm_year -= 1900;
-    tecMap.epoch.tm_mon -= 1;
-
-    tecMap.data.resize(m_header.numLat);
-    for (int i = 0; i < m_header.numLat; ++i) {
-        tecMap.data[i].resize(m_header.numLon, 9999.0);
-    }
+    tecMap.type = type;
+    tecMap.resize(m_header.numHgt, m_header.numLat, m_header.numLon);
+    double scale = std::pow(10.0, m_header.exponent);
 
-    int currentLatIdx = 0;
+    float* row = nullptr;
+    int lonIdx = 0;
 
-    while (std::getline(file, line)) {
-        if (line.find("END OF TEC MAP") != std::string::npos) {
+    while (nextLine(text, offset, line)) {
+        if (hasLabel(line, labels.end)) {
             break;
         }
 
-        if (line.find("LAT/LON1/LON2/DLON/H") != std::string::npos) {
-            double lat;
-            std::istringstream latIss(line.substr(0, 60));
-            latIss >> lat;
-            currentLatIdx = latToIndex(lat);
-
-            if (currentLatIdx < 0 || currentLatIdx >= m_header.numLat) {
+        if (hasLabel(line, "LAT/LON1/LON2/DLON/H")) {
+            // LAT, LON1, LON2, DLON, H
+            double rec[5];
+            row = nullptr;
+            lonIdx = 0;
+            if (parseNumbers(line, rec, 5) != 5) {
                 continue;
             }
 
-            int lonIdx = 0;
-            while (lonIdx < m_header.numLon && std::getline(file, line)) {
-                if (line.find("LAT/LON1/LON2/DLON/H") != std::string::npos ||
-                    line.find("END OF TEC MAP") != std::string::npos) {
-                    file.seekg(-static_cast<long>(line.length()) - 1, std::ios::cur);
-                    break;
-                }
+            int latIdx = latToIndex(rec[0]);
+            int layer = m_header.dhgt != 0.0
+                ? static_cast<int>(std::round((rec[4] - m_header.hgt1) / m_header.dhgt))
+                : 0;
+            if (latIdx >= 0 && latIdx < m_header.numLat && layer >= 0 && layer < m_header.numHgt) {
+                row = &tecMap.at(layer, latIdx, 0);
+            }
+            continue;
+        }
+
+        // A map may override the header exponent for its own values.
+        if (hasLabel(line, "EXPONENT")) {
+            double e;
+            if (parseNumbers(line, &e, 1) == 1) {
+                scale = std::pow(10.0, e);
+            }
+            continue;
+        }
 
-                for (size_t pos = 0; pos < line.length() && lonIdx < m_header.numLon; pos += 5) {
-                    if (pos + 5 <= line.length()) {
-                        std::string valueStr = line.substr(pos, 5);
-                        int value;
-                        std::istringstream valueIss(valueStr);
-                        if (valueIss >> value) {
-                            if (value != 9999) {
-                                tecMap.data[currentLatIdx][lonIdx] = value * std::pow(10.0, m_header.exponent);
-                            }
-                            lonIdx++;
-                        }
-                    }
+        if (!row) {
+            continue;
+        }
+
+        for (std::size_t pos = 0; pos + 5 <= line.size() && lonIdx < m_header.numLon; pos += 5) {
+            int value;
+            if (parseI5(line.data() + pos, value)) {
+                if (value != 9999) {
+                    row[lonIdx] = static_cast<float>(value * scale);
                 }
+                ++lonIdx;
             }
         }
     }
@@ -212,24 +331,22 @@ bool IonexReader::loadTecMap(std::ifstream& file, long position, TecMap& tecMap)
 // ========== TEC Value Retrieval ==========
 
 bool IonexReader::getTecValue(const std::tm& time, double lat, double lon, double& vtec) {
-    if (!m_isOpen) {
-        return false;
-    }
+    return getValue(IonexMapType::TEC, time, lat, lon, vtec);
+}
 
-    std::time_t targetTime = tmToTime(time);
+bool IonexReader::getTecValueInterpolated(const std::tm& time, double lat, double lon, double& vtec) {
+    return getValueInterpolated(IonexMapType::TEC, time, lat, lon, vtec);
+}
 
-    auto it = m_mapPositions.find(targetTime);
-    if (it == m_mapPositions.end()) {
-        return false;
-    }
+bool IonexReader::getRmsValueInterpolated(const std::tm& time, double lat, double lon, double& rms) {
+    return getValueInterpolated(IonexMapType::RMS, time, lat, lon, rms);
+}
 
-    std::ifstream file(m_filename);
-    if (!file.is_open()) {
-        return false;
-    }
+// ========== Generic Map Access ==========
 
-    TecMap tecMap;
-    if (!loadTecMap(file, it->second, tecMap)) {
+bool IonexReader::getValue(IonexMapType type, const std::tm& time, double lat, double lon,
+                           double& value, int layer) {
+    if (!m_isOpen || layer < 0 || layer >= m_header.numHgt) {
         return false;
     }
 
@@ -241,59 +358,148 @@ bool IonexReader::getTecValue(const std::tm& time, double lat, double lon, doubl
         return false;
     }
 
-    vtec = tecMap.data[latIdx][lonIdx];
-    return vtec != 9999.0;
-}
-
-// ========== Interpolated TEC Value ==========
+    if (m_preloaded) {
+        const TecCube& cube = getCube(type);
+        const std::time_t epoch = TecCube::toUtc(time);
+        auto it = std::lower_bound(cube.epochs.begin(), cube.epochs.end(), epoch);
+        if (it == cube.epochs.end() || *it != epoch) {
+            return false;
+        }
+        value = cube.at(static_cast<std::size_t>(it - cube.epochs.begin()), layer, latIdx, lonIdx);
+        return value != TecCube::MISSING;
+    }
 
-bool IonexReader::getTecValueInterpolated(const std::tm& time, double lat, double lon, double& vtec) {
-    if (!m_isOpen) {
+    std::shared_ptr<const TecMap> tecMap = getMap(type, tmToTime(time));
+    if (!tecMap) {
         return false;
     }
 
-    std::time_t targetTime = tmToTime(time);
-    std::time_t t1, t2;
+    value = tecMap->at(layer, latIdx, lonIdx);
+    return value != TecMap::MISSING;
+}
 
-    if (!findClosestMaps(time, t1, t2)) {
+bool IonexReader::getValueInterpolated(IonexMapType type, const std::tm& time, double lat, double lon,
+                                       double& value, int layer) {
+    if (!m_isOpen || layer < 0 || layer >= m_header.numHgt) {
         return false;
     }
 
-    std::ifstream file(m_filename);
-    if (!file.is_open()) {
+    if (m_preloaded) {
+        return getCube(type).interpolate(TecCube::toUtc(time), lat, lon, value, layer);
+    }
+
+    std::time_t targetTime = tmToTime(time);
+    std::time_t t1, t2;
+
+    if (!findClosestMaps(type, time, t1, t2)) {
         return false;
     }
 
-    TecMap map1, map2;
-    if (!loadTecMap(file, m_mapPositions[t1], map1)) {
+    std::shared_ptr<const TecMap> map1 = getMap(type, t1);
+    if (!map1) {
         return false;
     }
 
-    double vtec1 = bilinearInterpolate(map1.data, lat, lon);
-    if (vtec1 == 9999.0) {
+    double value1 = bilinearInterpolate(*map1, lat, lon, layer);
+    if (value1 == TecMap::MISSING) {
         return false;
     }
 
     if (t1 == t2) {
-        vtec = vtec1;
+        value = value1;
         return true;
     }
 
-    if (!loadTecMap(file, m_mapPositions[t2], map2)) {
+    std::shared_ptr<const TecMap> map2 = getMap(type, t2);
+    if (!map2) {
         return false;
     }
 
-    double vtec2 = bilinearInterpolate(map2.data, lat, lon);
-    if (vtec2 == 9999.0) {
+    double value2 = bilinearInterpolate(*map2, lat, lon, layer);
+    if (value2 == TecMap::MISSING) {
         return false;
     }
 
     double ratio = static_cast<double>(targetTime - t1) / static_cast<double>(t2 - t1);
-    vtec = vtec1 + ratio * (vtec2 - vtec1);
+    value = value1 + ratio * (value2 - value1);
 
     return true;
 }
 
+// ========== Decoded Map Cache ==========
+
+void IonexReader::setCacheBudget(std::size_t memoryBudget_bytes, std::size_t maxEntries) {
+    m_cache.setMemoryBudget(memoryBudget_bytes);
+    m_cache.setMaxEntries(maxEntries);
+}
+
+std::shared_ptr<const TecMap> IonexReader::getMap(IonexMapType type, std::time_t epoch) {
+    const TecMapKey key{type, epoch};
+    std::shared_ptr<const TecMap> cached = m_cache.find(key);
+    if (cached) {
+        return cached;
+    }
+
+    const std::map<std::time_t, std::size_t>& index = positions(type);
+    auto it = index.find(epoch);
+    if (it == index.end()) {
+        return nullptr;
+    }
+
+    TecMap tecMap;
+    if (!loadTecMap(type, it->second, tecMap)) {
+        return nullptr;
+    }
+
+    return m_cache.insert(key, std::move(tecMap));
+}
+
+// ========== Preload Mode ==========
+
+bool IonexReader::preloadAll() {
+    if (!m_isOpen) {
+        return false;
+    }
+
+    TecCube cubes[IONEX_MAP_TYPE_COUNT];
+    TecMap tecMap;
+
+    for (int i = 0; i < IONEX_MAP_TYPE_COUNT; ++i) {
+        const IonexMapType type = static_cast<IonexMapType>(i);
+        TecCube& cube = cubes[i];
+        cube.type = type;
+        cube.numHgt = m_header.numHgt;
+        cube.numLat = m_header.numLat;
+        cube.numLon = m_header.numLon;
+        cube.lat1 = m_header.lat1;
+        cube.dlat = m_header.dlat;
+        cube.lon1 = m_header.lon1;
+        cube.dlon = m_header.dlon;
+        cube.epochs.reserve(m_mapPositions[i].size());
+        cube.data.reserve(m_mapPositions[i].size() * cube.mapSize());
+
+        for (const auto& entry : m_mapPositions[i]) {
+            if (!loadTecMap(type, entry.second, tecMap)) {
+                return false;
+            }
+            cube.epochs.push_back(TecCube::toUtc(tecMap.epoch));
+            cube.data.insert(cube.data.end(), tecMap.data.begin(), tecMap.data.end());
+        }
+
+        if (!std::is_sorted(cube.epochs.begin(), cube.epochs.end())) {
+            return false;
+        }
+        cube.updateTimeIndex();
+    }
+
+    for (int i = 0; i < IONEX_MAP_TYPE_COUNT; ++i) {
+        m_cubes[i] = std::move(cubes[i]);
+    }
+    m_preloaded = true;
+    m_cache.clear();
+    return true;
+}
+
 // ========== Helper Functions ==========
 
 std::time_t IonexReader::tmToTime(const std::tm& tm) const {
@@ -302,14 +508,16 @@ std::time_t IonexReader::tmToTime(const std::tm& tm) const {
     return std::mktime(&temp);
 }
 
-bool IonexReader::findClosestMaps(const std::tm& time, std::time_t& t1, std::time_t& t2) {
+bool IonexReader::findClosestMaps(IonexMapType type, const std::tm& time,
+                                  std::time_t& t1, std::time_t& t2) const {
+    const std::map<std::time_t, std::size_t>& index = positions(type);
     std::time_t targetTime = tmToTime(time);
 
-    auto it = m_mapPositions.lower_bound(targetTime);
+    auto it = index.lower_bound(targetTime);
 
-    if (it == m_mapPositions.end()) {
-        if (m_mapPositions.empty()) return false;
-        auto last = m_mapPositions.rbegin();
+    if (it == index.end()) {
+        if (index.empty()) return false;
+        auto last = index.rbegin();
         t1 = t2 = last->first;
         return true;
     }
@@ -319,7 +527,7 @@ bool IonexReader::findClosestMaps(const std::tm& time, std::time_t& t1, std::tim
         return true;
     }
 
-    if (it == m_mapPositions.begin()) {
+    if (it == index.begin()) {
         t1 = t2 = it->first;
         return true;
     }
@@ -330,8 +538,7 @@ bool IonexReader::findClosestMaps(const std::tm& time, std::time_t& t1, std::tim
     return true;
 }
 
-double IonexReader::bilinearInterpolate(const std::vector<std::vector<double>>& data,
-                                        double lat, double lon) {
+double IonexReader::bilinearInterpolate(const TecMap& map, double lat, double lon, int layer) const {
     double latNorm = (lat - m_header.lat1) / m_header.dlat;
     double lonNorm = (lon - m_header.lon1) / m_header.dlon;
 
@@ -345,15 +552,21 @@ double IonexReader::bilinearInterpolate(const std::vector<std::vector<double>>&
     lon1Idx = std::max(0, std::min(lon1Idx, m_header.numLon - 1));
     lon2Idx = std::max(0, std::min(lon2Idx, m_header.numLon - 1));
 
-    double v11 = data[lat1Idx][lon1Idx];
-    double v12 = data[lat1Idx][lon2Idx];
-    double v21 = data[lat2Idx][lon1Idx];
-    double v22 = data[lat2Idx][lon2Idx];
+    float f11 = map.at(layer, lat1Idx, lon1Idx);
+    float f12 = map.at(layer, lat1Idx, lon2Idx);
+    float f21 = map.at(layer, lat2Idx, lon1Idx);
+    float f22 = map.at(layer, lat2Idx, lon2Idx);
 
-    if (v11 == 9999.0 || v12 == 9999.0 || v21 == 9999.0 || v22 == 9999.0) {
-        return 9999.0;
+    if (f11 == TecMap::MISSING || f12 == TecMap::MISSING ||
+        f21 == TecMap::MISSING || f22 == TecMap::MISSING) {
+        return TecMap::MISSING;
     }
 
+    double v11 = f11;
+    double v12 = f12;
+    double v21 = f21;
+    double v22 = f22;
+
     double latFrac = latNorm - lat1Idx;
     double lonFrac = lonNorm - lon1Idx;
 
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "TecMapCache.h"
+#include "MappedFile.h"
+#include "TecCube.h"
 #include <string>
 #include <vector>
 #include <map>
-#include <fstream>
+#include <memory>
 #include <ctime>
 
 // ========== IONEX Data Structures ==========
@@ -24,15 +27,11 @@ struct IonexHeader {
     double lon1 = 0.0, lon2 = 0.0, dlon = 0.0;
     int exponent = 0;
 
+    int numHgt = 1;
     int numLat = 0;
     int numLon = 0;
 };
 
-struct TecMap {
-    std::tm epoch = {};
-    std::vector<std::vector<double>> data;
-};
-
 // ========== IONEX Reader Class ==========
 
 class IonexReader {
@@ -49,22 +48,58 @@ public:
 
     bool getTecValueInterpolated(const std::tm& time, double lat, double lon, double& vtec);
 
+    bool getRmsValueInterpolated(const std::tm& time, double lat, double lon, double& rms);
+
+    // ========== Generic Map Access ==========
+    // `layer` selects the height layer of 3-D files (0 for 2-D files).
+    bool hasMaps(IonexMapType type) const { return !positions(type).empty(); }
+    std::size_t getMapCount(IonexMapType type) const { return positions(type).size(); }
+
+    bool getValue(IonexMapType type, const std::tm& time, double lat, double lon,
+                  double& value, int layer = 0);
+    bool getValueInterpolated(IonexMapType type, const std::tm& time, double lat, double lon,
+                              double& value, int layer = 0);
+
+    // ========== Decoded Map Cache ==========
+    // Maps are decoded once per epoch and reused until evicted.
+    void setCacheBudget(std::size_t memoryBudget_bytes, std::size_t maxEntries = 0);
+    TecMapCacheStats getCacheStats() const { return m_cache.getStats(); }
+
+    // ========== Preload Mode ==========
+    // Decodes every map of every type present into one contiguous
+    // [time][height][lat][lon] cube per type. Once preloaded, scalar lookups
+    // are served from the cubes and their batched kernel can evaluate many
+    // points per call.
+    bool preloadAll();
+    bool isPreloaded() const { return m_preloaded; }
+    const TecCube& getCube(IonexMapType type = IonexMapType::TEC) const {
+        return m_cubes[static_cast<int>(type)];
+    }
+
 private:
     std::string m_filename;
     bool m_isOpen;
     IonexHeader m_header;
 
-    std::map<std::time_t, long> m_mapPositions;
+    MappedFile m_file;
+    std::map<std::time_t, std::size_t> m_mapPositions[IONEX_MAP_TYPE_COUNT];
+    TecMapCache m_cache;
+    TecCube m_cubes[IONEX_MAP_TYPE_COUNT];
+    bool m_preloaded;
+
+    const std::map<std::time_t, std::size_t>& positions(IonexMapType type) const {
+        return m_mapPositions[static_cast<int>(type)];
+    }
 
-    bool parseHeader(std::ifstream& file);
-    bool buildMapIndex(std::ifstream& file);
-    bool loadTecMap(std::ifstream& file, long position, TecMap& tecMap);
+    bool parseHeader(std::size_t& offset);
+    bool buildMapIndex(std::size_t offset);
+    bool loadTecMap(IonexMapType type, std::size_t position, TecMap& tecMap) const;
+    std::shared_ptr<const TecMap> getMap(IonexMapType type, std::time_t epoch);
 
     std::time_t tmToTime(const std::tm& tm) const;
-    bool findClosestMaps(const std::tm& time, std::time_t& t1, std::time_t& t2);
+    bool findClosestMaps(IonexMapType type, const std::tm& time, std::time_t& t1, std::time_t& t2) const;
 
-    double bilinearInterpolate(const std::vector<std::vector<double>>& data,
-                               double lat, double lon);
+    double bilinearInterpolate(const TecMap& map, double lat, double lon, int layer) const;
 
     int latToIndex(double lat) const;
     int lonToIndex(double lon) const;
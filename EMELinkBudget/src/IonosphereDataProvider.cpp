@@ -10,7 +10,10 @@
 
 IonosphereDataProvider::IonosphereDataProvider()
     : m_reader(nullptr), m_wmm(nullptr),
-      m_ionexLoaded(false), m_wmmLoaded(false) {
+      m_ionexLoaded(false), m_wmmLoaded(false),
+      m_magGrid(nullptr), m_magGridEnabled(false),
+      m_magGridResolution(1.0), m_magGridHeight(SystemConstants::IONOSPHERE_HEIGHT_KM),
+      m_magGridMaxAgeYears(1.0 / 365.25) {
 }
 
 // ========== File Loading ==========
@@ -21,12 +24,65 @@ bool IonosphereDataProvider::loadIonexFile(const std::string& filename) {
     return m_ionexLoaded;
 }
 
-bool IonosphereDataProvider::loadWMMFile(const std::string& filename) {
-    m_wmm = std::make_unique<WMMModel>();
-    m_wmmLoaded = m_wmm->loadCoefficientFile(filename);
+bool IonosphereDataProvider::loadWMMFile(const std::string& filename, int maxDegree) {
+    auto wmm = std::make_unique<WMMModel>();
+    m_wmmLoaded = wmm->loadCoefficientFile(filename, maxDegree);
+    m_wmm = std::move(wmm);
+    m_fieldModelName = "WMM";
+    m_magGrid.reset();
     return m_wmmLoaded;
 }
 
+bool IonosphereDataProvider::loadEmbeddedWMM(int maxDegree) {
+    auto wmm = std::make_unique<WMMModel>();
+    m_wmmLoaded = wmm->loadEmbeddedModel(maxDegree);
+    m_wmm = std::move(wmm);
+    m_fieldModelName = "WMM";
+    m_magGrid.reset();
+    return m_wmmLoaded;
+}
+
+bool IonosphereDataProvider::loadIGRFFile(const std::string& filename) {
+    auto igrf = std::make_unique<IGRFModel>();
+    m_wmmLoaded = igrf->loadCoefficientFile(filename);
+    m_wmm = std::move(igrf);
+    m_fieldModelName = "IGRF";
+    m_magGrid.reset();
+    return m_wmmLoaded;
+}
+
+// ========== Magnetic Field Grid ==========
+
+void IonosphereDataProvider::enableMagneticGrid(double resolution_deg, double height_km, double maxAge_days) {
+    m_magGridEnabled = true;
+    m_magGridResolution = resolution_deg;
+    m_magGridHeight = height_km;
+    m_magGridMaxAgeYears = maxAge_days / 365.25;
+    m_magGrid.reset();
+}
+
+void IonosphereDataProvider::disableMagneticGrid() {
+    m_magGridEnabled = false;
+    m_magGrid.reset();
+}
+
+MagneticFieldResult IonosphereDataProvider::magneticField(double lat, double lon, double height_km,
+                                                          double decimal_year) {
+    if (!m_magGridEnabled) {
+        return m_wmm->calculate(lat, lon, height_km, decimal_year);
+    }
+
+    if (!m_magGrid || std::abs(decimal_year - m_magGrid->getDecimalYear()) > m_magGridMaxAgeYears) {
+        auto grid = std::make_unique<MagneticFieldGrid>();
+        if (!grid->build(*m_wmm, decimal_year, m_magGridHeight, m_magGridResolution)) {
+            return m_wmm->calculate(lat, lon, m_magGridHeight, decimal_year);
+        }
+        m_magGrid = std::move(grid);
+    }
+
+    return m_magGrid->interpolate(lat, lon);
+}
+
 // ========== Time Conversion ==========
 
 double IonosphereDataProvider::tmToDecimalYear(const std::tm& time) const {
@@ -75,11 +131,30 @@ bool IonosphereDataProvider::getIonosphereData(
     ionoData.vTEC_DX = vtec_dx;
     ionoData.vTEC_Home = vtec_home;
 
+    double rms_dx = 0.0;
+    double rms_home = 0.0;
+    if (m_reader->hasMaps(IonexMapType::RMS)) {
+        m_reader->getRmsValueInterpolated(time, lat_dx, lon_dx, rms_dx);
+        m_reader->getRmsValueInterpolated(time, lat_home, lon_home, rms_home);
+    }
+    ionoData.vTEC_RMS_DX = rms_dx;
+    ionoData.vTEC_RMS_Home = rms_home;
+
+    if (m_reader->hasMaps(IonexMapType::HEIGHT)) {
+        double height;
+        if (m_reader->getValueInterpolated(IonexMapType::HEIGHT, time, lat_dx, lon_dx, height)) {
+            ionoData.hmF2_DX = height;
+        }
+        if (m_reader->getValueInterpolated(IonexMapType::HEIGHT, time, lat_home, lon_home, height)) {
+            ionoData.hmF2_Home = height;
+        }
+    }
+
     if (m_wmmLoaded && m_wmm) {
         double decimal_year = tmToDecimalYear(time);
 
-        MagneticFieldResult mag_dx = m_wmm->calculate(lat_dx, lon_dx, height_dx_km, decimal_year);
-        MagneticFieldResult mag_home = m_wmm->calculate(lat_home, lon_home, height_home_km, decimal_year);
+        MagneticFieldResult mag_dx = magneticField(lat_dx, lon_dx, height_dx_km, decimal_year);
+        MagneticFieldResult mag_home = magneticField(lat_home, lon_home, height_home_km, decimal_year);
 
         ionoData.B_magnitude_DX = mag_dx.F * 1e-9;
         ionoData.B_magnitude_Home = mag_home.F * 1e-9;
@@ -96,7 +171,7 @@ bool IonosphereDataProvider::getIonosphereData(
         ionoData.B_declination_Home = 0.0;
     }
 
-    ionoData.dataSource = m_wmmLoaded ? "IONEX + WMM" : "IONEX + Default Magnetic";
+    ionoData.dataSource = m_wmmLoaded ? "IONEX + " + m_fieldModelName : "IONEX + Default Magnetic";
     ionoData.timestamp = std::mktime(const_cast<std::tm*>(&time));
 
     return true;
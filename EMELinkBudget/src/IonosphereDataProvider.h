@@ -2,6 +2,8 @@
 
 #include "IonexReader.h"
 #include "WMMModel.h"
+#include "IGRFModel.h"
+#include "MagneticFieldGrid.h"
 #include "Parameters.h"
 #include <string>
 #include <memory>
@@ -13,7 +15,23 @@ public:
     IonosphereDataProvider();
 
     bool loadIonexFile(const std::string& filename);
-    bool loadWMMFile(const std::string& filename);
+    // Pass WMMConstants::FULL_DEGREE to evaluate the crustal field of WMMHR.
+    bool loadWMMFile(const std::string& filename, int maxDegree = WMMConstants::MAX_DEGREE);
+    // Uses the compiled-in model when the build has one (EME_EMBED_WMM).
+    bool loadEmbeddedWMM(int maxDegree = WMMConstants::MAX_DEGREE);
+    // IGRF coefficient table (igrf14coeffs.txt), for dates before the WMM epoch.
+    bool loadIGRFFile(const std::string& filename);
+
+    // Serves B from a MagneticFieldGrid at height_km instead of evaluating
+    // the field model per call; station heights are then ignored for B. The grid is
+    // rebuilt when the query epoch moves more than maxAge_days from the one
+    // it was built for. See MagneticFieldGrid.h for the interpolation error.
+    void enableMagneticGrid(double resolution_deg = 1.0,
+                            double height_km = SystemConstants::IONOSPHERE_HEIGHT_KM,
+                            double maxAge_days = 1.0);
+    void disableMagneticGrid();
+    bool isMagneticGridEnabled() const { return m_magGridEnabled; }
+    const MagneticFieldGrid* getMagneticGrid() const { return m_magGrid.get(); }
 
     bool getIonosphereData(
         const std::tm& time,
@@ -22,13 +40,23 @@ public:
         IonosphereData& ionoData);
 
     bool isIonexLoaded() const { return m_ionexLoaded; }
+    // True once any field model (WMM or IGRF) is loaded.
     bool isWMMLoaded() const { return m_wmmLoaded; }
 
 private:
     std::unique_ptr<IonexReader> m_reader;
-    std::unique_ptr<WMMModel> m_wmm;
+    std::unique_ptr<GeomagneticModel> m_wmm;
+    std::string m_fieldModelName;
     bool m_ionexLoaded;
     bool m_wmmLoaded;
 
+    std::unique_ptr<MagneticFieldGrid> m_magGrid;
+    bool m_magGridEnabled;
+    double m_magGridResolution;
+    double m_magGridHeight;
+    double m_magGridMaxAgeYears;
+
+    MagneticFieldResult magneticField(double lat, double lon, double height_km, double decimal_year);
+
     double tmToDecimalYear(const std::tm& time) const;
 };
@@ -0,0 +1,273 @@
+#include "LinkBudgetResultsBatch.h"
+#include <charconv>
+#include <cstring>
+
+// ========== Column Table ==========
+
+namespace {
+
+// Calls visitor(name, column, &LinkBudgetResults::group, &GroupResults::field)
+// once for every numeric column, so the field list lives in one place.
+template <typename Batch, typename Visitor>
+void visitNumericColumns(Batch& b, Visitor&& v) {
+    using R = LinkBudgetResults;
+
+    v("geometry.distance_TX_km", b.geometry.distance_TX_km, &R::geometry, &GeometryResults::distance_TX_km);
+    v("geometry.distance_RX_km", b.geometry.distance_RX_km, &R::geometry, &GeometryResults::distance_RX_km);
+    v("geometry.totalPathLength_km", b.geometry.totalPathLength_km, &R::geometry, &GeometryResults::totalPathLength_km);
+    v("geometry.dopplerShift_Hz", b.geometry.dopplerShift_Hz, &R::geometry, &GeometryResults::dopplerShift_Hz);
+    v("geometry.moonRA_deg", b.geometry.moonRA_deg, &R::geometry, &GeometryResults::moonRA_deg);
+    v("geometry.moonDEC_deg", b.geometry.moonDEC_deg, &R::geometry, &GeometryResults::moonDEC_deg);
+    v("geometry.moonAzimuth_TX_deg", b.geometry.moonAzimuth_TX_deg, &R::geometry, &GeometryResults::moonAzimuth_TX_deg);
+    v("geometry.moonElevation_TX_deg", b.geometry.moonElevation_TX_deg, &R::geometry, &GeometryResults::moonElevation_TX_deg);
+    v("geometry.moonAzimuth_RX_deg", b.geometry.moonAzimuth_RX_deg, &R::geometry, &GeometryResults::moonAzimuth_RX_deg);
+    v("geometry.moonElevation_RX_deg", b.geometry.moonElevation_RX_deg, &R::geometry, &GeometryResults::moonElevation_RX_deg);
+    v("geometry.moonDistance_km", b.geometry.moonDistance_km, &R::geometry, &GeometryResults::moonDistance_km);
+    v("geometry.hourAngle_TX_rad", b.geometry.hourAngle_TX_rad, &R::geometry, &GeometryResults::hourAngle_TX_rad);
+    v("geometry.hourAngle_RX_rad", b.geometry.hourAngle_RX_rad, &R::geometry, &GeometryResults::hourAngle_RX_rad);
+    v("geometry.spectralSpread_Hz", b.geometry.spectralSpread_Hz, &R::geometry, &GeometryResults::spectralSpread_Hz);
+    v("geometry.coherentIntegrationLimit_s", b.geometry.coherentIntegrationLimit_s, &R::geometry, &GeometryResults::coherentIntegrationLimit_s);
+    v("geometry.librationVelocity_m_s", b.geometry.librationVelocity_m_s, &R::geometry, &GeometryResults::librationVelocity_m_s);
+
+    v("pathLoss.freeSpaceLoss_dB", b.pathLoss.freeSpaceLoss_dB, &R::pathLoss, &PathLossResults::freeSpaceLoss_dB);
+    v("pathLoss.lunarScatteringLoss_dB", b.pathLoss.lunarScatteringLoss_dB, &R::pathLoss, &PathLossResults::lunarScatteringLoss_dB);
+    v("pathLoss.atmosphericLoss_TX_dB", b.pathLoss.atmosphericLoss_TX_dB, &R::pathLoss, &PathLossResults::atmosphericLoss_TX_dB);
+    v("pathLoss.atmosphericLoss_RX_dB", b.pathLoss.atmosphericLoss_RX_dB, &R::pathLoss, &PathLossResults::atmosphericLoss_RX_dB);
+    v("pathLoss.atmosphericLoss_Total_dB", b.pathLoss.atmosphericLoss_Total_dB, &R::pathLoss, &PathLossResults::atmosphericLoss_Total_dB);
+    v("pathLoss.totalPathLoss_dB", b.pathLoss.totalPathLoss_dB, &R::pathLoss, &PathLossResults::totalPathLoss_dB);
+    v("pathLoss.wavelength_m", b.pathLoss.wavelength_m, &R::pathLoss, &PathLossResults::wavelength_m);
+    v("pathLoss.lunarReflectivity", b.pathLoss.lunarReflectivity, &R::pathLoss, &PathLossResults::lunarReflectivity);
+    v("pathLoss.bistaticAngle_deg", b.pathLoss.bistaticAngle_deg, &R::pathLoss, &PathLossResults::bistaticAngle_deg);
+    v("pathLoss.hagforsRoughnessParam", b.pathLoss.hagforsRoughnessParam, &R::pathLoss, &PathLossResults::hagforsRoughnessParam);
+    v("pathLoss.lunarRCS_dBsm", b.pathLoss.lunarRCS_dBsm, &R::pathLoss, &PathLossResults::lunarRCS_dBsm);
+    v("pathLoss.hagforsGain_dB", b.pathLoss.hagforsGain_dB, &R::pathLoss, &PathLossResults::hagforsGain_dB);
+
+    v("polarization.spatialRotation_deg", b.polarization.spatialRotation_deg, &R::polarization, &PolarizationResults::spatialRotation_deg);
+    v("polarization.faradayRotation_TX_deg", b.polarization.faradayRotation_TX_deg, &R::polarization, &PolarizationResults::faradayRotation_TX_deg);
+    v("polarization.faradayRotation_RX_deg", b.polarization.faradayRotation_RX_deg, &R::polarization, &PolarizationResults::faradayRotation_RX_deg);
+    v("polarization.totalRotation_deg", b.polarization.totalRotation_deg, &R::polarization, &PolarizationResults::totalRotation_deg);
+    v("polarization.PLF", b.polarization.PLF, &R::polarization, &PolarizationResults::PLF);
+    v("polarization.polarizationLoss_dB", b.polarization.polarizationLoss_dB, &R::polarization, &PolarizationResults::polarizationLoss_dB);
+    v("polarization.polarizationEfficiency_percent", b.polarization.polarizationEfficiency_percent, &R::polarization, &PolarizationResults::polarizationEfficiency_percent);
+    v("polarization.parallacticAngle_TX_deg", b.polarization.parallacticAngle_TX_deg, &R::polarization, &PolarizationResults::parallacticAngle_TX_deg);
+    v("polarization.parallacticAngle_RX_deg", b.polarization.parallacticAngle_RX_deg, &R::polarization, &PolarizationResults::parallacticAngle_RX_deg);
+    v("polarization.slantFactor_TX", b.polarization.slantFactor_TX, &R::polarization, &PolarizationResults::slantFactor_TX);
+    v("polarization.slantFactor_RX", b.polarization.slantFactor_RX, &R::polarization, &PolarizationResults::slantFactor_RX);
+
+    v("noise.skyNoiseTemp_K", b.noise.skyNoiseTemp_K, &R::noise, &NoiseResults::skyNoiseTemp_K);
+    v("noise.groundSpilloverTemp_K", b.noise.groundSpilloverTemp_K, &R::noise, &NoiseResults::groundSpilloverTemp_K);
+    v("noise.moonBodyTemp_K", b.noise.moonBodyTemp_K, &R::noise, &NoiseResults::moonBodyTemp_K);
+    v("noise.antennaNoiseTemp_K", b.noise.antennaNoiseTemp_K, &R::noise, &NoiseResults::antennaNoiseTemp_K);
+    v("noise.antennaEffectiveTemp_K", b.noise.antennaEffectiveTemp_K, &R::noise, &NoiseResults::antennaEffectiveTemp_K);
+    v("noise.receiverNoiseTemp_K", b.noise.receiverNoiseTemp_K, &R::noise, &NoiseResults::receiverNoiseTemp_K);
+    v("noise.systemNoiseTemp_K", b.noise.systemNoiseTemp_K, &R::noise, &NoiseResults::systemNoiseTemp_K);
+    v("noise.noisePower_dBm", b.noise.noisePower_dBm, &R::noise, &NoiseResults::noisePower_dBm);
+    v("noise.noisePower_W", b.noise.noisePower_W, &R::noise, &NoiseResults::noisePower_W);
+
+    v("snr.receivedSignalPower_dBm", b.snr.receivedSignalPower_dBm, &R::snr, &SNRResults::receivedSignalPower_dBm);
+    v("snr.receivedSignalPower_W", b.snr.receivedSignalPower_W, &R::snr, &SNRResults::receivedSignalPower_W);
+    v("snr.SNR_dB", b.snr.SNR_dB, &R::snr, &SNRResults::SNR_dB);
+    v("snr.fadingMargin_dB", b.snr.fadingMargin_dB, &R::snr, &SNRResults::fadingMargin_dB);
+    v("snr.effectiveSNR_dB", b.snr.effectiveSNR_dB, &R::snr, &SNRResults::effectiveSNR_dB);
+    v("snr.requiredSNR_dB", b.snr.requiredSNR_dB, &R::snr, &SNRResults::requiredSNR_dB);
+    v("snr.linkMargin_dB", b.snr.linkMargin_dB, &R::snr, &SNRResults::linkMargin_dB);
+}
+
+// Non-double columns, visited as visitor(column)
+template <typename Batch, typename Visitor>
+void visitOtherColumns(Batch& b, Visitor&& v) {
+    v(b.time);
+    v(b.geometry.ephemerisSourceId);
+    v(b.pathLoss.useHagforsModel);
+    v(b.snr.linkViable);
+    v(b.totalLoss_dB);
+    v(b.calculationSuccess);
+    v(b.errorMessageId);
+    v(b.calculationTime);
+}
+
+} // namespace
+
+// ========== Constructor ==========
+
+LinkBudgetResultsBatch::LinkBudgetResultsBatch()
+    : m_lastStringId(0) {
+    m_strings.push_back("");
+    m_stringIds.emplace("", 0);
+}
+
+// ========== Sizing ==========
+
+void LinkBudgetResultsBatch::resize(std::size_t rows) {
+    visitNumericColumns(*this, [rows](const char*, AlignedColumn& col, auto, auto) {
+        col.resize(rows, 0.0);
+    });
+    visitOtherColumns(*this, [rows](auto& col) { col.resize(rows); });
+}
+
+void LinkBudgetResultsBatch::reserve(std::size_t rows) {
+    visitNumericColumns(*this, [rows](const char*, AlignedColumn& col, auto, auto) {
+        col.reserve(rows);
+    });
+    visitOtherColumns(*this, [rows](auto& col) { col.reserve(rows); });
+}
+
+void LinkBudgetResultsBatch::clear() {
+    resize(0);
+    m_strings.resize(1);
+    m_stringIds.clear();
+    m_stringIds.emplace("", 0);
+    m_lastStringId = 0;
+}
+
+// ========== Row Access ==========
+
+void LinkBudgetResultsBatch::set(
+    std::size_t row,
+    const LinkBudgetResults& results,
+    std::time_t observationTime) {
+
+    setValues(row, results, observationTime);
+    geometry.ephemerisSourceId[row] = intern(results.geometry.ephemerisSource);
+    errorMessageId[row] = intern(results.errorMessage);
+}
+
+void LinkBudgetResultsBatch::setValues(
+    std::size_t row,
+    const LinkBudgetResults& results,
+    std::time_t observationTime) {
+
+    visitNumericColumns(*this, [&](const char*, AlignedColumn& col, auto group, auto field) {
+        col[row] = (results.*group).*field;
+    });
+
+    time[row] = observationTime;
+    pathLoss.useHagforsModel[row] = results.pathLoss.useHagforsModel ? 1 : 0;
+    snr.linkViable[row] = results.snr.linkViable ? 1 : 0;
+    totalLoss_dB[row] = results.totalLoss_dB;
+    calculationSuccess[row] = results.calculationSuccess ? 1 : 0;
+    calculationTime[row] = results.calculationTime;
+}
+
+void LinkBudgetResultsBatch::append(
+    const LinkBudgetResults& results,
+    std::time_t observationTime) {
+
+    resize(size() + 1);
+    set(size() - 1, results, observationTime);
+}
+
+LinkBudgetResults LinkBudgetResultsBatch::row(std::size_t row) const {
+    LinkBudgetResults results;
+
+    visitNumericColumns(*this, [&](const char*, const AlignedColumn& col, auto group, auto field) {
+        (results.*group).*field = col[row];
+    });
+
+    results.geometry.ephemerisSource = string(geometry.ephemerisSourceId[row]);
+    results.pathLoss.useHagforsModel = pathLoss.useHagforsModel[row] != 0;
+    results.snr.linkViable = snr.linkViable[row] != 0;
+    results.totalLoss_dB = totalLoss_dB[row];
+    results.calculationSuccess = calculationSuccess[row] != 0;
+    results.errorMessage = string(errorMessageId[row]);
+    results.calculationTime = calculationTime[row];
+
+    return results;
+}
+
+// ========== Interned Strings ==========
+
+std::uint32_t LinkBudgetResultsBatch::intern(const std::string& value) {
+    // Consecutive rows almost always repeat the same string
+    if (m_strings[m_lastStringId] == value) {
+        return m_lastStringId;
+    }
+
+    auto it = m_stringIds.find(value);
+    if (it == m_stringIds.end()) {
+        std::uint32_t id = static_cast<std::uint32_t>(m_strings.size());
+        m_strings.push_back(value);
+        it = m_stringIds.emplace(value, id).first;
+    }
+
+    m_lastStringId = it->second;
+    return m_lastStringId;
+}
+
+const std::string& LinkBudgetResultsBatch::string(std::uint32_t id) const {
+    return id < m_strings.size() ? m_strings[id] : m_strings[0];
+}
+
+// ========== Named Column Access ==========
+
+const std::vector<std::string>& LinkBudgetResultsBatch::columnNames() {
+    static const std::vector<std::string> names = [] {
+        std::vector<std::string> list;
+        LinkBudgetResultsBatch probe;
+        visitNumericColumns(probe, [&list](const char* name, AlignedColumn&, auto, auto) {
+            list.emplace_back(name);
+        });
+        list.emplace_back("totalLoss_dB");
+        return list;
+    }();
+    return names;
+}
+
+AlignedColumn* LinkBudgetResultsBatch::column(const std::string& name) {
+    if (name == "totalLoss_dB") {
+        return &totalLoss_dB;
+    }
+
+    AlignedColumn* found = nullptr;
+    visitNumericColumns(*this, [&](const char* columnName, AlignedColumn& col, auto, auto) {
+        if (found == nullptr && name == columnName) {
+            found = &col;
+        }
+    });
+    return found;
+}
+
+const AlignedColumn* LinkBudgetResultsBatch::column(const std::string& name) const {
+    return const_cast<LinkBudgetResultsBatch*>(this)->column(name);
+}
+
+// ========== CSV Export ==========
+
+bool LinkBudgetResultsBatch::writeCSV(
+    std::ostream& out,
+    const std::vector<std::string>& columns) const {
+
+    const std::vector<std::string>& names = columns.empty() ? columnNames() : columns;
+
+    std::vector<const AlignedColumn*> selected;
+    selected.reserve(names.size());
+    for (const auto& name : names) {
+        const AlignedColumn* col = column(name);
+        if (col == nullptr) {
+            return false;
+        }
+        selected.push_back(col);
+    }
+
+    out << "time";
+    for (const auto& name : names) {
+        out << ',' << name;
+    }
+    out << '\n';
+
+    char buffer[64];
+    for (std::size_t row = 0; row < size(); ++row) {
+        auto res = std::to_chars(buffer, buffer + sizeof(buffer),
+                                 static_cast<long long>(time[row]));
+        out.write(buffer, res.ptr - buffer);
+
+        for (const AlignedColumn* col : selected) {
+            buffer[0] = ',';
+            res = std::to_chars(buffer + 1, buffer + sizeof(buffer), (*col)[row]);
+            out.write(buffer, res.ptr - buffer);
+        }
+        out.put('\n');
+    }
+
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "LinkBudgetTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <new>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ========== Aligned Allocator ==========
+// Cache-line aligned storage so batch columns start on a vector-load boundary.
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+using AlignedColumn = std::vector<double, AlignedAllocator<double>>;
+using FlagColumn = std::vector<std::uint8_t>;
+using StringIdColumn = std::vector<std::uint32_t>;
+
+// ========== Column Groups ==========
+// Each group mirrors one of the *Results structs field for field.
+
+struct GeometryColumns {
+    AlignedColumn distance_TX_km;
+    AlignedColumn distance_RX_km;
+    AlignedColumn totalPathLength_km;
+    AlignedColumn dopplerShift_Hz;
+    AlignedColumn moonRA_deg;
+    AlignedColumn moonDEC_deg;
+    AlignedColumn moonAzimuth_TX_deg;
+    AlignedColumn moonElevation_TX_deg;
+    AlignedColumn moonAzimuth_RX_deg;
+    AlignedColumn moonElevation_RX_deg;
+    AlignedColumn moonDistance_km;
+    AlignedColumn hourAngle_TX_rad;
+    AlignedColumn hourAngle_RX_rad;
+    AlignedColumn spectralSpread_Hz;
+    AlignedColumn coherentIntegrationLimit_s;
+    AlignedColumn librationVelocity_m_s;
+    StringIdColumn ephemerisSourceId;
+};
+
+struct PathLossColumns {
+    AlignedColumn freeSpaceLoss_dB;
+    AlignedColumn lunarScatteringLoss_dB;
+    AlignedColumn atmosphericLoss_TX_dB;
+    AlignedColumn atmosphericLoss_RX_dB;
+    AlignedColumn atmosphericLoss_Total_dB;
+    AlignedColumn totalPathLoss_dB;
+    AlignedColumn wavelength_m;
+    AlignedColumn lunarReflectivity;
+    AlignedColumn bistaticAngle_deg;
+    AlignedColumn hagforsRoughnessParam;
+    AlignedColumn lunarRCS_dBsm;
+    AlignedColumn hagforsGain_dB;
+    FlagColumn useHagforsModel;
+};
+
+struct PolarizationColumns {
+    AlignedColumn spatialRotation_deg;
+    AlignedColumn faradayRotation_TX_deg;
+    AlignedColumn faradayRotation_RX_deg;
+    AlignedColumn totalRotation_deg;
+    AlignedColumn PLF;
+    AlignedColumn polarizationLoss_dB;
+    AlignedColumn polarizationEfficiency_percent;
+    AlignedColumn parallacticAngle_TX_deg;
+    AlignedColumn parallacticAngle_RX_deg;
+    AlignedColumn slantFactor_TX;
+    AlignedColumn slantFactor_RX;
+};
+
+struct NoiseColumns {
+    AlignedColumn skyNoiseTemp_K;
+    AlignedColumn groundSpilloverTemp_K;
+    AlignedColumn moonBodyTemp_K;
+    AlignedColumn antennaNoiseTemp_K;
+    AlignedColumn antennaEffectiveTemp_K;
+    AlignedColumn receiverNoiseTemp_K;
+    AlignedColumn systemNoiseTemp_K;
+    AlignedColumn noisePower_dBm;
+    AlignedColumn noisePower_W;
+};
+
+struct SNRColumns {
+    AlignedColumn receivedSignalPower_dBm;
+    AlignedColumn receivedSignalPower_W;
+    AlignedColumn SNR_dB;
+    AlignedColumn fadingMargin_dB;
+    AlignedColumn effectiveSNR_dB;
+    AlignedColumn requiredSNR_dB;
+    AlignedColumn linkMargin_dB;
+    FlagColumn linkViable;
+};
+
+// ========== Link Budget Results Batch ==========
+// Structure-of-arrays counterpart of std::vector<LinkBudgetResults>.
+// Every numeric field is a contiguous double column addressed by its dotted
+// name ("snr.linkMargin_dB"); strings are interned once and stored per row as
+// a 32-bit id (id 0 is always the empty string).
+class LinkBudgetResultsBatch {
+public:
+    LinkBudgetResultsBatch();
+
+    std::vector<std::time_t> time;
+    GeometryColumns geometry;
+    PathLossColumns pathLoss;
+    PolarizationColumns polarization;
+    NoiseColumns noise;
+    SNRColumns snr;
+    AlignedColumn totalLoss_dB;
+    FlagColumn calculationSuccess;
+    StringIdColumn errorMessageId;
+    std::vector<std::time_t> calculationTime;
+
+    std::size_t size() const { return time.size(); }
+    bool empty() const { return time.empty(); }
+
+    void resize(std::size_t rows);
+    void reserve(std::size_t rows);
+    void clear();
+
+    // Row access; set() requires row < size(), append() grows by one row.
+    void set(std::size_t row, const LinkBudgetResults& results, std::time_t observationTime);
+    // Writes every column except the interned string ids. Distinct rows may
+    // be written concurrently from different threads.
+    void setValues(std::size_t row, const LinkBudgetResults& results, std::time_t observationTime);
+    void append(const LinkBudgetResults& results, std::time_t observationTime);
+    LinkBudgetResults row(std::size_t row) const;
+
+    // ========== Interned Strings ==========
+    std::uint32_t intern(const std::string& value);
+    const std::string& string(std::uint32_t id) const;
+    const std::vector<std::string>& strings() const { return m_strings; }
+
+    // ========== Named Column Access ==========
+    static const std::vector<std::string>& columnNames();
+    const AlignedColumn* column(const std::string& name) const;
+    AlignedColumn* column(const std::string& name);
+
+    // Writes a header line and one line per row; an empty list exports every
+    // numeric column. Formatting goes through a fixed stack buffer.
+    bool writeCSV(std::ostream& out, const std::vector<std::string>& columns = {}) const;
+
+private:
+    std::vector<std::string> m_strings;
+    std::unordered_map<std::string, std::uint32_t> m_stringIds;
+    std::uint32_t m_lastStringId;
+};
@@ -7,6 +7,9 @@
 // ========== Data Source Configuration ==========
 struct DataSourceConfig {
     bool useJPLHorizons;
+    // Compute the moon position from LunarEphemeris at each observation
+    // time instead of using LinkBudgetParameters::moonEphemeris as given.
+    bool useAnalyticEphemeris;
     bool useRealTimeIonosphere;
     bool useSkyNoiseMap;
     std::string jplHorizonsUrl;
@@ -15,6 +18,7 @@ struct DataSourceConfig {
 
     DataSourceConfig()
         : useJPLHorizons(false),
+          useAnalyticEphemeris(false),
           useRealTimeIonosphere(false),
           useSkyNoiseMap(false),
           jplHorizonsUrl("https://ssd.jpl.nasa.gov/api/horizons.api"),
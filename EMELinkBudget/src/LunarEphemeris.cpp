@@ -0,0 +1,507 @@
+#include "LunarEphemeris.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ========== Lunar Position Batch ==========
+
+void LunarPositionBatch::resize(std::size_t rows) {
+    for (AlignedColumn* column : {&rightAscension, &declination, &eclipticLongitude,
+                                  &eclipticLatitude, &distance_km, &rangeRate_km_s,
+                                  &librationLon_deg, &librationLat_deg,
+                                  &librationLonRate_deg_day, &librationLatRate_deg_day}) {
+        column->resize(rows);
+    }
+}
+
+LunarPosition LunarPositionBatch::row(std::size_t i) const {
+    return {rightAscension[i], declination[i], eclipticLongitude[i], eclipticLatitude[i],
+            distance_km[i], rangeRate_km_s[i], librationLon_deg[i], librationLat_deg[i],
+            librationLonRate_deg_day[i], librationLatRate_deg_day[i]};
+}
+
+// ========== Series Tables ==========
+
+namespace {
+
+constexpr double DEG = M_PI / 180.0;
+constexpr double J2000 = 2451545.0;
+constexpr double DAYS_PER_CENTURY = 36525.0;
+
+// Linear rates of the arguments, degrees per Julian century.
+constexpr double RATE_LP = 481267.88123421;
+constexpr double RATE_D = 445267.1114034;
+constexpr double RATE_M = 35999.0502909;
+constexpr double RATE_MP = 477198.8675055;
+constexpr double RATE_F = 483202.0175233;
+constexpr double RATE_OMEGA = -1934.1362891;
+constexpr double RATE_A1 = 131.849;
+constexpr double RATE_A2 = 479264.290;
+constexpr double RATE_A3 = 481266.484;
+
+// Inclination of the mean lunar equator to the ecliptic.
+constexpr double LUNAR_EQUATOR_INCLINATION = 1.54242 * DEG;
+
+// Multiples of D, M, M', F; longitude in 1e-6 deg, distance in 1e-3 km (Meeus table 47.A).
+struct LongitudeDistanceTerm {
+    int d, m, mp, f;
+    double l;
+    double r;
+};
+
+constexpr LongitudeDistanceTerm LONGITUDE_DISTANCE_TERMS[] = {
+    {0, 0, 1, 0, 6288774, -20905355}, {2, 0, -1, 0, 1274027, -3699111},
+    {2, 0, 0, 0, 658314, -2955968},   {0, 0, 2, 0, 213618, -569925},
+    {0, 1, 0, 0, -185116, 48888},     {0, 0, 0, 2, -114332, -3149},
+    {2, 0, -2, 0, 58793, 246158},     {2, -1, -1, 0, 57066, -152138},
+    {2, 0, 1, 0, 53322, -170733},     {2, -1, 0, 0, 45758, -204586},
+    {0, 1, -1, 0, -40923, -129620},   {1, 0, 0, 0, -34720, 108743},
+    {0, 1, 1, 0, -30383, 104755},     {2, 0, 0, -2, 15327, 10321},
+    {0, 0, 1, 2, -12528, 0},          {0, 0, 1, -2, 10980, 79661},
+    {4, 0, -1, 0, 10675, -34782},     {0, 0, 3, 0, 10034, -23210},
+    {4, 0, -2, 0, 8548, -21636},      {2, 1, -1, 0, -7888, 24208},
+    {2, 1, 0, 0, -6766, 30824},       {1, 0, -1, 0, -5163, -8379},
+    {1, 1, 0, 0, 4987, -16675},       {2, -1, 1, 0, 4036, -12831},
+    {2, 0, 2, 0, 3994, -10445},       {4, 0, 0, 0, 3861, -11650},
+    {2, 0, -3, 0, 3665, 14403},       {0, 1, -2, 0, -2689, -7003},
+    {2, 0, -1, 2, -2602, 0},          {2, -1, -2, 0, 2390, 10056},
+    {1, 0, 1, 0, -2348, 6322},        {2, -2, 0, 0, 2236, -9884},
+    {0, 1, 2, 0, -2120, 5751},        {0, 2, 0, 0, -2069, 0},
+    {2, -2, -1, 0, 2048, -4950},      {2, 0, 1, -2, -1773, 4130},
+    {2, 0, 0, 2, -1595, 0},           {4, -1, -1, 0, 1215, -3958},
+    {0, 0, 2, 2, -1110, 0},           {3, 0, -1, 0, -892, 3258},
+    {2, 1, 1, 0, -810, 2616},         {4, -1, -2, 0, 759, -1897},
+    {0, 2, -1, 0, -713, -2117},       {2, 2, -1, 0, -700, 2354},
+    {2, 1, -2, 0, 691, 0},            {2, -1, 0, -2, 596, 0},
+    {4, 0, 1, 0, 549, -1423},         {0, 0, 4, 0, 537, -1117},
+    {4, -1, 0, 0, 520, -1571},        {1, 0, -2, 0, -487, -1739},
+    {2, 1, 0, -2, -399, 0},           {0, 0, 2, -2, -381, -4421},
+    {1, 1, 1, 0, 351, 0},             {3, 0, -2, 0, -340, 0},
+    {4, 0, -3, 0, 330, 0},            {2, -1, 2, 0, 327, 0},
+    {0, 2, 1, 0, -323, 1165},         {1, 1, -1, 0, 299, 0},
+    {2, 0, 3, 0, 294, 0},             {2, 0, -1, -2, 0, 8752},
+};
+
+// Latitude in 1e-6 deg (Meeus table 47.B).
+struct LatitudeTerm {
+    int d, m, mp, f;
+    double b;
+};
+
+constexpr LatitudeTerm LATITUDE_TERMS[] = {
+    {0, 0, 0, 1, 5128122}, {0, 0, 1, 1, 280602},  {0, 0, 1, -1, 277693}, {2, 0, 0, -1, 173237},
+    {2, 0, -1, 1, 55413},  {2, 0, -1, -1, 46271}, {2, 0, 0, 1, 32573},   {0, 0, 2, 1, 17198},
+    {2, 0, 1, -1, 9266},   {0, 0, 2, -1, 8822},   {2, -1, 0, -1, 8216},  {2, 0, -2, -1, 4324},
+    {2, 0, 1, 1, 4200},    {2, 1, 0, -1, -3359},  {2, -1, -1, 1, 2463},  {2, -1, 0, 1, 2211},
+    {2, -1, -1, -1, 2065}, {0, 1, -1, -1, -1870}, {4, 0, -1, -1, 1828},  {0, 1, 0, 1, -1794},
+    {0, 0, 0, 3, -1749},   {0, 1, -1, 1, -1565},  {1, 0, 0, 1, -1491},   {0, 1, 1, 1, -1475},
+    {0, 1, 1, -1, -1410},  {0, 1, 0, -1, -1344},  {1, 0, 0, -1, -1335},  {0, 0, 3, 1, 1107},
+    {4, 0, 0, -1, 1021},   {4, 0, -1, 1, 833},    {0, 0, 1, -3, 777},    {4, 0, -2, 1, 671},
+    {2, 0, 0, -3, 607},    {2, 0, 2, -1, 596},    {2, -1, 1, -1, 491},   {2, 0, -2, 1, -451},
+    {0, 0, 3, -1, 439},    {2, 0, 2, 1, 422},     {2, 0, -3, -1, 421},   {2, 1, -1, 1, -366},
+    {2, 1, 0, 1, -351},    {4, 0, 0, 1, 331},     {2, -1, 1, 1, 315},    {2, -2, 0, -1, 302},
+    {0, 0, 1, 3, -283},    {2, 1, 1, -1, -229},   {1, 1, 0, -1, 223},    {1, 1, 0, 1, 223},
+    {0, 1, -2, -1, -220},  {2, 1, -1, -1, -220},  {1, 0, 1, 1, -185},    {2, -1, -2, -1, 181},
+    {0, 1, 2, 1, -177},    {4, 0, -2, -1, 176},   {4, -1, -1, -1, 166},  {1, 0, 1, -1, -164},
+    {4, 0, 1, -1, 132},    {1, 0, -1, -1, -119},  {4, -1, 0, -1, 115},   {2, -2, 0, 1, 107},
+};
+
+// ========== Chunked Evaluation ==========
+
+constexpr int CHUNK = 32;
+constexpr int MAX_MULTIPLE = 4;
+constexpr int HARMONIC_ROWS = 2 * MAX_MULTIPLE + 1;
+
+// Every term is e^{i(dD + mM)} * e^{i(m'M' + fF)}. Only 13 (d, m) and 33
+// (m', f) combinations occur in the two tables, so those products are
+// formed once per time and each term costs a single complex multiply.
+struct ArgumentPair {
+    int a, b;
+};
+
+constexpr int MAX_PAIRS = 40;
+constexpr int TERM_COUNT = 60;
+
+struct SeriesLayout {
+    ArgumentPair dm[MAX_PAIRS] = {};
+    ArgumentPair mpf[MAX_PAIRS] = {};
+    int dmCount = 0;
+    int mpfCount = 0;
+    int lonDM[TERM_COUNT] = {};
+    int lonMPF[TERM_COUNT] = {};
+    int latDM[TERM_COUNT] = {};
+    int latMPF[TERM_COUNT] = {};
+};
+
+constexpr int pairIndex(ArgumentPair* pairs, int& count, int a, int b) {
+    for (int k = 0; k < count; ++k) {
+        if (pairs[k].a == a && pairs[k].b == b) {
+            return k;
+        }
+    }
+    pairs[count] = {a, b};
+    return count++;
+}
+
+constexpr SeriesLayout makeLayout() {
+    SeriesLayout layout;
+    for (int k = 0; k < TERM_COUNT; ++k) {
+        const LongitudeDistanceTerm& t = LONGITUDE_DISTANCE_TERMS[k];
+        layout.lonDM[k] = pairIndex(layout.dm, layout.dmCount, t.d, t.m);
+        layout.lonMPF[k] = pairIndex(layout.mpf, layout.mpfCount, t.mp, t.f);
+    }
+    for (int k = 0; k < TERM_COUNT; ++k) {
+        const LatitudeTerm& t = LATITUDE_TERMS[k];
+        layout.latDM[k] = pairIndex(layout.dm, layout.dmCount, t.d, t.m);
+        layout.latMPF[k] = pairIndex(layout.mpf, layout.mpfCount, t.mp, t.f);
+    }
+    return layout;
+}
+
+constexpr SeriesLayout LAYOUT = makeLayout();
+static_assert(std::size(LONGITUDE_DISTANCE_TERMS) == TERM_COUNT && std::size(LATITUDE_TERMS) == TERM_COUNT);
+
+// cos(kx), sin(kx) of one argument for k = -4..4 (row k + 4) across a chunk.
+// With a scale, harmonic k carries scale^|k|; for M that applies the
+// eccentricity factor E of the terms in M to the table itself.
+struct Harmonics {
+    alignas(64) double c[HARMONIC_ROWS][CHUNK];
+    alignas(64) double s[HARMONIC_ROWS][CHUNK];
+
+    void build(const double* x_deg, const double* scale, int n) {
+        for (int i = 0; i < n; ++i) {
+            const double k = scale ? scale[i] : 1.0;
+            c[MAX_MULTIPLE][i] = 1.0;
+            s[MAX_MULTIPLE][i] = 0.0;
+            c[MAX_MULTIPLE + 1][i] = k * std::cos(x_deg[i] * DEG);
+            s[MAX_MULTIPLE + 1][i] = k * std::sin(x_deg[i] * DEG);
+        }
+        for (int row = MAX_MULTIPLE + 2; row < HARMONIC_ROWS; ++row) {
+            for (int i = 0; i < n; ++i) {
+                const double c1 = c[MAX_MULTIPLE + 1][i];
+                const double s1 = s[MAX_MULTIPLE + 1][i];
+                c[row][i] = c[row - 1][i] * c1 - s[row - 1][i] * s1;
+                s[row][i] = s[row - 1][i] * c1 + c[row - 1][i] * s1;
+            }
+        }
+        for (int k = 1; k <= MAX_MULTIPLE; ++k) {
+            for (int i = 0; i < n; ++i) {
+                c[MAX_MULTIPLE - k][i] = c[MAX_MULTIPLE + k][i];
+                s[MAX_MULTIPLE - k][i] = -s[MAX_MULTIPLE + k][i];
+            }
+        }
+    }
+};
+
+struct ChunkSeries {
+    Harmonics D, M, Mp, F;
+
+    // Products for the argument pairs in LAYOUT.
+    alignas(64) double dmC[MAX_PAIRS][CHUNK];
+    alignas(64) double dmS[MAX_PAIRS][CHUNK];
+    alignas(64) double mpfC[MAX_PAIRS][CHUNK];
+    alignas(64) double mpfS[MAX_PAIRS][CHUNK];
+
+    alignas(64) double T[CHUNK];
+    alignas(64) double Lp[CHUNK];
+    alignas(64) double d[CHUNK];
+    alignas(64) double m[CHUNK];
+    alignas(64) double mp[CHUNK];
+    alignas(64) double f[CHUNK];
+    alignas(64) double E[CHUNK];
+    alignas(64) double omega[CHUNK];
+
+    // Periodic sums and their time derivatives (per day).
+    alignas(64) double sumL[CHUNK];
+    alignas(64) double sumR[CHUNK];
+    alignas(64) double sumB[CHUNK];
+    alignas(64) double rateL[CHUNK];
+    alignas(64) double rateR[CHUNK];
+    alignas(64) double rateB[CHUNK];
+};
+
+// Angle in rad/day of a combination of the fundamental arguments.
+inline double termRate(int d, int m, int mp, int f) {
+    return (d * RATE_D + m * RATE_M + mp * RATE_MP + f * RATE_F) * DEG / DAYS_PER_CENTURY;
+}
+
+void sumChunk(const double* jde, int n, ChunkSeries& cs) {
+    for (int i = 0; i < n; ++i) {
+        const double T = (jde[i] - J2000) / DAYS_PER_CENTURY;
+        const double T2 = T * T;
+        const double T3 = T2 * T;
+        const double T4 = T3 * T;
+        cs.T[i] = T;
+        cs.Lp[i] = std::fmod(218.3164477 + RATE_LP * T - 0.0015786 * T2 + T3 / 538841.0 - T4 / 65194000.0, 360.0);
+        cs.d[i] = std::fmod(297.8501921 + RATE_D * T - 0.0018819 * T2 + T3 / 545868.0 - T4 / 113065000.0, 360.0);
+        cs.m[i] = std::fmod(357.5291092 + RATE_M * T - 0.0001536 * T2 + T3 / 24490000.0, 360.0);
+        cs.mp[i] = std::fmod(134.9633964 + RATE_MP * T + 0.0087414 * T2 + T3 / 69699.0 - T4 / 14712000.0, 360.0);
+        cs.f[i] = std::fmod(93.2720950 + RATE_F * T - 0.0036539 * T2 - T3 / 3526000.0 + T4 / 863310000.0, 360.0);
+        cs.omega[i] = std::fmod(125.0445479 + RATE_OMEGA * T + 0.0020754 * T2 + T3 / 467441.0 - T4 / 60616000.0, 360.0);
+        cs.E[i] = 1.0 - 0.002516 * T - 0.0000074 * T2;
+
+        cs.sumL[i] = cs.sumR[i] = cs.sumB[i] = 0.0;
+        cs.rateL[i] = cs.rateR[i] = cs.rateB[i] = 0.0;
+    }
+
+    cs.D.build(cs.d, nullptr, n);
+    cs.M.build(cs.m, cs.E, n);
+    cs.Mp.build(cs.mp, nullptr, n);
+    cs.F.build(cs.f, nullptr, n);
+
+    auto combine = [n](const Harmonics& x, const Harmonics& y, const ArgumentPair& pair,
+                       double* c, double* sn) {
+        const double* cx = x.c[pair.a + MAX_MULTIPLE];
+        const double* sx = x.s[pair.a + MAX_MULTIPLE];
+        const double* cy = y.c[pair.b + MAX_MULTIPLE];
+        const double* sy = y.s[pair.b + MAX_MULTIPLE];
+        for (int i = 0; i < n; ++i) {
+            c[i] = cx[i] * cy[i] - sx[i] * sy[i];
+            sn[i] = cx[i] * sy[i] + sx[i] * cy[i];
+        }
+    };
+    for (int k = 0; k < LAYOUT.dmCount; ++k) {
+        combine(cs.D, cs.M, LAYOUT.dm[k], cs.dmC[k], cs.dmS[k]);
+    }
+    for (int k = 0; k < LAYOUT.mpfCount; ++k) {
+        combine(cs.Mp, cs.F, LAYOUT.mpf[k], cs.mpfC[k], cs.mpfS[k]);
+    }
+
+    // Real part of each term's phasor feeds the cosine series, the imaginary
+    // part the sine series.
+    for (int k = 0; k < TERM_COUNT; ++k) {
+        const LongitudeDistanceTerm& t = LONGITUDE_DISTANCE_TERMS[k];
+        const double w = termRate(t.d, t.m, t.mp, t.f);
+        const double l = t.l, r = t.r, lw = t.l * w, rw = t.r * w;
+        const double* c1 = cs.dmC[LAYOUT.lonDM[k]];
+        const double* s1 = cs.dmS[LAYOUT.lonDM[k]];
+        const double* c2 = cs.mpfC[LAYOUT.lonMPF[k]];
+        const double* s2 = cs.mpfS[LAYOUT.lonMPF[k]];
+        for (int i = 0; i < n; ++i) {
+            const double re = c1[i] * c2[i] - s1[i] * s2[i];
+            const double im = c1[i] * s2[i] + s1[i] * c2[i];
+            cs.sumL[i] += l * im;
+            cs.sumR[i] += r * re;
+            cs.rateL[i] += lw * re;
+            cs.rateR[i] -= rw * im;
+        }
+    }
+
+    for (int k = 0; k < TERM_COUNT; ++k) {
+        const LatitudeTerm& t = LATITUDE_TERMS[k];
+        const double b = t.b, bw = t.b * termRate(t.d, t.m, t.mp, t.f);
+        const double* c1 = cs.dmC[LAYOUT.latDM[k]];
+        const double* s1 = cs.dmS[LAYOUT.latDM[k]];
+        const double* c2 = cs.mpfC[LAYOUT.latMPF[k]];
+        const double* s2 = cs.mpfS[LAYOUT.latMPF[k]];
+        for (int i = 0; i < n; ++i) {
+            const double re = c1[i] * c2[i] - s1[i] * s2[i];
+            const double im = c1[i] * s2[i] + s1[i] * c2[i];
+            cs.sumB[i] += b * im;
+            cs.rateB[i] += bw * re;
+        }
+    }
+}
+
+LunarPosition finishPosition(const ChunkSeries& cs, int i) {
+    const double T = cs.T[i];
+    const double perDay = DEG / DAYS_PER_CENTURY;
+
+    // Additive terms: Venus (A1), Jupiter (A2) and the flattening of the Earth.
+    // Sums and differences with F and M' reuse their harmonic tables.
+    const double A1 = (119.75 + RATE_A1 * T) * DEG;
+    const double A2 = (53.09 + RATE_A2 * T) * DEG;
+    const double A3 = (313.45 + RATE_A3 * T) * DEG;
+    const double Lp = cs.Lp[i] * DEG;
+    const double sA1 = std::sin(A1), cA1 = std::cos(A1);
+    const double sA2 = std::sin(A2), cA2 = std::cos(A2);
+    const double sA3 = std::sin(A3), cA3 = std::cos(A3);
+    const double sLp = std::sin(Lp), cLp = std::cos(Lp);
+    const double sF = cs.F.s[MAX_MULTIPLE + 1][i], cF = cs.F.c[MAX_MULTIPLE + 1][i];
+    const double sMp = cs.Mp.s[MAX_MULTIPLE + 1][i], cMp = cs.Mp.c[MAX_MULTIPLE + 1][i];
+
+    const double sLpMinusF = sLp * cF - cLp * sF, cLpMinusF = cLp * cF + sLp * sF;
+    const double sA1MinusF = sA1 * cF - cA1 * sF, cA1MinusF = cA1 * cF + sA1 * sF;
+    const double sA1PlusF = sA1 * cF + cA1 * sF, cA1PlusF = cA1 * cF - sA1 * sF;
+    const double sLpMinusMp = sLp * cMp - cLp * sMp, cLpMinusMp = cLp * cMp + sLp * sMp;
+    const double sLpPlusMp = sLp * cMp + cLp * sMp, cLpPlusMp = cLp * cMp - sLp * sMp;
+
+    const double sumL = cs.sumL[i] + 3958.0 * sA1 + 1962.0 * sLpMinusF + 318.0 * sA2;
+    const double rateL = cs.rateL[i] + (3958.0 * cA1 * RATE_A1 +
+                                        1962.0 * cLpMinusF * (RATE_LP - RATE_F) +
+                                        318.0 * cA2 * RATE_A2) * perDay;
+    const double sumB = cs.sumB[i] - 2235.0 * sLp + 382.0 * sA3 +
+                        175.0 * sA1MinusF + 175.0 * sA1PlusF +
+                        127.0 * sLpMinusMp - 115.0 * sLpPlusMp;
+    const double rateB = cs.rateB[i] + (-2235.0 * cLp * RATE_LP + 382.0 * cA3 * RATE_A3 +
+                                        175.0 * cA1MinusF * (RATE_A1 - RATE_F) +
+                                        175.0 * cA1PlusF * (RATE_A1 + RATE_F) +
+                                        127.0 * cLpMinusMp * (RATE_LP - RATE_MP) -
+                                        115.0 * cLpPlusMp * (RATE_LP + RATE_MP)) * perDay;
+
+    // Degrees and degrees/day.
+    const double lambda = cs.Lp[i] + sumL * 1e-6;
+    const double lambdaRate = RATE_LP / DAYS_PER_CENTURY + rateL * 1e-6;
+    const double beta = sumB * 1e-6;
+    const double betaRate = rateB * 1e-6;
+
+    LunarPosition p;
+    p.distance_km = 385000.56 + cs.sumR[i] * 1e-3;
+    p.rangeRate_km_s = cs.rateR[i] * 1e-3 / 86400.0;
+
+    // Low-precision nutation (Meeus ch. 22, about 0.5").
+    const double omega = cs.omega[i] * DEG;
+    const double sOm = std::sin(omega), cOm = std::cos(omega);
+    const double Ls2 = 2.0 * (280.4665 + 36000.7698 * T) * DEG;
+    const double sLs2 = std::sin(Ls2), cLs2 = std::cos(Ls2);
+    const double nutLon = (-17.20 * sOm - 1.32 * sLs2 - 0.23 * (2.0 * sLp * cLp) +
+                           0.21 * (2.0 * sOm * cOm)) / 3600.0;
+    const double nutObl = (9.20 * cOm + 0.57 * cLs2 + 0.10 * (cLp * cLp - sLp * sLp) -
+                           0.09 * (cOm * cOm - sOm * sOm)) / 3600.0;
+    const double eps0 = (84381.448 - 46.8150 * T - 0.00059 * T * T + 0.001813 * T * T * T) / 3600.0;
+    const double eps = (eps0 + nutObl) * DEG;
+
+    const double lam = (lambda + nutLon) * DEG;
+    const double bet = beta * DEG;
+    const double sinLam = std::sin(lam), cosLam = std::cos(lam);
+    const double sinBet = std::sin(bet), cosBet = std::cos(bet);
+    const double sinEps = std::sin(eps), cosEps = std::cos(eps);
+
+    p.eclipticLongitude = std::fmod(lam + 2.0 * M_PI, 2.0 * M_PI);
+    p.eclipticLatitude = bet;
+    double ra = std::atan2(sinLam * cosEps - (sinBet / cosBet) * sinEps, cosLam);
+    if (ra < 0.0) ra += 2.0 * M_PI;
+    p.rightAscension = ra;
+    p.declination = std::asin(sinBet * cosEps + cosBet * sinEps * sinLam);
+
+    // Optical libration (Meeus ch. 53) with its analytic rate.
+    const double W = (lambda - cs.omega[i]) * DEG;
+    const double dW = (lambdaRate - RATE_OMEGA / DAYS_PER_CENTURY) * DEG;
+    const double dBet = betaRate * DEG;
+    const double sinW = std::sin(W), cosW = std::cos(W);
+    const double sinI = std::sin(LUNAR_EQUATOR_INCLINATION), cosI = std::cos(LUNAR_EQUATOR_INCLINATION);
+    const double sb = sinBet, cb = cosBet;
+
+    const double u = sinW * cb * cosI - sb * sinI;
+    const double v = cosW * cb;
+    const double w = -sinW * cb * sinI - sb * cosI;
+    const double du = cosW * cb * cosI * dW - sinW * sb * cosI * dBet - cb * sinI * dBet;
+    const double dv = -sinW * cb * dW - cosW * sb * dBet;
+    const double dw = -cosW * cb * sinI * dW + sinW * sb * sinI * dBet - cb * cosI * dBet;
+
+    double lon = std::atan2(u, v) / DEG - cs.f[i];
+    lon = std::remainder(lon, 360.0);
+    p.librationLon_deg = lon;
+    p.librationLat_deg = std::asin(w) / DEG;
+    p.librationLonRate_deg_day = (v * du - u * dv) / (u * u + v * v) / DEG - RATE_F / DAYS_PER_CENTURY;
+    p.librationLatRate_deg_day = dw / std::sqrt(1.0 - w * w) / DEG;
+
+    return p;
+}
+
+} // namespace
+
+// ========== Time Scales ==========
+
+double LunarEphemeris::julianDay(std::time_t utc) {
+    return 2440587.5 + static_cast<double>(utc) / 86400.0;
+}
+
+double LunarEphemeris::deltaT(double julianDay) {
+    const double y = 2000.0 + (julianDay - J2000) / 365.25;
+    if (y >= 1986.0 && y < 2005.0) {
+        const double t = y - 2000.0;
+        return 63.86 + t * (0.3345 + t * (-0.060374 + t * (0.0017275 + t * (0.000651814 + t * 0.00002373599))));
+    }
+    if (y >= 2005.0 && y < 2050.0) {
+        const double t = y - 2000.0;
+        return 62.92 + t * (0.32217 + t * 0.005589);
+    }
+    const double u = (y - 1820.0) / 100.0;
+    if (y >= 2050.0 && y < 2150.0) {
+        return -20.0 + 32.0 * u * u - 0.5628 * (2150.0 - y);
+    }
+    return -20.0 + 32.0 * u * u;
+}
+
+void LunarEphemeris::nutation(double jde, double& nutationLon_deg, double& nutationObl_deg,
+                              double& meanObliquity_deg) {
+    const double T = (jde - J2000) / DAYS_PER_CENTURY;
+    const double omega = (125.0445479 + RATE_OMEGA * T + 0.0020754 * T * T) * DEG;
+    const double Ls2 = 2.0 * (280.4665 + 36000.7698 * T) * DEG;
+    const double Lp2 = 2.0 * (218.3164477 + RATE_LP * T) * DEG;
+    nutationLon_deg = (-17.20 * std::sin(omega) - 1.32 * std::sin(Ls2) -
+                       0.23 * std::sin(Lp2) + 0.21 * std::sin(2.0 * omega)) / 3600.0;
+    nutationObl_deg = (9.20 * std::cos(omega) + 0.57 * std::cos(Ls2) +
+                       0.10 * std::cos(Lp2) - 0.09 * std::cos(2.0 * omega)) / 3600.0;
+    meanObliquity_deg = (84381.448 - 46.8150 * T - 0.00059 * T * T + 0.001813 * T * T * T) / 3600.0;
+}
+
+// ========== Evaluation ==========
+
+LunarPosition LunarEphemeris::calculate(std::time_t utc) const {
+    const double jd = julianDay(utc);
+    return calculateJDE(jd + deltaT(jd) / 86400.0);
+}
+
+LunarPosition LunarEphemeris::calculateJDE(double jde) const {
+    ChunkSeries cs;
+    sumChunk(&jde, 1, cs);
+    return finishPosition(cs, 0);
+}
+
+void LunarEphemeris::calculateBatch(const double* jde, std::size_t count, LunarPositionBatch& out) const {
+    out.resize(count);
+
+    ChunkSeries cs;
+    for (std::size_t start = 0; start < count; start += CHUNK) {
+        const int n = static_cast<int>(std::min<std::size_t>(CHUNK, count - start));
+        sumChunk(jde + start, n, cs);
+        for (int i = 0; i < n; ++i) {
+            const LunarPosition p = finishPosition(cs, i);
+            const std::size_t row = start + i;
+            out.rightAscension[row] = p.rightAscension;
+            out.declination[row] = p.declination;
+            out.eclipticLongitude[row] = p.eclipticLongitude;
+            out.eclipticLatitude[row] = p.eclipticLatitude;
+            out.distance_km[row] = p.distance_km;
+            out.rangeRate_km_s[row] = p.rangeRate_km_s;
+            out.librationLon_deg[row] = p.librationLon_deg;
+            out.librationLat_deg[row] = p.librationLat_deg;
+            out.librationLonRate_deg_day[row] = p.librationLonRate_deg_day;
+            out.librationLatRate_deg_day[row] = p.librationLatRate_deg_day;
+        }
+    }
+}
+
+void LunarEphemeris::calculateSeries(std::time_t start, std::time_t step_s, std::size_t count,
+                                     LunarPositionBatch& out) const {
+    std::vector<double> jde(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const double jd = julianDay(start + static_cast<std::time_t>(i) * step_s);
+        jde[i] = jd + deltaT(jd) / 86400.0;
+    }
+    calculateBatch(jde.data(), count, out);
+}
+
+void LunarEphemeris::fillEphemeris(const LunarPosition& position, std::time_t utc, MoonEphemeris& moon,
+                                   const char* source) {
+    moon.rightAscension = position.rightAscension;
+    moon.declination = position.declination;
+    moon.distance_km = position.distance_km;
+    moon.rangeRate_km_s = position.rangeRate_km_s;
+    moon.librationLon_deg = position.librationLon_deg;
+    moon.librationLat_deg = position.librationLat_deg;
+    moon.librationLonRate_deg_day = position.librationLonRate_deg_day;
+    moon.librationLatRate_deg_day = position.librationLatRate_deg_day;
+    moon.hourAngle_DX = 0.0;
+    moon.hourAngle_Home = 0.0;
+    moon.observationTime = utc;
+    moon.julianDate = julianDay(utc);
+    moon.ephemerisSource = source;
+}
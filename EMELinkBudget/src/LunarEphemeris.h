@@ -0,0 +1,80 @@
+#pragma once
+
+#include "LinkBudgetResultsBatch.h"
+#include "Parameters.h"
+#include <cstddef>
+#include <ctime>
+
+// ========== Lunar Position ==========
+// Geocentric apparent place of the moon, equinox of date.
+
+struct LunarPosition {
+    double rightAscension;      // rad
+    double declination;         // rad
+    double eclipticLongitude;   // rad, apparent
+    double eclipticLatitude;    // rad
+    double distance_km;         // centre to centre
+    double rangeRate_km_s;
+    double librationLon_deg;    // optical libration
+    double librationLat_deg;
+    double librationLonRate_deg_day;
+    double librationLatRate_deg_day;
+};
+
+// ========== Lunar Position Batch ==========
+// Structure-of-arrays LunarPosition, one row per input time.
+
+struct LunarPositionBatch {
+    AlignedColumn rightAscension;
+    AlignedColumn declination;
+    AlignedColumn eclipticLongitude;
+    AlignedColumn eclipticLatitude;
+    AlignedColumn distance_km;
+    AlignedColumn rangeRate_km_s;
+    AlignedColumn librationLon_deg;
+    AlignedColumn librationLat_deg;
+    AlignedColumn librationLonRate_deg_day;
+    AlignedColumn librationLatRate_deg_day;
+
+    std::size_t size() const { return distance_km.size(); }
+
+    void resize(std::size_t rows);
+    LunarPosition row(std::size_t row) const;
+};
+
+// ========== Lunar Ephemeris ==========
+// Truncated ELP-2000/82 theory as tabulated in Meeus, Astronomical
+// Algorithms ch. 47 (about 10" in longitude, 4" in latitude, 10 km in
+// distance), low-precision nutation and the optical libration of ch. 53.
+// Times are processed in chunks: the four fundamental arguments become
+// tables of harmonics e^{ikx} once per time, and each of the 120 periodic
+// terms is a product of table entries evaluated across the whole chunk,
+// with no trigonometric calls. Rates come from the analytic derivative of
+// the same series.
+
+class LunarEphemeris {
+public:
+    static constexpr const char* SOURCE_NAME = "Analytic (Meeus)";
+
+    static double julianDay(std::time_t utc);
+    // TT - UT in seconds (Espenak & Meeus polynomials).
+    static double deltaT(double julianDay);
+    // Low-precision nutation in longitude and obliquity and the mean
+    // obliquity of the ecliptic, all in degrees (Meeus ch. 22, about 0.5").
+    static void nutation(double jde, double& nutationLon_deg, double& nutationObl_deg,
+                         double& meanObliquity_deg);
+
+    LunarPosition calculate(std::time_t utc) const;
+    // Julian Ephemeris Day, i.e. already in dynamical time.
+    LunarPosition calculateJDE(double jde) const;
+
+    void calculateBatch(const double* jde, std::size_t count, LunarPositionBatch& out) const;
+    // count UTC instants start, start + step_s, ...
+    void calculateSeries(std::time_t start, std::time_t step_s, std::size_t count,
+                         LunarPositionBatch& out) const;
+
+    // Copies a position into the link budget's ephemeris record; hour angles
+    // are left at zero so they follow the observation time.
+    static void fillEphemeris(const LunarPosition& position, std::time_t utc, MoonEphemeris& moon,
+                              const char* source = SOURCE_NAME);
+};
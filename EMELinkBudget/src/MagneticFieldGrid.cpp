@@ -0,0 +1,145 @@
+#define _USE_MATH_DEFINES
+#include "MagneticFieldGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ========== Constructor ==========
+
+MagneticFieldGrid::MagneticFieldGrid()
+    : m_valid(false), m_decimalYear(0.0), m_height(0.0), m_resolution(0.0),
+      m_numLat(0), m_numLon(0) {
+}
+
+// ========== Grid Construction ==========
+
+bool MagneticFieldGrid::build(const GeomagneticModel& model, double decimal_year, double height_km,
+                              double resolution_deg, unsigned numThreads) {
+    m_valid = false;
+    if (!(resolution_deg > 0.0) || resolution_deg > 90.0) {
+        return false;
+    }
+
+    const int numLat = static_cast<int>(std::ceil(180.0 / resolution_deg - 1e-9)) + 1;
+    const int numLon = static_cast<int>(std::ceil(360.0 / resolution_deg - 1e-9)) + 1;
+    const double latStep = 180.0 / (numLat - 1);
+    const double lonStep = 360.0 / (numLon - 1);
+
+    m_nodes.assign(static_cast<std::size_t>(numLat) * numLon * 3, 0.0);
+
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const int workers = std::min<int>(static_cast<int>(numThreads), numLat);
+    std::vector<char> ok(workers, 0);
+
+    // Each worker evaluates a contiguous band of rows as one batch.
+    auto band = [&](int w) {
+        const int rowBegin = numLat * w / workers;
+        const int rowEnd = numLat * (w + 1) / workers;
+        const std::size_t count = static_cast<std::size_t>(rowEnd - rowBegin) * (numLon - 1);
+
+        std::vector<double> lat, lon, height(count, height_km);
+        lat.reserve(count);
+        lon.reserve(count);
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            for (int j = 0; j < numLon - 1; ++j) {
+                lat.push_back(-90.0 + i * latStep);
+                lon.push_back(-180.0 + j * lonStep);
+            }
+        }
+
+        MagneticFieldBatch field;
+        if (!model.calculateBatch(lat, lon, height, decimal_year, field)) {
+            return;
+        }
+
+        std::size_t k = 0;
+        for (int i = rowBegin; i < rowEnd; ++i) {
+            double* row = m_nodes.data() + static_cast<std::size_t>(i) * numLon * 3;
+            for (int j = 0; j < numLon - 1; ++j, ++k) {
+                row[3 * j] = field.X[k];
+                row[3 * j + 1] = field.Y[k];
+                row[3 * j + 2] = field.Z[k];
+            }
+            std::copy(row, row + 3, row + 3 * (numLon - 1));
+        }
+        ok[w] = 1;
+    };
+
+    if (workers == 1) {
+        band(0);
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        for (int w = 0; w < workers; ++w) {
+            threads.emplace_back(band, w);
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    if (std::find(ok.begin(), ok.end(), 0) != ok.end()) {
+        return false;
+    }
+
+    m_decimalYear = decimal_year;
+    m_height = height_km;
+    m_resolution = latStep;
+    m_numLat = numLat;
+    m_numLon = numLon;
+    m_valid = true;
+    return true;
+}
+
+// ========== Lookup ==========
+
+MagneticFieldResult MagneticFieldGrid::interpolate(double latitude_deg, double longitude_deg) const {
+    MagneticFieldResult result = {};
+    if (!m_valid) {
+        return result;
+    }
+
+    const double latStep = 180.0 / (m_numLat - 1);
+    const double lonStep = 360.0 / (m_numLon - 1);
+
+    double lon = std::fmod(longitude_deg + 180.0, 360.0);
+    if (lon < 0.0) {
+        lon += 360.0;
+    }
+    const double y = (std::clamp(latitude_deg, -90.0, 90.0) + 90.0) / latStep;
+    const double x = lon / lonStep;
+
+    const int i = std::min(static_cast<int>(y), m_numLat - 2);
+    const int j = std::min(static_cast<int>(x), m_numLon - 2);
+    const double fy = y - i;
+    const double fx = x - j;
+
+    const double* p00 = m_nodes.data() + (static_cast<std::size_t>(i) * m_numLon + j) * 3;
+    const double* p01 = p00 + 3;
+    const double* p10 = p00 + static_cast<std::size_t>(m_numLon) * 3;
+    const double* p11 = p10 + 3;
+
+    const double w00 = (1.0 - fy) * (1.0 - fx);
+    const double w01 = (1.0 - fy) * fx;
+    const double w10 = fy * (1.0 - fx);
+    const double w11 = fy * fx;
+
+    const double X = w00 * p00[0] + w01 * p01[0] + w10 * p10[0] + w11 * p11[0];
+    const double Y = w00 * p00[1] + w01 * p01[1] + w10 * p10[1] + w11 * p11[1];
+    const double Z = w00 * p00[2] + w01 * p01[2] + w10 * p10[2] + w11 * p11[2];
+
+    result.X = X;
+    result.Y = Y;
+    result.Z = Z;
+    result.H = std::sqrt(X * X + Y * Y);
+    result.F = std::sqrt(X * X + Y * Y + Z * Z);
+    result.inclination = std::atan2(Z, result.H) * 180.0 / M_PI;
+    result.declination = std::atan2(Y, X) * 180.0 / M_PI;
+    return result;
+}
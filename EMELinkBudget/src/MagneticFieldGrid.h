@@ -0,0 +1,44 @@
+#pragma once
+
+#include "GeomagneticModel.h"
+#include <vector>
+
+// ========== Magnetic Field Grid ==========
+// Main field sampled on a global lat/lon node grid at one shell height and
+// epoch, for callers that need B at many points on that shell. Nodes hold
+// the X/Y/Z components (interpolating F/I/D directly breaks where the
+// declination wraps); a lookup blends the four surrounding nodes and
+// derives F, inclination and declination from the result.
+//
+// Error against WMMModel::calculate() at 350 km for the degree-12 model
+// (test_magnetic_field_grid), |lat| <= 85: 1 deg spacing stays below 8 nT in
+// F, 0.02 deg in inclination and 0.12 deg in declination (which degrades
+// toward the poles); 0.5 deg is about four times tighter. Crustal terms of a
+// high-degree model are not resolved.
+
+class MagneticFieldGrid {
+public:
+    MagneticFieldGrid();
+
+    // Evaluates `model` at every node; rows are split across numThreads
+    // workers (0 uses std::thread::hardware_concurrency()).
+    bool build(const GeomagneticModel& model, double decimal_year, double height_km,
+               double resolution_deg = 1.0, unsigned numThreads = 0);
+
+    bool isValid() const { return m_valid; }
+    double getDecimalYear() const { return m_decimalYear; }
+    double getHeight() const { return m_height; }
+    double getResolution() const { return m_resolution; }
+
+    // Bilinear lookup; longitude wraps, latitude is clamped to +/-90.
+    MagneticFieldResult interpolate(double latitude_deg, double longitude_deg) const;
+
+private:
+    bool m_valid;
+    double m_decimalYear;
+    double m_height;
+    double m_resolution;
+    int m_numLat;   // rows from -90 to +90
+    int m_numLon;   // columns from -180 to +180, last column repeats the first
+    std::vector<double> m_nodes;  // X, Y, Z per node, row-major
+};
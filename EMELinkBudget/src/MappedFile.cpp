@@ -0,0 +1,114 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#include <fstream>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// ========== Constructors ==========
+
+MappedFile::MappedFile()
+    : m_data(nullptr), m_size(0), m_mapped(false) {
+}
+
+MappedFile::MappedFile(const std::string& filename)
+    : m_data(nullptr), m_size(0), m_mapped(false) {
+    open(filename);
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(other.m_data), m_size(other.m_size), m_mapped(other.m_mapped),
+      m_buffer(std::move(other.m_buffer)) {
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_mapped = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_data = other.m_data;
+        m_size = other.m_size;
+        m_mapped = other.m_mapped;
+        m_buffer = std::move(other.m_buffer);
+        other.m_data = nullptr;
+        other.m_size = 0;
+        other.m_mapped = false;
+    }
+    return *this;
+}
+
+// ========== Open / Close ==========
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+#ifdef _WIN32
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::streamsize length = file.tellg();
+    if (length <= 0) {
+        return false;
+    }
+
+    m_buffer.resize(static_cast<std::size_t>(length));
+    file.seekg(0);
+    if (!file.read(m_buffer.data(), length)) {
+        m_buffer.clear();
+        return false;
+    }
+
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+    return true;
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* addr = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+
+    madvise(addr, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    m_data = static_cast<const char*>(addr);
+    m_size = static_cast<std::size_t>(st.st_size);
+    m_mapped = true;
+    return true;
+#endif
+}
+
+void MappedFile::close() {
+#ifndef _WIN32
+    if (m_mapped && m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ========== Read-only Memory-Mapped File ==========
+// RAII wrapper around a private read-only mapping. On platforms without
+// mmap the file is read into an owned buffer so callers see the same view.
+
+class MappedFile {
+public:
+    MappedFile();
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool open(const std::string& filename);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    const char* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+    std::string_view view() const { return std::string_view(m_data, m_size); }
+
+private:
+    const char* m_data;
+    std::size_t m_size;
+    bool m_mapped;
+    std::vector<char> m_buffer;
+};
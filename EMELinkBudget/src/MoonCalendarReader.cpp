@@ -57,7 +57,7 @@ bool MoonCalendarReader::loadCalendarFile(const std::string& filename) {
 
 // ========== Get Moon Declination ==========
 
-bool MoonCalendarReader::getMoonDeclination(const std::tm& date, double& declination) {
+bool MoonCalendarReader::getMoonDeclination(const std::tm& date, double& declination) const {
     if (!m_loaded || m_entries.empty()) {
         return false;
     }
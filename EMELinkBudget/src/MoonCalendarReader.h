@@ -23,7 +23,7 @@ public:
 
     bool loadCalendarFile(const std::string& filename);
 
-    bool getMoonDeclination(const std::tm& date, double& declination);
+    bool getMoonDeclination(const std::tm& date, double& declination) const;
 
     bool isLoaded() const { return m_loaded; }
 
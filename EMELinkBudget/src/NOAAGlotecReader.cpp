@@ -1,11 +1,13 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include "NOAAGlotecReader.h"
-#include "SimpleHttpClient.h"
+#include "HttpSession.h"
+#include "MappedFile.h"
+#include "DataCache.h"
 #include <sstream>
 #include <iomanip>
 #include <cmath>
 #include <algorithm>
-#include <regex>
+#include <charconv>
 #include <iostream>
 
 NOAAGlotecReader::NOAAGlotecReader()
@@ -74,73 +76,277 @@ std::string NOAAGlotecReader::getDataUrl(const std::tm& time) const {
     return oss.str();
 }
 
-bool NOAAGlotecReader::parseGeoJson(const std::string& jsonContent, GlotecData& data) {
-    data.tecValues.clear();
-    data.isValid = false;
+// ========== GeoJSON Parsing ==========
 
-    std::regex coordRegex(R"("coordinates"\s*:\s*\[\s*(-?\d+\.?\d*)\s*,\s*(-?\d+\.?\d*)\s*\])");
-    std::regex tecRegex(R"("tec"\s*:\s*(-?\d+\.?\d*))");
+namespace {
 
-    auto coordBegin = std::sregex_iterator(jsonContent.begin(), jsonContent.end(), coordRegex);
-    auto coordEnd = std::sregex_iterator();
-    auto tecBegin = std::sregex_iterator(jsonContent.begin(), jsonContent.end(), tecRegex);
+const char* skipWhitespace(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+    return p;
+}
 
-    std::vector<double> lons, lats;
-    std::vector<float> tecs;
+// p points just past the opening quote; returns the position after the closing quote.
+const char* skipString(const char* p, const char* end) {
+    while (p < end) {
+        char c = *p++;
+        if (c == '\\') {
+            if (p < end) ++p;
+        } else if (c == '"') {
+            return p;
+        }
+    }
+    return end;
+}
 
-    for (auto it = coordBegin; it != coordEnd; ++it) {
-        std::smatch match = *it;
-        double lon = std::stod(match[1].str());
-        double lat = std::stod(match[2].str());
-        lons.push_back(lon);
-        lats.push_back(lat);
+template <typename T>
+bool readNumber(const char*& p, const char* end, T& value) {
+    p = skipWhitespace(p, end);
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        return false;
     }
+    p = result.ptr;
+    return true;
+}
 
-    for (auto it = tecBegin; it != std::sregex_iterator(); ++it) {
-        std::smatch match = *it;
-        float tec = std::stof(match[1].str());
-        tecs.push_back(tec);
+// Lays out points directly in GlotecData::tecValues while they arrive in
+// row-major order (longitude fastest). The first row fixes the longitude
+// spacing and count, the first point of the second row the latitude spacing.
+// Any point off that grid switches to collecting coordinates and regridding.
+class GlotecGridBuilder {
+public:
+    explicit GlotecGridBuilder(GlotecData& data)
+        : m_data(data), m_count(0), m_lon0(0.0), m_lat0(0.0),
+          m_lonStep(0.0), m_latStep(0.0), m_numLon(0), m_ordered(true) {
     }
 
-    if (lons.size() != tecs.size() || lons.empty()) {
-        return false;
+    void add(double lon, double lat, float tec) {
+        m_data.tecValues.push_back(tec);
+
+        if (m_ordered) {
+            if (m_count == 0) {
+                m_lon0 = lon;
+                m_lat0 = lat;
+            } else if (m_numLon == 0) {
+                if (near(lat, m_lat0)) {
+                    if (m_count == 1) {
+                        m_lonStep = lon - m_lon0;
+                    }
+                    m_ordered = m_lonStep > 0.0 && near(lon, gridLon(m_count));
+                } else {
+                    m_numLon = m_count;
+                    m_latStep = lat - m_lat0;
+                    m_ordered = m_numLon > 1 && near(lon, m_lon0);
+                }
+            } else {
+                m_ordered = near(lon, gridLon(m_count)) && near(lat, gridLat(m_count));
+            }
+
+            if (!m_ordered) {
+                m_lons.reserve(m_count + 1);
+                m_lats.reserve(m_count + 1);
+                for (std::size_t i = 0; i < m_count; ++i) {
+                    m_lons.push_back(gridLon(i));
+                    m_lats.push_back(gridLat(i));
+                }
+            }
+        }
+
+        if (!m_ordered) {
+            m_lons.push_back(lon);
+            m_lats.push_back(lat);
+        }
+        ++m_count;
     }
 
-    double minLat = *std::min_element(lats.begin(), lats.end());
-    double maxLat = *std::max_element(lats.begin(), lats.end());
-    double minLon = *std::min_element(lons.begin(), lons.end());
+    bool finish() {
+        if (m_count == 0) {
+            return false;
+        }
+        return m_ordered ? finishOrdered() : regrid();
+    }
+
+private:
+    GlotecData& m_data;
+    std::size_t m_count;
+    double m_lon0, m_lat0;
+    double m_lonStep, m_latStep;
+    std::size_t m_numLon;
+    bool m_ordered;
+    std::vector<double> m_lons;
+    std::vector<double> m_lats;
+
+    static bool near(double a, double b) {
+        return std::abs(a - b) < 1e-6;
+    }
+
+    double gridLon(std::size_t i) const {
+        return m_lon0 + static_cast<double>(m_numLon ? i % m_numLon : i) * m_lonStep;
+    }
+
+    double gridLat(std::size_t i) const {
+        return m_lat0 + static_cast<double>(m_numLon ? i / m_numLon : 0) * m_latStep;
+    }
 
-    data.latStart = minLat;
-    data.lonStart = minLon;
+    bool finishOrdered() {
+        if (m_numLon == 0) {
+            m_numLon = m_count;
+        }
+        const std::size_t numLat = (m_count + m_numLon - 1) / m_numLon;
+        m_data.tecValues.resize(numLat * m_numLon, 0.0f);
+
+        m_data.numLon = static_cast<int>(m_numLon);
+        m_data.numLat = static_cast<int>(numLat);
+        m_data.lonStart = m_lon0;
+        m_data.latStart = m_lat0;
+        if (m_lonStep > 0.0) {
+            m_data.lonStep = m_lonStep;
+        }
 
-    std::vector<double> uniqueLats = lats;
-    std::sort(uniqueLats.begin(), uniqueLats.end());
-    uniqueLats.erase(std::unique(uniqueLats.begin(), uniqueLats.end()), uniqueLats.end());
+        if (m_latStep < 0.0) {
+            // North-to-south files: flip rows so latitude ascends with the row index.
+            auto rows = m_data.tecValues.begin();
+            for (std::size_t r = 0; r < numLat / 2; ++r) {
+                std::swap_ranges(rows + r * m_numLon, rows + (r + 1) * m_numLon,
+                                 rows + (numLat - 1 - r) * m_numLon);
+            }
+            m_data.latStart = m_lat0 + static_cast<double>(numLat - 1) * m_latStep;
+            m_data.latStep = -m_latStep;
+        } else if (m_latStep > 0.0) {
+            m_data.latStep = m_latStep;
+        }
+        return true;
+    }
 
-    if (uniqueLats.size() > 1) {
-        data.latStep = uniqueLats[1] - uniqueLats[0];
-        data.numLat = static_cast<int>(uniqueLats.size());
+    static int axis(std::vector<double> values, double& start, double& step) {
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end(),
+                                 [](double a, double b) { return near(a, b); }), values.end());
+
+        start = values.front();
+        if (values.size() < 2) {
+            return 1;
+        }
+
+        double minStep = values[1] - values[0];
+        for (std::size_t i = 2; i < values.size(); ++i) {
+            minStep = std::min(minStep, values[i] - values[i - 1]);
+        }
+        step = minStep;
+        return static_cast<int>(std::round((values.back() - values.front()) / step)) + 1;
     }
 
-    data.numLon = 72;
-    data.lonStep = 5.0;
+    bool regrid() {
+        m_data.numLon = axis(m_lons, m_data.lonStart, m_data.lonStep);
+        m_data.numLat = axis(m_lats, m_data.latStart, m_data.latStep);
 
-    data.tecValues.resize(data.numLon * data.numLat, 0.0f);
+        std::vector<float> tecs;
+        tecs.swap(m_data.tecValues);
+        m_data.tecValues.assign(static_cast<std::size_t>(m_data.numLon) * m_data.numLat, 0.0f);
 
-    for (size_t i = 0; i < lons.size(); ++i) {
-        int col = static_cast<int>(std::round((lons[i] - data.lonStart) / data.lonStep));
-        int row = static_cast<int>(std::round((lats[i] - data.latStart) / data.latStep));
+        for (std::size_t i = 0; i < m_count; ++i) {
+            int col = static_cast<int>(std::round((m_lons[i] - m_data.lonStart) / m_data.lonStep));
+            int row = static_cast<int>(std::round((m_lats[i] - m_data.latStart) / m_data.latStep));
+            if (col >= 0 && col < m_data.numLon && row >= 0 && row < m_data.numLat) {
+                m_data.tecValues[col + static_cast<std::size_t>(row) * m_data.numLon] = tecs[i];
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+bool NOAAGlotecReader::parseGeoJson(std::string_view jsonContent, GlotecData& data) const {
+    data.tecValues.clear();
+    data.isValid = false;
 
-        if (col >= 0 && col < data.numLon && row >= 0 && row < data.numLat) {
-            int idx = getGridIndex(col, row, data.numLon);
-            data.tecValues[idx] = tecs[i];
+    GlotecGridBuilder grid(data);
+
+    const char* p = jsonContent.data();
+    const char* end = p + jsonContent.size();
+
+    // Structural scan: nesting depth plus the "features" array position is
+    // enough to delimit each Feature; only coordinates and tec are decoded.
+    int depth = 0;
+    int featureDepth = -1;
+    bool inFeature = false;
+    bool hasCoordinates = false;
+    double lon = 0.0, lat = 0.0;
+    float tec = 0.0f;
+
+    while (p < end) {
+        const char c = *p++;
+        switch (c) {
+        case '"': {
+            const char* keyBegin = p;
+            p = skipString(p, end);
+            const char* colon = skipWhitespace(p, end);
+            if (colon >= end || *colon != ':') {
+                break;
+            }
+            std::string_view key(keyBegin, static_cast<std::size_t>(p - keyBegin - 1));
+            p = colon + 1;
+            const char* value = skipWhitespace(p, end);
+
+            if (inFeature && key == "coordinates" && value < end && *value == '[') {
+                p = value + 1;
+                ++depth;
+                hasCoordinates = readNumber(p, end, lon) &&
+                                 (p = skipWhitespace(p, end)) < end && *p++ == ',' &&
+                                 readNumber(p, end, lat);
+            } else if (inFeature && key == "tec") {
+                readNumber(p, end, tec);
+            } else if (!inFeature && key == "features" && value < end && *value == '[') {
+                p = value + 1;
+                ++depth;
+                featureDepth = depth + 1;
+            }
+            break;
+        }
+        case '{':
+        case '[':
+            ++depth;
+            if (c == '{' && depth == featureDepth) {
+                inFeature = true;
+                hasCoordinates = false;
+                tec = 0.0f;
+            }
+            break;
+        case '}':
+        case ']':
+            if (c == '}' && inFeature && depth == featureDepth) {
+                inFeature = false;
+                if (hasCoordinates) {
+                    grid.add(lon, lat, tec);
+                }
+            }
+            --depth;
+            break;
+        default:
+            break;
         }
     }
 
+    if (!grid.finish()) {
+        data.tecValues.clear();
+        return false;
+    }
+
     data.isValid = true;
     return true;
 }
 
+bool NOAAGlotecReader::loadGeoJsonFile(const std::string& filename, GlotecData& data) const {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        return false;
+    }
+    return parseGeoJson(file.view(), data);
+}
+
+// ========== Grid Lookup ==========
+
 int NOAAGlotecReader::getGridIndex(int col, int row, int numCols) const {
     return col + row * numCols;
 }
@@ -193,69 +399,73 @@ bool NOAAGlotecReader::getTecAtLocation(const GlotecData& data, double lat, doub
     return true;
 }
 
+// ========== Fetch ==========
+
 bool NOAAGlotecReader::fetchTecData(const std::tm& requestTime, GlotecData& data) {
-    std::string url = getDataUrl(requestTime);
-    std::string jsonContent;
-    int statusCode = 0;
-    std::string errorMsg;
-
-    if (!SimpleHttpClient::fetchUrlWithStatus(url, jsonContent, statusCode, errorMsg)) {
-        std::cout << "[DEBUG] First attempt failed: " << errorMsg << std::endl;
-
-        std::tm roundedTime = roundToNearest5Minutes(requestTime, false);
-        url = getDataUrl(roundedTime);
-        std::cout << "[DEBUG] Trying alternate URL: " << url << std::endl;
-
-        if (!SimpleHttpClient::fetchUrlWithStatus(url, jsonContent, statusCode, errorMsg)) {
-            std::cout << "[DEBUG] Second attempt failed: " << errorMsg << std::endl;
-
-            if (statusCode == 404) {
-                std::cout << "[DEBUG] Data not available yet (404), trying recent historical data..." << std::endl;
-
-                for (int minutesBack = 10; minutesBack <= 30; minutesBack += 10) {
-                    std::tm historicalTime = requestTime;
-                    historicalTime.tm_min -= minutesBack;
-
-                    if (historicalTime.tm_min < 0) {
-                        historicalTime.tm_min += 60;
-                        historicalTime.tm_hour -= 1;
-                        if (historicalTime.tm_hour < 0) {
-                            historicalTime.tm_hour += 24;
-                            historicalTime.tm_mday -= 1;
-                        }
-                    }
+    const std::tm slot = roundToNearest5Minutes(requestTime, true);
 
-                    std::tm roundedHistorical = roundToNearest5Minutes(historicalTime, true);
-                    url = getDataUrl(roundedHistorical);
+    if (m_cache && m_cache->loadGlotec(slot, data)) {
+        return true;
+    }
 
-                    std::cout << "[DEBUG] Trying " << minutesBack << " minute(s) back: " << url << std::endl;
+    if (fetchFromNetwork(requestTime, data)) {
+        if (m_cache) {
+            m_cache->storeGlotec(slot, data);
+        }
+        return true;
+    }
 
-                    if (SimpleHttpClient::fetchUrlWithStatus(url, jsonContent, statusCode, errorMsg)) {
-                        std::cout << "[DEBUG] Found data from " << minutesBack << " minute(s) ago" << std::endl;
-                        data.timestamp = roundedHistorical;
-                        bool parseSuccess = parseGeoJson(jsonContent, data);
-                        if (parseSuccess) {
-                            std::cout << "[!] Using data from " << minutesBack << " minute(s) ago (NOAA data has ~10-30 min delay)" << std::endl;
-                        }
-                        return parseSuccess;
-                    }
-                }
+    if (m_cache && m_cache->loadGlotec(slot, data, true)) {
+        std::cout << "[!] GLOTEC download failed, using expired cached grid" << std::endl;
+        return true;
+    }
 
-                std::cout << "[DEBUG] No data found in past 30 minutes" << std::endl;
-            }
+    return false;
+}
 
-            return false;
+bool NOAAGlotecReader::fetchFromNetwork(const std::tm& requestTime, GlotecData& data) {
+    // Candidates in order of preference: the requested slot, the slot
+    // rounded the other way, then up to 30 minutes back (NOAA products
+    // appear with a 10-30 minute delay). All are requested at once and the
+    // first available one in this order wins.
+    const std::tm slot = roundToNearest5Minutes(requestTime, true);
+    std::vector<std::tm> slots = {slot, slot};
+    std::vector<std::string> urls = {getDataUrl(slot), getDataUrl(roundToNearest5Minutes(requestTime, false))};
+    for (int minutesBack = 10; minutesBack <= 30; minutesBack += 10) {
+        std::tm historicalTime = requestTime;
+        historicalTime.tm_min -= minutesBack;
+
+        if (historicalTime.tm_min < 0) {
+            historicalTime.tm_min += 60;
+            historicalTime.tm_hour -= 1;
+            if (historicalTime.tm_hour < 0) {
+                historicalTime.tm_hour += 24;
+                historicalTime.tm_mday -= 1;
+            }
         }
+
+        slots.push_back(roundToNearest5Minutes(historicalTime, true));
+        urls.push_back(getDataUrl(slots.back()));
+    }
+
+    HttpResult response;
+    const int winner = HttpSession::shared().fetchFirst(urls, response);
+    if (winner < 0) {
+        std::cout << "[DEBUG] No GLOTEC data found in past 30 minutes: " << response.errorMsg << std::endl;
+        return false;
     }
 
-    std::cout << "[DEBUG] HTTP 200 OK, response size: " << jsonContent.length() << " bytes" << std::endl;
+    std::cout << "[DEBUG] HTTP 200 OK, response size: " << response.body.length() << " bytes" << std::endl;
 
-    data.timestamp = roundToNearest5Minutes(requestTime, true);
-    bool parseSuccess = parseGeoJson(jsonContent, data);
+    data.timestamp = slots[winner];
+    bool parseSuccess = parseGeoJson(response.body, data);
 
     if (!parseSuccess) {
         std::cout << "[DEBUG] GeoJSON parsing failed" << std::endl;
-        std::cout << "[DEBUG] First 200 chars: " << jsonContent.substr(0, 200) << std::endl;
+        std::cout << "[DEBUG] First 200 chars: " << response.body.substr(0, 200) << std::endl;
+    } else if (winner >= 2) {
+        std::cout << "[!] Using data from " << (winner - 1) * 10
+                  << " minute(s) ago (NOAA data has ~10-30 min delay)" << std::endl;
     }
 
     return parseSuccess;
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <ctime>
+#include <memory>
+
+class DataCache;
 
 struct GlotecData {
     std::vector<float> tecValues;
@@ -25,18 +29,29 @@ class NOAAGlotecReader {
 public:
     NOAAGlotecReader();
 
+    // Cache hits skip the network; stale entries are used only when every fetch fails.
     bool fetchTecData(const std::tm& requestTime, GlotecData& data);
 
+    void setCache(std::shared_ptr<DataCache> cache) { m_cache = std::move(cache); }
+
     bool getTecAtLocation(const GlotecData& data, double lat, double lon, double& tec);
 
     std::string getDataUrl(const std::tm& time) const;
 
+    // Single-pass parse of a GLOTEC GeoJSON body. The grid origin, spacing and
+    // size are taken from the leading features; out-of-order files are regridded.
+    bool parseGeoJson(std::string_view jsonContent, GlotecData& data) const;
+
+    // Parses a recorded GeoJSON file through a read-only mapping.
+    bool loadGeoJsonFile(const std::string& filename, GlotecData& data) const;
+
 private:
     std::string m_baseUrl;
+    std::shared_ptr<DataCache> m_cache;
 
     std::tm roundToNearest5Minutes(const std::tm& time, bool roundDown) const;
 
-    bool parseGeoJson(const std::string& jsonContent, GlotecData& data);
+    bool fetchFromNetwork(const std::tm& requestTime, GlotecData& data);
 
     double bilinearInterpolate(const GlotecData& data, double lat, double lon) const;
 
@@ -1,4 +1,5 @@
 #include "NoiseCalculator.h"
+#include "DataRegistry.h"
 #include <cmath>
 #include <algorithm>
 
@@ -9,15 +10,21 @@
 // ========== NoiseCalculator Implementation ==========
 
 NoiseCalculator::NoiseCalculator() {
+    // A cached model avoids loading the FITS map at all.
+    if (std::shared_ptr<const SkySpectralModel> model = DataRegistry::shared().skyModel()) {
+        m_skyModel.setSpectralModel(std::move(model));
+    } else {
+        m_skyModel.setSkyMap(DataRegistry::shared().skyMap());
+    }
 }
 
 double NoiseCalculator::calculateSkyNoiseTemp(
     double frequency_MHz,
     double moonRA_deg,
-    double moonDEC_deg) {
+    double moonDEC_deg,
+    double beamwidth_deg) {
 
-    SkyNoiseModel skyModel;
-    return skyModel.getSkyTemp(frequency_MHz, moonRA_deg, moonDEC_deg);
+    return m_skyModel.getSkyTemp(frequency_MHz, moonRA_deg, moonDEC_deg, beamwidth_deg);
 }
 
 double NoiseCalculator::calculateGroundSpilloverTemp(
@@ -103,10 +110,36 @@ NoiseResults NoiseCalculator::calculate(
     double physicalTemp_K,
     bool includeGroundSpillover) {
 
+    return calculateWithReceiverTemp(
+        frequency_MHz,
+        bandwidth_Hz,
+        rxGain_dBi,
+        feedlineLoss_dB,
+        calculateReceiverNoiseTemp(noiseFigure_dB),
+        elevation_deg,
+        moonRA_deg,
+        moonDEC_deg,
+        physicalTemp_K,
+        includeGroundSpillover);
+}
+
+NoiseResults NoiseCalculator::calculateWithReceiverTemp(
+    double frequency_MHz,
+    double bandwidth_Hz,
+    double rxGain_dBi,
+    double feedlineLoss_dB,
+    double receiverNoiseTemp_K,
+    double elevation_deg,
+    double moonRA_deg,
+    double moonDEC_deg,
+    double physicalTemp_K,
+    bool includeGroundSpillover) {
+
     NoiseResults results;
 
     results.skyNoiseTemp_K = calculateSkyNoiseTemp(
-        frequency_MHz, moonRA_deg, moonDEC_deg);
+        frequency_MHz, moonRA_deg, moonDEC_deg,
+        SkyNoiseModel::beamwidthFromGain(rxGain_dBi));
 
     if (includeGroundSpillover) {
         results.groundSpilloverTemp_K = calculateGroundSpilloverTemp(
@@ -127,7 +160,7 @@ NoiseResults NoiseCalculator::calculate(
         feedlineLoss_dB,
         physicalTemp_K);
 
-    results.receiverNoiseTemp_K = calculateReceiverNoiseTemp(noiseFigure_dB);
+    results.receiverNoiseTemp_K = receiverNoiseTemp_K;
 
     results.systemNoiseTemp_K =
         results.antennaEffectiveTemp_K +
@@ -145,13 +178,13 @@ NoiseResults NoiseCalculator::calculate(
 // ========== SkyNoiseModel Implementation ==========
 
 SkyNoiseModel::SkyNoiseModel()
-    : m_haslamMap(nullptr), m_skyMapLoaded(false) {
+    : m_haslamMap(nullptr) {
 }
 
 SkyNoiseModel::~SkyNoiseModel() {
 }
 
-double SkyNoiseModel::estimateGalacticLatitude(double ra_deg, double dec_deg) {
+double SkyNoiseModel::estimateGalacticLatitude(double ra_deg, double dec_deg) const {
 
 double galacticLat_approx = std::abs(dec_deg);
 
@@ -164,7 +197,7 @@ if (ra_deg > 240.0 && ra_deg < 300.0) {
 
 double SkyNoiseModel::calculateSkyTemp_Simplified(
     double frequency_MHz,
-    double galacticLatitude_deg) {
+    double galacticLatitude_deg) const {
 
     // Get 408 MHz temperature based on galactic latitude
     double T_408;
@@ -192,10 +225,18 @@ double SkyNoiseModel::calculateSkyTemp_Simplified(
 double SkyNoiseModel::getSkyTemp(
     double frequency_MHz,
     double ra_deg,
-    double dec_deg) {
+    double dec_deg,
+    double beamwidth_deg) const {
 
-    if (m_skyMapLoaded && m_haslamMap && m_haslamMap->isLoaded()) {
-        double T_408 = m_haslamMap->getTemperature(ra_deg, dec_deg);
+    if (m_spectralModel && m_spectralModel->isLoaded()) {
+        double T_sky = m_spectralModel->getBeamTemperature(ra_deg, dec_deg, beamwidth_deg, frequency_MHz);
+        if (T_sky > 0.0) {
+            return T_sky;
+        }
+    }
+
+    if (m_haslamMap && m_haslamMap->isLoaded()) {
+        double T_408 = m_haslamMap->getBeamTemperature(ra_deg, dec_deg, beamwidth_deg);
         if (T_408 > 0.0) {
             return T_408 * std::pow(frequency_MHz / 408.0, SPECTRAL_INDEX);
         }
@@ -205,12 +246,31 @@ double SkyNoiseModel::getSkyTemp(
     return calculateSkyTemp_Simplified(frequency_MHz, galacticLat);
 }
 
+double SkyNoiseModel::beamwidthFromGain(double gain_dBi) {
+    // D = 4 pi / Omega with Omega = (pi / (4 ln 2)) * HPBW^2 for a Gaussian beam.
+    double gainLinear = std::pow(10.0, gain_dBi / 10.0);
+    double omega = 4.0 * M_PI / gainLinear;
+    return std::sqrt(omega * 4.0 * std::log(2.0) / M_PI) * 180.0 / M_PI;
+}
+
 bool SkyNoiseModel::loadSkyMap(const std::string& mapPath) {
-    m_haslamMap = std::make_unique<HaslamSkyMap>();
-    m_skyMapLoaded = m_haslamMap->loadFITS(mapPath);
-    return m_skyMapLoaded;
+    auto map = std::make_shared<HaslamSkyMap>();
+    if (!map->loadFITS(mapPath)) {
+        m_haslamMap.reset();
+        return false;
+    }
+    m_haslamMap = std::move(map);
+    return true;
+}
+
+void SkyNoiseModel::setSkyMap(std::shared_ptr<const HaslamSkyMap> map) {
+    m_haslamMap = std::move(map);
+}
+
+void SkyNoiseModel::setSpectralModel(std::shared_ptr<const SkySpectralModel> model) {
+    m_spectralModel = std::move(model);
 }
 
 bool SkyNoiseModel::isMapLoaded() const {
-    return m_skyMapLoaded && m_haslamMap && m_haslamMap->isLoaded();
+    return m_haslamMap && m_haslamMap->isLoaded();
 }
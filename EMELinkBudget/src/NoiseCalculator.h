@@ -2,10 +2,55 @@
 
 #include "LinkBudgetTypes.h"
 #include "HaslamSkyMap.h"
+#include "SkySpectralModel.h"
 #include <cmath>
 #include <string>
 #include <memory>
 
+class SkyNoiseModel {
+public:
+    SkyNoiseModel();
+    ~SkyNoiseModel();
+
+    // beamwidth_deg is the antenna's half-power beamwidth; 0 samples the map
+    // at a single point.
+    double getSkyTemp(
+        double frequency_MHz,
+        double ra_deg,
+        double dec_deg,
+        double beamwidth_deg = 0.0) const;
+
+    // Half-power beamwidth of a Gaussian beam with the given directivity.
+    static double beamwidthFromGain(double gain_dBi);
+
+    bool loadSkyMap(const std::string& mapPath);
+    // Shares an already loaded map, e.g. DataRegistry::skyMap(); null
+    // selects the simplified model.
+    void setSkyMap(std::shared_ptr<const HaslamSkyMap> map);
+    const std::shared_ptr<const HaslamSkyMap>& getSkyMap() const { return m_haslamMap; }
+    bool isMapLoaded() const;
+
+    // Per-pixel spectral indices; used in preference to the map and the
+    // fixed index when set.
+    void setSpectralModel(std::shared_ptr<const SkySpectralModel> model);
+    const std::shared_ptr<const SkySpectralModel>& getSpectralModel() const { return m_spectralModel; }
+
+private:
+    double calculateSkyTemp_Simplified(
+        double frequency_MHz,
+        double galacticLatitude_deg) const;
+
+    double estimateGalacticLatitude(double ra_deg, double dec_deg) const;
+
+    std::shared_ptr<const HaslamSkyMap> m_haslamMap;
+    std::shared_ptr<const SkySpectralModel> m_spectralModel;
+    static constexpr double T_SKY_408_COLD = 20.0;
+    static constexpr double T_SKY_408_WARM = 150.0;
+    static constexpr double SPECTRAL_INDEX = -2.55;
+};
+
+// Takes the sky model, or failing that the sky map, from
+// DataRegistry::shared() when constructed.
 class NoiseCalculator {
 public:
     NoiseCalculator();
@@ -22,10 +67,29 @@ public:
         double physicalTemp_K = 290.0,
         bool includeGroundSpillover = true);
 
+    // Same as calculate(), with the receiver noise temperature supplied by
+    // the caller so the noise-figure conversion can be done once per pass.
+    NoiseResults calculateWithReceiverTemp(
+        double frequency_MHz,
+        double bandwidth_Hz,
+        double rxGain_dBi,
+        double feedlineLoss_dB,
+        double receiverNoiseTemp_K,
+        double elevation_deg,
+        double moonRA_deg,
+        double moonDEC_deg,
+        double physicalTemp_K = 290.0,
+        bool includeGroundSpillover = true);
+
     double calculateSkyNoiseTemp(
         double frequency_MHz,
         double moonRA_deg,
-        double moonDEC_deg);
+        double moonDEC_deg,
+        double beamwidth_deg = 0.0);
+
+    void setSkyMap(std::shared_ptr<const HaslamSkyMap> map) { m_skyModel.setSkyMap(std::move(map)); }
+    void setSpectralModel(std::shared_ptr<const SkySpectralModel> model) { m_skyModel.setSpectralModel(std::move(model)); }
+    const SkyNoiseModel& getSkyNoiseModel() const { return m_skyModel; }
 
     double calculateGroundSpilloverTemp(
         double elevation_deg,
@@ -47,32 +111,7 @@ public:
         double bandwidth_Hz);
 
 private:
-static constexpr double BOLTZMANN_CONSTANT = 1.38064852e-23;
-};
+    SkyNoiseModel m_skyModel;
 
-class SkyNoiseModel {
-public:
-    SkyNoiseModel();
-    ~SkyNoiseModel();
-
-    double getSkyTemp(
-        double frequency_MHz,
-        double ra_deg,
-        double dec_deg);
-
-    bool loadSkyMap(const std::string& mapPath);
-    bool isMapLoaded() const;
-
-private:
-    double calculateSkyTemp_Simplified(
-        double frequency_MHz,
-        double galacticLatitude_deg);
-
-    double estimateGalacticLatitude(double ra_deg, double dec_deg);
-
-    std::unique_ptr<HaslamSkyMap> m_haslamMap;
-    bool m_skyMapLoaded;
-    static constexpr double T_SKY_408_COLD = 20.0;
-    static constexpr double T_SKY_408_WARM = 150.0;
-    static constexpr double SPECTRAL_INDEX = -2.55;
+static constexpr double BOLTZMANN_CONSTANT = 1.38064852e-23;
 };
@@ -0,0 +1,206 @@
+#include "ParameterSweep.h"
+#include "EMELinkBudget.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+template <typename T>
+std::size_t axisSize(const std::vector<T>& axis) {
+    return axis.empty() ? 1 : axis.size();
+}
+
+// Pops the next axis digit off a mixed-radix index (fastest axis first).
+template <typename T>
+const T* takeAxis(const std::vector<T>& axis, std::size_t& index) {
+    if (axis.empty()) {
+        return nullptr;
+    }
+    const std::size_t digit = index % axis.size();
+    index /= axis.size();
+    return &axis[digit];
+}
+
+// One per worker, padded so neighbouring cursors never share a cache line.
+struct alignas(64) WorkSlice {
+    std::atomic<std::size_t> next;
+    std::size_t end;
+
+    WorkSlice() : next(0), end(0) {}
+
+    bool claim(std::size_t chunk, std::size_t& begin, std::size_t& stop) {
+        if (next.load(std::memory_order_relaxed) >= end) {
+            return false;
+        }
+        begin = next.fetch_add(chunk, std::memory_order_relaxed);
+        if (begin >= end) {
+            return false;
+        }
+        stop = std::min(begin + chunk, end);
+        return true;
+    }
+
+    std::size_t remaining() const {
+        const std::size_t n = next.load(std::memory_order_relaxed);
+        return n < end ? end - n : 0;
+    }
+};
+
+// Rows whose strings differ from the pre-interned defaults; resolved after join.
+struct StringOverride {
+    std::size_t row;
+    std::string ephemerisSource;
+    std::string errorMessage;
+};
+
+} // namespace
+
+// ========== Sweep Grid ==========
+
+std::size_t SweepGrid::size() const {
+    return axisSize(stationPairs) *
+           axisSize(frequencies_MHz) *
+           axisSize(txPowers_dBm) *
+           axisSize(txGains_dBi) *
+           axisSize(rxGains_dBi) *
+           axisSize(polarizations);
+}
+
+LinkBudgetParameters SweepGrid::at(std::size_t index) const {
+    LinkBudgetParameters params = base;
+
+    const PolarizationSetting* pol = takeAxis(polarizations, index);
+    const double* rxGain = takeAxis(rxGains_dBi, index);
+    const double* txGain = takeAxis(txGains_dBi, index);
+    const double* txPower = takeAxis(txPowers_dBm, index);
+    const double* freq = takeAxis(frequencies_MHz, index);
+    const StationPair* pair = takeAxis(stationPairs, index);
+
+    if (pair) {
+        params.txSite = pair->txSite;
+        params.rxSite = pair->rxSite;
+    }
+    if (freq) params.frequency_MHz = *freq;
+    if (txPower) params.txPower_dBm = *txPower;
+    if (txGain) params.txGain_dBi = *txGain;
+    if (rxGain) params.rxGain_dBi = *rxGain;
+    if (pol) {
+        params.txSite.psi = pol->txPsi;
+        params.txSite.chi = pol->txChi;
+        params.rxSite.psi = pol->rxPsi;
+        params.rxSite.chi = pol->rxChi;
+    }
+
+    return params;
+}
+
+// ========== Parameter Sweep Executor ==========
+
+ParameterSweep::ParameterSweep(unsigned numThreads)
+    : m_numThreads(numThreads), m_chunkSize(16), m_traceSink() {
+    if (m_numThreads == 0) {
+        m_numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+void ParameterSweep::setChunkSize(std::size_t chunkSize) {
+    m_chunkSize = std::max<std::size_t>(1, chunkSize);
+}
+
+LinkBudgetResultsBatch ParameterSweep::run(const SweepGrid& grid) {
+    LinkBudgetResultsBatch results;
+    run(grid, results);
+    return results;
+}
+
+void ParameterSweep::run(const SweepGrid& grid, LinkBudgetResultsBatch& results) {
+    const std::size_t total = grid.size();
+    results.resize(total);
+    if (total == 0) {
+        return;
+    }
+
+    const std::uint32_t defaultSourceId = results.intern(grid.base.moonEphemeris.ephemerisSource);
+    const std::string& defaultSource = results.string(defaultSourceId);
+    std::fill(results.geometry.ephemerisSourceId.begin(),
+              results.geometry.ephemerisSourceId.end(), defaultSourceId);
+    std::fill(results.errorMessageId.begin(), results.errorMessageId.end(), 0u);
+
+    const std::size_t workerCount = std::min<std::size_t>(m_numThreads, total);
+    const std::size_t chunk = m_chunkSize;
+
+    std::unique_ptr<WorkSlice[]> slices(new WorkSlice[workerCount]);
+    for (std::size_t w = 0; w < workerCount; ++w) {
+        slices[w].next.store(total * w / workerCount, std::memory_order_relaxed);
+        slices[w].end = total * (w + 1) / workerCount;
+    }
+
+    std::vector<std::vector<StringOverride>> overrides(workerCount);
+
+    auto worker = [&](std::size_t self) {
+        EMELinkBudget calculator;
+        calculator.getPolarizationModule().getFaradayCalculator().setTraceSink(m_traceSink);
+        std::vector<StringOverride>& local = overrides[self];
+
+        auto evaluate = [&](std::size_t begin, std::size_t stop) {
+            for (std::size_t i = begin; i < stop; ++i) {
+                const LinkBudgetParameters params = grid.at(i);
+                calculator.setParameters(params);
+                const LinkBudgetResults& r = calculator.calculate();
+                results.setValues(i, r, params.observationTime);
+
+                if (!r.errorMessage.empty() || r.geometry.ephemerisSource != defaultSource) {
+                    local.push_back({i, r.geometry.ephemerisSource, r.errorMessage});
+                }
+            }
+        };
+
+        std::size_t begin = 0;
+        std::size_t stop = 0;
+        while (slices[self].claim(chunk, begin, stop)) {
+            evaluate(begin, stop);
+        }
+
+        // Own slice drained: steal from whichever slice has the most left.
+        for (;;) {
+            std::size_t victim = workerCount;
+            std::size_t most = 0;
+            for (std::size_t w = 0; w < workerCount; ++w) {
+                const std::size_t left = slices[w].remaining();
+                if (left > most) {
+                    most = left;
+                    victim = w;
+                }
+            }
+            if (victim == workerCount) {
+                break;
+            }
+            if (slices[victim].claim(chunk, begin, stop)) {
+                evaluate(begin, stop);
+            }
+        }
+    };
+
+    if (workerCount == 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(workerCount);
+        for (std::size_t w = 0; w < workerCount; ++w) {
+            threads.emplace_back(worker, w);
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+    }
+
+    for (const std::vector<StringOverride>& local : overrides) {
+        for (const StringOverride& o : local) {
+            results.geometry.ephemerisSourceId[o.row] = results.intern(o.ephemerisSource);
+            results.errorMessageId[o.row] = results.intern(o.errorMessage);
+        }
+    }
+}
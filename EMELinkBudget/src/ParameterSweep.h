@@ -0,0 +1,75 @@
+#pragma once
+
+#include "LinkBudgetTypes.h"
+#include "LinkBudgetResultsBatch.h"
+#include "PolarizationTrace.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// ========== Sweep Axes ==========
+struct StationPair {
+    SiteParameters txSite;
+    SiteParameters rxSite;
+};
+
+struct PolarizationSetting {
+    double txPsi;
+    double txChi;
+    double rxPsi;
+    double rxChi;
+
+    PolarizationSetting()
+        : txPsi(0.0), txChi(0.0), rxPsi(0.0), rxChi(0.0) {}
+
+    PolarizationSetting(double txPsi_, double txChi_, double rxPsi_, double rxChi_)
+        : txPsi(txPsi_), txChi(txChi_), rxPsi(rxPsi_), rxChi(rxChi_) {}
+};
+
+// ========== Sweep Grid ==========
+// Cartesian product of parameter overrides applied on top of `base`.
+// An empty axis keeps the base value. Row index order is
+// stationPair, frequency, txPower, txGain, rxGain, polarization,
+// with polarization varying fastest.
+struct SweepGrid {
+    LinkBudgetParameters base;
+
+    std::vector<StationPair> stationPairs;
+    std::vector<double> frequencies_MHz;
+    std::vector<double> txPowers_dBm;
+    std::vector<double> txGains_dBi;
+    std::vector<double> rxGains_dBi;
+    std::vector<PolarizationSetting> polarizations;
+
+    std::size_t size() const;
+    LinkBudgetParameters at(std::size_t index) const;
+};
+
+// ========== Parameter Sweep Executor ==========
+// Evaluates every grid point on a pool of worker threads. Each worker owns
+// its own EMELinkBudget, starts on a contiguous slice of the grid and steals
+// chunks from the busiest remaining slice once its own is drained. Results
+// are written straight into the row of a preallocated batch.
+class ParameterSweep {
+public:
+    // numThreads == 0 uses std::thread::hardware_concurrency().
+    explicit ParameterSweep(unsigned numThreads = 0);
+
+    LinkBudgetResultsBatch run(const SweepGrid& grid);
+    // Resizes `results` to grid.size() and fills it in place.
+    void run(const SweepGrid& grid, LinkBudgetResultsBatch& results);
+
+    unsigned getThreadCount() const { return m_numThreads; }
+
+    // Number of grid points claimed per work-queue access.
+    void setChunkSize(std::size_t chunkSize);
+    std::size_t getChunkSize() const { return m_chunkSize; }
+
+    // Attached to every worker's polarization calculator; must be thread-safe.
+    void setTraceSink(std::shared_ptr<PolarizationTraceSink> sink) { m_traceSink = std::move(sink); }
+
+private:
+    unsigned m_numThreads;
+    std::size_t m_chunkSize;
+    std::shared_ptr<PolarizationTraceSink> m_traceSink;
+};
@@ -146,6 +146,15 @@ double PathLossCalculator::calculateLunarScatteringLossHagfors(
     // Calculate frequency-dependent roughness parameter
     roughnessParam = calculateHagforsRoughnessParameter(frequency_MHz);
 
+    return calculateLunarScatteringLossHagfors(
+        bistaticAngle_deg, roughnessParam, rcs_dBsm);
+}
+
+double PathLossCalculator::calculateLunarScatteringLossHagfors(
+    double bistaticAngle_deg,
+    double roughnessParam,
+    double& rcs_dBsm) {
+
     // Convert bistatic angle to radians
     double bistaticAngle_rad = bistaticAngle_deg * M_PI / 180.0;
 
@@ -184,6 +193,25 @@ PathLossResults PathLossCalculator::calculate(
     bool includeAtmospheric,
     bool useHagforsModel) {
 
+    return calculateWithRoughness(
+        frequency_MHz,
+        distance_TX_km, distance_RX_km,
+        elevation_TX_deg, elevation_RX_deg,
+        calculateHagforsRoughnessParameter(frequency_MHz),
+        includeAtmospheric,
+        useHagforsModel);
+}
+
+PathLossResults PathLossCalculator::calculateWithRoughness(
+    double frequency_MHz,
+    double distance_TX_km,
+    double distance_RX_km,
+    double elevation_TX_deg,
+    double elevation_RX_deg,
+    double hagforsRoughnessParam,
+    bool includeAtmospheric,
+    bool useHagforsModel) {
+
     PathLossResults results;
 
     double frequency_Hz = frequency_MHz * 1e6;
@@ -207,11 +235,11 @@ PathLossResults PathLossCalculator::calculate(
             distance_TX_km, distance_RX_km);
 
         // Use Hagfors' Law
+        results.hagforsRoughnessParam = hagforsRoughnessParam;
         results.lunarScatteringLoss_dB = calculateLunarScatteringLossHagfors(
-            frequency_MHz,
             results.bistaticAngle_deg,
-            results.lunarRCS_dBsm,
-            results.hagforsRoughnessParam);
+            results.hagforsRoughnessParam,
+            results.lunarRCS_dBsm);
 
         results.hagforsGain_dB = -results.lunarScatteringLoss_dB;
     } else {
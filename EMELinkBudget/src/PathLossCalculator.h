@@ -17,6 +17,20 @@ public:
         bool includeAtmospheric = true,
         bool useHagforsModel = true);
 
+    // Same as calculate(), with the frequency-dependent Hagfors roughness
+    // supplied by the caller so it can be looked up once per pass.
+    PathLossResults calculateWithRoughness(
+        double frequency_MHz,
+        double distance_TX_km,
+        double distance_RX_km,
+        double elevation_TX_deg,
+        double elevation_RX_deg,
+        double hagforsRoughnessParam,
+        bool includeAtmospheric = true,
+        bool useHagforsModel = true);
+
+    double calculateHagforsRoughnessParameter(double frequency_MHz);
+
     double calculateFreeSpaceLoss(
         double frequency_MHz,
         double distance_km);
@@ -50,10 +64,13 @@ private:
     double deg2rad(double degrees) const;
 
     // Hagfors model helper functions
-    double calculateHagforsRoughnessParameter(double frequency_MHz);
     double calculateHagforsScatteringCrossSection(
         double bistaticAngle_rad,
         double roughnessParam);
+    double calculateLunarScatteringLossHagfors(
+        double bistaticAngle_deg,
+        double roughnessParam,
+        double& rcs_dBsm);
 };
 
 // ========== Atmospheric Model ==========
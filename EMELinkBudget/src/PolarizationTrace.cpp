@@ -0,0 +1,73 @@
+#include "PolarizationTrace.h"
+#include <algorithm>
+
+// ========== Ring Buffer Sink ==========
+
+RingBufferTraceSink::RingBufferTraceSink(std::size_t capacity)
+    : m_capacity(std::max<std::size_t>(1, capacity)), m_next(0), m_total(0) {
+    m_buffer.reserve(m_capacity);
+}
+
+void RingBufferTraceSink::record(const PolarizationTrace& trace) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_buffer.size() < m_capacity) {
+        m_buffer.push_back(trace);
+    } else {
+        m_buffer[m_next] = trace;
+    }
+    m_next = (m_next + 1) % m_capacity;
+    ++m_total;
+}
+
+std::vector<PolarizationTrace> RingBufferTraceSink::snapshot() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_buffer.size() < m_capacity) {
+        return m_buffer;
+    }
+
+    std::vector<PolarizationTrace> ordered;
+    ordered.reserve(m_capacity);
+    ordered.insert(ordered.end(), m_buffer.begin() + m_next, m_buffer.end());
+    ordered.insert(ordered.end(), m_buffer.begin(), m_buffer.begin() + m_next);
+    return ordered;
+}
+
+std::size_t RingBufferTraceSink::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_buffer.size();
+}
+
+std::size_t RingBufferTraceSink::totalRecorded() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_total;
+}
+
+void RingBufferTraceSink::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_buffer.clear();
+    m_next = 0;
+    m_total = 0;
+}
+
+// ========== Stream Sink ==========
+
+OStreamTraceSink::OStreamTraceSink(std::ostream& out)
+    : m_out(out) {
+}
+
+void OStreamTraceSink::record(const PolarizationTrace& trace) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_out << "\n[DEBUG] Polarization Calculation Details:\n";
+    m_out << "  TX psi: " << trace.txPsi_deg << " deg, chi: " << trace.txChi_deg << " deg\n";
+    m_out << "  RX psi: " << trace.rxPsi_deg << " deg, chi: " << trace.rxChi_deg << " deg\n";
+    m_out << "  Parallactic angle TX: " << trace.parallacticAngle_TX_deg << " deg\n";
+    m_out << "  Parallactic angle RX: " << trace.parallacticAngle_RX_deg << " deg\n";
+    m_out << "  Phi_up (TX rotation): " << trace.Phi_up_deg << " deg\n";
+    m_out << "  Phi_down (RX rotation): " << trace.Phi_down_deg << " deg\n";
+    m_out << "  Total rotation: " << trace.totalRotation_deg << " deg\n";
+    m_out << "  J_TX: [" << trace.J_TX[0] << ", " << trace.J_TX[1] << "]\n";
+    m_out << "  J_RX: [" << trace.J_RX[0] << ", " << trace.J_RX[1] << "]\n";
+    m_out << "  E_final: [" << trace.E_final[0] << ", " << trace.E_final[1] << "]\n";
+    m_out << "  Inner product: " << trace.innerProduct << "\n";
+    m_out << "  PLF: " << trace.PLF << "\n\n";
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+using JonesVector = std::array<std::complex<double>, 2>;
+using Matrix2x2 = std::array<std::array<std::complex<double>, 2>, 2>;
+
+// ========== Polarization Trace Record ==========
+// Intermediate values of one FaradayRotation::calculate() evaluation.
+struct PolarizationTrace {
+    double txPsi_deg;
+    double txChi_deg;
+    double rxPsi_deg;
+    double rxChi_deg;
+    double parallacticAngle_TX_deg;
+    double parallacticAngle_RX_deg;
+    double Phi_up_deg;
+    double Phi_down_deg;
+    double totalRotation_deg;
+
+    JonesVector J_TX;
+    JonesVector J_RX;
+    JonesVector E_final;
+    std::complex<double> innerProduct;
+    double PLF;
+
+    PolarizationTrace()
+        : txPsi_deg(0.0), txChi_deg(0.0), rxPsi_deg(0.0), rxChi_deg(0.0),
+          parallacticAngle_TX_deg(0.0), parallacticAngle_RX_deg(0.0),
+          Phi_up_deg(0.0), Phi_down_deg(0.0), totalRotation_deg(0.0),
+          J_TX{}, J_RX{}, E_final{}, innerProduct(0.0, 0.0), PLF(0.0) {}
+};
+
+// ========== Trace Sink Interface ==========
+// The calculator holds no sink by default and skips building the record
+// entirely; attach a sink only when the intermediate values are wanted.
+// A sink shared between calculators must be safe to call concurrently.
+class PolarizationTraceSink {
+public:
+    virtual ~PolarizationTraceSink() = default;
+    virtual void record(const PolarizationTrace& trace) = 0;
+};
+
+// ========== Ring Buffer Sink ==========
+// Keeps the last `capacity` records; safe to share across threads.
+class RingBufferTraceSink : public PolarizationTraceSink {
+public:
+    explicit RingBufferTraceSink(std::size_t capacity);
+
+    void record(const PolarizationTrace& trace) override;
+
+    // Oldest first.
+    std::vector<PolarizationTrace> snapshot() const;
+    std::size_t size() const;
+    std::size_t capacity() const { return m_capacity; }
+    // Total records seen, including those already overwritten.
+    std::size_t totalRecorded() const;
+    void clear();
+
+private:
+    const std::size_t m_capacity;
+    std::vector<PolarizationTrace> m_buffer;
+    std::size_t m_next;
+    std::size_t m_total;
+    mutable std::mutex m_mutex;
+};
+
+// ========== Stream Sink ==========
+// Formats each record as the former "[DEBUG] Polarization Calculation
+// Details" console block.
+class OStreamTraceSink : public PolarizationTraceSink {
+public:
+    explicit OStreamTraceSink(std::ostream& out);
+
+    void record(const PolarizationTrace& trace) override;
+
+private:
+    std::ostream& m_out;
+    std::mutex m_mutex;
+};
@@ -1,9 +1,21 @@
 #pragma once
 
+#include <functional>
 #include <string>
 
+// Requests go through the shared HttpSession (pooled connections, bounded
+// retries); see HttpSession for concurrent and candidate fetches.
 class SimpleHttpClient {
 public:
+    // Replaces the curl transport, e.g. with FileHttpTransport for offline tests.
+    // Same contract as fetchUrlWithStatus: true only for a non-empty 200 response.
+    using Transport = std::function<bool(const std::string& url, std::string& response,
+                                         int& statusCode, std::string& errorMsg)>;
+
     static bool fetchUrl(const std::string& url, std::string& response);
     static bool fetchUrlWithStatus(const std::string& url, std::string& response, int& statusCode, std::string& errorMsg);
+
+    static void setTransport(Transport transport);
+    static void resetTransport();
+    static Transport currentTransport();
 };
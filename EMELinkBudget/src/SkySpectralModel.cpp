@@ -0,0 +1,324 @@
+#include "SkySpectralModel.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+const char MAGIC[4] = {'E', 'M', 'S', 'K'};
+const std::size_t HEADER_BYTES = 24;
+const std::size_t LEVEL_BYTES = 24;
+const std::size_t DATA_ALIGN = 64;
+const std::uint32_t MAX_LEVELS = 32;
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T get(const char* data, std::size_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+void hashBytes(std::uint64_t& hash, const void* data, std::size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+}  // namespace
+
+// ========== Constructor ==========
+
+SkySpectralModel::SkySpectralModel() {
+}
+
+void SkySpectralModel::unload() {
+    m_levels.clear();
+    m_storage.clear();
+    m_file.close();
+}
+
+// ========== Building ==========
+
+bool SkySpectralModel::build(const HaslamSkyMap& reference, const std::vector<SkySurvey>& surveys) {
+    unload();
+    if (!reference.isLoaded()) {
+        return false;
+    }
+
+    std::vector<SkySurvey> used;
+    double widest = 0.0;
+    for (const SkySurvey& survey : surveys) {
+        if (survey.map && survey.map->isLoaded() && survey.frequency_MHz > 0.0 &&
+            survey.frequency_MHz != REFERENCE_MHZ) {
+            used.push_back(survey);
+            widest = std::max(widest, survey.map->getLevelBeam(0));
+        }
+    }
+
+    const float noData = -std::numeric_limits<float>::infinity();
+    m_storage.resize(reference.getPyramidLevels());
+    for (std::size_t k = 0; k < reference.getPyramidLevels(); ++k) {
+        Level level;
+        level.grid = HealpixGrid(reference.getLevelNside(k));
+        level.fwhm_deg = reference.getLevelBeam(k);
+        const std::vector<float>& source = reference.getLevelPixels(k);
+
+        // Every map is compared at the coarser of this level and the widest
+        // survey, so differing resolutions do not show up as spectral structure.
+        const double common = std::max(level.fwhm_deg, widest);
+        std::vector<Pixel>& pixels = m_storage[k];
+        pixels.resize(static_cast<std::size_t>(level.grid.getNpix()));
+        for (int64_t pix = 0; pix < level.grid.getNpix(); ++pix) {
+            const double t408 = source[pix];
+            Pixel& out = pixels[pix];
+            out.logT = t408 > 0.0 ? static_cast<float>(std::log(t408)) : noData;
+            out.beta = static_cast<float>(DEFAULT_SPECTRAL_INDEX);
+            if (used.empty() || t408 <= 0.0) {
+                continue;
+            }
+
+            double theta, phi;
+            level.grid.pix2angNest(pix, theta, phi);
+            const double ra = phi * 180.0 / PI;
+            const double dec = 90.0 - theta * 180.0 / PI;
+
+            double n = 0.0, sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+            auto add = [&](double x, double t) {
+                if (t <= 0.0) return;
+                const double y = std::log(t);
+                n += 1.0;
+                sx += x;
+                sy += y;
+                sxx += x * x;
+                sxy += x * y;
+            };
+            add(0.0, common > level.fwhm_deg ? reference.getBeamTemperature(ra, dec, common) : t408);
+            for (const SkySurvey& survey : used) {
+                add(std::log(survey.frequency_MHz / REFERENCE_MHZ), survey.map->getBeamTemperature(ra, dec, common));
+            }
+
+            const double denominator = n * sxx - sx * sx;
+            if (n >= 2.0 && denominator > 1e-12) {
+                const double beta = (n * sxy - sx * sy) / denominator;
+                out.beta = static_cast<float>(std::max(MIN_SPECTRAL_INDEX, std::min(MAX_SPECTRAL_INDEX, beta)));
+            }
+        }
+        level.pixels = pixels.data();
+        m_levels.push_back(level);
+    }
+    return true;
+}
+
+// ========== Cache File ==========
+
+std::uint64_t SkySpectralModel::sourceKey(const std::vector<SkySurveyFile>& files) {
+    std::uint64_t hash = 14695981039346656037ull;
+    hashBytes(hash, &FORMAT_VERSION, sizeof(FORMAT_VERSION));
+    for (const SkySurveyFile& file : files) {
+        std::error_code ec;
+        const std::uint64_t size = fs::file_size(file.path, ec);
+        const std::int64_t modified = ec ? 0 : static_cast<std::int64_t>(
+            fs::last_write_time(file.path, ec).time_since_epoch().count());
+        hashBytes(hash, file.path.data(), file.path.size() + 1);
+        hashBytes(hash, &size, sizeof(size));
+        hashBytes(hash, &modified, sizeof(modified));
+        hashBytes(hash, &file.frequency_MHz, sizeof(file.frequency_MHz));
+        hashBytes(hash, &file.beam_deg, sizeof(file.beam_deg));
+    }
+    return hash;
+}
+
+bool SkySpectralModel::save(const std::string& filename, std::uint64_t sourceKey) const {
+    if (m_levels.empty()) {
+        return false;
+    }
+
+    std::string header(MAGIC, 4);
+    put<std::uint32_t>(header, FORMAT_VERSION);
+    put<std::uint64_t>(header, sourceKey);
+    put<std::uint32_t>(header, static_cast<std::uint32_t>(m_levels.size()));
+    put<std::uint32_t>(header, 0);
+
+    std::uint64_t offset = HEADER_BYTES + LEVEL_BYTES * m_levels.size();
+    std::vector<std::uint64_t> offsets;
+    for (const Level& level : m_levels) {
+        offset = (offset + DATA_ALIGN - 1) / DATA_ALIGN * DATA_ALIGN;
+        offsets.push_back(offset);
+        put<std::int32_t>(header, level.grid.getNside());
+        put<std::uint32_t>(header, 0);
+        put<double>(header, level.fwhm_deg);
+        put<std::uint64_t>(header, offset);
+        offset += static_cast<std::uint64_t>(level.grid.getNpix()) * sizeof(Pixel);
+    }
+
+    // Written beside the target and renamed, so a reader never maps a
+    // partial file.
+    const std::string temporary = filename + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+        std::uint64_t written = header.size();
+        for (std::size_t k = 0; k < m_levels.size(); ++k) {
+            const std::string padding(offsets[k] - written, '\0');
+            out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+            const std::size_t bytes = static_cast<std::size_t>(m_levels[k].grid.getNpix()) * sizeof(Pixel);
+            out.write(reinterpret_cast<const char*>(m_levels[k].pixels), static_cast<std::streamsize>(bytes));
+            written = offsets[k] + bytes;
+        }
+        if (!out) {
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(temporary, filename, ec);
+    if (ec) {
+        fs::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
+
+bool SkySpectralModel::open(const std::string& filename, std::uint64_t sourceKey) {
+    unload();
+    if (!m_file.open(filename)) {
+        return false;
+    }
+
+    const char* data = m_file.data();
+    const std::size_t size = m_file.size();
+    if (size < HEADER_BYTES || std::memcmp(data, MAGIC, 4) != 0 ||
+        get<std::uint32_t>(data, 4) != FORMAT_VERSION || get<std::uint64_t>(data, 8) != sourceKey) {
+        unload();
+        return false;
+    }
+
+    const std::uint32_t count = get<std::uint32_t>(data, 16);
+    if (count == 0 || count > MAX_LEVELS || size < HEADER_BYTES + LEVEL_BYTES * count) {
+        unload();
+        return false;
+    }
+
+    std::vector<Level> levels;
+    for (std::uint32_t k = 0; k < count; ++k) {
+        const std::size_t entry = HEADER_BYTES + LEVEL_BYTES * k;
+        const std::int32_t nside = get<std::int32_t>(data, entry);
+        const double fwhm = get<double>(data, entry + 8);
+        const std::uint64_t offset = get<std::uint64_t>(data, entry + 16);
+        if (!HealpixGrid::isValidNside(nside) || !(fwhm > 0.0) ||
+            (!levels.empty() && fwhm <= levels.back().fwhm_deg)) {
+            unload();
+            return false;
+        }
+
+        Level level;
+        level.grid = HealpixGrid(nside);
+        level.fwhm_deg = fwhm;
+        const std::uint64_t bytes = static_cast<std::uint64_t>(level.grid.getNpix()) * sizeof(Pixel);
+        if (offset % DATA_ALIGN != 0 || offset > size || bytes > size - offset ||
+            reinterpret_cast<std::uintptr_t>(data + offset) % alignof(Pixel) != 0) {
+            unload();
+            return false;
+        }
+        level.pixels = reinterpret_cast<const Pixel*>(data + offset);
+        levels.push_back(level);
+    }
+
+    m_levels = std::move(levels);
+    return true;
+}
+
+// ========== Lookup ==========
+
+double SkySpectralModel::levelTemperature(const Level& level, double z, double phi, double logRatio) const {
+    const Pixel& p = level.pixels[level.grid.zphi2nest(z, phi)];
+    return std::exp(std::fma(static_cast<double>(p.beta), logRatio, static_cast<double>(p.logT)));
+}
+
+double SkySpectralModel::getTemperature(double ra_deg, double dec_deg, double frequency_MHz) const {
+    if (m_levels.empty() || frequency_MHz <= 0.0) return 0.0;
+    if (dec_deg < -90.0 || dec_deg > 90.0) return 0.0;
+    return levelTemperature(m_levels.front(), std::sin(dec_deg * PI / 180.0), ra_deg * PI / 180.0,
+                            std::log(frequency_MHz / REFERENCE_MHZ));
+}
+
+void SkySpectralModel::getTemperatures(const double* ra_deg, const double* dec_deg, double* temperature,
+                                       std::size_t n, double frequency_MHz) const {
+    if (m_levels.empty() || frequency_MHz <= 0.0) {
+        std::fill(temperature, temperature + n, 0.0);
+        return;
+    }
+
+    const Level& level = m_levels.front();
+    const double logRatio = std::log(frequency_MHz / REFERENCE_MHZ);
+    constexpr std::size_t BLOCK = 256;
+    double z[BLOCK], phi[BLOCK];
+    int64_t pix[BLOCK];
+    for (std::size_t first = 0; first < n; first += BLOCK) {
+        const std::size_t count = std::min(BLOCK, n - first);
+        for (std::size_t i = 0; i < count; ++i) {
+            const double dec = std::max(-90.0, std::min(90.0, dec_deg[first + i]));
+            z[i] = std::sin(dec * PI / 180.0);
+            phi[i] = ra_deg[first + i] * PI / 180.0;
+        }
+        level.grid.zphi2nestBatch(z, phi, pix, count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const double dec = dec_deg[first + i];
+            const Pixel& p = level.pixels[pix[i]];
+            temperature[first + i] = dec < -90.0 || dec > 90.0
+                ? 0.0
+                : std::exp(std::fma(static_cast<double>(p.beta), logRatio, static_cast<double>(p.logT)));
+        }
+    }
+}
+
+double SkySpectralModel::getBeamTemperature(double ra_deg, double dec_deg, double fwhm_deg,
+                                            double frequency_MHz) const {
+    if (m_levels.empty() || frequency_MHz <= 0.0) return 0.0;
+    if (dec_deg < -90.0 || dec_deg > 90.0) return 0.0;
+
+    const double z = std::sin(dec_deg * PI / 180.0);
+    const double phi = ra_deg * PI / 180.0;
+    const double logRatio = std::log(frequency_MHz / REFERENCE_MHZ);
+    if (fwhm_deg <= m_levels.front().fwhm_deg) {
+        return levelTemperature(m_levels.front(), z, phi, logRatio);
+    }
+
+    std::size_t upper = std::min(m_levels.size() - 1,
+                                 static_cast<std::size_t>(std::ceil(std::log2(fwhm_deg / m_levels.front().fwhm_deg))));
+    if (fwhm_deg >= m_levels[upper].fwhm_deg) {
+        return levelTemperature(m_levels[upper], z, phi, logRatio);
+    }
+
+    const Level& a = m_levels[upper - 1];
+    const Level& b = m_levels[upper];
+    const double wa = 1.0 / (a.fwhm_deg * a.fwhm_deg);
+    const double wb = 1.0 / (b.fwhm_deg * b.fwhm_deg);
+    const double t = (1.0 / (fwhm_deg * fwhm_deg) - wa) / (wb - wa);
+    const double ta = levelTemperature(a, z, phi, logRatio);
+    const double tb = levelTemperature(b, z, phi, logRatio);
+    return ta + t * (tb - ta);
+}
+
+double SkySpectralModel::getSpectralIndex(double ra_deg, double dec_deg) const {
+    if (m_levels.empty()) return DEFAULT_SPECTRAL_INDEX;
+    dec_deg = std::max(-90.0, std::min(90.0, dec_deg));
+    const Level& level = m_levels.front();
+    return level.pixels[level.grid.zphi2nest(std::sin(dec_deg * PI / 180.0), ra_deg * PI / 180.0)].beta;
+}
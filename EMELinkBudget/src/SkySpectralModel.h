@@ -0,0 +1,106 @@
+#pragma once
+
+#include "HaslamSkyMap.h"
+#include "HealpixGrid.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ========== Sky Survey Description ==========
+
+struct SkySurveyFile {
+    std::string path;
+    double frequency_MHz = 0.0;
+    double beam_deg = HaslamSkyMap::SURVEY_BEAM_DEG;
+};
+
+struct SkySurvey {
+    const HaslamSkyMap* map = nullptr;  // loaded with the survey's own beam
+    double frequency_MHz = 0.0;
+};
+
+// ========== Multi-Frequency Sky Model ==========
+// The 408 MHz map together with a per-pixel spectral index fitted against
+// maps at other frequencies, so T(f) = T408 (f / 408)^beta with beta varying
+// across the sky (flatter free-free emission along the plane, steeper
+// synchrotron at high latitude). Each pixel holds ln T408 and beta side by
+// side, making any-frequency lookup one fused multiply-add in log space and
+// an exp; ln(f / 408) is computed once per call.
+//
+// The index is fitted by least squares in log-log space after smoothing
+// every map to the widest survey beam. The model keeps the pyramid of the
+// 408 MHz map, so beam-averaged temperatures work as in HaslamSkyMap.
+//
+// Built models are saved to a cache file and memory-mapped on later runs,
+// which skips parsing and smoothing the FITS maps altogether. The file is
+// tied to its sources by a key over their paths, sizes, modification times,
+// frequencies and beams:
+//
+//   "EMSK" | version u32 | source key u64 | levels u32 | reserved u32 |
+//   levels x (nside i32 | reserved u32 | fwhm f64 | offset u64) | pixels
+//
+// Pixel arrays are NESTED pairs of floats (ln T408, beta) starting on 64-byte
+// boundaries. Values are stored in host byte order.
+
+class SkySpectralModel {
+public:
+    struct Pixel {
+        float logT;  // ln T408, -inf where the map has no data
+        float beta;
+    };
+
+    SkySpectralModel();
+
+    SkySpectralModel(const SkySpectralModel&) = delete;
+    SkySpectralModel& operator=(const SkySpectralModel&) = delete;
+
+    // Surveys without a map are ignored; with none left, beta is
+    // DEFAULT_SPECTRAL_INDEX everywhere.
+    bool build(const HaslamSkyMap& reference, const std::vector<SkySurvey>& surveys);
+
+    bool save(const std::string& filename, std::uint64_t sourceKey) const;
+    // Fails if the file was written for other sources or is damaged.
+    bool open(const std::string& filename, std::uint64_t sourceKey);
+    void unload();
+
+    // Identifies a set of source files; the reference map comes first.
+    static std::uint64_t sourceKey(const std::vector<SkySurveyFile>& files);
+
+    // Brightness temperature in K at the finest level; 0 where there is no data.
+    double getTemperature(double ra_deg, double dec_deg, double frequency_MHz) const;
+    void getTemperatures(const double* ra_deg, const double* dec_deg, double* temperature,
+                         std::size_t n, double frequency_MHz) const;
+
+    // Seen through a Gaussian beam, blending pyramid levels like
+    // HaslamSkyMap::getBeamTemperature().
+    double getBeamTemperature(double ra_deg, double dec_deg, double fwhm_deg, double frequency_MHz) const;
+
+    double getSpectralIndex(double ra_deg, double dec_deg) const;
+
+    bool isLoaded() const { return !m_levels.empty(); }
+    bool isMapped() const { return m_file.isOpen(); }
+    int getNside() const { return m_levels.empty() ? 0 : m_levels.front().grid.getNside(); }
+    std::size_t getPyramidLevels() const { return m_levels.size(); }
+    double getLevelBeam(std::size_t level) const { return m_levels[level].fwhm_deg; }
+
+    static constexpr double REFERENCE_MHZ = 408.0;
+    static constexpr double DEFAULT_SPECTRAL_INDEX = -2.55;
+    static constexpr double MIN_SPECTRAL_INDEX = -3.5;
+    static constexpr double MAX_SPECTRAL_INDEX = -1.5;
+    static constexpr std::uint32_t FORMAT_VERSION = 1;
+
+private:
+    struct Level {
+        HealpixGrid grid;
+        double fwhm_deg = 0.0;
+        const Pixel* pixels = nullptr;  // NESTED, in m_storage or m_file
+    };
+
+    std::vector<Level> m_levels;
+    std::vector<std::vector<Pixel>> m_storage;
+    MappedFile m_file;
+
+    double levelTemperature(const Level& level, double z, double phi, double logRatio) const;
+};
@@ -0,0 +1,220 @@
+#include "SphericalHarmonicEngine.h"
+#include <algorithm>
+#include <cmath>
+
+// ========== Constructor ==========
+
+SphericalHarmonicEngine::SphericalHarmonicEngine(int maxDegree) : m_maxDegree(0) {
+    setMaxDegree(maxDegree);
+}
+
+void SphericalHarmonicEngine::setMaxDegree(int maxDegree) {
+    m_maxDegree = std::clamp(maxDegree, 0, MAX_SUPPORTED_DEGREE);
+    const int N = m_maxDegree;
+
+    m_offset.resize(N + 2);
+    m_offset[0] = 0;
+    for (int m = 0; m <= N; ++m) {
+        m_offset[m + 1] = m_offset[m] + static_cast<std::size_t>(N - m + 1);
+    }
+
+    m_a.assign(termCount(), 0.0);
+    m_b.assign(termCount(), 0.0);
+    for (int m = 0; m <= N; ++m) {
+        for (int n = m + 1; n <= N; ++n) {
+            const double norm = std::sqrt(static_cast<double>(n * n - m * m));
+            m_a[index(n, m)] = (2.0 * n - 1.0) / norm;
+            m_b[index(n, m)] = std::sqrt(static_cast<double>((n - 1) * (n - 1) - m * m)) / norm;
+        }
+    }
+
+    m_sectoral.assign(N + 1, 1.0);
+    for (int m = 2; m <= N; ++m) {
+        m_sectoral[m] = std::sqrt((2.0 * m - 1.0) / (2.0 * m));
+    }
+}
+
+// ========== Coefficient Layout ==========
+
+void SphericalHarmonicEngine::pack(const double* g, const double* h, std::vector<double>& packed) const {
+    packed.resize(2 * termCount());
+    for (int m = 0; m <= m_maxDegree; ++m) {
+        for (int n = m; n <= m_maxDegree; ++n) {
+            const std::size_t row = static_cast<std::size_t>(n) * (n + 1) / 2 + m;
+            const std::size_t col = index(n, m);
+            packed[2 * col] = g[row];
+            packed[2 * col + 1] = h[row];
+        }
+    }
+}
+
+void SphericalHarmonicEngine::longitudeTerms(double phi, double* cosm, double* sinm) const {
+    cosm[0] = 1.0;
+    sinm[0] = 0.0;
+    if (m_maxDegree == 0) {
+        return;
+    }
+
+    cosm[1] = std::cos(phi);
+    sinm[1] = std::sin(phi);
+    for (int m = 2; m <= m_maxDegree; ++m) {
+        cosm[m] = cosm[m - 1] * cosm[1] - sinm[m - 1] * sinm[1];
+        sinm[m] = sinm[m - 1] * cosm[1] + cosm[m - 1] * sinm[1];
+    }
+}
+
+// ========== Field Evaluation ==========
+
+namespace {
+
+// Backward Clenshaw state for one order m over n = N..m:
+//   y1 = sum r_n (g cos + h sin) S_nm       (and d/dtheta, for Btheta)
+//   y2 = sum (n+1) r_n (g cos + h sin) S_nm (Br)
+//   y3 = sum r_n (h cos - g sin) S_nm       (Bphi)
+struct ClenshawOrder {
+    const double* gh;
+    const double* a;
+    const double* b;
+    double cm, sm;
+    double y1 = 0.0, y1p = 0.0, d1 = 0.0, d1p = 0.0;
+    double y2 = 0.0, y2p = 0.0;
+    double y3 = 0.0, y3p = 0.0;
+    double aNext = 0.0;   // a_{n+1,m}
+    double bNext = 0.0;   // b_{n+1,m}
+    double bNext2 = 0.0;  // b_{n+2,m}
+
+    inline void step(int k, double rn, double np1, double t, double s) {
+        const double G = gh[2 * k];
+        const double H = gh[2 * k + 1];
+        const double c1 = rn * (G * cm + H * sm);
+        const double c3 = rn * (H * cm - G * sm);
+
+        const double alpha = aNext * t;
+        const double dAlpha = -aNext * s;
+
+        // Terms from earlier steps first, so only alpha * y waits on the last step.
+        const double y1n = (c1 - bNext2 * y1p) + alpha * y1;
+        const double d1n = (dAlpha * y1 - bNext2 * d1p) + alpha * d1;
+        const double y2n = (np1 * c1 - bNext2 * y2p) + alpha * y2;
+        const double y3n = (c3 - bNext2 * y3p) + alpha * y3;
+
+        y1p = y1; y1 = y1n;
+        d1p = d1; d1 = d1n;
+        y2p = y2; y2 = y2n;
+        y3p = y3; y3 = y3n;
+
+        aNext = a[k];
+        bNext2 = bNext;
+        bNext = b[k];
+    }
+};
+
+inline ClenshawOrder makeOrder(const double* gh, const double* a, const double* b, double cm, double sm) {
+    ClenshawOrder order;
+    order.gh = gh;
+    order.a = a;
+    order.b = b;
+    order.cm = cm;
+    order.sm = sm;
+    return order;
+}
+
+// Runs order m from degree N down to m, using the precomputed (a/r)^(n+2).
+inline void sumOrder(ClenshawOrder& order, int N, int m, const double* rn, double t, double s) {
+    for (int n = N; n >= m; --n) {
+        order.step(n - m, rn[n], n + 1.0, t, s);
+    }
+}
+
+} // namespace
+
+void SphericalHarmonicEngine::radialTerms(double a_over_r, double* rn) const {
+    rn[0] = a_over_r * a_over_r;
+    for (int n = 1; n <= m_maxDegree; ++n) {
+        rn[n] = rn[n - 1] * a_over_r;
+    }
+}
+
+void SphericalHarmonicEngine::evaluate(double a_over_r, double cos_theta, double sin_theta,
+                                       const double* cosm, const double* sinm, const double* packed,
+                                       double& Br, double& Btheta, double& Bphi) const {
+    const int N = m_maxDegree;
+    const double t = cos_theta;
+    const double s = sin_theta;
+
+    double rn[MAX_SUPPORTED_DEGREE + 1];
+    radialTerms(a_over_r, rn);
+
+    Br = 0.0;
+    Btheta = 0.0;
+    Bphi = 0.0;
+
+    // Sectoral value S_mm and dS_mm/dtheta of the current order.
+    double Smm = 1.0;
+    double dSmm = 0.0;
+
+    for (int m = 0; m <= N; ++m) {
+        if (m > 0) {
+            const double c = m_sectoral[m];
+            dSmm = c * (s * dSmm + t * Smm);
+            Smm = c * s * Smm;
+            if (std::abs(Smm) < 1e-280) {
+                break;
+            }
+        }
+
+        const std::size_t base = m_offset[m];
+        ClenshawOrder order = makeOrder(packed + 2 * base, m_a.data() + base, m_b.data() + base, cosm[m], sinm[m]);
+        sumOrder(order, N, m, rn, t, s);
+
+        Br += Smm * order.y2;
+        Btheta += dSmm * order.y1 + Smm * order.d1;
+        if (m > 0) {
+            Bphi += m * Smm * order.y3 / s;
+        }
+    }
+}
+
+int SphericalHarmonicEngine::orderSums(double a_over_r, double cos_theta, double sin_theta,
+                                       const double* packed, double* sums) const {
+    const int N = m_maxDegree;
+    const double t = cos_theta;
+    const double s = sin_theta;
+
+    double rn[MAX_SUPPORTED_DEGREE + 1];
+    radialTerms(a_over_r, rn);
+
+    std::fill(sums, sums + ORDER_SUM_STRIDE * (N + 1), 0.0);
+
+    double Smm = 1.0;
+    double dSmm = 0.0;
+
+    int m = 0;
+    for (; m <= N; ++m) {
+        if (m > 0) {
+            const double c = m_sectoral[m];
+            dSmm = c * (s * dSmm + t * Smm);
+            Smm = c * s * Smm;
+            if (std::abs(Smm) < 1e-280) {
+                break;
+            }
+        }
+
+        // The order sums are linear in (cos, sin); one pass per basis vector.
+        const std::size_t base = m_offset[m];
+        ClenshawOrder cosPart = makeOrder(packed + 2 * base, m_a.data() + base, m_b.data() + base, 1.0, 0.0);
+        ClenshawOrder sinPart = makeOrder(packed + 2 * base, m_a.data() + base, m_b.data() + base, 0.0, 1.0);
+        sumOrder(cosPart, N, m, rn, t, s);
+        sumOrder(sinPart, N, m, rn, t, s);
+
+        double* out = sums + ORDER_SUM_STRIDE * m;
+        out[0] = Smm * cosPart.y2;
+        out[1] = Smm * sinPart.y2;
+        out[2] = dSmm * cosPart.y1 + Smm * cosPart.d1;
+        out[3] = dSmm * sinPart.y1 + Smm * sinPart.d1;
+        out[4] = m * Smm * cosPart.y3 / s;
+        out[5] = m * Smm * sinPart.y3 / s;
+    }
+
+    return m;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// ========== Spherical Harmonic Engine ==========
+// Evaluates a Schmidt semi-normalized internal potential field to high degree.
+// Recursion constants are precomputed per (n, m) in order-major triangular
+// arrays (all degrees of order 0, then order 1, ...). Each order is summed over
+// degree with Clenshaw's backward recurrence, so no Legendre table is built and
+// the per-point working set is the coefficient column being summed. Sectoral
+// terms that fall below 1e-280 end the order loop instead of going denormal.
+
+class SphericalHarmonicEngine {
+public:
+    static constexpr int MAX_SUPPORTED_DEGREE = 1024;
+    static constexpr int ORDER_SUM_STRIDE = 6;
+
+    explicit SphericalHarmonicEngine(int maxDegree = 0);
+
+    void setMaxDegree(int maxDegree);
+    int getMaxDegree() const { return m_maxDegree; }
+
+    // Entries in an order-major triangular array of degree 0..maxDegree.
+    std::size_t termCount() const { return m_offset.empty() ? 0 : m_offset.back(); }
+    std::size_t index(int n, int m) const { return m_offset[m] + static_cast<std::size_t>(n - m); }
+
+    // Interleaves row-major g/h (index n(n+1)/2 + m) into the order-major
+    // (g, h) pairs expected by evaluate().
+    void pack(const double* g, const double* h, std::vector<double>& packed) const;
+
+    // cos(m*phi) and sin(m*phi) for m = 0..maxDegree.
+    void longitudeTerms(double phi, double* cosm, double* sinm) const;
+
+    // Br, Btheta, Bphi for reference-to-point radius ratio a/r at colatitude
+    // theta. sin_theta must already be clamped away from zero.
+    void evaluate(double a_over_r, double cos_theta, double sin_theta,
+                  const double* cosm, const double* sinm, const double* packed,
+                  double& Br, double& Btheta, double& Bphi) const;
+
+    // Degree sums of each order for one radius and colatitude, so points that
+    // share them only need the longitude series. sums holds ORDER_SUM_STRIDE
+    // values per order m = 0..maxDegree, (rc, rs, tc, ts, pc, ps), with
+    //   Br = sum_m rc cos(m phi) + rs sin(m phi), Btheta from (tc, ts),
+    //   Bphi from (pc, ps).
+    // Returns the number of leading orders that are non-zero; the rest are
+    // cleared.
+    int orderSums(double a_over_r, double cos_theta, double sin_theta,
+                   const double* packed, double* sums) const;
+
+private:
+    int m_maxDegree;
+    std::vector<std::size_t> m_offset;  // start of each order, plus total
+    std::vector<double> m_a;            // (2n-1) / sqrt(n^2 - m^2)
+    std::vector<double> m_b;            // sqrt((n-1)^2 - m^2) / sqrt(n^2 - m^2)
+    std::vector<double> m_sectoral;     // sqrt((2m-1) / 2m), 1 for m <= 1
+
+    // (a/r)^(n+2) for n = 0..maxDegree.
+    void radialTerms(double a_over_r, double* rn) const;
+};
@@ -0,0 +1,451 @@
+#include "SpkEphemeris.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <tuple>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+constexpr std::size_t RECORD_BYTES = 1024;
+constexpr std::size_t RECORD_WORDS = RECORD_BYTES / sizeof(double);
+constexpr int SPK_ND = 2;
+constexpr int SPK_NI = 6;
+constexpr std::size_t SUMMARY_WORDS = SPK_ND + (SPK_NI + 1) / 2;
+constexpr int CHEBYSHEV_POSITION = 2;
+constexpr int MAX_CHAIN = 8;
+
+constexpr double DEG = M_PI / 180.0;
+constexpr double ARCSEC = DEG / 3600.0;
+constexpr double SECONDS_PER_DAY = 86400.0;
+constexpr double SECONDS_PER_CENTURY = 36525.0 * SECONDS_PER_DAY;
+constexpr double J2000_JD = 2451545.0;
+constexpr double J2000_UNIX = 946728000.0;  // 2000-01-01 12:00:00 UTC
+constexpr double SPEED_OF_LIGHT_KM_S = 299792.458;
+
+// Byte reversal for files written on a machine of the other endianness.
+inline std::uint64_t byteSwap(std::uint64_t v) {
+#ifdef _MSC_VER
+    return _byteswap_uint64(v);
+#else
+    return __builtin_bswap64(v);
+#endif
+}
+
+inline std::uint32_t byteSwap(std::uint32_t v) {
+#ifdef _MSC_VER
+    return _byteswap_ulong(v);
+#else
+    return __builtin_bswap32(v);
+#endif
+}
+
+// ========== Time Scales ==========
+
+// First day of the month from which TAI - UTC took the listed value.
+struct LeapSecond {
+    int year;
+    unsigned month;
+    int taiMinusUtc;
+};
+
+constexpr LeapSecond LEAP_SECONDS[] = {
+    {1972, 1, 10}, {1972, 7, 11}, {1973, 1, 12}, {1974, 1, 13}, {1975, 1, 14},
+    {1976, 1, 15}, {1977, 1, 16}, {1978, 1, 17}, {1979, 1, 18}, {1980, 1, 19},
+    {1981, 7, 20}, {1982, 7, 21}, {1983, 7, 22}, {1985, 7, 23}, {1988, 1, 24},
+    {1990, 1, 25}, {1991, 1, 26}, {1992, 7, 27}, {1993, 7, 28}, {1994, 7, 29},
+    {1996, 1, 30}, {1997, 7, 31}, {1999, 1, 32}, {2006, 1, 33}, {2009, 1, 34},
+    {2012, 7, 35}, {2015, 7, 36}, {2017, 1, 37},
+};
+
+// Days since 1970-01-01 of a proleptic Gregorian date.
+constexpr std::int64_t daysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+// ========== Apparent Place ==========
+
+// Rotates an ICRF/J2000 geocentric vector to the true equator and equinox of
+// date and fills the angular fields of out.
+void apparentPlace(double et, const double* r, LunarPosition& out) {
+    const double T = et / SECONDS_PER_CENTURY;
+
+    // IAU 1976 precession angles (Meeus 21.3).
+    const double zeta = (2306.2181 * T + 0.30188 * T * T + 0.017998 * T * T * T) * ARCSEC;
+    const double z = (2306.2181 * T + 1.09468 * T * T + 0.018203 * T * T * T) * ARCSEC;
+    const double theta = (2004.3109 * T - 0.42665 * T * T - 0.041833 * T * T * T) * ARCSEC;
+    const double cZeta = std::cos(zeta), sZeta = std::sin(zeta);
+    const double cz = std::cos(z), sz = std::sin(z);
+    const double cTheta = std::cos(theta), sTheta = std::sin(theta);
+
+    const double x = (cZeta * cz * cTheta - sZeta * sz) * r[0] +
+                     (-sZeta * cz * cTheta - cZeta * sz) * r[1] - cz * sTheta * r[2];
+    const double y = (cZeta * sz * cTheta + sZeta * cz) * r[0] +
+                     (-sZeta * sz * cTheta + cZeta * cz) * r[1] - sz * sTheta * r[2];
+    const double w = cZeta * sTheta * r[0] - sZeta * sTheta * r[1] + cTheta * r[2];
+
+    // Nutation: to the mean ecliptic, shift the longitude, back to the true equator.
+    double nutLon, nutObl, eps0;
+    LunarEphemeris::nutation(J2000_JD + et / SECONDS_PER_DAY, nutLon, nutObl, eps0);
+    const double cEps0 = std::cos(eps0 * DEG), sEps0 = std::sin(eps0 * DEG);
+    const double cEps = std::cos((eps0 + nutObl) * DEG), sEps = std::sin((eps0 + nutObl) * DEG);
+    const double cPsi = std::cos(nutLon * DEG), sPsi = std::sin(nutLon * DEG);
+
+    const double yEcl = y * cEps0 + w * sEps0;
+    const double zEcl = -y * sEps0 + w * cEps0;
+    const double xLon = x * cPsi - yEcl * sPsi;
+    const double yLon = x * sPsi + yEcl * cPsi;
+    const double yEq = yLon * cEps - zEcl * sEps;
+    const double zEq = yLon * sEps + zEcl * cEps;
+
+    const double norm = std::sqrt(x * x + y * y + w * w);
+    double lon = std::atan2(yLon, xLon);
+    if (lon < 0.0) lon += 2.0 * M_PI;
+    double ra = std::atan2(yEq, xLon);
+    if (ra < 0.0) ra += 2.0 * M_PI;
+
+    out.eclipticLongitude = lon;
+    out.eclipticLatitude = std::asin(zEcl / norm);
+    out.rightAscension = ra;
+    out.declination = std::asin(zEq / norm);
+}
+
+} // namespace
+
+SpkEphemeris::SpkEphemeris() : m_swapBytes(false) {
+}
+
+// ========== File Access ==========
+
+double SpkEphemeris::word(std::size_t index) const {
+    std::uint64_t bits;
+    std::memcpy(&bits, m_file.data() + index * sizeof(double), sizeof(bits));
+    if (m_swapBytes) {
+        bits = byteSwap(bits);
+    }
+    return std::bit_cast<double>(bits);
+}
+
+std::int32_t SpkEphemeris::integer(std::size_t byteOffset) const {
+    std::uint32_t bits;
+    std::memcpy(&bits, m_file.data() + byteOffset, sizeof(bits));
+    if (m_swapBytes) {
+        bits = byteSwap(bits);
+    }
+    return static_cast<std::int32_t>(bits);
+}
+
+bool SpkEphemeris::open(const std::string& filename) {
+    m_segments.clear();
+    m_internalName.clear();
+
+    if (!m_file.open(filename)) {
+        m_lastError = "Cannot open SPK file: " + filename;
+        return false;
+    }
+
+    const char* data = m_file.data();
+    if (m_file.size() < RECORD_BYTES || std::memcmp(data, "DAF/SPK ", 8) != 0) {
+        m_lastError = "Not a DAF/SPK file: " + filename;
+        m_file.close();
+        return false;
+    }
+
+    const bool bigEndianFile = std::memcmp(data + 88, "BIG-IEEE", 8) == 0;
+    if (!bigEndianFile && std::memcmp(data + 88, "LTL-IEEE", 8) != 0) {
+        m_lastError = "Unsupported DAF binary format";
+        m_file.close();
+        return false;
+    }
+    m_swapBytes = bigEndianFile != (std::endian::native == std::endian::big);
+
+    if (integer(8) != SPK_ND || integer(12) != SPK_NI) {
+        m_lastError = "Unexpected SPK summary layout";
+        m_file.close();
+        return false;
+    }
+
+    m_internalName.assign(data + 16, 60);
+    m_internalName.erase(m_internalName.find_last_not_of(" \0", std::string::npos, 2) + 1);
+
+    const std::size_t totalWords = m_file.size() / sizeof(double);
+    std::size_t skipped = 0;
+
+    // Summary records form a doubly linked list starting at FWARD.
+    std::int32_t record = integer(76);
+    for (std::size_t visited = 0; record > 0 && visited < totalWords / RECORD_WORDS; ++visited) {
+        const std::size_t base = static_cast<std::size_t>(record - 1) * RECORD_WORDS;
+        if (base + RECORD_WORDS > totalWords) {
+            break;
+        }
+
+        const int next = static_cast<int>(word(base));
+        const int count = static_cast<int>(word(base + 2));
+        for (int i = 0; i < count && 3 + (i + 1) * SUMMARY_WORDS <= RECORD_WORDS; ++i) {
+            const std::size_t summary = base + 3 + i * SUMMARY_WORDS;
+            const std::size_t ints = (summary + SPK_ND) * sizeof(double);
+
+            Segment segment;
+            segment.startEt = word(summary);
+            segment.endEt = word(summary + 1);
+            segment.target = integer(ints);
+            segment.center = integer(ints + 4);
+            segment.frame = integer(ints + 8);
+            const std::int32_t type = integer(ints + 12);
+            const std::int32_t begin = integer(ints + 16);
+            const std::int32_t end = integer(ints + 20);
+
+            if (type != CHEBYSHEV_POSITION || begin < 1 || end < begin + 4 ||
+                static_cast<std::size_t>(end) > totalWords) {
+                ++skipped;
+                continue;
+            }
+
+            // Directory at the end of the segment: INIT, INTLEN, RSIZE, N.
+            segment.init = word(end - 4);
+            segment.intervalLength = word(end - 3);
+            const double recordSize = word(end - 2);
+            const double recordCount = word(end - 1);
+            if (!(recordSize >= 5.0 && recordSize < RECORD_WORDS * 8 && recordCount >= 1.0 &&
+                  recordCount <= static_cast<double>(totalWords))) {
+                ++skipped;
+                continue;
+            }
+            segment.firstWord = static_cast<std::size_t>(begin - 1);
+            segment.recordSize = static_cast<std::size_t>(recordSize);
+            segment.recordCount = static_cast<std::size_t>(recordCount);
+            segment.degree = static_cast<int>((segment.recordSize - 2) / 3) - 1;
+
+            if (!(segment.intervalLength > 0.0) || (segment.recordSize - 2) % 3 != 0 ||
+                segment.firstWord + segment.recordCount * segment.recordSize >
+                    static_cast<std::size_t>(end - 4)) {
+                ++skipped;
+                continue;
+            }
+
+            m_segments.push_back(segment);
+        }
+        record = next;
+    }
+
+    std::sort(m_segments.begin(), m_segments.end(), [](const Segment& a, const Segment& b) {
+        if (a.target != b.target) return a.target < b.target;
+        if (a.center != b.center) return a.center < b.center;
+        return a.startEt < b.startEt;
+    });
+
+    if (m_segments.empty()) {
+        m_lastError = skipped > 0 ? "SPK file has no type 2 segments" : "SPK file has no segments";
+        m_file.close();
+        return false;
+    }
+
+    m_lastError.clear();
+    return true;
+}
+
+// ========== Segment Lookup ==========
+
+const SpkEphemeris::Segment* SpkEphemeris::findSegment(int target, int center, double et) const {
+    // Last segment of (target, center) starting at or before et.
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), std::make_tuple(target, center, et),
+                               [](const std::tuple<int, int, double>& key, const Segment& s) {
+                                   if (std::get<0>(key) != s.target) return std::get<0>(key) < s.target;
+                                   if (std::get<1>(key) != s.center) return std::get<1>(key) < s.center;
+                                   return std::get<2>(key) < s.startEt;
+                               });
+    if (it == m_segments.begin()) {
+        return nullptr;
+    }
+    --it;
+    if (it->target != target || it->center != center || et > it->endEt) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+const SpkEphemeris::Segment* SpkEphemeris::findAnySegment(int target, double et) const {
+    auto it = std::lower_bound(m_segments.begin(), m_segments.end(), target,
+                               [](const Segment& s, int t) { return s.target < t; });
+    for (; it != m_segments.end() && it->target == target; ++it) {
+        if (const Segment* segment = findSegment(target, it->center, et)) {
+            return segment;
+        }
+    }
+    return nullptr;
+}
+
+// ========== Chebyshev Evaluation ==========
+
+void SpkEphemeris::evaluate(const Segment& segment, double et, SpkState& out) const {
+    const double offset = std::floor((et - segment.init) / segment.intervalLength);
+    const std::size_t index = offset <= 0.0 ? 0 :
+        std::min(static_cast<std::size_t>(offset), segment.recordCount - 1);
+    const std::size_t base = segment.firstWord + index * segment.recordSize;
+
+    const double mid = word(base);
+    const double radius = word(base + 1);
+    const double x = (et - mid) / radius;
+    const double twoX = 2.0 * x;
+    const int n = segment.degree + 1;
+
+    // Clenshaw for the series and its derivative together.
+    for (int axis = 0; axis < 3; ++axis) {
+        const std::size_t coeffs = base + 2 + static_cast<std::size_t>(axis) * n;
+        double b1 = 0.0, b2 = 0.0, d1 = 0.0, d2 = 0.0;
+        for (int k = n - 1; k >= 1; --k) {
+            const double b0 = word(coeffs + k) + twoX * b1 - b2;
+            const double d0 = 2.0 * b1 + twoX * d1 - d2;
+            b2 = b1;
+            b1 = b0;
+            d2 = d1;
+            d1 = d0;
+        }
+        out.position[axis] = word(coeffs) + x * b1 - b2;
+        out.velocity[axis] = (b1 + x * d1 - d2) / radius;
+    }
+}
+
+bool SpkEphemeris::state(int target, int center, double et, SpkState& out) const {
+    if (const Segment* direct = findSegment(target, center, et)) {
+        evaluate(*direct, et, out);
+        return true;
+    }
+
+    // Walk both bodies towards the barycenter; each entry is the body's state
+    // relative to that chain node.
+    struct Link {
+        int body;
+        SpkState state;
+    };
+    auto walk = [&](int body, Link* chain) {
+        int length = 0;
+        chain[length++] = {body, {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}}};
+        while (length < MAX_CHAIN) {
+            const Segment* segment = findAnySegment(chain[length - 1].body, et);
+            if (!segment) {
+                break;
+            }
+            SpkState step;
+            evaluate(*segment, et, step);
+            Link link{segment->center, chain[length - 1].state};
+            for (int axis = 0; axis < 3; ++axis) {
+                link.state.position[axis] += step.position[axis];
+                link.state.velocity[axis] += step.velocity[axis];
+            }
+            chain[length++] = link;
+        }
+        return length;
+    };
+
+    Link targetChain[MAX_CHAIN];
+    Link centerChain[MAX_CHAIN];
+    const int targetLength = walk(target, targetChain);
+    const int centerLength = walk(center, centerChain);
+
+    for (int i = 0; i < targetLength; ++i) {
+        for (int j = 0; j < centerLength; ++j) {
+            if (targetChain[i].body == centerChain[j].body) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    out.position[axis] = targetChain[i].state.position[axis] - centerChain[j].state.position[axis];
+                    out.velocity[axis] = targetChain[i].state.velocity[axis] - centerChain[j].state.velocity[axis];
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool SpkEphemeris::covers(int target, int center, double et) const {
+    SpkState unused;
+    return state(target, center, et, unused);
+}
+
+// ========== Time Scales ==========
+
+double SpkEphemeris::ephemerisTime(std::time_t utc) {
+    double ttMinusUtc = 0.0;
+    const double seconds = static_cast<double>(utc);
+    if (seconds < daysFromCivil(1972, 1, 1) * SECONDS_PER_DAY) {
+        ttMinusUtc = LunarEphemeris::deltaT(LunarEphemeris::julianDay(utc));
+    } else {
+        for (auto it = std::rbegin(LEAP_SECONDS); it != std::rend(LEAP_SECONDS); ++it) {
+            if (seconds >= daysFromCivil(it->year, it->month, 1) * SECONDS_PER_DAY) {
+                ttMinusUtc = 32.184 + it->taiMinusUtc;
+                break;
+            }
+        }
+    }
+
+    const double tt = seconds - J2000_UNIX + ttMinusUtc;
+    const double g = (357.53 + 0.98560028 * tt / SECONDS_PER_DAY) * DEG;
+    return tt + 0.001657 * std::sin(g) + 0.000014 * std::sin(2.0 * g);
+}
+
+// ========== Moon Position ==========
+
+bool SpkEphemeris::apparentPosition(double et, LunarPosition& out) const {
+    SpkState geometric;
+    if (!state(MOON, EARTH, et, geometric)) {
+        return false;
+    }
+    const double* r = geometric.position;
+    const double* v = geometric.velocity;
+    const double distance = std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+
+    // Direction at the emission time; the Earth moves a few metres meanwhile.
+    SpkState retarded;
+    if (!state(MOON, EARTH, et - distance / SPEED_OF_LIGHT_KM_S, retarded)) {
+        retarded = geometric;
+    }
+
+    apparentPlace(et, retarded.position, out);
+    out.distance_km = distance;
+    out.rangeRate_km_s = (r[0] * v[0] + r[1] * v[1] + r[2] * v[2]) / distance;
+    return true;
+}
+
+bool SpkEphemeris::calculate(std::time_t utc, LunarPosition& position) const {
+    if (!apparentPosition(ephemerisTime(utc), position)) {
+        return false;
+    }
+
+    const LunarPosition analytic = LunarEphemeris().calculate(utc);
+    position.librationLon_deg = analytic.librationLon_deg;
+    position.librationLat_deg = analytic.librationLat_deg;
+    position.librationLonRate_deg_day = analytic.librationLonRate_deg_day;
+    position.librationLatRate_deg_day = analytic.librationLatRate_deg_day;
+    return true;
+}
+
+bool SpkEphemeris::calculateSeries(std::time_t start, std::time_t step_s, std::size_t count,
+                                   LunarPositionBatch& out) const {
+    // Libration from the analytic theory, positions from the kernel.
+    LunarEphemeris().calculateSeries(start, step_s, count, out);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        LunarPosition p;
+        if (!apparentPosition(ephemerisTime(start + static_cast<std::time_t>(i) * step_s), p)) {
+            return false;
+        }
+        out.rightAscension[i] = p.rightAscension;
+        out.declination[i] = p.declination;
+        out.eclipticLongitude[i] = p.eclipticLongitude;
+        out.eclipticLatitude[i] = p.eclipticLatitude;
+        out.distance_km[i] = p.distance_km;
+        out.rangeRate_km_s[i] = p.rangeRate_km_s;
+    }
+    return true;
+}
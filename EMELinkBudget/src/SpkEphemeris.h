@@ -0,0 +1,94 @@
+#pragma once
+
+#include "LunarEphemeris.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+// ========== SPK State ==========
+// Cartesian state in the kernel frame (ICRF for the JPL DE files).
+
+struct SpkState {
+    double position[3];  // km
+    double velocity[3];  // km/s
+};
+
+// ========== SPK Ephemeris ==========
+// Reader for JPL DE binary kernels (de440.bsp, de441.bsp, ...) in the NAIF
+// DAF/SPK format. The file is memory-mapped and only the segment
+// summaries are decoded on open; type 2 (Chebyshev position) segments are
+// then evaluated straight from the mapping. A segment is found by binary
+// search over its start epoch, the record inside it by its fixed interval,
+// and position and velocity come from one Clenshaw pass per coordinate.
+// All lookups are const and safe to call from several threads.
+
+class SpkEphemeris {
+public:
+    // NAIF body codes.
+    static constexpr int SOLAR_SYSTEM_BARYCENTER = 0;
+    static constexpr int EARTH_MOON_BARYCENTER = 3;
+    static constexpr int EARTH = 399;
+    static constexpr int MOON = 301;
+
+    static constexpr const char* SOURCE_NAME = "JPL DE (SPK)";
+
+    SpkEphemeris();
+
+    bool open(const std::string& filename);
+    bool isOpen() const { return m_file.isOpen(); }
+    const std::string& getLastError() const { return m_lastError; }
+    const std::string& getInternalName() const { return m_internalName; }
+    std::size_t getSegmentCount() const { return m_segments.size(); }
+
+    // TDB seconds past J2000 for a UTC instant (leap-second table, then
+    // the periodic TDB - TT terms).
+    static double ephemerisTime(std::time_t utc);
+
+    // State of target relative to center at ephemeris time et, chaining
+    // through intermediate centres (e.g. Moon - Earth via the EMB).
+    bool state(int target, int center, double et, SpkState& out) const;
+    bool covers(int target, int center, double et) const;
+
+    // Apparent geocentric moon of date: light time, precession (IAU 1976)
+    // and nutation applied to the kernel position; range rate from the
+    // kernel velocity. The kernels carry no libration, so it comes from
+    // LunarEphemeris.
+    bool calculate(std::time_t utc, LunarPosition& position) const;
+    bool calculateSeries(std::time_t start, std::time_t step_s, std::size_t count,
+                         LunarPositionBatch& out) const;
+
+private:
+    struct Segment {
+        int target;
+        int center;
+        int frame;
+        double startEt;
+        double endEt;
+        double init;         // epoch of the first record
+        double intervalLength;
+        std::size_t firstWord;  // 0-based double index of record 0
+        std::size_t recordSize;
+        std::size_t recordCount;
+        int degree;
+    };
+
+    MappedFile m_file;
+    bool m_swapBytes;
+    std::string m_internalName;
+    std::string m_lastError;
+    // Sorted by (target, center, startEt).
+    std::vector<Segment> m_segments;
+
+    double word(std::size_t index) const;
+    std::int32_t integer(std::size_t byteOffset) const;
+
+    const Segment* findSegment(int target, int center, double et) const;
+    const Segment* findAnySegment(int target, double et) const;
+    void evaluate(const Segment& segment, double et, SpkState& out) const;
+
+    // Everything but the libration fields.
+    bool apparentPosition(double et, LunarPosition& out) const;
+};
@@ -0,0 +1,134 @@
+#include "TecCube.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// ========== Time Axis ==========
+
+void TecCube::updateTimeIndex() {
+    m_uniformStep = 0;
+    if (epochs.size() < 2) {
+        return;
+    }
+
+    const std::time_t step = epochs[1] - epochs[0];
+    for (std::size_t i = 2; i < epochs.size(); ++i) {
+        if (epochs[i] - epochs[i - 1] != step) {
+            return;
+        }
+    }
+    m_uniformStep = step;
+}
+
+void TecCube::locateTime(std::time_t time, std::size_t& t1, std::size_t& t2, double& ratio) const {
+    const std::size_t last = epochs.size() - 1;
+    ratio = 0.0;
+
+    if (time <= epochs.front()) {
+        t1 = t2 = 0;
+        return;
+    }
+    if (time >= epochs.back()) {
+        t1 = t2 = last;
+        return;
+    }
+
+    if (m_uniformStep > 0) {
+        t1 = static_cast<std::size_t>((time - epochs.front()) / m_uniformStep);
+    } else {
+        t1 = static_cast<std::size_t>(
+            std::upper_bound(epochs.begin(), epochs.end(), time) - epochs.begin()) - 1;
+    }
+
+    if (epochs[t1] == time) {
+        t2 = t1;
+        return;
+    }
+
+    t2 = t1 + 1;
+    ratio = static_cast<double>(time - epochs[t1]) / static_cast<double>(epochs[t2] - epochs[t1]);
+}
+
+std::time_t TecCube::toUtc(const std::tm& tm) {
+    // Days from civil date (proleptic Gregorian), independent of the local zone.
+    int y = tm.tm_year + 1900;
+    const int m = tm.tm_mon + 1;
+    y -= m <= 2;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const int yoe = y - era * 400;
+    const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + tm.tm_mday - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    const long long days = static_cast<long long>(era) * 146097 + doe - 719468;
+
+    return static_cast<std::time_t>(days * 86400LL + tm.tm_hour * 3600LL + tm.tm_min * 60LL + tm.tm_sec);
+}
+
+// ========== Batched Interpolation ==========
+
+std::size_t TecCube::interpolate(const std::time_t* times, const double* lat, const double* lon,
+                                 double* value, std::size_t n, int layer) const {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    if (empty() || layer < 0 || layer >= numHgt) {
+        std::fill(value, value + n, nan);
+        return 0;
+    }
+
+    const std::size_t plane = mapSize();
+    const float* base = data.data() + layer * layerSize();
+    const int maxLat = numLat - 1;
+    const int maxLon = numLon - 1;
+    std::size_t valid = 0;
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const double latNorm = (lat[i] - lat1) / dlat;
+        const double lonNorm = (lon[i] - lon1) / dlon;
+
+        int la1 = static_cast<int>(std::floor(latNorm));
+        int lo1 = static_cast<int>(std::floor(lonNorm));
+        const int la2 = std::clamp(la1 + 1, 0, maxLat);
+        const int lo2 = std::clamp(lo1 + 1, 0, maxLon);
+        la1 = std::clamp(la1, 0, maxLat);
+        lo1 = std::clamp(lo1, 0, maxLon);
+
+        const double latFrac = latNorm - la1;
+        const double lonFrac = lonNorm - lo1;
+
+        std::size_t t1, t2;
+        double ratio;
+        locateTime(times[i], t1, t2, ratio);
+
+        const std::size_t r1 = static_cast<std::size_t>(la1) * numLon;
+        const std::size_t r2 = static_cast<std::size_t>(la2) * numLon;
+        const float* m1 = base + t1 * plane;
+        const float* m2 = base + t2 * plane;
+
+        const float a11 = m1[r1 + lo1], a12 = m1[r1 + lo2], a21 = m1[r2 + lo1], a22 = m1[r2 + lo2];
+        const float b11 = m2[r1 + lo1], b12 = m2[r1 + lo2], b21 = m2[r2 + lo1], b22 = m2[r2 + lo2];
+
+        const bool missing =
+            a11 == MISSING || a12 == MISSING || a21 == MISSING || a22 == MISSING ||
+            b11 == MISSING || b12 == MISSING || b21 == MISSING || b22 == MISSING;
+
+        const double a1 = a11 * (1.0 - lonFrac) + a12 * lonFrac;
+        const double a2 = a21 * (1.0 - lonFrac) + a22 * lonFrac;
+        const double va = a1 * (1.0 - latFrac) + a2 * latFrac;
+
+        const double b1 = b11 * (1.0 - lonFrac) + b12 * lonFrac;
+        const double b2 = b21 * (1.0 - lonFrac) + b22 * lonFrac;
+        const double vb = b1 * (1.0 - latFrac) + b2 * latFrac;
+
+        value[i] = missing ? nan : va + ratio * (vb - va);
+        valid += missing ? 0 : 1;
+    }
+
+    return valid;
+}
+
+bool TecCube::interpolate(std::time_t time, double lat, double lon, double& value, int layer) const {
+    double result;
+    if (interpolate(&time, &lat, &lon, &result, 1, layer) == 0) {
+        return false;
+    }
+    value = result;
+    return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "TecMapCache.h"
+#include <cstddef>
+#include <ctime>
+#include <vector>
+
+// ========== TEC Space-Time Cube ==========
+// Every map of one IONEX map type decoded into one contiguous
+// [time][height][lat][lon] float block. Epochs are UTC seconds. Interpolation matches
+// IonexReader::getTecValueInterpolated: bilinear in space on the header
+// grid, linear in time, clamped to the first/last map outside the file.
+
+struct TecCube {
+    static constexpr float MISSING = 9999.0f;
+
+    IonexMapType type = IonexMapType::TEC;
+    std::vector<std::time_t> epochs;
+    int numHgt = 1;
+    int numLat = 0;
+    int numLon = 0;
+    double lat1 = 0.0, dlat = 0.0;
+    double lon1 = 0.0, dlon = 0.0;
+    std::vector<float> data;
+
+    std::size_t numTimes() const { return epochs.size(); }
+    std::size_t layerSize() const { return static_cast<std::size_t>(numLat) * numLon; }
+    std::size_t mapSize() const { return numHgt * layerSize(); }
+    bool empty() const { return epochs.empty(); }
+
+    float at(std::size_t t, int latIdx, int lonIdx) const {
+        return at(t, 0, latIdx, lonIdx);
+    }
+
+    float at(std::size_t t, int layer, int latIdx, int lonIdx) const {
+        return data[t * mapSize() + layer * layerSize() +
+                    static_cast<std::size_t>(latIdx) * numLon + lonIdx];
+    }
+
+    // Evaluates n query points on one height layer; value[i] is NaN where any
+    // contributing grid value is missing. Returns the number of valid outputs.
+    std::size_t interpolate(const std::time_t* times, const double* lat, const double* lon,
+                            double* value, std::size_t n, int layer = 0) const;
+
+    // Single-point convenience wrapper; false if the value is missing.
+    bool interpolate(std::time_t time, double lat, double lon, double& value, int layer = 0) const;
+
+    // Must be called after `epochs` is filled (sorted ascending).
+    void updateTimeIndex();
+
+    // Calendar fields interpreted as UTC.
+    static std::time_t toUtc(const std::tm& tm);
+
+private:
+    // Spacing of the epochs when uniform, 0 otherwise.
+    std::time_t m_uniformStep = 0;
+
+    void locateTime(std::time_t time, std::size_t& t1, std::size_t& t2, double& ratio) const;
+};
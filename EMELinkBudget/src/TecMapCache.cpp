@@ -0,0 +1,102 @@
+#include "TecMapCache.h"
+
+// ========== Constructor ==========
+
+TecMapCache::TecMapCache(std::size_t memoryBudget_bytes, std::size_t maxEntries)
+    : m_memoryBudget(memoryBudget_bytes), m_maxEntries(maxEntries),
+      m_bytes(0), m_hits(0), m_misses(0), m_evictions(0) {
+}
+
+// ========== Lookup / Insert ==========
+
+std::shared_ptr<const TecMap> TecMapCache::find(const TecMapKey& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        ++m_misses;
+        return nullptr;
+    }
+
+    ++m_hits;
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lruPos);
+    return it->second.map;
+}
+
+std::shared_ptr<const TecMap> TecMapCache::insert(const TecMapKey& key, TecMap&& map) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Another caller may have decoded the same map concurrently.
+    auto it = m_entries.find(key);
+    if (it != m_entries.end()) {
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lruPos);
+        return it->second.map;
+    }
+
+    auto stored = std::make_shared<const TecMap>(std::move(map));
+    m_lru.push_front(key);
+    m_entries[key] = Entry{stored, m_lru.begin()};
+    m_bytes += stored->memoryBytes();
+
+    evictLocked();
+    return stored;
+}
+
+// ========== Budget Control ==========
+
+void TecMapCache::setMemoryBudget(std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_memoryBudget = bytes;
+    evictLocked();
+}
+
+void TecMapCache::setMaxEntries(std::size_t entries) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxEntries = entries;
+    evictLocked();
+}
+
+std::size_t TecMapCache::getMemoryBudget() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_memoryBudget;
+}
+
+std::size_t TecMapCache::getMaxEntries() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_maxEntries;
+}
+
+void TecMapCache::evictLocked() {
+    while (m_lru.size() > 1) {
+        bool overBudget = m_memoryBudget != 0 && m_bytes > m_memoryBudget;
+        bool overCount = m_maxEntries != 0 && m_lru.size() > m_maxEntries;
+        if (!overBudget && !overCount) {
+            break;
+        }
+
+        auto it = m_entries.find(m_lru.back());
+        m_bytes -= it->second.map->memoryBytes();
+        m_entries.erase(it);
+        m_lru.pop_back();
+        ++m_evictions;
+    }
+}
+
+void TecMapCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_lru.clear();
+    m_bytes = 0;
+}
+
+TecMapCacheStats TecMapCache::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    TecMapCacheStats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    stats.entries = m_entries.size();
+    stats.bytes = m_bytes;
+    return stats;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <ctime>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// ========== IONEX Map Types ==========
+
+enum class IonexMapType : int {
+    TEC = 0,
+    RMS = 1,
+    HEIGHT = 2
+};
+
+constexpr int IONEX_MAP_TYPE_COUNT = 3;
+
+// ========== Decoded TEC Map ==========
+// One IONEX map (TEC, RMS or HEIGHT) decoded to physical units, row-major
+// [height][lat][lon] in header grid order. 2-D files have a single layer.
+
+struct TecMap {
+    static constexpr float MISSING = 9999.0f;
+
+    IonexMapType type = IonexMapType::TEC;
+    std::tm epoch = {};
+    int numHgt = 1;
+    int numLat = 0;
+    int numLon = 0;
+    std::vector<float> data;
+
+    void resize(int hgts, int lats, int lons) {
+        numHgt = hgts;
+        numLat = lats;
+        numLon = lons;
+        data.assign(static_cast<std::size_t>(hgts) * lats * lons, MISSING);
+    }
+
+    std::size_t layerSize() const { return static_cast<std::size_t>(numLat) * numLon; }
+
+    float at(int latIdx, int lonIdx) const {
+        return data[static_cast<std::size_t>(latIdx) * numLon + lonIdx];
+    }
+
+    float at(int layer, int latIdx, int lonIdx) const {
+        return data[layer * layerSize() + static_cast<std::size_t>(latIdx) * numLon + lonIdx];
+    }
+
+    float& at(int layer, int latIdx, int lonIdx) {
+        return data[layer * layerSize() + static_cast<std::size_t>(latIdx) * numLon + lonIdx];
+    }
+
+    std::size_t memoryBytes() const {
+        return sizeof(TecMap) + data.capacity() * sizeof(float);
+    }
+};
+
+// ========== Cache Key ==========
+
+struct TecMapKey {
+    IonexMapType type;
+    std::time_t epoch;
+
+    bool operator==(const TecMapKey& other) const {
+        return type == other.type && epoch == other.epoch;
+    }
+};
+
+struct TecMapKeyHash {
+    std::size_t operator()(const TecMapKey& key) const {
+        return std::hash<long long>()(static_cast<long long>(key.epoch) * IONEX_MAP_TYPE_COUNT +
+                                      static_cast<int>(key.type));
+    }
+};
+
+// ========== TEC Map Cache Statistics ==========
+
+struct TecMapCacheStats {
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+    std::size_t entries = 0;
+    std::size_t bytes = 0;
+};
+
+// ========== Decoded TEC Map Cache ==========
+// LRU store of decoded maps keyed by map type and epoch, bounded by a memory budget and
+// optionally by an entry count. Maps are handed out as shared_ptr<const>, so
+// an evicted map stays valid for callers still holding it. The most recently
+// inserted map is always kept even if it alone exceeds the budget.
+
+class TecMapCache {
+public:
+    static constexpr std::size_t DEFAULT_MEMORY_BUDGET = 64 * 1024 * 1024;
+
+    explicit TecMapCache(std::size_t memoryBudget_bytes = DEFAULT_MEMORY_BUDGET,
+                         std::size_t maxEntries = 0);
+
+    std::shared_ptr<const TecMap> find(const TecMapKey& key);
+    std::shared_ptr<const TecMap> insert(const TecMapKey& key, TecMap&& map);
+
+    // 0 means unbounded.
+    void setMemoryBudget(std::size_t bytes);
+    void setMaxEntries(std::size_t entries);
+    std::size_t getMemoryBudget() const;
+    std::size_t getMaxEntries() const;
+
+    void clear();
+    TecMapCacheStats getStats() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<const TecMap> map;
+        std::list<TecMapKey>::iterator lruPos;
+    };
+
+    mutable std::mutex m_mutex;
+    std::list<TecMapKey> m_lru;  // front = most recently used
+    std::unordered_map<TecMapKey, Entry, TecMapKeyHash> m_entries;
+    std::size_t m_memoryBudget;
+    std::size_t m_maxEntries;
+    std::size_t m_bytes;
+    std::size_t m_hits;
+    std::size_t m_misses;
+    std::size_t m_evictions;
+
+    void evictLocked();
+};
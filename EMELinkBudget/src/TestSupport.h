@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ========== Test Support ==========
+// Shared by the test programs: check() reports each failed condition and
+// keeps going, finishTests() prints the summary and gives the exit code.
+
+inline int g_failures = 0;
+
+inline void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cout << "✗ " << what << std::endl;
+        ++g_failures;
+    }
+}
+
+// Relative to b, absolute near zero.
+inline bool near(double a, double b, double tol = 1e-9) {
+    return std::abs(a - b) <= tol * (1.0 + std::abs(b));
+}
+
+inline bool nearAbs(double a, double b, double tol = 1e-4) {
+    return std::abs(a - b) <= tol;
+}
+
+inline int finishTests(const std::string& passed) {
+    if (g_failures == 0) {
+        std::cout << "✓ " << passed << std::endl;
+        return 0;
+    }
+    std::cout << g_failures << " check(s) failed" << std::endl;
+    return 1;
+}
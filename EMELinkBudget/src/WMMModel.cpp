@@ -1,280 +1,272 @@
-#define _USE_MATH_DEFINES
 #include "WMMModel.h"
+#include "MappedFile.h"
 #include <fstream>
-#include <sstream>
+#include <charconv>
+#include <cstring>
 #include <cmath>
 #include <algorithm>
+#include <cstdint>
 #include <vector>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
+#ifdef EME_EMBED_WMM
+#include "WMMEmbeddedModel.h"
 #endif
 
-WMMModel::WMMModel() : m_loaded(false) {
+WMMModel::WMMModel()
+    : GeomagneticModel(WMMConstants::WGS84_A), m_epoch(WMMConstants::EPOCH) {
 }
 
-bool WMMModel::loadCoefficientFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        return false;
-    }
-
-    m_coefficients.clear();
-    std::string line;
-
-    bool firstLine = true;
+// ========== Coefficient Loading ==========
 
-    while (std::getline(file, line)) {
-        if (line.empty() || line[0] == '#') continue;
-
-        if (firstLine) {
-            firstLine = false;
-            continue;
-        }
+namespace {
 
-        std::istringstream iss(line);
-        GaussCoefficient coef;
+// Binary layout (native little-endian):
+//   "WMMB", version u32, degree u32, reserved u32, epoch f64, name char[32],
+//   checksum u32 (FNV-1a of the payload), reserved u32,
+//   then g, h, dg, dh as f64 for n = 1..degree, m = 0..n.
+constexpr char BINARY_MAGIC[4] = {'W', 'M', 'M', 'B'};
+constexpr std::uint32_t BINARY_VERSION = 1;
+constexpr std::size_t BINARY_NAME_LENGTH = 32;
+constexpr std::size_t BINARY_HEADER_SIZE = 64;
 
-        if (iss >> coef.n >> coef.m >> coef.gnm >> coef.hnm >> coef.dgnm >> coef.dhnm) {
-            if (coef.n <= WMMConstants::MAX_DEGREE) {
-                m_coefficients.push_back(coef);
-            }
-        }
+std::uint32_t checksum(const char* data, std::size_t size) {
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
     }
+    return hash;
+}
 
-    m_loaded = !m_coefficients.empty();
-    return m_loaded;
+template <typename T>
+T readValue(const char* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
 }
 
-void WMMModel::timeEvolveCoefficients(double decimal_year,
-                                      std::vector<double>& g,
-                                      std::vector<double>& h) const {
-    double dt = decimal_year - WMMConstants::EPOCH;
+template <typename T>
+void appendValue(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
 
-    int maxIndex = (WMMConstants::MAX_DEGREE + 1) * (WMMConstants::MAX_DEGREE + 2) / 2;
-    g.resize(maxIndex, 0.0);
-    h.resize(maxIndex, 0.0);
+// Terms with n = 1..degree.
+std::size_t termsThrough(int degree) {
+    return static_cast<std::size_t>(degree + 1) * (degree + 2) / 2 - 1;
+}
 
-    for (const auto& coef : m_coefficients) {
-        int idx = getIndex(coef.n, coef.m);
-        g[idx] = coef.gnm + dt * coef.dgnm;
-        h[idx] = coef.hnm + dt * coef.dhnm;
+// Reads the next whitespace-separated number of a line; advances p.
+template <typename T>
+bool readField(const char*& p, const char* end, T& value) {
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        return false;
     }
+    p = result.ptr;
+    return true;
 }
 
-void WMMModel::geodeticToGeocentric(double lat_deg, double height_km,
-                                    double& lat_geocentric_deg,
-                                    double& radius_km) const {
-    double lat_rad = lat_deg * M_PI / 180.0;
-    double sin_lat = std::sin(lat_rad);
-    double cos_lat = std::cos(lat_rad);
-
-    double a = WMMConstants::WGS84_A;
-    double e2 = WMMConstants::WGS84_E2;
-
-    double N = a / std::sqrt(1.0 - e2 * sin_lat * sin_lat);
+} // namespace
 
-    double x = (N + height_km) * cos_lat;
-    double z = (N * (1.0 - e2) + height_km) * sin_lat;
-
-    radius_km = std::sqrt(x * x + z * z);
-    lat_geocentric_deg = std::atan2(z, x) * 180.0 / M_PI;
-}
-
-void WMMModel::computeLegendrePolynomials(double theta,
-                                          std::vector<std::vector<double>>& P,
-                                          std::vector<std::vector<double>>& dP) const {
-    int nMax = WMMConstants::MAX_DEGREE;
+bool WMMModel::loadCoefficientFile(const std::string& filename, int maxDegree) {
+    MappedFile file(filename);
+    if (!file.isOpen()) {
+        return false;
+    }
+    if (file.size() >= 4 && std::memcmp(file.data(), BINARY_MAGIC, 4) == 0) {
+        return loadBinary(file, maxDegree);
+    }
 
-    P.assign(nMax + 1, std::vector<double>(nMax + 1, 0.0));
-    dP.assign(nMax + 1, std::vector<double>(nMax + 1, 0.0));
+    maxDegree = std::clamp(maxDegree, 1, WMMConstants::FULL_DEGREE);
 
-    double cos_theta = std::cos(theta);
-    double sin_theta = std::sin(theta);
+    std::vector<double> terms;
+    double epoch = WMMConstants::EPOCH;
+    std::string name;
+    bool firstLine = true;
+    int fileDegree = 0;
 
-    if (std::abs(sin_theta) < 1e-10) {
-        sin_theta = 1e-10;
-    }
+    std::string_view text = file.view();
+    while (!text.empty()) {
+        std::size_t eol = text.find('\n');
+        std::string_view line = text.substr(0, eol);
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
 
-    std::vector<std::vector<double>> k(nMax + 1, std::vector<double>(nMax + 1, 0.0));
+        if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t\r") == std::string_view::npos) continue;
 
-    k[1][0] = 0.0;
-    k[1][1] = 0.0;
+        const char* p = line.data();
+        const char* end = p + line.size();
 
-    for (int n = 2; n <= nMax; ++n) {
-        for (int m = 0; m <= n; ++m) {
-            if (n == m) {
-                k[n][m] = 0.0;
-            } else if (m == 0) {
-                k[n][m] = ((n - 1) * (n - 1) - m * m) /
-                          ((2.0 * n - 1) * (2.0 * n - 3));
+        // Header: epoch, model name, release date.
+        if (firstLine) {
+            firstLine = false;
+            if (readField(p, end, epoch)) {
+                while (p < end && (*p == ' ' || *p == '\t')) ++p;
+                const char* nameEnd = p;
+                while (nameEnd < end && *nameEnd != ' ' && *nameEnd != '\t' && *nameEnd != '\r') ++nameEnd;
+                name.assign(p, nameEnd);
             } else {
-                k[n][m] = ((n - 1) * (n - 1) - m * m) /
-                          ((2.0 * n - 1) * (2.0 * n - 3));
+                epoch = WMMConstants::EPOCH;
             }
+            continue;
         }
-    }
-
-    P[0][0] = 1.0;
-    dP[0][0] = 0.0;
-
-    P[1][0] = cos_theta;
-    dP[1][0] = -sin_theta;
 
-    P[1][1] = sin_theta;
-    dP[1][1] = cos_theta;
-
-    for (int n = 2; n <= nMax; ++n) {
-        for (int m = 0; m <= n; ++m) {
-            if (n == m) {
-                P[n][n] = sin_theta * P[n-1][n-1];
-                dP[n][n] = sin_theta * dP[n-1][n-1] + cos_theta * P[n-1][n-1];
-            } else if (n == 1) {
-                P[n][m] = cos_theta * P[n-1][m];
-                dP[n][m] = cos_theta * dP[n-1][m] - sin_theta * P[n-1][m];
-            } else if (m == n - 1) {
-                P[n][m] = cos_theta * P[n-1][m];
-                dP[n][m] = cos_theta * dP[n-1][m] - sin_theta * P[n-1][m];
-            } else {
-                P[n][m] = cos_theta * P[n-1][m] - k[n][m] * P[n-2][m];
-                dP[n][m] = cos_theta * dP[n-1][m] - sin_theta * P[n-1][m] - k[n][m] * dP[n-2][m];
+        GaussCoefficient coef;
+        if (readField(p, end, coef.n) && readField(p, end, coef.m) &&
+            readField(p, end, coef.gnm) && readField(p, end, coef.hnm) &&
+            readField(p, end, coef.dgnm) && readField(p, end, coef.dhnm)) {
+            if (coef.n >= 1 && coef.n <= maxDegree && coef.m >= 0 && coef.m <= coef.n) {
+                const std::size_t k = 4 * (getIndex(coef.n, coef.m) - 1);
+                if (terms.size() < k + 4) {
+                    terms.resize(4 * termsThrough(coef.n), 0.0);
+                }
+                terms[k] = coef.gnm;
+                terms[k + 1] = coef.hnm;
+                terms[k + 2] = coef.dgnm;
+                terms[k + 3] = coef.dhnm;
+                fileDegree = std::max(fileDegree, coef.n);
             }
         }
     }
 
-    std::vector<std::vector<double>> schmidtQuasiNorm(nMax + 1, std::vector<double>(nMax + 1, 1.0));
+    return installCoefficients(terms.data(), fileDegree, maxDegree, epoch, name);
+}
 
-    for (int n = 1; n <= nMax; ++n) {
-        schmidtQuasiNorm[n][0] = schmidtQuasiNorm[n-1][0] * (2.0 * n - 1) / n;
+bool WMMModel::loadBinaryFile(const std::string& filename, int maxDegree) {
+    MappedFile file(filename);
+    return file.isOpen() && loadBinary(file, maxDegree);
+}
 
-        for (int m = 1; m <= n; ++m) {
-            schmidtQuasiNorm[n][m] = schmidtQuasiNorm[n][m-1] *
-                std::sqrt((n - m + 1) * (m == 1 ? 2.0 : 1.0) / (n + m));
-        }
+bool WMMModel::loadBinary(const MappedFile& file, int maxDegree) {
+    const char* data = file.data();
+    if (file.size() < BINARY_HEADER_SIZE || std::memcmp(data, BINARY_MAGIC, 4) != 0 ||
+        readValue<std::uint32_t>(data + 4) != BINARY_VERSION) {
+        return false;
     }
 
-    for (int n = 1; n <= nMax; ++n) {
-        for (int m = 0; m <= n; ++m) {
-            P[n][m] *= schmidtQuasiNorm[n][m];
-            dP[n][m] *= schmidtQuasiNorm[n][m];
-        }
+    const std::uint32_t degree = readValue<std::uint32_t>(data + 8);
+    if (degree < 1 || degree > static_cast<std::uint32_t>(WMMConstants::FULL_DEGREE)) {
+        return false;
     }
-}
-
-void WMMModel::computeMagneticField(double r, double theta, double phi,
-                                    const std::vector<double>& g,
-                                    const std::vector<double>& h,
-                                    double& Br, double& Btheta, double& Bphi) const {
-    int nMax = WMMConstants::MAX_DEGREE;
-    double a = WMMConstants::WGS84_A;
-
-    std::vector<std::vector<double>> P, dP;
-    computeLegendrePolynomials(theta, P, dP);
-
-    double sin_theta = std::sin(theta);
-    if (std::abs(sin_theta) < 1e-10) {
-        sin_theta = 1e-10;
+    const std::size_t payloadSize = 4 * termsThrough(static_cast<int>(degree)) * sizeof(double);
+    if (file.size() != BINARY_HEADER_SIZE + payloadSize ||
+        checksum(data + BINARY_HEADER_SIZE, payloadSize) != readValue<std::uint32_t>(data + 56)) {
+        return false;
     }
 
-    std::vector<double> cos_m_phi(nMax + 1);
-    std::vector<double> sin_m_phi(nMax + 1);
+    const char* nameField = data + 24;
+    std::string name(nameField, strnlen(nameField, BINARY_NAME_LENGTH));
 
-    cos_m_phi[0] = 1.0;
-    sin_m_phi[0] = 0.0;
+    // The mapping is only byte-aligned; copy before viewing as doubles.
+    std::vector<double> terms(payloadSize / sizeof(double));
+    std::memcpy(terms.data(), data + BINARY_HEADER_SIZE, payloadSize);
 
-    if (nMax >= 1) {
-        cos_m_phi[1] = std::cos(phi);
-        sin_m_phi[1] = std::sin(phi);
-    }
+    return installCoefficients(terms.data(), static_cast<int>(degree), maxDegree,
+                               readValue<double>(data + 16), name);
+}
 
-    for (int m = 2; m <= nMax; ++m) {
-        cos_m_phi[m] = cos_m_phi[m-1] * cos_m_phi[1] - sin_m_phi[m-1] * sin_m_phi[1];
-        sin_m_phi[m] = sin_m_phi[m-1] * cos_m_phi[1] + cos_m_phi[m-1] * sin_m_phi[1];
+bool WMMModel::saveBinaryFile(const std::string& filename) const {
+    if (!isLoaded()) {
+        return false;
     }
 
-    Br = 0.0;
-    Btheta = 0.0;
-    Bphi = 0.0;
+    std::string payload;
+    const int degree = getMaxDegree();
+    payload.reserve(4 * termsThrough(degree) * sizeof(double));
+    for (int idx = 1; idx <= getIndex(degree, degree); ++idx) {
+        appendValue(payload, m_g[idx]);
+        appendValue(payload, m_h[idx]);
+        appendValue(payload, m_dg[idx]);
+        appendValue(payload, m_dh[idx]);
+    }
 
-    for (int n = 1; n <= nMax; ++n) {
-        double ratio = std::pow(a / r, n + 2);
+    char name[BINARY_NAME_LENGTH] = {};
+    const std::string& modelName = getModelName();
+    std::memcpy(name, modelName.data(), std::min(modelName.size(), BINARY_NAME_LENGTH - 1));
+
+    std::string header(BINARY_MAGIC, 4);
+    appendValue(header, BINARY_VERSION);
+    appendValue(header, static_cast<std::uint32_t>(degree));
+    appendValue(header, std::uint32_t(0));
+    appendValue(header, m_epoch);
+    header.append(name, BINARY_NAME_LENGTH);
+    appendValue(header, checksum(payload.data(), payload.size()));
+    appendValue(header, std::uint32_t(0));
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    return static_cast<bool>(out);
+}
 
-        for (int m = 0; m <= n; ++m) {
-            int idx = getIndex(n, m);
-            double gnm = g[idx];
-            double hnm = h[idx];
+bool WMMModel::hasEmbeddedModel() {
+#ifdef EME_EMBED_WMM
+    return true;
+#else
+    return false;
+#endif
+}
 
-            double cos_term = gnm * cos_m_phi[m] + hnm * sin_m_phi[m];
-            double d_lambda_term = hnm * cos_m_phi[m] - gnm * sin_m_phi[m];
+bool WMMModel::loadEmbeddedModel(int maxDegree) {
+#ifdef EME_EMBED_WMM
+    return installCoefficients(WMMEmbedded::COEFFICIENTS, WMMEmbedded::MAX_DEGREE, maxDegree,
+                               WMMEmbedded::EPOCH, WMMEmbedded::MODEL_NAME);
+#else
+    (void)maxDegree;
+    return false;
+#endif
+}
 
-            Br += ratio * (n + 1) * P[n][m] * cos_term;
-            Btheta += ratio * dP[n][m] * cos_term;
+std::vector<GaussCoefficient> WMMModel::getCoefficients() const {
+    std::vector<GaussCoefficient> coefficients;
+    if (!isLoaded()) {
+        return coefficients;
+    }
 
-            if (m > 0) {
-                Bphi += ratio * m * P[n][m] * d_lambda_term / sin_theta;
-            }
+    const int degree = getMaxDegree();
+    coefficients.reserve(termsThrough(degree));
+    for (int n = 1; n <= degree; ++n) {
+        for (int m = 0; m <= n; ++m) {
+            const int idx = getIndex(n, m);
+            coefficients.push_back({n, m, m_g[idx], m_h[idx], m_dg[idx], m_dh[idx]});
         }
     }
+    return coefficients;
 }
 
-void WMMModel::rotateToGeodetic(double X_prime, double Z_prime,
-                                double lat_geodetic, double lat_geocentric,
-                                double& X, double& Z) const {
-    double psi = (lat_geodetic - lat_geocentric) * M_PI / 180.0;
-
-    double cos_psi = std::cos(psi);
-    double sin_psi = std::sin(psi);
+bool WMMModel::installCoefficients(const double* terms, int degree, int maxDegree,
+                                   double epoch, const std::string& name) {
+    maxDegree = std::clamp(maxDegree, 1, WMMConstants::FULL_DEGREE);
+    degree = std::max(std::min(degree, maxDegree), 0);
+
+    const int count = termCount(degree);
+    m_g.assign(count, 0.0);
+    m_h.assign(count, 0.0);
+    m_dg.assign(count, 0.0);
+    m_dh.assign(count, 0.0);
+
+    for (int idx = 1; idx < count; ++idx) {
+        const double* t = terms + 4 * (idx - 1);
+        m_g[idx] = t[0];
+        m_h[idx] = t[1];
+        m_dg[idx] = t[2];
+        m_dh[idx] = t[3];
+    }
 
-    X = X_prime * cos_psi - Z_prime * sin_psi;
-    Z = X_prime * sin_psi + Z_prime * cos_psi;
+    m_epoch = epoch;
+    configure(degree, name);
+    return isLoaded();
 }
 
-MagneticFieldResult WMMModel::calculate(
-    double latitude_deg,
-    double longitude_deg,
-    double height_km,
-    double decimal_year) const {
-
-    MagneticFieldResult result = {};
+// ========== Secular Variation ==========
 
-    if (!m_loaded) {
-        return result;
+void WMMModel::evolveCoefficients(double decimal_year, double* g, double* h) const {
+    const double dt = decimal_year - m_epoch;
+    const int terms = termCount(getMaxDegree());
+    for (int i = 0; i < terms; ++i) {
+        g[i] = m_g[i] + dt * m_dg[i];
+        h[i] = m_h[i] + dt * m_dh[i];
     }
-
-    if (std::abs(latitude_deg) > 89.9) {
-        latitude_deg = (latitude_deg > 0) ? 89.9 : -89.9;
-    }
-
-    std::vector<double> g, h;
-    timeEvolveCoefficients(decimal_year, g, h);
-
-    double lat_geocentric, radius_km;
-    geodeticToGeocentric(latitude_deg, height_km, lat_geocentric, radius_km);
-
-    double theta = (90.0 - lat_geocentric) * M_PI / 180.0;
-    double phi = longitude_deg * M_PI / 180.0;
-
-    double Br, Btheta, Bphi;
-    computeMagneticField(radius_km, theta, phi, g, h, Br, Btheta, Bphi);
-
-    double X_gc = Btheta;
-    double Y_gc = -Bphi;
-    double Z_gc = -Br;
-
-    double X, Z;
-    rotateToGeodetic(X_gc, Z_gc, latitude_deg, lat_geocentric, X, Z);
-
-    result.X = X;
-    result.Y = Y_gc;
-    result.Z = Z;
-    result.H = std::sqrt(X * X + Y_gc * Y_gc);
-    result.F = std::sqrt(X * X + Y_gc * Y_gc + Z * Z);
-    result.inclination = std::atan2(Z, result.H) * 180.0 / M_PI;
-    result.declination = std::atan2(Y_gc, X) * 180.0 / M_PI;
-
-    return result;
-}
-
-int WMMModel::getIndex(int n, int m) const {
-    return n * (n + 1) / 2 + m;
 }
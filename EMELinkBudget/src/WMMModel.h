@@ -1,81 +1,73 @@
 #pragma once
 
+#include "GeomagneticModel.h"
 #include <vector>
 #include <string>
-#include <cmath>
+
+class MappedFile;
 
 // ========== WMM Constants ==========
 
 namespace WMMConstants {
-    constexpr double WGS84_A = 6378.137;
-    constexpr double WGS84_F = 1.0 / 298.257223563;
-    constexpr double WGS84_B = WGS84_A * (1.0 - WGS84_F);
-    constexpr double WGS84_E2 = 2.0 * WGS84_F - WGS84_F * WGS84_F;
+    constexpr double WGS84_A = GeomagneticConstants::WGS84_A;
+    constexpr double WGS84_F = GeomagneticConstants::WGS84_F;
+    constexpr double WGS84_B = GeomagneticConstants::WGS84_B;
+    constexpr double WGS84_E2 = GeomagneticConstants::WGS84_E2;
     constexpr double EPOCH = 2025.0;
     constexpr int MAX_DEGREE = 12;
-}
+    constexpr int NUM_TERMS = (MAX_DEGREE + 1) * (MAX_DEGREE + 2) / 2;
 
-// ========== Gauss Coefficient ==========
-
-struct GaussCoefficient {
-    int n;
-    int m;
-    double gnm;
-    double hnm;
-    double dgnm;
-    double dhnm;
-};
-
-// ========== Magnetic Field Result ==========
+    // Pass as maxDegree to read every degree in the file (e.g. WMMHR to 133).
+    constexpr int FULL_DEGREE = SphericalHarmonicEngine::MAX_SUPPORTED_DEGREE;
+}
 
-struct MagneticFieldResult {
-    double X;
-    double Y;
-    double Z;
-    double H;
-    double F;
-    double inclination;
-    double declination;
-};
+using WMMCoefficientSnapshot = GeomagneticCoefficientSnapshot;
 
 // ========== WMM Model ==========
+// One epoch of Gauss coefficients with linear secular variation. Loading
+// reads a .COF text file, the binary format from wmm_convert or the
+// compiled-in tables; evaluation is shared with IGRF through
+// GeomagneticModel. The expansion keeps WGS84_A as its reference radius,
+// as earlier releases of this code did.
 
-class WMMModel {
+class WMMModel : public GeomagneticModel {
 public:
     WMMModel();
 
-    bool loadCoefficientFile(const std::string& filename);
-
-    MagneticFieldResult calculate(
-        double latitude_deg,
-        double longitude_deg,
-        double height_km,
-        double decimal_year) const;
+    // Reads a text .COF file, or a binary file written by saveBinaryFile()
+    // (detected by its magic). Degrees above maxDegree are skipped; the
+    // default matches the standard WMM.
+    bool loadCoefficientFile(const std::string& filename,
+                             int maxDegree = WMMConstants::MAX_DEGREE);
+    bool loadBinaryFile(const std::string& filename,
+                        int maxDegree = WMMConstants::MAX_DEGREE);
+    // Compact binary copy of every loaded degree (see wmm_convert).
+    bool saveBinaryFile(const std::string& filename) const;
+
+    // data/WMMHR.COF compiled in as constexpr tables (CMake option
+    // EME_EMBED_WMM); loading it needs no file I/O or parsing.
+    static bool hasEmbeddedModel();
+    bool loadEmbeddedModel(int maxDegree = WMMConstants::MAX_DEGREE);
+
+    double getEpoch() const { return m_epoch; }
+    // Epoch coefficients in (n, m) order.
+    std::vector<GaussCoefficient> getCoefficients() const;
+    bool isHighDegree() const { return getMaxDegree() > WMMConstants::MAX_DEGREE; }
+
+protected:
+    void evolveCoefficients(double decimal_year, double* g, double* h) const override;
 
 private:
-    std::vector<GaussCoefficient> m_coefficients;
-    bool m_loaded;
-
-    void timeEvolveCoefficients(double decimal_year,
-                                std::vector<double>& g,
-                                std::vector<double>& h) const;
-
-    void geodeticToGeocentric(double lat_deg, double height_km,
-                              double& lat_geocentric_deg,
-                              double& radius_km) const;
-
-    void computeLegendrePolynomials(double theta,
-                                    std::vector<std::vector<double>>& P,
-                                    std::vector<std::vector<double>>& dP) const;
-
-    void computeMagneticField(double r, double theta, double phi,
-                              const std::vector<double>& g,
-                              const std::vector<double>& h,
-                              double& Br, double& Btheta, double& Bphi) const;
-
-    void rotateToGeodetic(double X_prime, double Z_prime,
-                          double lat_geodetic, double lat_geocentric,
-                          double& X, double& Z) const;
-
-    int getIndex(int n, int m) const;
+    double m_epoch;
+
+    // Epoch coefficients and secular variation, flat triangular layout.
+    std::vector<double> m_g;
+    std::vector<double> m_h;
+    std::vector<double> m_dg;
+    std::vector<double> m_dh;
+
+    // terms holds g, h, dg, dh for n = 1..degree, m = 0..n.
+    bool installCoefficients(const double* terms, int degree, int maxDegree,
+                             double epoch, const std::string& name);
+    bool loadBinary(const MappedFile& file, int maxDegree);
 };
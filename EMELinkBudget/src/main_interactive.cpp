@@ -127,7 +127,7 @@ int main() {
             std::cout << "IONEX file loaded successfully!" << std::endl;
 
             std::cout << "Loading WMM model (WMMHR.COF)..." << std::endl;
-            if (!provider.loadWMMFile("../data/WMMHR.COF")) {
+            if (!provider.loadEmbeddedWMM() && !provider.loadWMMFile("../data/WMMHR.COF")) {
                 std::cout << "Warning: Could not load WMM file. Using default magnetic field values." << std::endl;
             } else {
                 std::cout << "WMM model loaded successfully!" << std::endl;
@@ -4,10 +4,12 @@
 #include "EMELinkBudget.h"
 #include "MaidenheadGrid.h"
 #include "MoonCalendarReader.h"
+#include "LunarEphemeris.h"
 #include "AstronomyAPIClient.h"
 #include "NOAAGlotecReader.h"
+#include "DataCache.h"
+#include "DataRegistry.h"
 #include "WMMModel.h"
-#include "NoiseCalculator.h"
 #include <iostream>
 #include <iomanip>
 #include <string>
@@ -20,7 +22,11 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-SkyNoiseModel g_skyModel;
+// GLOTEC grids and Horizons positions shared across runs; see DataCache::defaultDirectory().
+std::shared_ptr<DataCache> downloadCache() {
+    static std::shared_ptr<DataCache> cache = std::make_shared<DataCache>(DataCache::defaultDirectory());
+    return cache->isUsable() ? cache : nullptr;
+}
 
 void clearInputBuffer() {
     std::cin.clear();
@@ -244,7 +250,7 @@ void inputMoonEphemeris(MoonEphemeris& moon, std::time_t observationTime, const
     std::cout << "\nOptions:" << std::endl;
     std::cout << "  1. Auto-fetch from Astronomy API (requires internet)" << std::endl;
     std::cout << "  2. Load from moon calendar file (data/calendar.dat)" << std::endl;
-    std::cout << "  3. Use estimated position (less accurate)" << std::endl;
+    std::cout << "  3. Built-in lunar ephemeris (offline, ~10 arcsec)" << std::endl;
     std::cout << "  4. Manual input (if you have data from astronomy software)" << std::endl;
 
     int choice = static_cast<int>(getDouble("Select option", 1.0));
@@ -254,6 +260,7 @@ void inputMoonEphemeris(MoonEphemeris& moon, std::time_t observationTime, const
 
         AstronomyAPIClient apiClient;
         AstronomyAPIClient::MoonData apiData;
+        apiClient.setCache(downloadCache());
 
         double txLat_deg = txSite.latitude * 180.0 / M_PI;
         double txLon_deg = txSite.longitude * 180.0 / M_PI;
@@ -272,11 +279,10 @@ void inputMoonEphemeris(MoonEphemeris& moon, std::time_t observationTime, const
             moon.librationLatRate_deg_day = apiData.libration_lat_rate_deg_day;
 
             if (moon.librationLonRate_deg_day == 0.0 && moon.librationLatRate_deg_day == 0.0) {
-                double lunarMonth_days = 27.32166;
-                double librationLonAmplitude_deg = 7.9;
-                double librationLatAmplitude_deg = 6.7;
-                moon.librationLonRate_deg_day = (2.0 * M_PI * librationLonAmplitude_deg) / lunarMonth_days;
-                moon.librationLatRate_deg_day = (2.0 * M_PI * librationLatAmplitude_deg) / lunarMonth_days;
+                LunarEphemeris ephemeris;
+                const LunarPosition position = ephemeris.calculate(observationTime);
+                moon.librationLonRate_deg_day = position.librationLonRate_deg_day;
+                moon.librationLatRate_deg_day = position.librationLatRate_deg_day;
             }
 
             moon.hourAngle_DX = 0.0;
@@ -295,15 +301,14 @@ void inputMoonEphemeris(MoonEphemeris& moon, std::time_t observationTime, const
                           << apiData.libration_lon_rate_deg_day << " deg/day, Lat="
                           << apiData.libration_lat_rate_deg_day << " deg/day" << std::endl;
             } else {
-                std::cout << "  => Using estimated libration rates" << std::endl;
+                std::cout << "  => Libration rates from the built-in ephemeris" << std::endl;
             }
 
             // Try to improve DEC accuracy with calendar data
-            MoonCalendarReader calendar;
+            std::shared_ptr<const MoonCalendarReader> calendar = DataRegistry::shared().calendar();
             std::tm* timeInfo = std::gmtime(&observationTime);
             double dec_calendar;
-            if (calendar.loadCalendarFile("data/calendar.dat") &&
-                calendar.getMoonDeclination(*timeInfo, dec_calendar)) {
+            if (calendar && calendar->getMoonDeclination(*timeInfo, dec_calendar)) {
                 moon.declination = dec_calendar * M_PI / 180.0;
                 std::cout << "  => DEC refined: " << dec_calendar
                           << " deg (from calendar interpolation)" << std::endl;
@@ -318,57 +323,54 @@ void inputMoonEphemeris(MoonEphemeris& moon, std::time_t observationTime, const
     }
 
     if (choice == 2) {
-        MoonCalendarReader calendar;
-        if (calendar.loadCalendarFile("data/calendar.dat")) {
+        std::shared_ptr<const MoonCalendarReader> calendar = DataRegistry::shared().calendar();
+        if (calendar) {
             std::cout << "Loading moon position from calendar file..." << std::endl;
 
             std::tm* timeInfo = std::localtime(&observationTime);
 
             double declination;
-            if (calendar.getMoonDeclination(*timeInfo, declination)) {
+            if (calendar->getMoonDeclination(*timeInfo, declination)) {
                 moon.declination = declination * M_PI / 180.0;
 
-                int dayOfYear = timeInfo->tm_yday;
-                double estimatedRA = std::fmod(180.0 + dayOfYear * 13.2, 360.0);
-                moon.rightAscension = estimatedRA * M_PI / 180.0;
-
-                moon.distance_km = 384400.0;
-                moon.hourAngle_DX = 0.0;
-                moon.hourAngle_Home = 0.0;
+                // The calendar only tabulates declination; take the rest
+                // from the built-in ephemeris.
+                LunarEphemeris ephemeris;
+                LunarEphemeris::fillEphemeris(ephemeris.calculate(observationTime), observationTime, moon);
+                moon.declination = declination * M_PI / 180.0;
                 moon.ephemerisSource = "Moon Calendar";
 
                 std::cout << "  => RA: " << std::fixed << std::setprecision(1)
-                          << estimatedRA << " deg (estimated from date)" << std::endl;
+                          << moon.rightAscension * 180.0 / M_PI << " deg (built-in ephemeris)" << std::endl;
                 std::cout << "  => DEC: " << declination << " deg (from calendar)" << std::endl;
-                std::cout << "  => Distance: 384400 km (average)" << std::endl;
+                std::cout << "  => Distance: " << moon.distance_km << " km" << std::endl;
                 std::cout << "[OK] Moon calendar loaded successfully" << std::endl;
                 return;
             } else {
                 std::cout << "[!] Could not find moon data for this date in calendar." << std::endl;
-                std::cout << "Falling back to estimated position...\n" << std::endl;
+                std::cout << "Falling back to the built-in ephemeris...\n" << std::endl;
                 choice = 3;
             }
         } else {
             std::cout << "[!] Could not load calendar file: data/calendar.dat" << std::endl;
-            std::cout << "Falling back to estimated position...\n" << std::endl;
+            std::cout << "Falling back to the built-in ephemeris...\n" << std::endl;
             choice = 3;
         }
     }
 
     if (choice == 3) {
-        std::cout << "Using estimated moon position (approximate)..." << std::endl;
-        std::cout << "[!] Note: For accurate results, use real ephemeris data!" << std::endl;
-
-        moon.rightAscension = 180.0 * M_PI / 180.0;
-        moon.declination = 15.0 * M_PI / 180.0;
-        moon.distance_km = 384400.0;
-        moon.hourAngle_DX = 0.0;
-        moon.hourAngle_Home = 0.0;
-        moon.ephemerisSource = "Estimated";
-
-        std::cout << "  => RA: 180.0 deg (estimated)" << std::endl;
-        std::cout << "  => DEC: 15.0 deg (estimated)" << std::endl;
-        std::cout << "  => Distance: 384400 km (average)" << std::endl;
+        std::cout << "Computing moon position from the built-in lunar ephemeris..." << std::endl;
+
+        LunarEphemeris ephemeris;
+        LunarEphemeris::fillEphemeris(ephemeris.calculate(observationTime), observationTime, moon);
+
+        std::cout << "  => RA: " << std::fixed << std::setprecision(2)
+                  << moon.rightAscension * 180.0 / M_PI << " deg" << std::endl;
+        std::cout << "  => DEC: " << moon.declination * 180.0 / M_PI << " deg" << std::endl;
+        std::cout << "  => Distance: " << std::setprecision(1) << moon.distance_km << " km" << std::endl;
+        std::cout << "  => Range rate: " << std::setprecision(4) << moon.rangeRate_km_s << " km/s" << std::endl;
+        std::cout << "  => Libration: Lon=" << std::setprecision(2) << moon.librationLon_deg
+                  << " deg, Lat=" << moon.librationLat_deg << " deg" << std::endl;
     } else if (choice == 4) {
         std::cout << "\nIf you have astronomy software (Stellarium, WSJT-X, etc.)," << std::endl;
         std::cout << "you can get accurate moon position data:\n" << std::endl;
@@ -408,6 +410,7 @@ void inputIonosphereData(IonosphereData& iono, std::time_t observationTime,
 
         NOAAGlotecReader glotecReader;
         GlotecData glotecData;
+        glotecReader.setCache(downloadCache());
 
         std::string url = glotecReader.getDataUrl(*timeInfo);
         std::cout << "[DEBUG] GLOTEC URL: " << url << std::endl;
@@ -439,23 +442,9 @@ void inputIonosphereData(IonosphereData& iono, std::time_t observationTime,
                 std::cout << "  TX TEC: " << std::fixed << std::setprecision(1) << tec_tx << " TECU" << std::endl;
                 std::cout << "  RX TEC: " << tec_rx << " TECU" << std::endl;
 
-                WMMModel wmm;
-                const char* wmmPaths[] = {
-                    "data/WMMHR.COF",
-                    "EMELinkBudget/data/WMMHR.COF",
-                    "../data/WMMHR.COF",
-                    "../EMELinkBudget/data/WMMHR.COF"
-                };
-
-                bool wmmLoaded = false;
-                for (const char* path : wmmPaths) {
-                    if (wmm.loadCoefficientFile(path)) {
-                        wmmLoaded = true;
-                        break;
-                    }
-                }
+                std::shared_ptr<const WMMModel> wmm = DataRegistry::shared().wmm();
 
-                if (wmmLoaded) {
+                if (wmm) {
                     int year = timeInfo->tm_year + 1900;
                     int month = timeInfo->tm_mon + 1;
                     int day = timeInfo->tm_mday;
@@ -473,8 +462,8 @@ void inputIonosphereData(IonosphereData& iono, std::time_t observationTime,
                     double height_tx_km = 0.0;
                     double height_rx_km = 0.0;
 
-                    MagneticFieldResult mag_tx = wmm.calculate(lat_tx, lon_tx, height_tx_km, decimal_year);
-                    MagneticFieldResult mag_rx = wmm.calculate(lat_rx, lon_rx, height_rx_km, decimal_year);
+                    MagneticFieldResult mag_tx = wmm->calculate(lat_tx, lon_tx, height_tx_km, decimal_year);
+                    MagneticFieldResult mag_rx = wmm->calculate(lat_rx, lon_rx, height_rx_km, decimal_year);
 
                     iono.B_magnitude_DX = mag_tx.F * 1e-9;
                     iono.B_magnitude_Home = mag_rx.F * 1e-9;
@@ -652,7 +641,9 @@ void displayResults(const LinkBudgetResults& results) {
     std::cout << "  Sky Noise: " << std::setprecision(1)
               << results.noise.skyNoiseTemp_K << " K";
 
-    if (g_skyModel.isMapLoaded()) {
+    if (DataRegistry::shared().skyModel()) {
+        std::cout << " (Haslam 408 MHz map, per-pixel spectral index)" << std::endl;
+    } else if (DataRegistry::shared().skyMap()) {
         std::cout << " (Haslam 408 MHz map)" << std::endl;
     } else {
         std::cout << " (Simplified model)" << std::endl;
@@ -689,23 +680,11 @@ int main() {
 
     std::cout << "[*] Loading Haslam 408 MHz Sky Map..." << std::endl;
 
-    const char* haslamPaths[] = {
-        "EMELinkBudget/data/haslam408_dsds_Remazeilles2014_ns2048.fits",
-        "data/haslam408_dsds_Remazeilles2014_ns2048.fits",
-        "../EMELinkBudget/data/haslam408_dsds_Remazeilles2014_ns2048.fits",
-        "../../EMELinkBudget/data/haslam408_dsds_Remazeilles2014_ns2048.fits"
-    };
-
-    bool haslamLoaded = false;
-    for (const char* path : haslamPaths) {
-        if (g_skyModel.loadSkyMap(path)) {
-            haslamLoaded = true;
-            std::cout << "[+] Haslam sky map loaded successfully" << std::endl;
-            break;
-        }
-    }
-
-    if (!haslamLoaded) {
+    if (DataRegistry::shared().skyModel()) {
+        std::cout << "[+] Multi-frequency sky model loaded successfully" << std::endl;
+    } else if (DataRegistry::shared().skyMap()) {
+        std::cout << "[+] Haslam sky map loaded successfully" << std::endl;
+    } else {
         std::cout << "[!] Could not load Haslam sky map, using simplified model" << std::endl;
     }
     std::cout << std::endl;
@@ -737,6 +716,8 @@ int main() {
 
     std::cout << "Calculating link budget..." << std::endl;
     EMELinkBudget linkBudget(params);
+    linkBudget.getPolarizationModule().getFaradayCalculator().setTraceSink(
+        std::make_shared<OStreamTraceSink>(std::cout));
     LinkBudgetResults results = linkBudget.calculate();
 
     displayResults(results);
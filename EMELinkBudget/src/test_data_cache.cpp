@@ -0,0 +1,174 @@
+#include "DataCache.h"
+#include "FileHttpTransport.h"
+#include "NOAAGlotecReader.h"
+#include "AstronomyAPIClient.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <memory>
+#include <cstdio>
+#include <cmath>
+
+static std::tm makeTime(int hour, int minute) {
+    std::tm t = {};
+    t.tm_year = 2026 - 1900;
+    t.tm_mon = 2 - 1;
+    t.tm_mday = 9;
+    t.tm_hour = hour;
+    t.tm_min = minute;
+    return t;
+}
+
+// 72 x 72 GLOTEC-style product with every value offset by `bias`.
+static std::string glotecBody(double bias) {
+    std::string out = "{\"type\": \"FeatureCollection\", \"features\": [\n";
+    char buf[200];
+    for (int row = 0; row < 72; ++row) {
+        for (int col = 0; col < 72; ++col) {
+            std::snprintf(buf, sizeof(buf),
+                          "{\"type\": \"Feature\", \"geometry\": {\"type\": \"Point\", \"coordinates\": "
+                          "[%.2f, %.2f]}, \"properties\": {\"tec\": %.2f}}%s\n",
+                          -177.5 + 5.0 * col, -88.75 + 2.5 * row, bias + 0.1 * row + 0.01 * col,
+                          (row == 71 && col == 71) ? "" : ",");
+            out += buf;
+        }
+    }
+    return out + "]}\n";
+}
+
+static std::string horizonsBody(double ra_deg) {
+    char buf[512];
+    std::snprintf(buf, sizeof(buf),
+                  "{\"signature\":{\"source\":\"NASA/JPL Horizons API\",\"version\":\"1.2\"},"
+                  "\"result\":\"*******\\n$$SOE\\n 2026-Feb-09 14:17:00.000, , ,%.6f,12.345678,"
+                  "384400.123456,0.0512,1.25,-3.5,0.11,0.22,\\n$$EOE\\n\"}",
+                  ra_deg);
+    return buf;
+}
+
+int main() {
+    std::cout << "Download Cache Test\n" << std::endl;
+
+    namespace fs = std::filesystem;
+    const fs::path root = fs::temp_directory_path() / "test_data_cache";
+    fs::remove_all(root);
+
+    FileHttpTransport http((root / "http").string());
+    SimpleHttpClient::setTransport(http.asTransport());
+
+    auto cache = std::make_shared<DataCache>((root / "cache").string(), 3600, 0);
+    std::time_t now = 1770646620;
+    cache->setClock([&now] { return now; });
+    check(cache->isUsable(), "cache directory created");
+
+    // ---------- GLOTEC ----------
+    NOAAGlotecReader glotec;
+    glotec.setCache(cache);
+    const std::tm request = makeTime(14, 17);
+    http.put(glotec.getDataUrl(request), glotecBody(10.0));
+
+    GlotecData first;
+    check(glotec.fetchTecData(request, first) && http.getRequestCount() == 1, "first GLOTEC fetch goes to HTTP");
+    check(cache->getStats().stores == 1, "decoded grid stored");
+
+    GlotecData second;
+    check(glotec.fetchTecData(makeTime(14, 19), second) && http.getRequestCount() == 1,
+          "same 5-minute slot served from disk");
+    check(second.isValid && second.numLon == first.numLon && second.numLat == first.numLat &&
+          second.lonStart == first.lonStart && second.latStep == first.latStep &&
+          second.tecValues == first.tecValues && second.timestamp.tm_min == first.timestamp.tm_min,
+          "cached grid round-trips exactly");
+
+    auto start = std::chrono::steady_clock::now();
+    const int loads = 200;
+    bool allHit = true;
+    for (int i = 0; i < loads; ++i) {
+        allHit = cache->loadGlotec(makeTime(14, 15), second) && allHit;
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / loads;
+    check(allHit, "repeated loads hit");
+    std::cout << "  GLOTEC grid load from disk: " << us << " us" << std::endl;
+
+    // Expired entry is refetched; when HTTP is unavailable the stale entry is used.
+    now += 7200;
+    http.put(glotec.getDataUrl(request), glotecBody(20.0));
+    GlotecData refreshed;
+    check(glotec.fetchTecData(request, refreshed) && http.getRequestCount() == 2 &&
+          std::abs(refreshed.tecValues[0] - 20.0f) < 1e-4, "expired grid is refetched");
+
+    now += 7200;
+    http.remove(glotec.getDataUrl(request));
+    std::size_t before = http.getRequestCount();
+    GlotecData offline;
+    check(glotec.fetchTecData(request, offline) && http.getRequestCount() > before &&
+          offline.tecValues == refreshed.tecValues, "offline run falls back to expired grid");
+    check(cache->getStats().expired >= 2, "expiry counted");
+
+    GlotecData none;
+    check(!glotec.fetchTecData(makeTime(3, 0), none), "uncached slot without HTTP fails");
+
+    // ---------- Horizons ----------
+    AstronomyAPIClient horizons;
+    horizons.setCache(cache);
+    const std::time_t obsTime = 1770646620;
+    const double lat = 31.77, lon = 116.87;
+    http.put(horizons.buildAPIUrl(obsTime, lat, lon), horizonsBody(123.456789));
+
+    AstronomyAPIClient::MoonData moon;
+    before = http.getRequestCount();
+    check(horizons.fetchMoonPosition(obsTime, lat, lon, moon) && http.getRequestCount() == before + 1 &&
+          moon.ra_deg == 123.456789, "first Horizons query goes to HTTP");
+
+    AstronomyAPIClient::MoonData cachedMoon;
+    check(horizons.fetchMoonPosition(obsTime, lat, lon, cachedMoon) && http.getRequestCount() == before + 1,
+          "repeated Horizons query served from disk");
+    check(cachedMoon.valid && cachedMoon.ra_deg == moon.ra_deg && cachedMoon.dec_deg == moon.dec_deg &&
+          cachedMoon.distance_km == moon.distance_km && cachedMoon.range_rate_km_s == moon.range_rate_km_s &&
+          cachedMoon.libration_lat_rate_deg_day == moon.libration_lat_rate_deg_day &&
+          cachedMoon.source == moon.source, "moon record round-trips exactly");
+
+    AstronomyAPIClient::MoonData otherSite;
+    check(!cache->loadMoon(obsTime, lat, lon + 0.001, otherSite) && !cache->loadMoon(obsTime + 60, lat, lon, otherSite),
+          "entries are keyed by time and site");
+
+    // A damaged entry is discarded rather than returned.
+    std::string entry;
+    for (const auto& file : fs::directory_iterator(root / "cache")) {
+        std::ifstream in(file.path(), std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (content.find("moon/") != std::string::npos) {
+            entry = file.path().string();
+        }
+    }
+    {
+        std::fstream damage(entry, std::ios::in | std::ios::out | std::ios::binary);
+        damage.seekp(-3, std::ios::end);
+        damage.put('\x7f');
+    }
+    check(!cache->loadMoon(obsTime, lat, lon, otherSite) && !fs::exists(entry), "corrupted entry is removed");
+
+    // ---------- Size limit ----------
+    cache->setTtl(0);
+    const std::uint64_t entrySize = fs::file_size(cache->getDirectory() + "/" +
+                                                  DataCache::hashName("glotec/2026-02-09T14:15") + ".emec");
+    cache->setMaxBytes(entrySize * 5 / 2);
+    check(cache->diskUsage() <= entrySize * 5 / 2, "lowering the limit trims the directory");
+
+    for (int minute = 0; minute < 25; minute += 5) {
+        check(cache->storeGlotec(makeTime(6, minute), refreshed), "store under size limit");
+    }
+    check(cache->diskUsage() <= entrySize * 5 / 2, "directory stays under the size limit");
+    check(cache->loadGlotec(makeTime(6, 20), none) && !cache->loadGlotec(makeTime(6, 0), none),
+          "least recently used entries are evicted first");
+    check(cache->getStats().evictions >= 3, "evictions counted");
+
+    cache->clear();
+    check(cache->diskUsage() == 0, "clear removes every entry");
+
+    SimpleHttpClient::resetTransport();
+    fs::remove_all(root);
+
+    return finishTests("GLOTEC and Horizons downloads are cached on disk");
+}
@@ -0,0 +1,161 @@
+#include "DataRegistry.h"
+#include "EMELinkBudget.h"
+#include "NoiseCalculator.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// ========== Synthetic Sky Map ==========
+// NSIDE 1 HEALPix table with every pixel at the same 408 MHz temperature,
+// one big-endian float per row after the primary header.
+
+static const double MAP_TEMP_K = 30.0;
+
+static std::string card(const std::string& text) {
+    std::string c = text;
+    c.resize(80, ' ');
+    return c;
+}
+
+static void writeSkyMap(const std::string& path) {
+    std::string primary = card("SIMPLE  =                    T") + card("BITPIX  =                    8") +
+                          card("NAXIS   =                    0") + card("END");
+    primary.resize(2880, ' ');
+
+    std::string header = card("XTENSION= 'BINTABLE'") + card("BITPIX  =                    8") +
+                         card("NAXIS   =                    2") + card("NAXIS1  =                    4") +
+                         card("NAXIS2  =                   12") + card("TFIELDS =                    1") +
+                         card("TFORM1  = 'E       '") + card("TUNIT1  = 'K       '") +
+                         card("ORDERING= 'RING    '") + card("COORDSYS= 'G       '") +
+                         card("NSIDE   =                    1") + card("END");
+    header.resize(2880, ' ');
+
+    std::string data(2880, '\0');
+    const float value = static_cast<float>(MAP_TEMP_K);
+    unsigned char bytes[4];
+    std::memcpy(bytes, &value, 4);
+    for (int pix = 0; pix < 12; ++pix) {
+        for (int i = 0; i < 4; ++i) {
+            data[4 * pix + i] = static_cast<char>(bytes[3 - i]);
+        }
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    out << primary << header << data;
+}
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / "eme_data_registry_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    // Concurrent first use loads once and every thread sees the same object.
+    {
+        DataRegistry registry;
+        registry.setCalendarPaths({(dir / "missing.dat").string(), "../data/calendar.dat"});
+
+        const int threads = 8;
+        std::vector<std::shared_ptr<const MoonCalendarReader>> seen(threads);
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threads; ++i) {
+            workers.emplace_back([&registry, &seen, i] { seen[i] = registry.calendar(); });
+        }
+        for (std::thread& t : workers) {
+            t.join();
+        }
+
+        check(seen[0] != nullptr, "calendar loaded from the second candidate");
+        for (int i = 1; i < threads; ++i) {
+            check(seen[i] == seen[0], "every thread shares one calendar");
+        }
+        check(registry.getStats().calendarLoads == 1, "calendar loaded exactly once");
+
+        std::tm date = {};
+        date.tm_year = 125;
+        date.tm_mon = 2;
+        date.tm_mday = 15;
+        double declination = 0.0;
+        check(seen[0] && seen[0]->getMoonDeclination(date, declination), "declination through the shared calendar");
+    }
+
+    // A missing dataset stays null and is not searched for again.
+    {
+        DataRegistry registry;
+        registry.setSkyMapPaths({(dir / "missing.fits").string()});
+        check(registry.skyMap() == nullptr, "missing sky map is null");
+        check(registry.skyMap() == nullptr, "missing sky map stays null");
+        check(registry.getStats().skyMapLoads == 1, "missing sky map searched once");
+
+        check(registry.ionex((dir / "missing.ionex").string()) == nullptr, "missing IONEX file is null");
+        check(registry.ionex((dir / "missing.ionex").string()) == nullptr, "missing IONEX file stays null");
+        check(registry.getStats().ionexLoads == 1, "IONEX file opened once per path");
+    }
+
+    // WMM comes from the embedded tables or the data directory.
+    {
+        DataRegistry registry;
+        registry.setWmmPaths({"../data/WMMHR.COF"});
+        std::shared_ptr<const WMMModel> wmm = registry.wmm();
+        check(wmm != nullptr, "WMM loaded");
+        check(wmm == registry.wmm(), "WMM shared");
+        if (wmm) {
+            MagneticFieldResult field = wmm->calculate(45.0, 10.0, 0.0, 2025.5);
+            check(field.F > 20000.0 && field.F < 70000.0, "WMM evaluates through the shared model");
+        }
+    }
+
+    // The noise calculator uses a loaded map instead of the simplified model.
+    {
+        const std::string mapPath = (dir / "sky.fits").string();
+        writeSkyMap(mapPath);
+
+        DataRegistry registry;
+        registry.setSkyMapPaths({mapPath});
+        std::shared_ptr<const HaslamSkyMap> map = registry.skyMap();
+        check(map != nullptr && map->getNside() == 1, "sky map loaded");
+
+        NoiseCalculator withoutMap;
+        withoutMap.setSkyMap(nullptr);
+        NoiseCalculator withMap;
+        withMap.setSkyMap(map);
+        check(withMap.getSkyNoiseModel().isMapLoaded(), "calculator holds the map");
+
+        const double expected = MAP_TEMP_K * std::pow(144.0 / 408.0, -2.55);
+        const double fromMap = withMap.calculateSkyNoiseTemp(144.0, 120.0, 80.0);
+        const double simplified = withoutMap.calculateSkyNoiseTemp(144.0, 120.0, 80.0);
+        check(std::abs(fromMap - expected) < 1e-9, "sky temperature taken from the map");
+        check(std::abs(simplified - expected) > 1.0, "simplified model differs from the map");
+        check(map.use_count() == 3, "calculators share the registry's map");
+    }
+
+    // Calculators take their datasets from the shared registry, so building
+    // one per thread is cheap once the data is loaded.
+    {
+        std::shared_ptr<const HaslamSkyMap> sharedMap = DataRegistry::shared().skyMap();
+        NoiseCalculator calculator;
+        check(calculator.getSkyNoiseModel().getSkyMap() == sharedMap, "default calculator uses the shared registry");
+
+        const int count = 2000;
+        auto t0 = std::chrono::steady_clock::now();
+        std::size_t sink = 0;
+        for (int i = 0; i < count; ++i) {
+            EMELinkBudget link;
+            sink += link.getNoiseCalculator().getSkyNoiseModel().isMapLoaded() ? 1 : 0;
+        }
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / count;
+        check(DataRegistry::shared().getStats().skyMapLoads == 1, "shared sky map searched once");
+        std::cout << "  per EMELinkBudget construction: " << us << " us (" << sink << " with map)" << std::endl;
+    }
+
+    fs::remove_all(dir);
+
+    return finishTests("Shared datasets load once and are used by the calculators");
+}
@@ -0,0 +1,199 @@
+#include "NOAAGlotecReader.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <random>
+#include <regex>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+
+// Previous two-pass std::regex parser, kept here as the reference implementation.
+static bool parseGeoJsonRegex(const std::string& jsonContent, GlotecData& data) {
+    data.tecValues.clear();
+    data.isValid = false;
+
+    std::regex coordRegex(R"("coordinates"\s*:\s*\[\s*(-?\d+\.?\d*)\s*,\s*(-?\d+\.?\d*)\s*\])");
+    std::regex tecRegex(R"("tec"\s*:\s*(-?\d+\.?\d*))");
+
+    std::vector<double> lons, lats;
+    std::vector<float> tecs;
+
+    for (auto it = std::sregex_iterator(jsonContent.begin(), jsonContent.end(), coordRegex);
+         it != std::sregex_iterator(); ++it) {
+        lons.push_back(std::stod((*it)[1].str()));
+        lats.push_back(std::stod((*it)[2].str()));
+    }
+    for (auto it = std::sregex_iterator(jsonContent.begin(), jsonContent.end(), tecRegex);
+         it != std::sregex_iterator(); ++it) {
+        tecs.push_back(std::stof((*it)[1].str()));
+    }
+
+    if (lons.size() != tecs.size() || lons.empty()) {
+        return false;
+    }
+
+    data.latStart = *std::min_element(lats.begin(), lats.end());
+    data.lonStart = *std::min_element(lons.begin(), lons.end());
+
+    std::vector<double> uniqueLats = lats;
+    std::sort(uniqueLats.begin(), uniqueLats.end());
+    uniqueLats.erase(std::unique(uniqueLats.begin(), uniqueLats.end()), uniqueLats.end());
+    if (uniqueLats.size() > 1) {
+        data.latStep = uniqueLats[1] - uniqueLats[0];
+        data.numLat = static_cast<int>(uniqueLats.size());
+    }
+
+    data.numLon = 72;
+    data.lonStep = 5.0;
+    data.tecValues.resize(data.numLon * data.numLat, 0.0f);
+
+    for (std::size_t i = 0; i < lons.size(); ++i) {
+        int col = static_cast<int>(std::round((lons[i] - data.lonStart) / data.lonStep));
+        int row = static_cast<int>(std::round((lats[i] - data.latStart) / data.latStep));
+        if (col >= 0 && col < data.numLon && row >= 0 && row < data.numLat) {
+            data.tecValues[col + row * data.numLon] = tecs[i];
+        }
+    }
+
+    data.isValid = true;
+    return true;
+}
+
+struct Point {
+    double lon;
+    double lat;
+    double tec;
+};
+
+static std::vector<Point> makeGrid(int numLon, int numLat, double lonStep, double latStep) {
+    std::vector<Point> points;
+    for (int row = 0; row < numLat; ++row) {
+        for (int col = 0; col < numLon; ++col) {
+            double lon = -180.0 + lonStep / 2.0 + col * lonStep;
+            double lat = -90.0 + latStep / 2.0 + row * latStep;
+            double tec = 20.0 + 15.0 * std::cos(lat * M_PI / 180.0) * std::sin(lon * M_PI / 90.0);
+            points.push_back({lon, lat, std::round(tec * 100.0) / 100.0});
+        }
+    }
+    return points;
+}
+
+// Feature layout of the SWPC glotec_icao products, one feature per line.
+static std::string toGeoJson(const std::vector<Point>& points, const char* newline = "\n") {
+    std::string out = "{\"type\": \"FeatureCollection\", \"features\": [";
+    out += newline;
+    char buf[256];
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        std::snprintf(buf, sizeof(buf),
+                      "{\"type\": \"Feature\", \"geometry\": {\"type\": \"Point\", "
+                      "\"coordinates\": [%.2f, %.2f]}, \"properties\": {\"quality_flag\": 1, "
+                      "\"tec\": %.2f, \"anomaly\": %.2f, \"hmF2\": %.1f, \"NmF2\": %.3e}}%s%s",
+                      points[i].lon, points[i].lat, points[i].tec, points[i].tec * 0.1 - 1.0,
+                      280.0 + points[i].lat, 1.5e11, i + 1 < points.size() ? "," : "", newline);
+        out += buf;
+    }
+    out += "]}";
+    out += newline;
+    return out;
+}
+
+static bool sameGrid(const GlotecData& a, const GlotecData& b) {
+    return a.isValid && b.isValid && a.numLon == b.numLon && a.numLat == b.numLat &&
+           a.lonStart == b.lonStart && a.latStart == b.latStart &&
+           a.lonStep == b.lonStep && a.latStep == b.latStep && a.tecValues == b.tecValues;
+}
+
+template <typename F>
+static double timeMs(F&& f, int repeats) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        f();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+static void benchmark(const NOAAGlotecReader& reader, const std::string& json, const std::string& label) {
+    GlotecData streamed, legacy;
+    double streamMs = timeMs([&] { reader.parseGeoJson(json, streamed); }, 20);
+    double regexMs = timeMs([&] { parseGeoJsonRegex(json, legacy); }, 1);
+    check(sameGrid(streamed, legacy), label + ": streaming parse matches regex parse");
+
+    std::cout << "  " << label << ": " << json.size() / 1024 << " KiB, "
+              << streamed.tecValues.size() << " points, regex " << regexMs << " ms, streaming "
+              << streamMs << " ms (" << regexMs / streamMs << "x)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::cout << "NOAA GLOTEC GeoJSON Parser Test\n" << std::endl;
+
+    NOAAGlotecReader reader;
+    const std::vector<Point> points = makeGrid(72, 72, 5.0, 2.5);
+    const std::string json = toGeoJson(points);
+
+    GlotecData data;
+    check(reader.parseGeoJson(json, data), "standard grid parses");
+    check(data.numLon == 72 && data.numLat == 72 && data.lonStart == -177.5 &&
+          data.latStart == -88.75 && data.lonStep == 5.0 && data.latStep == 2.5, "grid detected from features");
+    double tec = 0.0;
+    check(reader.getTecAtLocation(data, points[73].lat, points[73].lon, tec) &&
+          std::abs(tec - points[73].tec) < 1e-5, "grid value readable at its coordinates");
+
+    // North-to-south and shuffled feature order land on the same grid.
+    std::vector<Point> southward;
+    for (int row = 71; row >= 0; --row) {
+        southward.insert(southward.end(), points.begin() + row * 72, points.begin() + (row + 1) * 72);
+    }
+    GlotecData flipped;
+    check(reader.parseGeoJson(toGeoJson(southward), flipped) && sameGrid(flipped, data),
+          "descending latitude rows are flipped");
+
+    std::vector<Point> shuffled = points;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(42));
+    GlotecData regridded;
+    check(reader.parseGeoJson(toGeoJson(shuffled, "\r\n"), regridded) && sameGrid(regridded, data),
+          "shuffled CRLF file is regridded");
+
+    // A finer grid is no longer forced to 72 x 5 degrees.
+    const std::vector<Point> fine = makeGrid(144, 10, 2.5, 1.0);
+    GlotecData fineData;
+    check(reader.parseGeoJson(toGeoJson(fine), fineData) && fineData.numLon == 144 &&
+          fineData.lonStep == 2.5 && fineData.numLat == 10 && fineData.latStep == 1.0 &&
+          fineData.tecValues[143 + 9 * 144] == static_cast<float>(fine.back().tec),
+          "non-default grid spacing detected");
+
+    GlotecData sparse;
+    check(reader.parseGeoJson(
+              "{\"features\":[{\"geometry\":{\"coordinates\":[0,0]},\"properties\":{\"tec\":null}},"
+              "{\"geometry\":{\"coordinates\":[5,0]},\"properties\":{\"tec\":1.5e1}}]}", sparse) &&
+          sparse.numLon == 2 && sparse.tecValues[0] == 0.0f && sparse.tecValues[1] == 15.0f,
+          "null and exponent TEC values");
+
+    GlotecData empty;
+    check(!reader.parseGeoJson("{\"type\": \"FeatureCollection\", \"features\": []}", empty) && !empty.isValid,
+          "empty feature collection is rejected");
+    check(!reader.parseGeoJson("<html>404</html>", empty), "non-JSON body is rejected");
+
+    const std::string path = (std::filesystem::temp_directory_path() / "test_glotec_parse.geojson").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << json;
+    }
+    GlotecData fromFile;
+    check(reader.loadGeoJsonFile(path, fromFile) && sameGrid(fromFile, data), "recorded file loads via mapping");
+    std::remove(path.c_str());
+    check(!reader.loadGeoJsonFile(path, fromFile), "missing file is reported");
+
+    benchmark(reader, json, "synthetic 72x72");
+    if (argc > 1) {
+        std::ifstream in(argv[1], std::ios::binary);
+        std::ostringstream recorded;
+        recorded << in.rdbuf();
+        benchmark(reader, recorded.str(), argv[1]);
+    }
+
+    return finishTests("Streaming GeoJSON parser matches the regex parser");
+}
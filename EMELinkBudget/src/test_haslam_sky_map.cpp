@@ -0,0 +1,323 @@
+#include "HaslamSkyMap.h"
+#include "MappedFile.h"
+#include "NoiseCalculator.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <set>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const double DEG = M_PI / 180.0;
+
+// ========== Synthetic FITS Maps ==========
+
+static std::string card(const std::string& key, const std::string& value) {
+    std::string c = key;
+    c.resize(8, ' ');
+    c += "= " + value;
+    c.resize(80, ' ');
+    return c;
+}
+
+static std::string quoted(const std::string& s) {
+    std::string v = "'" + s;
+    v.resize(9, ' ');
+    return v + "'";
+}
+
+static void pad(std::string& s, char fill) {
+    s.resize((s.size() + 2879) / 2880 * 2880, fill);
+}
+
+static void putBigEndian(std::string& out, const void* value, int bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(value);
+    for (int i = bytes - 1; i >= 0; --i) {
+        out += static_cast<char>(p[i]);
+    }
+}
+
+// `values` in the given ordering. float32 tables use `repeat` values per row;
+// int16 tables store round(value / 0.01) with TSCAL1 = 0.01 and TNULL1.
+static void writeMap(const std::string& path, int nside, const std::vector<float>& values,
+                     const std::string& ordering, const std::string& coordsys,
+                     bool int16, int repeat) {
+    std::string primary = card("SIMPLE", "T") + card("BITPIX", "8") + card("NAXIS", "0");
+    std::string end = "END";
+    end.resize(80, ' ');
+    primary += end;
+    pad(primary, ' ');
+
+    const int width = int16 ? 2 : 4;
+    std::string header = card("XTENSION", quoted("BINTABLE")) + card("BITPIX", "8") + card("NAXIS", "2") +
+                         card("NAXIS1", std::to_string(repeat * width)) +
+                         card("NAXIS2", std::to_string(values.size() / repeat)) +
+                         card("PCOUNT", "0") + card("GCOUNT", "1") + card("TFIELDS", "1") +
+                         card("TTYPE1", quoted("TEMPERATURE")) +
+                         card("TFORM1", quoted(std::to_string(repeat) + (int16 ? "I" : "E"))) +
+                         card("TUNIT1", quoted("K")) +
+                         card("PIXTYPE", quoted("HEALPIX")) + card("ORDERING", quoted(ordering)) +
+                         card("COORDSYS", quoted(coordsys)) + card("NSIDE", std::to_string(nside)) +
+                         card("INDXSCHM", quoted("IMPLICIT"));
+    if (int16) {
+        header += card("TSCAL1", "0.01") + card("TZERO1", "0.0") + card("TNULL1", "-32768");
+    }
+    header += end;
+    pad(header, ' ');
+
+    std::string data;
+    for (float v : values) {
+        if (int16) {
+            int16_t raw = std::isnan(v) ? int16_t(-32768) : static_cast<int16_t>(std::lround(v / 0.01));
+            putBigEndian(data, &raw, 2);
+        } else {
+            putBigEndian(data, &v, 4);
+        }
+    }
+    pad(data, '\0');
+
+    std::ofstream out(path, std::ios::binary);
+    out << primary << header << data;
+}
+
+// Galactic latitude from the north galactic pole, independent of the
+// rotation matrix used by the map.
+static double galacticLatitude(double ra_deg, double dec_deg) {
+    const double raNGP = 192.85948 * DEG, decNGP = 27.12825 * DEG;
+    const double ra = ra_deg * DEG, dec = dec_deg * DEG;
+    return std::asin(std::sin(dec) * std::sin(decNGP) +
+                     std::cos(dec) * std::cos(decNGP) * std::cos(ra - raNGP)) / DEG;
+}
+
+// ========== Previous Lookup Path ==========
+// What getTemperature() did before maps were decoded at load: walk the FITS
+// headers from the start of the file, then byte-swap one int16 in place.
+// Only its cost is compared; the values are not meaningful for this file.
+
+static double headerWalkLookup(const MappedFile& file, int64_t pix) {
+    const char* data = file.data();
+    for (std::size_t offset = 0; offset + 2880 <= file.size(); offset += 2880) {
+        const char* header = data + offset;
+        if (std::strncmp(header, "XTENSION= 'BINTABLE'", 20) == 0) {
+            for (std::size_t i = 0; i < 2880; i += 80) {
+                if (std::strncmp(header + i, "END", 3) == 0) {
+                    const unsigned char* raw =
+                        reinterpret_cast<const unsigned char*>(data + offset + 2880 + 2 * pix);
+                    return static_cast<int16_t>((raw[0] << 8) | raw[1]) / 1000.0;
+                }
+            }
+        }
+    }
+    return 0.0;
+}
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / "eme_haslam_sky_map_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    // ========== HEALPix Pixelisation ==========
+    {
+        HealpixGrid base(1);
+        check(base.zphi2nest(0.9, 0.1) == 0, "north cap face 0");
+        check(base.zphi2nest(0.0, 0.0) == 4, "equatorial face 4");
+        check(base.zphi2nest(-0.9, 3.5 * M_PI / 2.0) == 11, "south cap face 11");
+        check(base.zphi2ring(0.0, 0.0) == 4, "ring pixel on the equator");
+        check(!HealpixGrid(48).isValid(), "non power of two NSIDE rejected");
+
+        for (int nside : {1, 2, 16, 256}) {
+            HealpixGrid grid(nside);
+            HealpixGrid parent(nside > 1 ? nside / 2 : 1);
+            bool roundTrip = true, hierarchy = true;
+            std::set<int64_t> rings;
+            for (int64_t pix = 0; pix < grid.getNpix(); ++pix) {
+                double z, phi;
+                grid.pix2zphiNest(pix, z, phi);
+                roundTrip = roundTrip && grid.zphi2nest(z, phi) == pix;
+                // Pixel centres lie inside their parent pixel.
+                if (nside > 1) {
+                    hierarchy = hierarchy && parent.zphi2nest(z, phi) == (pix >> 2);
+                }
+                rings.insert(grid.zphi2ring(z, phi));
+            }
+            check(roundTrip, "NESTED pix2ang/ang2pix round trip at NSIDE " + std::to_string(nside));
+            check(hierarchy, "NESTED children inside their parent at NSIDE " + std::to_string(nside));
+            check(static_cast<int64_t>(rings.size()) == grid.getNpix(),
+                  "RING and NESTED pixel centres match one to one at NSIDE " + std::to_string(nside));
+        }
+    }
+
+    // ========== Galactic Map Reprojection ==========
+    // T = 100 K + b (deg): the equatorial lookup must follow galactic latitude.
+    const int nside = 64;
+    HealpixGrid grid(nside);
+    std::vector<float> ringMap(grid.getNpix());
+    for (int64_t pix = 0; pix < grid.getNpix(); ++pix) {
+        double z, phi;
+        grid.pix2zphiNest(pix, z, phi);
+        ringMap[grid.zphi2ring(z, phi)] = static_cast<float>(100.0 + std::asin(z) / DEG);
+    }
+    const std::string galacticPath = (dir / "galactic.fits").string();
+    writeMap(galacticPath, nside, ringMap, "RING", "G", false, 1024);
+
+    HaslamSkyMap map;
+    check(map.loadFITS(galacticPath), "galactic RING map loads");
+    check(map.getNside() == nside, "NSIDE read from the header");
+    check(map.getPixels().size() == static_cast<std::size_t>(grid.getNpix()), "map decoded at load");
+
+    check(std::abs(map.getTemperature(266.40499, -28.93617) - 100.0) < 1.5, "galactic centre on the plane");
+    check(std::abs(map.getTemperature(192.85948, 27.12825) - 190.0) < 1.5, "north galactic pole");
+    check(std::abs(map.getTemperature(12.85948, -27.12825) - 10.0) < 1.5, "south galactic pole");
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const int samples = 1000000;
+    std::vector<double> ra(samples), dec(samples);
+    for (int i = 0; i < samples; ++i) {
+        ra[i] = 360.0 * uniform(rng);
+        dec[i] = std::asin(2.0 * uniform(rng) - 1.0) / DEG;
+    }
+
+    double maxError = 0.0, sumError = 0.0;
+    for (int i = 0; i < 20000; ++i) {
+        double error = std::abs(map.getTemperature(ra[i], dec[i]) - (100.0 + galacticLatitude(ra[i], dec[i])));
+        maxError = std::max(maxError, error);
+        sumError += error;
+    }
+    check(maxError < 1.5, "reprojected latitude within two pixels");
+    check(sumError / 20000 < 0.5, "reprojected latitude mean error");
+    std::cout << "  reprojection |dT| max " << maxError << " K, mean " << sumError / 20000 << " K" << std::endl;
+
+    // ========== Equatorial NESTED int16 Map ==========
+    {
+        std::vector<float> nestMap(grid.getNpix());
+        for (int64_t pix = 0; pix < grid.getNpix(); ++pix) {
+            double z, phi;
+            grid.pix2zphiNest(pix, z, phi);
+            nestMap[pix] = static_cast<float>(100.0 + std::asin(z) / DEG);
+        }
+        const int64_t blank = grid.zphi2nest(0.0, M_PI);
+        nestMap[blank] = NAN;
+        const std::string path = (dir / "equatorial.fits").string();
+        writeMap(path, nside, nestMap, "NESTED", "C", true, 1);
+
+        HaslamSkyMap equatorial;
+        check(equatorial.loadFITS(path), "equatorial NESTED int16 map loads");
+        double worst = 0.0;
+        for (int i = 0; i < 20000; ++i) {
+            double t = equatorial.getTemperature(ra[i], dec[i]);
+            if (t != 0.0) {
+                worst = std::max(worst, std::abs(t - (100.0 + dec[i])));
+            }
+        }
+        check(worst < 1.0, "equatorial map used without rotation");
+        check(equatorial.getTemperature(180.0, 0.0) == 0.0, "TNULL pixel has no data");
+        check(std::abs(equatorial.getPixels()[0] - nestMap[0]) < 0.006, "TSCAL applied");
+    }
+
+    check(!HaslamSkyMap().loadFITS((dir / "missing.fits").string()), "missing file rejected");
+
+    // ========== Beam Pyramid ==========
+    // 20 K background with a Gaussian source of 2 deg sigma: seen through a
+    // Gaussian beam its peak drops to A s^2 / (s^2 + sigma_beam^2), where the
+    // beam excludes the survey resolution the finest level already carries.
+    {
+        const int beamNside = 256;
+        const double amplitude = 1000.0, width = 2.0;
+        const double srcRa = 150.0, srcDec = 20.0;
+        HealpixGrid beamGrid(beamNside);
+        std::vector<float> blob(beamGrid.getNpix());
+        const double src[3] = {std::cos(srcDec * DEG) * std::cos(srcRa * DEG),
+                               std::cos(srcDec * DEG) * std::sin(srcRa * DEG), std::sin(srcDec * DEG)};
+        for (int64_t pix = 0; pix < beamGrid.getNpix(); ++pix) {
+            double z, phi;
+            beamGrid.pix2zphiNest(pix, z, phi);
+            const double r = std::sqrt(1.0 - z * z);
+            const double cosD = r * std::cos(phi) * src[0] + r * std::sin(phi) * src[1] + z * src[2];
+            const double d = std::acos(std::max(-1.0, std::min(1.0, cosD))) / DEG;
+            blob[pix] = static_cast<float>(20.0 + amplitude * std::exp(-0.5 * d * d / (width * width)));
+        }
+        const std::string path = (dir / "blob.fits").string();
+        writeMap(path, beamNside, blob, "NESTED", "C", false, 1024);
+
+        HaslamSkyMap sky;
+        auto t0 = std::chrono::steady_clock::now();
+        check(sky.loadFITS(path), "source map loads");
+        const double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+        check(sky.getPyramidLevels() >= 7, "pyramid reaches wide beams");
+        check(std::abs(sky.getLevelBeam(0) - HaslamSkyMap::SURVEY_BEAM_DEG) < 1e-12, "finest level at survey resolution");
+        bool doubling = true;
+        for (std::size_t k = 1; k < sky.getPyramidLevels(); ++k) {
+            doubling = doubling && sky.getLevelNside(k) * 2 == sky.getLevelNside(k - 1) &&
+                       std::abs(sky.getLevelBeam(k) - 2.0 * sky.getLevelBeam(k - 1)) < 1e-9;
+        }
+        check(doubling, "each level halves NSIDE and doubles the beam");
+
+        check(sky.getBeamTemperature(srcRa, srcDec, 0.5) == sky.getTemperature(srcRa, srcDec),
+              "narrow beam samples the full-resolution map");
+        check(std::abs(sky.getBeamTemperature(330.0, -40.0, 5.0) - 20.0) < 0.2, "background unchanged by smoothing");
+
+        for (double fwhm : {3.0, 10.0, 25.0}) {
+            const double sigma2 = (fwhm * fwhm - HaslamSkyMap::SURVEY_BEAM_DEG * HaslamSkyMap::SURVEY_BEAM_DEG) /
+                                  (2.3548200450309493 * 2.3548200450309493);
+            const double expected = amplitude * width * width / (width * width + sigma2);
+            const double got = sky.getBeamTemperature(srcRa, srcDec, fwhm) - 20.0;
+            check(std::abs(got / expected - 1.0) < 0.1, "beam-averaged peak at " + std::to_string(fwhm) + " deg");
+            std::cout << "  " << fwhm << " deg beam: peak " << got << " K (Gaussian " << expected << " K)" << std::endl;
+        }
+
+        NoiseCalculator noise;
+        noise.setSkyMap(std::make_shared<HaslamSkyMap>(std::move(sky)));
+        const double beam = SkyNoiseModel::beamwidthFromGain(30.0);
+        check(std::abs(beam - 6.1) < 0.1, "30 dBi Gaussian beam is about 6 deg wide");
+        const HaslamSkyMap& shared = *noise.getSkyNoiseModel().getSkyMap();
+        const double expectedSky = shared.getBeamTemperature(srcRa, srcDec, beam) * std::pow(144.0 / 408.0, -2.55);
+        check(std::abs(noise.calculateSkyNoiseTemp(144.0, srcRa, srcDec, beam) - expectedSky) < 1e-9,
+              "sky noise uses the beam-averaged map");
+        NoiseResults narrow = noise.calculate(144.0, 2500.0, 40.0, 0.0, 0.5, 45.0, srcRa, srcDec);
+        NoiseResults wide = noise.calculate(144.0, 2500.0, 20.0, 0.0, 0.5, 45.0, srcRa, srcDec);
+        check(narrow.skyNoiseTemp_K > wide.skyNoiseTemp_K, "higher gain sees more of a compact source");
+
+        double sink = 0.0;
+        t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < samples; ++i) {
+            sink += shared.getBeamTemperature(ra[i], dec[i], 2.0 + 20.0 * (i & 7) / 7.0);
+        }
+        const double beamNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / samples;
+        check(sink > 0.0, "beam benchmark produced values");
+        std::cout << "  NSIDE " << beamNside << " load with pyramid " << loadMs << " ms, beam lookup "
+                  << beamNs << " ns" << std::endl;
+    }
+
+    // ========== Lookup Cost ==========
+    {
+        MappedFile legacy(galacticPath);
+        double sink = 0.0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < samples; ++i) {
+            sink += headerWalkLookup(legacy, grid.zphi2nest(std::sin(dec[i] * DEG), ra[i] * DEG));
+        }
+        const double walkNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / samples;
+
+        t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < samples; ++i) {
+            sink += map.getTemperature(ra[i], dec[i]);
+        }
+        const double lookupNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / samples;
+
+        check(sink != 0.0, "benchmark produced values");
+        std::cout << "  per lookup: header walk " << walkNs << " ns, decoded map " << lookupNs
+                  << " ns (" << walkNs / lookupNs << "x)" << std::endl;
+    }
+
+    fs::remove_all(dir);
+
+    return finishTests("Haslam maps are decoded, reprojected and looked up correctly");
+}
@@ -0,0 +1,194 @@
+#include "HealpixGrid.h"
+#include "HaslamSkyMap.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const double DEG = M_PI / 180.0;
+
+// Equatorial NESTED float map, T = 100 K + declination at pixel centres.
+static void writeDeclinationMap(const std::string& path, const HealpixGrid& grid) {
+    auto card = [](const std::string& key, const std::string& value) {
+        std::string c = key;
+        c.resize(8, ' ');
+        c += "= " + value;
+        c.resize(80, ' ');
+        return c;
+    };
+    std::string end = "END";
+    end.resize(80, ' ');
+
+    std::string primary = card("SIMPLE", "T") + card("BITPIX", "8") + card("NAXIS", "0") + end;
+    primary.resize(2880, ' ');
+    std::string header = card("XTENSION", "'BINTABLE'") + card("BITPIX", "8") + card("NAXIS", "2") +
+                         card("NAXIS1", "4") + card("NAXIS2", std::to_string(grid.getNpix())) +
+                         card("TFIELDS", "1") + card("TFORM1", "'E       '") +
+                         card("ORDERING", "'NESTED  '") + card("COORDSYS", "'C       '") +
+                         card("NSIDE", std::to_string(grid.getNside())) + end;
+    header.resize((header.size() + 2879) / 2880 * 2880, ' ');
+
+    std::string data;
+    for (int64_t pix = 0; pix < grid.getNpix(); ++pix) {
+        double z, phi;
+        grid.pix2zphiNest(pix, z, phi);
+        const float t = static_cast<float>(100.0 + std::asin(z) / DEG);
+        unsigned char b[4];
+        std::memcpy(b, &t, 4);
+        for (int i = 3; i >= 0; --i) {
+            data += static_cast<char>(b[i]);
+        }
+    }
+    data.resize((data.size() + 2879) / 2880 * 2880, '\0');
+
+    std::ofstream out(path, std::ios::binary);
+    out << primary << header << data;
+}
+
+int main() {
+    const std::size_t count = 2000000;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<double> z(count), phi(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        z[i] = 2.0 * uniform(rng) - 1.0;
+        phi[i] = 4.0 * M_PI * uniform(rng) - M_PI;  // includes negative and > 2 pi
+    }
+    // Boundaries: poles, the cap/belt transition and the phi seam.
+    const double edges[][2] = {{1.0, 0.0}, {-1.0, 0.0}, {2.0 / 3.0, 1.0}, {-2.0 / 3.0, 1.0},
+                               {0.0, 2.0 * M_PI}, {0.3, -1e-12}, {0.99999, 6.283185}};
+    for (std::size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); ++i) {
+        z[i] = edges[i][0];
+        phi[i] = edges[i][1];
+    }
+
+    // ========== Batched Pixel Numbers ==========
+    for (int nside : {1, 4, 64, 2048, 8192}) {
+        HealpixGrid grid(nside);
+        std::vector<int64_t> batch(count);
+        grid.zphi2nestBatch(z.data(), phi.data(), batch.data(), count);
+        bool same = true;
+        for (std::size_t i = 0; i < count && same; ++i) {
+            same = batch[i] == grid.zphi2nest(z[i], phi[i]);
+        }
+        check(same, "batch matches scalar ang2pix at NSIDE " + std::to_string(nside));
+    }
+
+    // ========== RING to NESTED ==========
+    for (int nside : {1, 2, 32}) {
+        HealpixGrid grid(nside);
+        bool same = true;
+        for (int64_t pix = 0; pix < grid.getNpix(); ++pix) {
+            double pz, pphi;
+            grid.pix2zphiNest(pix, pz, pphi);
+            same = same && grid.ring2nest(grid.zphi2ring(pz, pphi)) == pix;
+        }
+        check(same, "ring2nest inverts the RING numbering at NSIDE " + std::to_string(nside));
+    }
+
+    // ========== Interpolation Weights ==========
+    {
+        HealpixGrid grid(32);
+        bool normalised = true, valid = true;
+        for (std::size_t i = 0; i < 100000; ++i) {
+            int64_t pix[4];
+            double w[4];
+            grid.getInterpolation(z[i], phi[i], pix, w);
+            double sum = 0.0;
+            for (int k = 0; k < 4; ++k) {
+                sum += w[k];
+                valid = valid && pix[k] >= 0 && pix[k] < grid.getNpix() && w[k] >= -1e-12 && w[k] <= 1.0 + 1e-12;
+            }
+            normalised = normalised && std::abs(sum - 1.0) < 1e-12;
+        }
+        check(normalised, "interpolation weights sum to one");
+        check(valid, "interpolation pixels and weights in range");
+
+        bool centred = true;
+        for (int64_t pix = 0; pix < grid.getNpix(); ++pix) {
+            double pz, pphi;
+            grid.pix2zphiNest(pix, pz, pphi);
+            int64_t near[4];
+            double w[4];
+            grid.getInterpolation(pz, pphi, near, w);
+            double own = 0.0;
+            for (int k = 0; k < 4; ++k) {
+                if (near[k] == pix) own += w[k];
+            }
+            centred = centred && own > 1.0 - 1e-9;
+        }
+        check(centred, "pixel centres interpolate to the pixel itself");
+    }
+
+    // ========== Sky Map Batch Lookups ==========
+    const fs::path dir = fs::temp_directory_path() / "eme_healpix_batch_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const std::string path = (dir / "declination.fits").string();
+    writeDeclinationMap(path, HealpixGrid(64));
+
+    HaslamSkyMap map;
+    check(map.loadFITS(path), "declination map loads");
+
+    const std::size_t points = 200000;
+    std::vector<double> ra(points), dec(points), nearest(points), smooth(points);
+    for (std::size_t i = 0; i < points; ++i) {
+        ra[i] = 360.0 * uniform(rng);
+        dec[i] = std::asin(2.0 * uniform(rng) - 1.0) / DEG;
+    }
+    map.getTemperatures(ra.data(), dec.data(), nearest.data(), points);
+    map.getTemperatures(ra.data(), dec.data(), smooth.data(), points, true);
+
+    bool batchSame = true;
+    double nearestErr = 0.0, smoothErr = 0.0, smoothMax = 0.0;
+    for (std::size_t i = 0; i < points; ++i) {
+        batchSame = batchSame && nearest[i] == map.getTemperature(ra[i], dec[i]) &&
+                    smooth[i] == map.getInterpolatedTemperature(ra[i], dec[i]);
+        nearestErr += std::abs(nearest[i] - (100.0 + dec[i]));
+        if (std::abs(dec[i]) < 85.0) {
+            smoothErr += std::abs(smooth[i] - (100.0 + dec[i]));
+            smoothMax = std::max(smoothMax, std::abs(smooth[i] - (100.0 + dec[i])));
+        }
+    }
+    check(batchSame, "batched map lookups match the scalar ones");
+    check(smoothErr < 0.2 * nearestErr, "interpolation follows a smooth map more closely");
+    check(smoothMax < 0.05, "interpolation exact in declination away from the poles");
+    std::cout << "  mean |dT| nearest " << nearestErr / points << " K, interpolated "
+              << smoothErr / points << " K" << std::endl;
+
+    // ========== Throughput ==========
+    {
+        HealpixGrid grid(2048);
+        std::vector<int64_t> out(count);
+        auto t0 = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = grid.zphi2nest(z[i], phi[i]);
+        }
+        const double scalarS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        int64_t sink = out[count / 2];
+
+        t0 = std::chrono::steady_clock::now();
+        grid.zphi2nestBatch(z.data(), phi.data(), out.data(), count);
+        const double batchS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        sink += out[count / 3];
+
+        t0 = std::chrono::steady_clock::now();
+        map.getTemperatures(ra.data(), dec.data(), smooth.data(), points, true);
+        const double interpS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        check(sink >= 0, "benchmark produced pixels");
+        std::cout << "  ang2pix: scalar " << count / scalarS / 1e6 << " M/s, batch " << count / batchS / 1e6
+                  << " M/s; interpolated lookup " << points / interpS / 1e6 << " M/s" << std::endl;
+    }
+
+    fs::remove_all(dir);
+
+    return finishTests("Batched HEALPix lookups and interpolation are correct");
+}
@@ -0,0 +1,238 @@
+#include "AstronomyAPIClient.h"
+#include "HorizonsTable.h"
+#include "DataCache.h"
+#include "FileHttpTransport.h"
+#include "EMELinkBudget.h"
+#include "MaidenheadGrid.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include <cstdio>
+#include <cmath>
+
+namespace fs = std::filesystem;
+
+static double deg(double rad) {
+    return rad * 180.0 / M_PI;
+}
+
+// Geocentric range response in the CSV layout of QUANTITIES='2,20', with
+// the built-in ephemeris standing in for Horizons.
+static std::string rangeBody(std::time_t start, std::time_t stop, std::time_t step, bool shuffle = false) {
+    static const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    LunarEphemeris ephemeris;
+    std::string out = "{\"signature\":{\"source\":\"NASA/JPL Horizons API\",\"version\":\"1.2\"},"
+                      "\"result\":\"*******\\n Date__(UT)__HR:MN:SC.fff, , , R.A._(a-apparent), "
+                      "DEC_(a-apparent), delta, deldot,\\n$$SOE\\n";
+    std::vector<std::time_t> times;
+    for (std::time_t t = start; t <= stop; t += step) {
+        times.push_back(t);
+    }
+    if (shuffle) {
+        std::swap(times[1], times[2]);
+    }
+    for (std::time_t t : times) {
+        const LunarPosition p = ephemeris.calculate(t);
+        const std::tm* tm = std::gmtime(&t);
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      " %04d-%s-%02d %02d:%02d:%02d.000, , ,%.9f,%.9f,%.9f,%.10f,\\n",
+                      tm->tm_year + 1900, months[tm->tm_mon], tm->tm_mday, tm->tm_hour, tm->tm_min,
+                      tm->tm_sec, deg(p.rightAscension), deg(p.declination), p.distance_km,
+                      p.rangeRate_km_s);
+        out += line;
+    }
+    return out + "$$EOE\\n*******\\n\"}";
+}
+
+// Meeus, Astronomical Algorithms ch. 40: rigorous parallax in RA and Dec.
+static void meeusParallax(double ra, double dec, double distance_km, double hourAngle,
+                          double lat, double height_m, double& topoRa, double& topoDec) {
+    const double b_a = 0.99664719;
+    const double u = std::atan(b_a * std::tan(lat));
+    const double rhoSin = b_a * std::sin(u) + height_m / 6378140.0 * std::sin(lat);
+    const double rhoCos = std::cos(u) + height_m / 6378140.0 * std::cos(lat);
+    const double sinPi = 6378.14 / distance_km;
+    const double dRa = std::atan2(-rhoCos * sinPi * std::sin(hourAngle),
+                                  std::cos(dec) - rhoCos * sinPi * std::cos(hourAngle));
+    topoRa = ra + dRa;
+    topoDec = std::atan2((std::sin(dec) - rhoSin * sinPi) * std::cos(dRa),
+                         std::cos(dec) - rhoCos * sinPi * std::cos(hourAngle));
+}
+
+static double apparentSiderealTime(double time) {
+    const double days = (time - 946728000.0) / 86400.0;
+    const double jd = 2451545.0 + days;
+    const double t = days / 36525.0;
+    const double gmst = 280.46061837 + 360.98564736629 * days
+                        + 0.000387933 * t * t - t * t * t / 38710000.0;
+    double dpsi, deps, eps0;
+    LunarEphemeris::nutation(jd + LunarEphemeris::deltaT(jd) / 86400.0, dpsi, deps, eps0);
+    return (gmst + dpsi * std::cos((eps0 + deps) * M_PI / 180.0)) * M_PI / 180.0;
+}
+
+int main() {
+    std::cout << "Horizons Range Query Test\n" << std::endl;
+
+    const fs::path root = fs::temp_directory_path() / "test_horizons_range";
+    fs::remove_all(root);
+    fs::create_directories(root / "http");
+
+    FileHttpTransport http((root / "http").string());
+    SimpleHttpClient::setTransport(http.asTransport());
+
+    const std::time_t start = 1770645600;  // 2026-02-09 14:00 UTC
+    const std::time_t stop = start + 6 * 3600;
+    const std::time_t step = 600;
+
+    AstronomyAPIClient horizons;
+    const std::string url = horizons.buildRangeUrl(start, stop, step);
+    check(url.find("STEP_SIZE='10m'") != std::string::npos && url.find("CENTER='500@399'") != std::string::npos,
+          "one geocentric request spans the pass");
+    http.put(url, rangeBody(start, stop, step));
+
+    HorizonsTable table;
+    check(horizons.fetchMoonRange(start, stop, step, table), "range query succeeds");
+    check(http.getRequestCount() == 1 && table.size() == 37, "all rows come from one request");
+    check(table.startTime() == start && table.endTime() == stop, "rows are time-indexed from the response");
+
+    // Interpolation between rows against the generating ephemeris.
+    LunarEphemeris ephemeris;
+    double maxAngle = 0.0, maxDistance = 0.0, maxRate = 0.0, maxLibration = 0.0;
+    for (std::time_t t = start; t <= stop; t += 37) {
+        AstronomyAPIClient::MoonData geo;
+        if (!table.interpolate(static_cast<double>(t), geo)) {
+            check(false, "covered time interpolates");
+            break;
+        }
+        const LunarPosition p = ephemeris.calculate(t);
+        maxAngle = std::max({maxAngle, std::abs(std::remainder(geo.ra_deg - deg(p.rightAscension), 360.0)),
+                             std::abs(geo.dec_deg - deg(p.declination))});
+        maxDistance = std::max(maxDistance, std::abs(geo.distance_km - p.distance_km));
+        maxRate = std::max(maxRate, std::abs(geo.range_rate_km_s - p.rangeRate_km_s));
+        maxLibration = std::max({maxLibration, std::abs(geo.libration_lon_deg - p.librationLon_deg),
+                                 std::abs(geo.libration_lat_deg - p.librationLat_deg)});
+    }
+    check(maxAngle < 1e-5, "RA/Dec interpolate to 0.04 arcsec");
+    check(maxDistance < 1e-3 && maxRate < 1e-6, "distance and range rate interpolate");
+    check(maxLibration < 1e-5, "libration filled from the analytic theory");
+    std::cout << "  max interpolation error: " << maxAngle * 3600.0 << " arcsec, " << maxDistance * 1000.0
+              << " m, " << maxRate * 1000.0 << " m/s" << std::endl;
+
+    AstronomyAPIClient::MoonData outside;
+    check(!table.interpolate(static_cast<double>(stop + 1), outside) &&
+          !table.interpolate(static_cast<double>(start - 1), outside), "times outside the table fail");
+
+    // Several sites from the same rows, no further requests.
+    struct Site { const char* grid; double height_m; };
+    const Site sites[] = {{"FN20xa", 120.0}, {"JO62qm", 40.0}, {"PM96", 0.0}, {"QF56", 900.0}};
+    double maxParallaxErr = 0.0, maxElevationErr = 0.0, maxRangeRateErr = 0.0;
+    GeometryCalculator geometry;
+    for (const Site& site : sites) {
+        double lat, lon;
+        MaidenheadGrid::gridToLatLon(site.grid, lat, lon);
+        for (std::time_t t = start + 300; t < stop; t += 1234) {
+            AstronomyAPIClient::MoonData geo, topo, before, after;
+            table.interpolate(static_cast<double>(t), geo);
+            table.topocentric(static_cast<double>(t), lat, lon, site.height_m, topo);
+            table.topocentric(t - 1.0, lat, lon, site.height_m, before);
+            table.topocentric(t + 1.0, lat, lon, site.height_m, after);
+
+            const double lst = apparentSiderealTime(static_cast<double>(t)) + lon * M_PI / 180.0;
+            const double ra = geo.ra_deg * M_PI / 180.0;
+            double topoRa, topoDec;
+            meeusParallax(ra, geo.dec_deg * M_PI / 180.0, geo.distance_km, lst - ra,
+                          lat * M_PI / 180.0, site.height_m, topoRa, topoDec);
+            maxParallaxErr = std::max({maxParallaxErr,
+                                       std::abs(std::remainder(topo.ra_deg - deg(topoRa), 360.0)),
+                                       std::abs(topo.dec_deg - deg(topoDec))});
+
+            double az, el;
+            geometry.calculateMoonPosition(lat * M_PI / 180.0, lon * M_PI / 180.0, topo.ra_deg * M_PI / 180.0,
+                                           topo.dec_deg * M_PI / 180.0, lst - topo.ra_deg * M_PI / 180.0, az, el);
+            maxElevationErr = std::max(maxElevationErr, std::abs(topo.elevation_deg - deg(el)));
+            maxRangeRateErr = std::max(maxRangeRateErr,
+                                       std::abs(topo.range_rate_km_s - (after.distance_km - before.distance_km) / 2.0));
+        }
+    }
+    check(maxParallaxErr < 1e-6, "topocentric RA/Dec match the rigorous parallax formulae");
+    check(maxElevationErr < 1e-9, "elevation from the topocentric place");
+    check(maxRangeRateErr < 1e-6, "topocentric range rate includes Earth rotation");
+    check(http.getRequestCount() == 1, "site values need no further requests");
+    std::cout << "  topocentric vs Meeus ch. 40: " << maxParallaxErr * 3600.0 << " arcsec" << std::endl;
+
+    // Cached range is reused and survives a round trip exactly.
+    auto cache = std::make_shared<DataCache>((root / "cache").string());
+    AstronomyAPIClient cached;
+    cached.setCache(cache);
+    HorizonsTable first, second;
+    check(cached.fetchMoonRange(start, stop, step, first) && http.getRequestCount() == 2, "first cached query goes to HTTP");
+    check(cached.fetchMoonRange(start, stop, step, second) && http.getRequestCount() == 2, "repeated range served from disk");
+    bool same = second.size() == first.size();
+    for (std::size_t i = 0; same && i < first.size(); ++i) {
+        const HorizonsTable::Row& a = first.rows()[i];
+        const HorizonsTable::Row& b = second.rows()[i];
+        same = a.time == b.time && a.ra_deg == b.ra_deg && a.dec_deg == b.dec_deg &&
+               a.distance_km == b.distance_km && a.range_rate_km_s == b.range_rate_km_s &&
+               a.libration_lon_deg == b.libration_lon_deg && a.libration_lat_deg == b.libration_lat_deg;
+    }
+    check(same, "cached rows round-trip exactly");
+
+    // Rejected requests and responses.
+    HorizonsTable rejected;
+    check(!horizons.fetchMoonRange(start, stop, 90, rejected) && !horizons.getLastError().empty(),
+          "steps must be whole minutes");
+    check(!horizons.fetchMoonRange(start, stop, 1200, rejected) && rejected.empty(), "missing response fails");
+    http.put(horizons.buildRangeUrl(start, stop, 1800), rangeBody(start, stop, 1800, true));
+    check(!horizons.fetchMoonRange(start, stop, 1800, rejected) &&
+          horizons.getLastError().find("order") != std::string::npos, "rows out of order are rejected");
+
+    // The link budget interpolates the table at every step.
+    LinkBudgetParameters params;
+    double lat, lon;
+    MaidenheadGrid::gridToLatLon("FN20xa", lat, lon);
+    params.txSite.latitude = ParameterUtils::deg2rad(lat);
+    params.txSite.longitude = ParameterUtils::deg2rad(lon);
+    MaidenheadGrid::gridToLatLon("JO62qm", lat, lon);
+    params.rxSite.latitude = ParameterUtils::deg2rad(lat);
+    params.rxSite.longitude = ParameterUtils::deg2rad(lon);
+
+    auto shared = std::make_shared<HorizonsTable>(table);
+    EMELinkBudget calculator(params);
+    calculator.setHorizonsTable(shared);
+    LinkBudgetResultsBatch pass = calculator.calculateSeries(start, stop, 60);
+    LunarPosition expected;
+    table.calculate(start + 60 * 100, expected);
+    check(pass.size() == 361 && pass.string(pass.geometry.ephemerisSourceId[100]) == HorizonsTable::SOURCE_NAME,
+          "series uses the Horizons table");
+    check(std::abs(pass.geometry.moonRA_deg[100] - deg(expected.rightAscension)) < 1e-9 &&
+          std::abs(pass.geometry.moonDistance_km[100] - expected.distance_km) < 1e-9,
+          "series row is the interpolated position");
+
+    LinkBudgetResultsBatch beyond = calculator.calculateSeries(start, stop + 3600, 60);
+    check(beyond.string(beyond.geometry.ephemerisSourceId[0]) != HorizonsTable::SOURCE_NAME,
+          "series past the table falls back");
+
+    // Lookup cost against one request per timestep and site.
+    const int lookups = 200000;
+    double sink = 0.0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; ++i) {
+        AstronomyAPIClient::MoonData site;
+        table.topocentric(start + 0.1 * i, lat, lon, 0.0, site);
+        sink += site.elevation_deg;
+    }
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / lookups;
+    check(sink != 0.0, "benchmark produced positions");
+    std::cout << "  topocentric lookup: " << us << " us (one request for "
+              << (stop - start) / 60 + 1 << " steps x " << std::size(sites) << " sites)" << std::endl;
+
+    SimpleHttpClient::resetTransport();
+    fs::remove_all(root);
+
+    return finishTests("Horizons range query serves the pass locally");
+}
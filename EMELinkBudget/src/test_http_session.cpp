@@ -0,0 +1,357 @@
+#include "HttpSession.h"
+#include "SimpleHttpClient.h"
+#include "FileHttpTransport.h"
+#include "NOAAGlotecReader.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 72 x 72 GLOTEC-style product with every value offset by `bias`.
+static std::string glotecBody(double bias) {
+    std::string out = "{\"type\": \"FeatureCollection\", \"features\": [\n";
+    char buf[200];
+    for (int row = 0; row < 72; ++row) {
+        for (int col = 0; col < 72; ++col) {
+            std::snprintf(buf, sizeof(buf),
+                          "{\"type\": \"Feature\", \"geometry\": {\"type\": \"Point\", \"coordinates\": "
+                          "[%.2f, %.2f]}, \"properties\": {\"tec\": %.2f}}%s\n",
+                          -177.5 + 5.0 * col, -88.75 + 2.5 * row, bias + 0.1 * row + 0.01 * col,
+                          (row == 71 && col == 71) ? "" : ",");
+            out += buf;
+        }
+    }
+    return out + "]}\n";
+}
+
+#ifndef _WIN32
+
+// ========== Local HTTP Stand-In ==========
+// Keep-alive HTTP/1.1 server on 127.0.0.1 serving the recorded bodies of a
+// FileHttpTransport directory, with per-path delays and injected failures.
+
+class LocalHttpServer {
+public:
+    explicit LocalHttpServer(const FileHttpTransport& files) : m_files(files) {}
+    ~LocalHttpServer() { stop(); }
+
+    bool start() {
+        m_listen = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (m_listen < 0 || bind(m_listen, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+            listen(m_listen, 64) != 0 || getsockname(m_listen, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            return false;
+        }
+        m_port = ntohs(addr.sin_port);
+        m_running = true;
+        m_acceptThread = std::thread([this] { acceptLoop(); });
+        return true;
+    }
+
+    void stop() {
+        if (!m_running.exchange(false)) {
+            return;
+        }
+        shutdown(m_listen, SHUT_RDWR);
+        close(m_listen);
+        m_acceptThread.join();
+        std::vector<std::thread> threads;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (int fd : m_clients) {
+                shutdown(fd, SHUT_RDWR);
+            }
+            threads.swap(m_threads);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    std::string url(const std::string& path) const {
+        return "http://127.0.0.1:" + std::to_string(m_port) + path;
+    }
+
+    void setDelay(const std::string& path, int ms) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_delay[path] = ms;
+    }
+
+    void failNext(const std::string& path, int status, int count) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failures[path] = {status, count};
+    }
+
+    std::size_t connections() const { return m_connections.load(); }
+    std::size_t requests() const { return m_requests.load(); }
+
+private:
+    const FileHttpTransport& m_files;
+    int m_listen = -1;
+    int m_port = 0;
+    std::atomic<bool> m_running{false};
+    std::atomic<std::size_t> m_connections{0};
+    std::atomic<std::size_t> m_requests{0};
+    std::thread m_acceptThread;
+
+    std::mutex m_mutex;
+    std::vector<std::thread> m_threads;
+    std::vector<int> m_clients;
+    std::map<std::string, int> m_delay;
+    std::map<std::string, std::pair<int, int>> m_failures;
+
+    void acceptLoop() {
+        while (m_running) {
+            const int fd = accept(m_listen, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+            ++m_connections;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_clients.push_back(fd);
+            m_threads.emplace_back([this, fd] { serve(fd); });
+        }
+    }
+
+    void serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        while (m_running) {
+            const std::size_t headerEnd = buffer.find("\r\n\r\n");
+            if (headerEnd == std::string::npos) {
+                const ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    break;
+                }
+                buffer.append(chunk, static_cast<std::size_t>(n));
+                continue;
+            }
+
+            const std::size_t pathStart = buffer.find(' ') + 1;
+            const std::string path = buffer.substr(pathStart, buffer.find(' ', pathStart) - pathStart);
+            buffer.erase(0, headerEnd + 4);
+            ++m_requests;
+
+            int delay = 0, status = 200;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                delay = m_delay.count(path) ? m_delay[path] : 0;
+                auto failure = m_failures.find(path);
+                if (failure != m_failures.end() && failure->second.second > 0) {
+                    status = failure->second.first;
+                    --failure->second.second;
+                }
+            }
+            for (int waited = 0; waited < delay && m_running; waited += 10) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+
+            std::string body;
+            if (status == 200) {
+                std::ifstream in(m_files.bodyPath(url(path)), std::ios::binary);
+                if (in) {
+                    body.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+                } else {
+                    status = 404;
+                }
+            }
+
+            const std::string response = "HTTP/1.1 " + std::to_string(status) + " X\r\nContent-Length: " +
+                                         std::to_string(body.size()) + "\r\nConnection: keep-alive\r\n\r\n" + body;
+            if (send(fd, response.data(), response.size(), MSG_NOSIGNAL) < 0) {
+                break;
+            }
+        }
+        close(fd);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_clients.erase(std::remove(m_clients.begin(), m_clients.end(), fd), m_clients.end());
+    }
+};
+
+#endif
+
+int main() {
+    std::cout << "HTTP Session Test\n" << std::endl;
+
+    const fs::path root = fs::temp_directory_path() / "test_http_session";
+    fs::remove_all(root);
+    FileHttpTransport files((root / "http").string());
+
+#ifndef _WIN32
+    setenv("no_proxy", "127.0.0.1", 1);
+    LocalHttpServer server(files);
+    if (!server.start()) {
+        std::cout << "✗ local HTTP server could not start" << std::endl;
+        return 1;
+    }
+
+    HttpSession session;
+    HttpRetryPolicy retry;
+    retry.initialBackoff_ms = 50;
+    session.setRetryPolicy(retry);
+
+    for (const char* name : {"/a", "/b", "/c", "/d", "/e", "/f", "/slow", "/flaky"}) {
+        files.put(server.url(name), std::string("body of ") + name);
+    }
+
+    // Single requests reuse one pooled connection.
+    HttpResult first = session.fetch(server.url("/a"));
+    check(first.ok && first.body == "body of /a" && first.statusCode == 200 && first.attempts == 1,
+          "single fetch returns the body");
+    for (int i = 0; i < 4; ++i) {
+        session.fetch(server.url("/b"));
+    }
+    check(session.getStats().newConnections == 1 && server.connections() == 1,
+          "sequential requests reuse the connection");
+
+    HttpResult missing = session.fetch(server.url("/missing"));
+    check(!missing.ok && missing.statusCode == 404 && missing.attempts == 1, "404 is final");
+
+    // Transient failures back off and retry.
+    server.failNext("/flaky", 503, 2);
+    auto t0 = std::chrono::steady_clock::now();
+    HttpResult flaky = session.fetch(server.url("/flaky"));
+    const double flakyMs = elapsed_ms(t0);
+    check(flaky.ok && flaky.attempts == 3 && flakyMs >= 150.0, "503 is retried with growing backoff");
+    server.failNext("/flaky", 503, 5);
+    HttpResult exhausted = session.fetch(server.url("/flaky"));
+    check(!exhausted.ok && exhausted.statusCode == 503 && exhausted.attempts == 3, "retries are bounded");
+    server.failNext("/flaky", 0, 0);
+
+    // Batches run concurrently.
+    for (const char* name : {"/a", "/b", "/c", "/d", "/e", "/f"}) {
+        server.setDelay(name, 300);
+    }
+    t0 = std::chrono::steady_clock::now();
+    std::vector<HttpResult> batch = session.fetchAll({server.url("/a"), server.url("/b"), server.url("/c"),
+                                                      server.url("/d"), server.url("/e"), server.url("/f")});
+    const double batchMs = elapsed_ms(t0);
+    bool allOk = batch.size() == 6;
+    for (const HttpResult& r : batch) {
+        allOk = allOk && r.ok;
+    }
+    check(allOk && batch[3].body == "body of /d", "batch returns every body in order");
+    check(batchMs < 900.0, "six 300 ms requests overlap");
+    std::cout << "  6 x 300 ms requests: " << batchMs << " ms" << std::endl;
+
+    // Callers on different threads do not wait for each other's batches.
+    t0 = std::chrono::steady_clock::now();
+    std::vector<HttpResult> parallel(4);
+    {
+        std::vector<std::thread> callers;
+        for (int i = 0; i < 4; ++i) {
+            callers.emplace_back([&session, &server, &parallel, i] {
+                parallel[i] = session.fetch(server.url(i % 2 ? "/e" : "/f"));
+            });
+        }
+        for (std::thread& caller : callers) {
+            caller.join();
+        }
+    }
+    const double parallelMs = elapsed_ms(t0);
+    bool parallelOk = true;
+    for (const HttpResult& r : parallel) {
+        parallelOk = parallelOk && r.ok;
+    }
+    check(parallelOk && parallelMs < 900.0, "fetches from four threads overlap");
+    std::cout << "  4 threads x 300 ms request: " << parallelMs << " ms" << std::endl;
+
+    // Candidate racing: preference order decides, losers are cancelled.
+    server.setDelay("/slow", 300);
+    HttpResult winner;
+    t0 = std::chrono::steady_clock::now();
+    int index = session.fetchFirst({server.url("/missing"), server.url("/slow"), server.url("/c")}, winner);
+    check(index == 1 && winner.body == "body of /slow" && elapsed_ms(t0) >= 300.0,
+          "earlier candidate wins over a faster later one");
+
+    server.setDelay("/slow", 5000);
+    server.setDelay("/c", 0);
+    const std::size_t cancelledBefore = session.getStats().cancelled;
+    t0 = std::chrono::steady_clock::now();
+    index = session.fetchFirst({server.url("/c"), server.url("/slow")}, winner);
+    const double raceMs = elapsed_ms(t0);
+    check(index == 0 && raceMs < 1000.0 && session.getStats().cancelled == cancelledBefore + 1,
+          "losing transfers are cancelled");
+
+    for (const char* name : {"/m1", "/m2", "/m3", "/m4"}) {
+        server.setDelay(name, 300);
+    }
+    server.setDelay("/e", 300);
+    t0 = std::chrono::steady_clock::now();
+    index = session.fetchFirst({server.url("/m1"), server.url("/m2"), server.url("/m3"), server.url("/m4"),
+                                server.url("/e")}, winner);
+    const double worstMs = elapsed_ms(t0);
+    check(index == 4 && worstMs < 750.0, "five candidates cost one round trip");
+    std::cout << "  5 candidates, last one available: " << worstMs << " ms (sequential ~1500 ms)" << std::endl;
+
+    HttpResult none;
+    check(session.fetchFirst({server.url("/m1"), server.url("/m2")}, none) == -1 && none.statusCode == 404,
+          "no candidate available reports the failure");
+
+    // SimpleHttpClient goes through the shared session.
+    const std::size_t sharedBefore = HttpSession::shared().getStats().requests;
+    std::string response;
+    check(SimpleHttpClient::fetchUrl(server.url("/f"), response) && response == "body of /f" &&
+          HttpSession::shared().getStats().requests == sharedBefore + 1, "SimpleHttpClient uses the shared session");
+
+    server.stop();
+#else
+    std::cout << "  local HTTP server not available on this platform, skipping" << std::endl;
+#endif
+
+    // With a replacement transport candidates are tried in order, stopping at the winner.
+    SimpleHttpClient::setTransport(files.asTransport());
+    files.put("file://two", "two");
+    files.put("file://three", "three");
+    HttpResult viaFiles;
+    check(HttpSession::shared().fetchFirst({"file://one", "file://two", "file://three"}, viaFiles) == 1 &&
+          viaFiles.body == "two" && files.getRequestCount() == 2, "transport fetches stop at the winner");
+
+    // GLOTEC takes the freshest available product among its candidates.
+    NOAAGlotecReader glotec;
+    std::tm request = {};
+    request.tm_year = 2026 - 1900;
+    request.tm_mon = 1;
+    request.tm_mday = 9;
+    request.tm_hour = 14;
+    request.tm_min = 17;
+    std::tm older = request;
+    older.tm_min = 55;
+    older.tm_hour = 13;
+    files.put(glotec.getDataUrl(older), glotecBody(5.0));
+    files.resetRequestCount();
+    GlotecData data;
+    check(glotec.fetchTecData(request, data) && data.isValid && data.timestamp.tm_hour == 13 &&
+          data.timestamp.tm_min == 55 && files.getRequestCount() == 4, "GLOTEC falls back to a delayed product");
+
+    SimpleHttpClient::resetTransport();
+    fs::remove_all(root);
+
+    return finishTests("HTTP session pools, retries and races requests");
+}
@@ -0,0 +1,227 @@
+#include "IGRFModel.h"
+#include "WMMModel.h"
+#include "MagneticFieldGrid.h"
+#include "IonosphereDataProvider.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+static const double EPOCHS[] = {2010.0, 2015.0, 2020.0, 2025.0};
+static const int NUM_EPOCHS = 4;
+static const int DEGREE = 13;
+
+// Synthetic IAGA-format table: WMMHR degrees 1..13 evolved to each epoch,
+// with an alternating offset so the epochs are not collinear.
+struct Table {
+    std::vector<GaussCoefficient> base;
+
+    double value(const GaussCoefficient& c, bool g, int epoch) const {
+        const double v = g ? c.gnm + (EPOCHS[epoch] - 2025.0) * c.dgnm : c.hnm + (EPOCHS[epoch] - 2025.0) * c.dhnm;
+        return v + ((epoch % 2) ? 3.0 : -2.0) * (c.n <= 3 ? 1.0 : 0.1);
+    }
+    double sv(const GaussCoefficient& c, bool g) const { return g ? c.dgnm : c.dhnm; }
+
+    std::string text() const {
+        std::string out = "# synthetic IGRF table\n"
+                          "c/s deg ord IGRF IGRF IGRF IGRF SV\n"
+                          "g/h n m 2010.0 2015.0 2020.0 2025.0 2025-30\n";
+        char buf[256];
+        for (const GaussCoefficient& c : base) {
+            for (int gh = 0; gh < 2; ++gh) {
+                const bool g = gh == 0;
+                if (!g && c.m == 0) {
+                    continue;
+                }
+                int len = std::snprintf(buf, sizeof(buf), "%s %d %d", g ? "g" : "h", c.n, c.m);
+                for (int e = 0; e < NUM_EPOCHS; ++e) {
+                    len += std::snprintf(buf + len, sizeof(buf) - len, " %.4f", value(c, g, e));
+                }
+                std::snprintf(buf + len, sizeof(buf) - len, " %.4f\r\n", sv(c, g));
+                out += buf;
+            }
+        }
+        return out;
+    }
+
+    // Expected g or h at a decimal year.
+    double at(const GaussCoefficient& c, bool g, double year) const {
+        if (year <= EPOCHS[0]) {
+            return value(c, g, 0);
+        }
+        for (int e = 0; e + 1 < NUM_EPOCHS; ++e) {
+            if (year < EPOCHS[e + 1]) {
+                const double f = (year - EPOCHS[e]) / (EPOCHS[e + 1] - EPOCHS[e]);
+                return value(c, g, e) + f * (value(c, g, e + 1) - value(c, g, e));
+            }
+        }
+        return value(c, g, NUM_EPOCHS - 1) + (year - EPOCHS[NUM_EPOCHS - 1]) * sv(c, g);
+    }
+};
+
+// Direct long double sum with a = 6371.2 km, independent of the engine.
+static void referenceField(const Table& table, double year, double lat_deg, double lon_deg, double height_km,
+                           double& X, double& Y, double& Z) {
+    typedef long double ld;
+    const ld pi = 3.14159265358979323846264338327950288L;
+    const ld a = GeomagneticConstants::REFERENCE_RADIUS;
+    const ld A = GeomagneticConstants::WGS84_A;
+    const ld e2 = GeomagneticConstants::WGS84_E2;
+
+    const ld lat = lat_deg * pi / 180.0L;
+    const ld N = A / std::sqrt(1.0L - e2 * std::sin(lat) * std::sin(lat));
+    const ld x = (N + height_km) * std::cos(lat);
+    const ld z = (N * (1.0L - e2) + height_km) * std::sin(lat);
+    const ld r = std::sqrt(x * x + z * z);
+    const ld latGc = std::atan2(z, x);
+    const ld t = std::cos(pi / 2.0L - latGc);
+    const ld s = std::sin(pi / 2.0L - latGc);
+    const ld phi = lon_deg * pi / 180.0L;
+
+    auto idx = [](int n, int m) { return static_cast<std::size_t>(n) * (n + 1) / 2 + m; };
+    std::vector<ld> S(idx(DEGREE, DEGREE) + 1, 0.0L);
+    S[0] = 1.0L;
+    for (int m = 0; m <= DEGREE; ++m) {
+        if (m > 0) {
+            S[idx(m, m)] = S[idx(m - 1, m - 1)] * s * (m == 1 ? 1.0L : std::sqrt((2.0L * m - 1) / (2.0L * m)));
+        }
+        for (int n = m + 1; n <= DEGREE; ++n) {
+            ld prev2 = (n - 2 >= m) ? S[idx(n - 2, m)] : 0.0L;
+            S[idx(n, m)] = ((2.0L * n - 1) * t * S[idx(n - 1, m)] -
+                            std::sqrt(static_cast<ld>((n - 1) * (n - 1) - m * m)) * prev2) /
+                           std::sqrt(static_cast<ld>(n * n - m * m));
+        }
+    }
+
+    ld Br = 0, Bt = 0, Bp = 0;
+    for (const GaussCoefficient& c : table.base) {
+        const int n = c.n, m = c.m;
+        const ld ratio = std::pow(a / r, static_cast<ld>(n + 2));
+        const ld Snm = S[idx(n, m)];
+        const ld Sprev = (n - 1 >= m) ? S[idx(n - 1, m)] : 0.0L;
+        const ld dSnm = (n * t * Snm - std::sqrt(static_cast<ld>(n * n - m * m)) * Sprev) / s;
+        const ld g = table.at(c, true, year);
+        const ld h = m > 0 ? table.at(c, false, year) : 0.0L;
+        const ld cosTerm = g * std::cos(m * phi) + h * std::sin(m * phi);
+        Br += ratio * (n + 1) * Snm * cosTerm;
+        Bt += ratio * dSnm * cosTerm;
+        Bp += ratio * m * Snm * (h * std::cos(m * phi) - g * std::sin(m * phi)) / s;
+    }
+
+    const ld psi = lat - latGc;
+    X = static_cast<double>(Bt * std::cos(psi) + Br * std::sin(psi));
+    Y = static_cast<double>(-Bp);
+    Z = static_cast<double>(Bt * std::sin(psi) - Br * std::cos(psi));
+}
+
+int main() {
+    std::cout << "IGRF Model Test\n" << std::endl;
+
+    WMMModel wmm;
+    if (!wmm.loadCoefficientFile("../data/WMMHR.COF", DEGREE)) {
+        std::cout << "✗ could not load ../data/WMMHR.COF" << std::endl;
+        return 1;
+    }
+
+    Table table;
+    table.base = wmm.getCoefficients();
+    const std::string text = table.text();
+
+    IGRFModel igrf;
+    check(!igrf.calculate(10.0, 10.0, 0.0, 2020.0).F && !igrf.isLoaded(), "unloaded model returns zero field");
+    check(!igrf.parseCoefficients("# no table\n"), "empty table rejected");
+    check(!igrf.loadCoefficientFile("../data/missing_igrf.txt"), "missing file reported");
+    check(igrf.parseCoefficients(text), "synthetic IGRF table parses");
+    check(igrf.getMaxDegree() == DEGREE && igrf.getEpochs().size() == 4u && igrf.getEpochs().back() == 2025.0,
+          "degree and epochs read");
+    check(igrf.getModelName() == "IGRF 2010-2025", "model name from epoch range");
+    check(igrf.getReferenceRadius() == GeomagneticConstants::REFERENCE_RADIUS, "IGRF uses 6371.2 km");
+
+    // Coefficients at epochs, between them, after the last and before the first.
+    const GaussCoefficient& g11 = table.base[1];
+    const double years[] = {2010.0, 2012.5, 2015.0, 2019.99, 2020.0, 2024.3, 2025.0, 2027.75, 2001.0};
+    double maxCoefErr = 0.0;
+    for (double year : years) {
+        auto snap = igrf.getSnapshot(year);
+        maxCoefErr = std::max({maxCoefErr, std::abs(snap->g[1] - table.at(table.base[0], true, year)),
+                               std::abs(snap->g[2] - table.at(g11, true, year)),
+                               std::abs(snap->h[2] - table.at(g11, false, year))});
+    }
+    check(maxCoefErr < 1e-9, "epoch interpolation and secular variation");
+
+    double maxErr = 0.0;
+    for (int i = 0; i < 24; ++i) {
+        const double lat = -85.0 + 7.3 * i;
+        const double lon = -180.0 + 15.1 * i;
+        const double height = 100.0 * (i % 6);
+        const double year = years[i % 9];
+        double X, Y, Z;
+        referenceField(table, year, lat, lon, height, X, Y, Z);
+        MagneticFieldResult r = igrf.calculate(lat, lon, height, year);
+        maxErr = std::max({maxErr, std::abs(r.X - X), std::abs(r.Y - Y), std::abs(r.Z - Z)});
+    }
+    check(maxErr < 1e-6, "field matches long double reference");
+    std::cout << "  max |error|: coefficients " << maxCoefErr << " nT, field " << maxErr << " nT" << std::endl;
+
+    // Shared batch path and grid.
+    std::vector<double> lat, lon, height;
+    for (int i = 0; i < 500; ++i) {
+        lat.push_back(-80.0 + (i % 33) * 5.0);
+        lon.push_back(-180.0 + i * 0.72);
+        height.push_back(350.0);
+    }
+    MagneticFieldBatch batch;
+    bool batchOk = igrf.calculateBatch(lat, lon, height, 2017.3, batch);
+    double batchErr = 0.0;
+    for (std::size_t i = 0; batchOk && i < lat.size(); ++i) {
+        batchErr = std::max(batchErr, std::abs(batch.F[i] - igrf.calculate(lat[i], lon[i], 350.0, 2017.3).F));
+    }
+    check(batchOk && batchErr < 1e-6, "batch API matches calculate()");
+
+    MagneticFieldGrid grid;
+    check(grid.build(igrf, 2017.3, 350.0, 1.0) &&
+          std::abs(grid.interpolate(30.0, 120.0).F - igrf.calculate(30.0, 120.0, 350.0, 2017.3).F) < 1e-6,
+          "shell grid builds from IGRF");
+
+    // Provider reports the model it used.
+    const std::string path = (std::filesystem::temp_directory_path() / "test_igrf_coeffs.txt").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << text;
+    }
+    IonosphereDataProvider provider;
+    IonosphereData iono;
+    std::tm when = {};
+    when.tm_year = 2026 - 1900;
+    when.tm_mon = 1;
+    when.tm_mday = 9;
+    when.tm_hour = 6;
+    check(provider.loadIonexFile("../data/data.txt") && provider.loadIGRFFile(path) &&
+          provider.getIonosphereData(when, 31.77, 116.87, 0.0, 51.5, -0.1, 0.0, iono) &&
+          iono.dataSource == "IONEX + IGRF" && iono.B_magnitude_DX > 3e-5 && iono.B_magnitude_DX < 7e-5,
+          "provider evaluates IGRF");
+    std::remove(path.c_str());
+
+    // Per-point and per-epoch cost.
+    const int n = 100000;
+    double sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        sum += igrf.calculate(-60.0 + i % 120, (i % 360) - 180.0, 350.0, 2017.3).F;
+    }
+    double pointUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / n;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 2000; ++i) {
+        sum += igrf.getSnapshot(2010.0 + i * 0.01)->g[1];
+    }
+    double epochUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 2000;
+    check(sum != 0.0, "benchmark produced a field");
+    std::cout << "  calculate(): " << pointUs << " us per point, new epoch: " << epochUs << " us" << std::endl;
+
+    return finishTests("IGRF epochs interpolate and evaluate through the shared core");
+}
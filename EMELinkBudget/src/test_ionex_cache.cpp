@@ -0,0 +1,97 @@
+#include "IonexReader.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdio>
+#include <filesystem>
+#include <cmath>
+
+static std::tm makeTime(int hour, int minute) {
+    std::tm t = {};
+    t.tm_year = 2026 - 1900;
+    t.tm_mon = 2 - 1;
+    t.tm_mday = 9;
+    t.tm_hour = hour;
+    t.tm_min = minute;
+    return t;
+}
+
+int main() {
+    std::cout << "IONEX Decoded Map Cache Test\n" << std::endl;
+
+    IonexReader reader("../data/data.txt");
+    if (!reader.isOpen()) {
+        std::cout << "✗ could not open ../data/data.txt" << std::endl;
+        return 1;
+    }
+
+    const IonexHeader& header = reader.getHeader();
+    check(header.numMaps == 25 && header.interval == 3600, "map count and interval parsed");
+    check(header.numLat == 71 && header.numLon == 73 && header.exponent == -1, "grid header parsed");
+    check(nearAbs(header.lat1, 87.5) && nearAbs(header.lon1, -180.0) && nearAbs(header.dlat, -2.5),
+          "grid origin and spacing parsed");
+
+    double vtec = 0.0;
+
+    // First grid values of the first two maps are 82 and 92 (x 0.1 TECU).
+    check(reader.getTecValue(makeTime(0, 0), 87.5, -180.0, vtec) && nearAbs(vtec, 8.2),
+          "grid value decoded from first map");
+    check(reader.getTecValue(makeTime(1, 0), 87.5, -180.0, vtec) && nearAbs(vtec, 9.2),
+          "grid value decoded from second map");
+    check(reader.getTecValueInterpolated(makeTime(0, 30), 87.5, -180.0, vtec) && nearAbs(vtec, 8.7),
+          "time interpolation between cached maps");
+
+    TecMapCacheStats stats = reader.getCacheStats();
+    check(stats.misses == 2 && stats.entries == 2, "each epoch decoded once");
+    check(stats.hits >= 2, "adjacent-epoch lookup served from cache");
+
+    double first = 0.0;
+    double again = 0.0;
+    reader.getTecValueInterpolated(makeTime(12, 20), 31.79, 116.87, first);
+    for (int i = 0; i < 1000; ++i) {
+        reader.getTecValueInterpolated(makeTime(12, 20), 31.79, 116.87, again);
+    }
+    check(first == again && first > 0.0, "repeated lookup is stable");
+    check(reader.getCacheStats().misses == 4, "repeated lookups never re-decode");
+
+    const std::size_t mapBytes = reader.getCacheStats().bytes / reader.getCacheStats().entries;
+    reader.setCacheBudget(3 * mapBytes);
+    check(reader.getCacheStats().entries == 3, "shrinking the budget evicts down to it");
+
+    for (int hour = 0; hour < 24; ++hour) {
+        check(reader.getTecValueInterpolated(makeTime(hour, 30), 45.0, 10.0, vtec), "lookup within budget");
+    }
+    stats = reader.getCacheStats();
+    check(stats.entries <= 3 && stats.bytes <= 3 * mapBytes, "memory budget is respected");
+    check(stats.evictions > 0, "least recently used maps are evicted");
+
+    double evictedAgain = 0.0;
+    reader.getTecValueInterpolated(makeTime(12, 20), 31.79, 116.87, evictedAgain);
+    check(evictedAgain == first, "re-decoded map gives identical values");
+
+    reader.setCacheBudget(0, 1);
+    reader.getTecValueInterpolated(makeTime(5, 30), 45.0, 10.0, vtec);
+    check(reader.getCacheStats().entries == 1, "entry limit is respected");
+
+    // Same file with CRLF line endings decodes identically.
+    const std::string crlfPath = (std::filesystem::temp_directory_path() / "test_ionex_crlf.txt").string();
+    {
+        std::ifstream in("../data/data.txt");
+        std::ofstream out(crlfPath, std::ios::binary);
+        std::string line;
+        while (std::getline(in, line)) {
+            out << line << "\r\n";
+        }
+    }
+    IonexReader crlf(crlfPath);
+    double crlfValue = 0.0;
+    check(crlf.isOpen() && crlf.getHeader().numMaps == 25, "CRLF file opens");
+    check(crlf.getTecValueInterpolated(makeTime(12, 20), 31.79, 116.87, crlfValue) && crlfValue == first,
+          "CRLF file decodes identically");
+    std::remove(crlfPath.c_str());
+
+    check(!IonexReader("../data/no_such_file.txt").isOpen(), "missing file is rejected");
+
+    return finishTests("IONEX maps are decoded once and cached");
+}
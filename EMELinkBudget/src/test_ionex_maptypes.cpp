@@ -0,0 +1,161 @@
+#include "IonexReader.h"
+#include "IonosphereDataProvider.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+#include <string>
+#include <cmath>
+
+static std::string record(const std::string& data, const std::string& label) {
+    std::string line = data;
+    line.resize(60, ' ');
+    return line + label + "\n";
+}
+
+static std::string numbers(const char* fmt, double a, double b, double c) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), fmt, a, b, c);
+    return buf;
+}
+
+// TEC value in 0.1 TECU: 100 per epoch, 10 per height layer, 1 per grid cell.
+static int tecValue(int epoch, int layer, int lat, int lon) {
+    return 100 * epoch + 10 * layer + 3 * lat + lon + 50;
+}
+
+// 3x3 grid (lat 10..-10, lon 0..20), three height layers, two epochs.
+static std::string buildIonex() {
+    std::string out;
+    out += record("     1.0            IONOSPHERE MAPS     GNSS", "IONEX VERSION / TYPE");
+    out += record("  2026     2     9     0     0     0", "EPOCH OF FIRST MAP");
+    out += record("  2026     2     9     1     0     0", "EPOCH OF LAST MAP");
+    out += record("  3600", "INTERVAL");
+    out += record("     2", "# OF MAPS IN FILE");
+    out += record("     3", "MAP DIMENSION");
+    out += record(numbers("  %6.1f%6.1f%6.1f", 200.0, 400.0, 100.0), "HGT1 / HGT2 / DHGT");
+    out += record(numbers("  %6.1f%6.1f%6.1f", 10.0, -10.0, -10.0), "LAT1 / LAT2 / DLAT");
+    out += record(numbers("  %6.1f%6.1f%6.1f", 0.0, 20.0, 10.0), "LON1 / LON2 / DLON");
+    out += record("    -1", "EXPONENT");
+    out += record("", "END OF HEADER");
+
+    const char* types[] = {"TEC", "RMS", "HEIGHT"};
+    for (int t = 0; t < 3; ++t) {
+        for (int e = 0; e < 2; ++e) {
+            out += record("     " + std::to_string(e + 1), std::string("START OF ") + types[t] + " MAP");
+            out += record("  2026     2     9     " + std::to_string(e) + "     0     0", "EPOCH OF CURRENT MAP");
+            if (t == 1) {
+                out += record("    -2", "EXPONENT");
+            }
+            const int layers = (t == 2) ? 1 : 3;
+            for (int h = 0; h < layers; ++h) {
+                for (int i = 0; i < 3; ++i) {
+                    char latRec[64];
+                    std::snprintf(latRec, sizeof(latRec), "  %6.1f%6.1f%6.1f%6.1f%6.1f",
+                                  10.0 - 10.0 * i, 0.0, 20.0, 10.0, 200.0 + 100.0 * h);
+                    out += record(latRec, "LAT/LON1/LON2/DLON/H");
+
+                    std::string values;
+                    for (int j = 0; j < 3; ++j) {
+                        int v = 0;
+                        if (t == 0) v = tecValue(e, h, i, j);
+                        if (t == 1) v = 200 + 10 * e;        // 2.00 / 2.10 TECU at exponent -2
+                        if (t == 2) v = 3500 + 100 * e;      // 350 / 360 km
+                        if (t == 0 && e == 1 && h == 2 && i == 2 && j == 2) v = 9999;
+                        char buf[8];
+                        std::snprintf(buf, sizeof(buf), "%5d", v);
+                        values += buf;
+                    }
+                    out += values + "\n";
+                }
+            }
+            out += record("     " + std::to_string(e + 1), std::string("END OF ") + types[t] + " MAP");
+        }
+    }
+
+    out += record("", "END OF FILE");
+    return out;
+}
+
+static std::tm makeTime(int hour, int minute) {
+    std::tm t = {};
+    t.tm_year = 2026 - 1900;
+    t.tm_mon = 2 - 1;
+    t.tm_mday = 9;
+    t.tm_hour = hour;
+    t.tm_min = minute;
+    return t;
+}
+
+static void checkReader(IonexReader& reader, const std::string& mode) {
+    double v = 0.0;
+
+    check(reader.getValue(IonexMapType::TEC, makeTime(1, 0), 0.0, 10.0, v, 1) &&
+          nearAbs(v, tecValue(1, 1, 1, 1) * 0.1), mode + ": TEC grid value on height layer");
+    check(reader.getTecValue(makeTime(0, 0), 10.0, 20.0, v) && nearAbs(v, tecValue(0, 0, 0, 2) * 0.1),
+          mode + ": default TEC lookup uses first layer");
+    check(reader.getValueInterpolated(IonexMapType::TEC, makeTime(0, 30), 5.0, 5.0, v, 2) &&
+          nearAbs(v, 0.1 * (tecValue(0, 2, 0, 0) + tecValue(0, 2, 1, 1)) / 2.0 + 5.0),
+          mode + ": space-time interpolation on a height layer");
+    check(!reader.getValue(IonexMapType::TEC, makeTime(1, 0), -10.0, 20.0, v, 2),
+          mode + ": missing TEC value is reported");
+    check(!reader.getValue(IonexMapType::TEC, makeTime(0, 0), 0.0, 0.0, v, 3),
+          mode + ": out-of-range layer is rejected");
+
+    check(reader.getRmsValueInterpolated(makeTime(0, 30), 3.0, 7.0, v) && nearAbs(v, 2.05),
+          mode + ": RMS map with its own exponent");
+    check(reader.getValueInterpolated(IonexMapType::HEIGHT, makeTime(1, 0), 0.0, 0.0, v) && nearAbs(v, 360.0),
+          mode + ": HEIGHT map value");
+}
+
+int main() {
+    std::cout << "IONEX RMS / HEIGHT / Multi-Height Map Test\n" << std::endl;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "test_ionex_maptypes.txt").string();
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << buildIonex();
+    }
+
+    IonexReader reader(path);
+    check(reader.isOpen(), "synthetic file opens");
+    check(reader.getHeader().numHgt == 3, "height layers from HGT1 / HGT2 / DHGT");
+    check(reader.getMapCount(IonexMapType::TEC) == 2 &&
+          reader.getMapCount(IonexMapType::RMS) == 2 &&
+          reader.getMapCount(IonexMapType::HEIGHT) == 2, "all map types indexed");
+
+    checkReader(reader, "lazy");
+    // TEC at both epochs, RMS at both epochs, HEIGHT at the second epoch only.
+    check(reader.getCacheStats().entries == 5, "each type and epoch is cached separately");
+
+    IonexReader preloaded(path);
+    check(preloaded.preloadAll(), "preload succeeds");
+    const TecCube& rms = preloaded.getCube(IonexMapType::RMS);
+    check(rms.numTimes() == 2 && rms.numHgt == 3 && rms.data.size() == 2u * 3u * 9u,
+          "RMS cube has the same layout as TEC");
+    checkReader(preloaded, "preloaded");
+
+    std::time_t times[2] = {rms.epochs[0], rms.epochs[0] + 1800};
+    double lats[2] = {0.0, 0.0};
+    double lons[2] = {10.0, 10.0};
+    double out[2];
+    check(rms.interpolate(times, lats, lons, out, 2) == 2 && nearAbs(out[0], 2.0) && nearAbs(out[1], 2.05),
+          "batched RMS lookup");
+
+    IonosphereDataProvider provider;
+    IonosphereData iono;
+    check(provider.loadIonexFile(path), "provider loads synthetic file");
+    check(provider.getIonosphereData(makeTime(0, 30), 0.0, 0.0, 400.0, 5.0, 15.0, 400.0, iono),
+          "provider returns ionosphere data");
+    check(nearAbs(iono.vTEC_RMS_DX, 2.05) && nearAbs(iono.vTEC_RMS_Home, 2.05), "provider fills vTEC RMS");
+    check(nearAbs(iono.hmF2_DX, 355.0), "provider takes layer height from HEIGHT maps");
+
+    IonexReader real("../data/data.txt");
+    check(real.isOpen() && !real.hasMaps(IonexMapType::RMS) && real.getHeader().numHgt == 1,
+          "2-D file without RMS maps still reads");
+
+    std::remove(path.c_str());
+
+    return finishTests("TEC, RMS and HEIGHT maps share the indexed, cached path");
+}
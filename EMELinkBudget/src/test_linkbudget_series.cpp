@@ -0,0 +1,99 @@
+#include "EMELinkBudget.h"
+#include "MaidenheadGrid.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+static LinkBudgetParameters makeParameters() {
+    LinkBudgetParameters params;
+    params.frequency_MHz = 144.0;
+
+    double lat, lon;
+    MaidenheadGrid::gridToLatLon("FN20xa", lat, lon);
+    params.txSite.latitude = ParameterUtils::deg2rad(lat);
+    params.txSite.longitude = ParameterUtils::deg2rad(lon);
+
+    MaidenheadGrid::gridToLatLon("JO62qm", lat, lon);
+    params.rxSite.latitude = ParameterUtils::deg2rad(lat);
+    params.rxSite.longitude = ParameterUtils::deg2rad(lon);
+
+    params.moonEphemeris.rightAscension = ParameterUtils::deg2rad(120.0);
+    params.moonEphemeris.declination = ParameterUtils::deg2rad(18.0);
+    params.moonEphemeris.distance_km = 380000.0;
+
+    params.ionosphereData.vTEC_DX = 25.0;
+    params.ionosphereData.vTEC_Home = 30.0;
+    params.ionosphereData.B_inclination_DX = ParameterUtils::deg2rad(60.0);
+    params.ionosphereData.B_inclination_Home = ParameterUtils::deg2rad(65.0);
+
+    return params;
+}
+
+int main() {
+    std::cout << "EME Link Budget - Time Series Test\n" << std::endl;
+
+    LinkBudgetParameters params = makeParameters();
+    const std::time_t start = 1767225600;  // 2026-01-01 00:00:00 UTC
+    const std::time_t stop = start + 6 * 3600;
+    const std::time_t step = 600;
+
+    EMELinkBudget series(params);
+    LinkBudgetResultsBatch result = series.calculateSeries(start, stop, step);
+
+    check(result.size() == 37, "series has one row per timestep");
+
+    for (size_t i = 0; i < result.size(); ++i) {
+        check(result.calculationSuccess[i] != 0, "series row succeeds");
+
+        LinkBudgetParameters single = params;
+        single.observationTime = result.time[i];
+
+        EMELinkBudget reference(single);
+        LinkBudgetResults expected = reference.calculate();
+
+        check(near(result.geometry.moonElevation_RX_deg[i], expected.geometry.moonElevation_RX_deg),
+              "RX elevation matches single evaluation");
+        check(near(result.geometry.moonAzimuth_TX_deg[i], expected.geometry.moonAzimuth_TX_deg),
+              "TX azimuth matches single evaluation");
+        check(near(result.pathLoss.totalPathLoss_dB[i], expected.pathLoss.totalPathLoss_dB),
+              "path loss matches single evaluation");
+        check(near(result.polarization.polarizationLoss_dB[i], expected.polarization.polarizationLoss_dB),
+              "polarization loss matches single evaluation");
+        check(near(result.noise.systemNoiseTemp_K[i], expected.noise.systemNoiseTemp_K),
+              "system noise matches single evaluation");
+        check(near(result.snr.linkMargin_dB[i], expected.snr.linkMargin_dB),
+              "link margin matches single evaluation");
+
+        LinkBudgetResults row = result.row(i);
+        check(row.geometry.ephemerisSource == expected.geometry.ephemerisSource,
+              "interned ephemeris source round-trips");
+        check(row.snr.linkViable == expected.snr.linkViable, "viability flag round-trips");
+        check(near(row.noise.skyNoiseTemp_K, expected.noise.skyNoiseTemp_K),
+              "row() rebuilds nested results");
+    }
+
+    check(result.strings().size() == 2, "ephemeris source is interned once");
+
+    const AlignedColumn* margin = result.column("snr.linkMargin_dB");
+    check(margin == &result.snr.linkMargin_dB, "named column lookup");
+    check(result.column("snr.noSuchColumn") == nullptr, "unknown column is rejected");
+    check(reinterpret_cast<std::uintptr_t>(margin->data()) % 64 == 0, "columns are cache-line aligned");
+
+    std::ostringstream csv;
+    check(result.writeCSV(csv, {"geometry.moonElevation_RX_deg", "snr.linkMargin_dB"}),
+          "CSV export succeeds");
+    const std::string text = csv.str();
+    check(text.rfind("time,geometry.moonElevation_RX_deg,snr.linkMargin_dB\n", 0) == 0,
+          "CSV header lists requested columns");
+    check(static_cast<size_t>(std::count(text.begin(), text.end(), '\n')) == result.size() + 1,
+          "CSV has one line per row");
+
+    LinkBudgetResultsBatch invalid = series.calculateSeries(stop, start, step);
+    check(invalid.empty() && !series.getLastResults().errorMessage.empty(),
+          "reversed range is rejected");
+
+    return finishTests("Time series matches per-timestep evaluation");
+}
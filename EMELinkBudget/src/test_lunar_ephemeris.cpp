@@ -0,0 +1,133 @@
+#include "LunarEphemeris.h"
+#include "EMELinkBudget.h"
+#include "MaidenheadGrid.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static double deg(double rad) {
+    return rad * 180.0 / M_PI;
+}
+
+int main() {
+    std::cout << "Lunar Ephemeris Test\n" << std::endl;
+
+    LunarEphemeris ephemeris;
+
+    // Meeus, Astronomical Algorithms, examples 47.a and 53.a: 1992 April 12, 0h TD.
+    const LunarPosition meeus = ephemeris.calculateJDE(2448724.5);
+    check(std::abs(deg(meeus.eclipticLongitude) - 133.167265) < 3e-4, "apparent longitude matches example 47.a");
+    check(std::abs(deg(meeus.eclipticLatitude) - -3.229126) < 1e-6, "latitude matches example 47.a");
+    check(std::abs(meeus.distance_km - 368409.7) < 0.1, "distance matches example 47.a");
+    check(std::abs(deg(meeus.rightAscension) - 134.688470) < 1e-4, "right ascension matches example 47.a");
+    check(std::abs(deg(meeus.declination) - 13.768368) < 1e-4, "declination matches example 47.a");
+    check(std::abs(meeus.librationLon_deg - -1.206) < 2e-3, "optical libration in longitude matches example 53.a");
+    check(std::abs(meeus.librationLat_deg - 4.194) < 2e-3, "optical libration in latitude matches example 53.a");
+    std::cout << std::setprecision(9) << "  1992-04-12 0h TD: RA " << deg(meeus.rightAscension) << " deg, Dec "
+              << deg(meeus.declination) << " deg, " << meeus.distance_km << " km, libration "
+              << meeus.librationLon_deg << ", " << meeus.librationLat_deg << " deg" << std::setprecision(6) << std::endl;
+
+    // Rates against central differences of the positions.
+    const double h = 60.0 / 86400.0;
+    double maxRangeRateErr = 0.0, maxLibRateErr = 0.0;
+    for (int day = 0; day < 60; day += 3) {
+        const double jde = 2461041.5 + day + 0.37;
+        const LunarPosition mid = ephemeris.calculateJDE(jde);
+        const LunarPosition before = ephemeris.calculateJDE(jde - h);
+        const LunarPosition after = ephemeris.calculateJDE(jde + h);
+        const double rangeRate = (after.distance_km - before.distance_km) / (2.0 * h * 86400.0);
+        const double lonRate = (after.librationLon_deg - before.librationLon_deg) / (2.0 * h);
+        const double latRate = (after.librationLat_deg - before.librationLat_deg) / (2.0 * h);
+        maxRangeRateErr = std::max(maxRangeRateErr, std::abs(mid.rangeRate_km_s - rangeRate));
+        maxLibRateErr = std::max({maxLibRateErr, std::abs(mid.librationLonRate_deg_day - lonRate),
+                                  std::abs(mid.librationLatRate_deg_day - latRate)});
+    }
+    check(maxRangeRateErr < 2e-4, "range rate is the derivative of distance");
+    check(maxLibRateErr < 2e-3, "libration rates are the derivatives of libration");
+    std::cout << "  max rate error: range " << maxRangeRateErr << " km/s, libration "
+              << maxLibRateErr << " deg/day" << std::endl;
+
+    // Batch rows are the scalar results, and stay physical over a year.
+    const std::time_t start = 1767225600;  // 2026-01-01 00:00:00 UTC
+    const std::size_t count = 365 * 24;
+    LunarPositionBatch year;
+    ephemeris.calculateSeries(start, 3600, count, year);
+    check(year.size() == count, "series has one row per time");
+
+    bool parity = true, physical = true;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i % 97 == 0) {
+            const LunarPosition p = ephemeris.calculate(start + static_cast<std::time_t>(i) * 3600);
+            parity = parity && p.rightAscension == year.rightAscension[i] &&
+                     p.declination == year.declination[i] && p.distance_km == year.distance_km[i] &&
+                     p.rangeRate_km_s == year.rangeRate_km_s[i] &&
+                     p.librationLatRate_deg_day == year.librationLatRate_deg_day[i];
+        }
+        physical = physical && year.distance_km[i] > 356000.0 && year.distance_km[i] < 407000.0 &&
+                   std::abs(deg(year.declination[i])) < 29.0 &&
+                   std::abs(year.rangeRate_km_s[i]) < 0.1 &&
+                   std::abs(year.librationLon_deg[i]) < 8.5 && std::abs(year.librationLat_deg[i]) < 7.0;
+    }
+    check(parity, "batch rows equal scalar evaluation");
+    check(physical, "a year of positions stays within lunar limits");
+
+    // The link budget picks the positions up per timestep.
+    LinkBudgetParameters params;
+    double lat, lon;
+    MaidenheadGrid::gridToLatLon("FN20xa", lat, lon);
+    params.txSite.latitude = ParameterUtils::deg2rad(lat);
+    params.txSite.longitude = ParameterUtils::deg2rad(lon);
+    MaidenheadGrid::gridToLatLon("JO62qm", lat, lon);
+    params.rxSite.latitude = ParameterUtils::deg2rad(lat);
+    params.rxSite.longitude = ParameterUtils::deg2rad(lon);
+    params.dataSources.useAnalyticEphemeris = true;
+
+    EMELinkBudget series(params);
+    LinkBudgetResultsBatch pass = series.calculateSeries(start, start + 6 * 3600, 1800);
+    check(pass.size() == 13, "series covers the pass");
+    for (std::size_t i = 0; i < pass.size(); ++i) {
+        LinkBudgetParameters single = params;
+        single.observationTime = pass.time[i];
+        EMELinkBudget reference(single);
+        const LinkBudgetResults expected = reference.calculate();
+        check(pass.calculationSuccess[i] != 0, "series row succeeds");
+        check(std::abs(pass.geometry.moonRA_deg[i] - expected.geometry.moonRA_deg) < 1e-9 &&
+              std::abs(pass.geometry.moonElevation_RX_deg[i] - expected.geometry.moonElevation_RX_deg) < 1e-9,
+              "series and single evaluation use the same moon position");
+        if (i % 2 == 0) {
+            check(std::abs(pass.geometry.moonRA_deg[i] - deg(year.rightAscension[i / 2])) < 1e-9,
+                  "series uses the ephemeris at each timestep");
+        }
+    }
+    check(pass.string(pass.geometry.ephemerisSourceId[0]) == LunarEphemeris::SOURCE_NAME,
+          "series reports the ephemeris source");
+
+    // Throughput over a month at one-second steps.
+    const std::size_t month = 30 * 86400;
+    std::vector<double> jde(month);
+    for (std::size_t i = 0; i < month; ++i) {
+        jde[i] = 2461041.5 + static_cast<double>(i) / 86400.0;
+    }
+    LunarPositionBatch batch;
+    auto t0 = std::chrono::steady_clock::now();
+    ephemeris.calculateBatch(jde.data(), month, batch);
+    const double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    const int scalarCount = 200000;
+    double sink = 0.0;
+    t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < scalarCount; ++i) {
+        sink += ephemeris.calculateJDE(jde[i]).distance_km;
+    }
+    const double scalarSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    check(sink > 0.0 && batch.size() == month, "benchmark produced positions");
+
+    std::cout << "  batch: " << month / batchSeconds / 1e6 << " M positions/s, scalar: "
+              << scalarCount / scalarSeconds / 1e6 << " M positions/s" << std::endl;
+
+    return finishTests("Built-in lunar ephemeris matches the reference examples");
+}
@@ -0,0 +1,132 @@
+#include "MagneticFieldGrid.h"
+#include "IonosphereDataProvider.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+static std::tm makeTime(int day, int hour) {
+    std::tm t = {};
+    t.tm_year = 2026 - 1900;
+    t.tm_mon = 2 - 1;
+    t.tm_mday = day;
+    t.tm_hour = hour;
+    return t;
+}
+
+struct GridError {
+    double F = 0.0;
+    double inclination = 0.0;
+    double declination = 0.0;
+};
+
+// Worst difference against direct evaluation over scattered points, |lat| <= 85.
+static GridError gridError(const WMMModel& model, const MagneticFieldGrid& grid) {
+    GridError e;
+    for (int i = 0; i < 20000; ++i) {
+        const double lat = -85.0 + std::fmod(i * 0.6180339887 * 170.0, 170.0);
+        const double lon = -180.0 + std::fmod(i * 0.4142135624 * 360.0, 360.0);
+        MagneticFieldResult direct = model.calculate(lat, lon, grid.getHeight(), grid.getDecimalYear());
+        MagneticFieldResult fast = grid.interpolate(lat, lon);
+        double dD = std::abs(direct.declination - fast.declination);
+        e.F = std::max(e.F, std::abs(direct.F - fast.F));
+        e.inclination = std::max(e.inclination, std::abs(direct.inclination - fast.inclination));
+        e.declination = std::max(e.declination, std::min(dD, 360.0 - dD));
+    }
+    return e;
+}
+
+int main() {
+    std::cout << "Magnetic Field Grid Test\n" << std::endl;
+
+    WMMModel model;
+    MagneticFieldGrid grid;
+    check(!grid.build(model, 2026.1, 350.0) && !grid.isValid(), "unloaded model does not build");
+    check(grid.interpolate(10.0, 10.0).F == 0.0, "invalid grid returns zero field");
+
+    if (!model.loadCoefficientFile("../data/WMMHR.COF")) {
+        std::cout << "✗ could not load ../data/WMMHR.COF" << std::endl;
+        return 1;
+    }
+    check(!grid.build(model, 2026.1, 350.0, 0.0), "non-positive resolution rejected");
+
+    auto start = std::chrono::steady_clock::now();
+    check(grid.build(model, 2026.1, 350.0, 1.0, 1), "1 degree grid builds");
+    double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    MagneticFieldResult node = grid.interpolate(40.0, -75.0);
+    MagneticFieldResult direct = model.calculate(40.0, -75.0, 350.0, 2026.1);
+    check(std::abs(node.X - direct.X) < 1e-6 && std::abs(node.Z - direct.Z) < 1e-6, "grid nodes are exact");
+
+    MagneticFieldResult east = grid.interpolate(20.3, 179.75);
+    MagneticFieldResult west = grid.interpolate(20.3, -180.25);
+    check(std::abs(east.F - west.F) < 1e-9, "longitude wraps across the dateline");
+
+    MagneticFieldGrid threaded;
+    check(threaded.build(model, 2026.1, 350.0, 1.0, 4), "grid builds on four threads");
+    bool same = true;
+    for (int i = 0; i < 200; ++i) {
+        same = same && threaded.interpolate(-89.0 + i * 0.89, -179.0 + i * 1.79).F ==
+                       grid.interpolate(-89.0 + i * 0.89, -179.0 + i * 1.79).F;
+    }
+    check(same, "threaded build matches serial build");
+
+    GridError coarse = gridError(model, grid);
+    check(coarse.F < 8.0 && coarse.inclination < 0.02 && coarse.declination < 0.12,
+          "1 degree grid within documented error");
+
+    MagneticFieldGrid fine;
+    check(fine.build(model, 2026.1, 350.0, 0.5) && std::abs(fine.getResolution() - 0.5) < 1e-12, "0.5 degree grid builds");
+    GridError tight = gridError(model, fine);
+    check(tight.F < 2.0 && tight.inclination < 0.005 && tight.declination < 0.03,
+          "0.5 degree grid within documented error");
+
+    std::cout << "  1 deg: |dF| " << coarse.F << " nT, |dI| " << coarse.inclination << " deg, |dD| "
+              << coarse.declination << " deg (build " << buildMs << " ms)" << std::endl;
+    std::cout << "  0.5 deg: |dF| " << tight.F << " nT, |dI| " << tight.inclination << " deg, |dD| "
+              << tight.declination << " deg" << std::endl;
+
+    // Lookup cost against direct evaluation.
+    const int n = 200000;
+    double sum = 0.0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        sum += model.calculate(-60.0 + i % 120, (i % 360) - 180.0, 350.0, 2026.1).F;
+    }
+    double directUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / n;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        sum += grid.interpolate(-60.0 + i % 120 + 0.37, (i % 360) - 180.0 + 0.61).F;
+    }
+    double gridUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / n;
+    check(sum > 0.0, "benchmark produced a field");
+    std::cout << "  per point: calculate " << directUs << " us, grid " << gridUs << " us" << std::endl;
+
+    // Provider serves B from the shell grid and rebuilds it for a new epoch.
+    IonosphereDataProvider provider;
+    check(provider.loadIonexFile("../data/data.txt") && provider.loadWMMFile("../data/WMMHR.COF"),
+          "provider loads IONEX and WMM");
+    provider.enableMagneticGrid(1.0, SystemConstants::IONOSPHERE_HEIGHT_KM, 0.5);
+
+    IonosphereData iono;
+    check(provider.getIonosphereData(makeTime(9, 2), 31.77, 116.87, 0.0, 51.5, -0.1, 0.0, iono) &&
+          provider.getMagneticGrid() != nullptr, "provider builds grid on first query");
+    const double firstYear = provider.getMagneticGrid()->getDecimalYear();
+    MagneticFieldResult shell = model.calculate(31.77, 116.87, SystemConstants::IONOSPHERE_HEIGHT_KM, firstYear);
+    check(std::abs(iono.B_magnitude_DX - shell.F * 1e-9) < 8e-9 &&
+          std::abs(iono.B_inclination_DX - shell.inclination * M_PI / 180.0) < 0.02 * M_PI / 180.0,
+          "provider field taken on the ionospheric shell");
+
+    provider.getIonosphereData(makeTime(9, 8), 31.77, 116.87, 0.0, 51.5, -0.1, 0.0, iono);
+    check(provider.getMagneticGrid()->getDecimalYear() == firstYear, "grid reused within its epoch window");
+    provider.getIonosphereData(makeTime(9, 23), 31.77, 116.87, 0.0, 51.5, -0.1, 0.0, iono);
+    check(provider.getMagneticGrid()->getDecimalYear() > firstYear, "grid rebuilt for a new epoch");
+
+    provider.disableMagneticGrid();
+    provider.getIonosphereData(makeTime(9, 23), 31.77, 116.87, 0.0, 51.5, -0.1, 0.0, iono);
+    check(!provider.isMagneticGridEnabled() && provider.getMagneticGrid() == nullptr, "grid can be disabled");
+
+    return finishTests("Shell-height field grid matches direct WMM evaluation");
+}
@@ -0,0 +1,106 @@
+#include "ParameterSweep.h"
+#include "EMELinkBudget.h"
+#include "MaidenheadGrid.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <cmath>
+#include <memory>
+
+static SiteParameters makeSite(const std::string& grid) {
+    double lat, lon;
+    MaidenheadGrid::gridToLatLon(grid, lat, lon);
+
+    SiteParameters site;
+    site.latitude = ParameterUtils::deg2rad(lat);
+    site.longitude = ParameterUtils::deg2rad(lon);
+    return site;
+}
+
+static SweepGrid makeGrid() {
+    SweepGrid grid;
+    grid.base.observationTime = 1767225600;  // 2026-01-01 00:00:00 UTC
+    grid.base.moonEphemeris.rightAscension = ParameterUtils::deg2rad(120.0);
+    grid.base.moonEphemeris.declination = ParameterUtils::deg2rad(18.0);
+    grid.base.moonEphemeris.distance_km = 380000.0;
+    grid.base.ionosphereData.vTEC_DX = 25.0;
+    grid.base.ionosphereData.vTEC_Home = 30.0;
+
+    grid.stationPairs = {
+        {makeSite("FN20xa"), makeSite("JO62qm")},
+        {makeSite("PM95vq"), makeSite("QF22ne")},
+    };
+    grid.frequencies_MHz = {144.0, 432.0, 1296.0};
+    grid.txPowers_dBm = {50.0, 60.0};
+    grid.rxGains_dBi = {18.0, 24.0};
+    grid.polarizations = {
+        PolarizationSetting(0.0, 0.0, 0.0, 0.0),
+        PolarizationSetting(0.0, 0.0, ParameterUtils::deg2rad(90.0), 0.0),
+        PolarizationSetting(0.0, ParameterUtils::deg2rad(45.0), 0.0, ParameterUtils::deg2rad(45.0)),
+    };
+    return grid;
+}
+
+int main() {
+    std::cout << "EME Link Budget - Parameter Sweep Test\n" << std::endl;
+
+    SweepGrid grid = makeGrid();
+    check(grid.size() == 2 * 3 * 2 * 2 * 3, "grid size is the product of axis sizes");
+
+    LinkBudgetParameters last = grid.at(grid.size() - 1);
+    check(last.frequency_MHz == 1296.0 && last.rxGain_dBi == 24.0, "last index selects last values");
+    check(last.txGain_dBi == grid.base.txGain_dBi, "empty axis keeps base value");
+    check(grid.at(1).rxSite.psi == grid.polarizations[1].rxPsi, "polarization varies fastest");
+
+    ParameterSweep sweep(4);
+    sweep.setChunkSize(2);
+    LinkBudgetResultsBatch parallel = sweep.run(grid);
+    LinkBudgetResultsBatch serial = ParameterSweep(1).run(grid);
+
+    check(parallel.size() == grid.size(), "one row per grid point");
+
+    EMELinkBudget reference;
+    for (size_t i = 0; i < grid.size(); ++i) {
+        reference.setParameters(grid.at(i));
+        LinkBudgetResults expected = reference.calculate();
+
+        check(parallel.calculationSuccess[i] != 0, "sweep row succeeds");
+        check(near(parallel.pathLoss.totalPathLoss_dB[i], expected.pathLoss.totalPathLoss_dB),
+              "path loss matches serial loop");
+        check(near(parallel.polarization.PLF[i], expected.polarization.PLF),
+              "PLF matches serial loop");
+        check(near(parallel.snr.linkMargin_dB[i], expected.snr.linkMargin_dB),
+              "link margin matches serial loop");
+        check(parallel.snr.linkMargin_dB[i] == serial.snr.linkMargin_dB[i],
+              "thread count does not change results");
+        check(parallel.row(i).geometry.ephemerisSource == expected.geometry.ephemerisSource,
+              "ephemeris source is interned");
+    }
+
+    auto trace = std::make_shared<RingBufferTraceSink>(8);
+    sweep.setTraceSink(trace);
+    sweep.run(grid);
+    std::vector<PolarizationTrace> traces = trace->snapshot();
+    size_t moonUp = 0;
+    for (size_t i = 0; i < parallel.size(); ++i) {
+        if (parallel.geometry.moonElevation_TX_deg[i] >= 0.0 &&
+            parallel.geometry.moonElevation_RX_deg[i] >= 0.0) {
+            ++moonUp;
+        }
+    }
+    check(moonUp >= 8, "grid has enough mutual-visibility points");
+    check(trace->totalRecorded() == moonUp, "trace sink sees every Jones evaluation");
+    check(traces.size() == 8, "ring buffer keeps the last N evaluations");
+    for (const PolarizationTrace& t : traces) {
+        check(t.PLF >= 0.0 && t.PLF <= 1.0 + 1e-12, "traced PLF is a valid fraction");
+        check(near(t.PLF, std::norm(t.innerProduct)), "traced PLF matches inner product");
+    }
+
+    EMELinkBudget traced(grid.at(0));
+    auto single = std::make_shared<RingBufferTraceSink>(4);
+    traced.getPolarizationModule().getFaradayCalculator().setTraceSink(single);
+    LinkBudgetResults tracedResult = traced.calculate();
+    check(single->size() == 1 && near(single->snapshot()[0].PLF, tracedResult.polarization.PLF),
+          "trace record matches reported PLF");
+
+    return finishTests("Parallel sweep matches serial evaluation");
+}
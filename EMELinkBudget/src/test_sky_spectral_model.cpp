@@ -0,0 +1,245 @@
+#include "SkySpectralModel.h"
+#include "DataRegistry.h"
+#include "NoiseCalculator.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const double DEG = M_PI / 180.0;
+static const int NSIDE = 32;
+
+// Smooth synthetic sky: warm towards the equator, with an index flattening
+// from -2.9 at the poles to -2.3 on the equator.
+static double t408(double z, double phi) {
+    return 20.0 + 60.0 * (1.0 - z * z) * (1.0 + 0.3 * std::sin(phi));
+}
+
+static double trueIndex(double z) {
+    return -2.9 + 0.6 * (1.0 - z * z);
+}
+
+// Equatorial NESTED float map with T(z, phi) at pixel centres.
+static void writeMap(const std::string& path, const std::function<double(double, double)>& temperature) {
+    const HealpixGrid grid(NSIDE);
+    auto card = [](const std::string& key, const std::string& value) {
+        std::string c = key;
+        c.resize(8, ' ');
+        c += "= " + value;
+        c.resize(80, ' ');
+        return c;
+    };
+    std::string end = "END";
+    end.resize(80, ' ');
+
+    std::string primary = card("SIMPLE", "T") + card("BITPIX", "8") + card("NAXIS", "0") + end;
+    primary.resize(2880, ' ');
+    std::string header = card("XTENSION", "'BINTABLE'") + card("BITPIX", "8") + card("NAXIS", "2") +
+                         card("NAXIS1", "4") + card("NAXIS2", std::to_string(grid.getNpix())) +
+                         card("TFIELDS", "1") + card("TFORM1", "'E       '") +
+                         card("ORDERING", "'NESTED  '") + card("COORDSYS", "'C       '") +
+                         card("NSIDE", std::to_string(NSIDE)) + end;
+    header.resize((header.size() + 2879) / 2880 * 2880, ' ');
+
+    std::string data;
+    for (int64_t pix = 0; pix < grid.getNpix(); ++pix) {
+        double z, phi;
+        grid.pix2zphiNest(pix, z, phi);
+        const float t = static_cast<float>(temperature(z, phi));
+        unsigned char b[4];
+        std::memcpy(b, &t, 4);
+        for (int i = 3; i >= 0; --i) {
+            data += static_cast<char>(b[i]);
+        }
+    }
+    data.resize((data.size() + 2879) / 2880 * 2880, '\0');
+
+    std::ofstream out(path, std::ios::binary);
+    out << primary << header << data;
+}
+
+static void writeSurvey(const std::string& path, double frequency_MHz) {
+    writeMap(path, [frequency_MHz](double z, double phi) {
+        return t408(z, phi) * std::pow(frequency_MHz / 408.0, trueIndex(z));
+    });
+}
+
+int main() {
+    const fs::path dir = fs::temp_directory_path() / "eme_sky_spectral_model_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const std::string path408 = (dir / "sky408.fits").string();
+    const std::string path1420 = (dir / "sky1420.fits").string();
+    const std::string path45 = (dir / "sky45.fits").string();
+    writeMap(path408, t408);
+    writeSurvey(path1420, 1420.0);
+    writeSurvey(path45, 45.0);
+
+    HaslamSkyMap map408, map1420, map45;
+    check(map408.loadFITS(path408), "408 MHz map loads");
+    check(map1420.loadFITS(path1420, 2.0), "1420 MHz map loads");
+    check(map45.loadFITS(path45, 2.0), "45 MHz map loads");
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const std::size_t points = 20000;
+    std::vector<double> ra(points), dec(points);
+    for (std::size_t i = 0; i < points; ++i) {
+        ra[i] = 360.0 * uniform(rng);
+        dec[i] = std::asin(2.0 * uniform(rng) - 1.0) / DEG;
+    }
+
+    // ========== Fixed Index Without Surveys ==========
+    {
+        SkySpectralModel model;
+        check(model.build(map408, {}), "model builds from the 408 MHz map alone");
+        bool same = true;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            const double expected = map408.getBeamTemperature(ra[i], dec[i], model.getLevelBeam(0)) *
+                                    std::pow(144.0 / 408.0, -2.55);
+            const double got = model.getBeamTemperature(ra[i], dec[i], model.getLevelBeam(0), 144.0);
+            same = same && std::abs(got / expected - 1.0) < 1e-5 &&
+                   model.getSpectralIndex(ra[i], dec[i]) == static_cast<float>(-2.55);
+        }
+        check(same, "without surveys the index is the fixed -2.55");
+    }
+
+    // ========== Fitted Index ==========
+    SkySpectralModel model;
+    auto t0 = std::chrono::steady_clock::now();
+    check(model.build(map408, {{&map1420, 1420.0}, {&map45, 45.0}}), "model builds with two surveys");
+    const double buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    {
+        SkySpectralModel single;
+        single.build(map408, {{&map1420, 1420.0}});
+        const HealpixGrid grid(model.getNside());
+        double worst = 0.0, worstSingle = 0.0, worstT = 0.0;
+        for (int64_t pix = 0; pix < grid.getNpix(); ++pix) {
+            double z, phi;
+            grid.pix2zphiNest(pix, z, phi);
+            const double r = phi / DEG, d = std::asin(z) / DEG;
+            worst = std::max(worst, std::abs(model.getSpectralIndex(r, d) - trueIndex(z)));
+            worstSingle = std::max(worstSingle, std::abs(single.getSpectralIndex(r, d) - trueIndex(z)));
+
+            const double level0 = map408.getLevelPixels(0)[pix];
+            const double expected = level0 * std::pow(144.0 / 408.0, trueIndex(z));
+            worstT = std::max(worstT, std::abs(model.getTemperature(r, d, 144.0) / expected - 1.0));
+        }
+        check(worst < 0.02, "per-pixel index recovered from three frequencies");
+        check(worstSingle < 0.02, "per-pixel index recovered from two frequencies");
+        check(worstT < 0.02, "144 MHz temperature follows the local index");
+        std::cout << "  max |d beta| " << worst << " (3 maps), " << worstSingle
+                  << " (2 maps); max 144 MHz error " << 100.0 * worstT << "%" << std::endl;
+    }
+
+    {
+        std::vector<double> batch(points);
+        model.getTemperatures(ra.data(), dec.data(), batch.data(), points, 50.0);
+        bool same = true;
+        for (std::size_t i = 0; i < points; ++i) {
+            same = same && batch[i] == model.getTemperature(ra[i], dec[i], 50.0);
+        }
+        check(same, "batched lookups match the scalar ones");
+
+        bool beams = true;
+        for (std::size_t i = 0; i < 2000; ++i) {
+            for (double fwhm : {7.0, 20.0}) {
+                const double expected = map408.getBeamTemperature(ra[i], dec[i], fwhm);
+                beams = beams && std::abs(model.getBeamTemperature(ra[i], dec[i], fwhm, 408.0) / expected - 1.0) < 1e-5;
+            }
+        }
+        check(beams, "beam temperatures at 408 MHz match the map's pyramid");
+        check(model.getTemperature(10.0, 95.0, 144.0) == 0.0, "declination out of range gives 0");
+    }
+
+    // ========== Cache File ==========
+    {
+        const std::vector<SkySurveyFile> sources = {{path408, 408.0, HaslamSkyMap::SURVEY_BEAM_DEG},
+                                                    {path1420, 1420.0, 2.0}, {path45, 45.0, 2.0}};
+        const std::uint64_t key = SkySpectralModel::sourceKey(sources);
+        const std::string cachePath = (dir / "model.bin").string();
+        check(model.save(cachePath, key), "model saved");
+
+        SkySpectralModel mapped;
+        t0 = std::chrono::steady_clock::now();
+        check(mapped.open(cachePath, key), "cache file opens");
+        const double openMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        check(mapped.isMapped(), "cache file is memory-mapped");
+        check(mapped.getPyramidLevels() == model.getPyramidLevels(), "cache keeps every pyramid level");
+
+        bool same = true;
+        for (std::size_t i = 0; i < points; ++i) {
+            same = same && mapped.getBeamTemperature(ra[i], dec[i], 12.0, 144.0) ==
+                               model.getBeamTemperature(ra[i], dec[i], 12.0, 144.0) &&
+                   mapped.getTemperature(ra[i], dec[i], 1296.0) == model.getTemperature(ra[i], dec[i], 1296.0);
+        }
+        check(same, "mapped model gives the built model's values");
+
+        SkySpectralModel stale;
+        check(!stale.open(cachePath, key + 1), "cache for other sources rejected");
+        std::vector<SkySurveyFile> changed = sources;
+        changed[1].frequency_MHz = 1400.0;
+        check(SkySpectralModel::sourceKey(changed) != key, "source key covers the frequencies");
+
+        const std::string truncated = (dir / "truncated.bin").string();
+        fs::copy_file(cachePath, truncated);
+        fs::resize_file(truncated, fs::file_size(cachePath) - 100);
+        check(!stale.open(truncated, key) && !stale.isLoaded(), "truncated cache rejected");
+
+        std::cout << "  build " << buildMs << " ms, open cache " << openMs << " ms" << std::endl;
+    }
+
+    // ========== Registry ==========
+    {
+        const std::string cacheDir = (dir / "cache").string();
+        auto configure = [&](DataRegistry& registry) {
+            registry.setSkyMapPaths({(dir / "missing.fits").string(), path408});
+            registry.setSkySurveys({{path1420, 1420.0, 2.0}, {path45, 45.0, 2.0}});
+            registry.setSkyModelCacheDirectory(cacheDir);
+        };
+
+        DataRegistry plain;
+        plain.setSkyMapPaths({path408});
+        check(plain.skyModel() == nullptr, "no surveys, no model");
+
+        DataRegistry first;
+        configure(first);
+        std::shared_ptr<const SkySpectralModel> built = first.skyModel();
+        check(built != nullptr && !built->isMapped(), "first registry builds the model");
+        check(first.getStats().skyMapLoads == 1 && first.getStats().skyModelCacheHits == 0, "first registry reads the maps");
+
+        DataRegistry second;
+        configure(second);
+        std::shared_ptr<const SkySpectralModel> cached = second.skyModel();
+        check(cached != nullptr && cached->isMapped(), "second registry maps the cache");
+        check(second.getStats().skyModelCacheHits == 1, "cache hit counted");
+        check(second.getStats().skyMapLoads == 0, "cache hit skips the FITS maps");
+        check(cached && built && cached->getTemperature(40.0, 10.0, 70.0) == built->getTemperature(40.0, 10.0, 70.0),
+              "cached model matches the built one");
+
+        fs::last_write_time(path1420, fs::last_write_time(path1420) + std::chrono::hours(1));
+        DataRegistry third;
+        configure(third);
+        check(third.skyModel() != nullptr && third.getStats().skyModelCacheHits == 0, "changed survey rebuilds the model");
+
+        // The noise calculator prefers the model to the map.
+        NoiseCalculator calculator;
+        calculator.setSpectralModel(cached);
+        const double expected = cached ? cached->getTemperature(120.0, 30.0, 144.0) : 0.0;
+        check(std::abs(calculator.calculateSkyNoiseTemp(144.0, 120.0, 30.0) - expected) < 1e-12,
+              "sky noise taken from the spectral model");
+    }
+
+    fs::remove_all(dir);
+
+    return finishTests("Per-pixel spectral index model fits, caches and evaluates correctly");
+}
@@ -0,0 +1,347 @@
+#include "SpkEphemeris.h"
+#include "EMELinkBudget.h"
+#include "MaidenheadGrid.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// ========== Synthetic Kernel ==========
+// A circular geocentric orbit split between Moon and Earth about the EMB,
+// fitted with degree 13 Chebyshev records of 4 days like DE440.
+
+static const double ORBIT_RADIUS = 384400.0;
+static const double ORBIT_RATE = 2.0 * M_PI / (27.321661 * 86400.0);
+static const double ORBIT_INCLINATION = 0.4;
+static const double MOON_SHARE = 81.3 / 82.3;
+
+static void geocentric(double et, double* r, double* v) {
+    const double phi = ORBIT_RATE * et + 1.0;
+    const double ci = std::cos(ORBIT_INCLINATION), si = std::sin(ORBIT_INCLINATION);
+    r[0] = ORBIT_RADIUS * std::cos(phi);
+    r[1] = ORBIT_RADIUS * std::sin(phi) * ci;
+    r[2] = ORBIT_RADIUS * std::sin(phi) * si;
+    v[0] = -ORBIT_RADIUS * ORBIT_RATE * std::sin(phi);
+    v[1] = ORBIT_RADIUS * ORBIT_RATE * std::cos(phi) * ci;
+    v[2] = ORBIT_RADIUS * ORBIT_RATE * std::cos(phi) * si;
+}
+
+// EMB about the SSB: a slow quadratic drift, exact in any degree >= 2.
+static void barycenter(double et, double* r) {
+    const double d = et / 86400.0;
+    r[0] = 1.2e8 + 2.5e6 * d;
+    r[1] = -0.9e8 + 1.0e6 * d + 30.0 * d * d;
+    r[2] = 4.0e7 - 500.0 * d * d;
+}
+
+struct TestSegment {
+    int target;
+    int center;
+    double start;
+    double stop;
+    double intervalLength;
+    int degree;
+    std::vector<double> records;
+};
+
+template <typename F>
+static TestSegment fitSegment(int target, int center, double start, double stop,
+                              double intervalLength, int degree, F&& position) {
+    TestSegment segment{target, center, start, stop, intervalLength, degree, {}};
+    const int n = degree + 1;
+    for (double t0 = start; t0 < stop; t0 += intervalLength) {
+        const double radius = intervalLength / 2.0;
+        const double mid = t0 + radius;
+        segment.records.push_back(mid);
+        segment.records.push_back(radius);
+
+        std::vector<double> samples(3 * n);
+        for (int j = 0; j < n; ++j) {
+            double r[3];
+            position(mid + radius * std::cos(M_PI * (j + 0.5) / n), r);
+            for (int axis = 0; axis < 3; ++axis) {
+                samples[axis * n + j] = r[axis];
+            }
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            for (int k = 0; k < n; ++k) {
+                double c = 0.0;
+                for (int j = 0; j < n; ++j) {
+                    c += samples[axis * n + j] * std::cos(M_PI * k * (j + 0.5) / n);
+                }
+                segment.records.push_back(c * (k == 0 ? 1.0 : 2.0) / n);
+            }
+        }
+    }
+    return segment;
+}
+
+static void putBytes(std::vector<char>& file, std::size_t offset, const void* value, std::size_t size,
+                     bool bigEndian) {
+    const char* bytes = static_cast<const char*>(value);
+    for (std::size_t i = 0; i < size; ++i) {
+        file[offset + i] = bigEndian ? bytes[size - 1 - i] : bytes[i];
+    }
+}
+
+static void putWord(std::vector<char>& file, std::size_t address, double value, bool bigEndian) {
+    putBytes(file, (address - 1) * 8, &value, 8, bigEndian);
+}
+
+static void putInt(std::vector<char>& file, std::size_t offset, std::int32_t value, bool bigEndian) {
+    putBytes(file, offset, &value, 4, bigEndian);
+}
+
+static void writeSpk(const fs::path& path, const std::vector<TestSegment>& segments, bool bigEndian) {
+    std::size_t words = 3 * 128;
+    for (const TestSegment& s : segments) {
+        words += s.records.size() + 4;
+    }
+    std::vector<char> file(((words + 127) / 128) * 1024, 0);
+
+    std::memcpy(file.data(), "DAF/SPK ", 8);
+    putInt(file, 8, 2, bigEndian);
+    putInt(file, 12, 6, bigEndian);
+    std::memset(file.data() + 16, ' ', 60);
+    std::memcpy(file.data() + 16, "EME TEST KERNEL", 15);
+    putInt(file, 76, 2, bigEndian);
+    putInt(file, 80, 2, bigEndian);
+    putInt(file, 84, static_cast<std::int32_t>(words + 1), bigEndian);
+    std::memcpy(file.data() + 88, bigEndian ? "BIG-IEEE" : "LTL-IEEE", 8);
+
+    // Summary record 2 (name record 3 stays blank), data from record 4.
+    putWord(file, 128 + 1, 0.0, bigEndian);
+    putWord(file, 128 + 2, 0.0, bigEndian);
+    putWord(file, 128 + 3, static_cast<double>(segments.size()), bigEndian);
+    std::size_t address = 3 * 128 + 1;
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+        const TestSegment& s = segments[i];
+        const std::size_t begin = address;
+        for (double value : s.records) {
+            putWord(file, address++, value, bigEndian);
+        }
+        putWord(file, address++, s.start, bigEndian);
+        putWord(file, address++, s.intervalLength, bigEndian);
+        putWord(file, address++, 2.0 + 3.0 * (s.degree + 1), bigEndian);
+        putWord(file, address++, static_cast<double>(s.records.size() / (2 + 3 * (s.degree + 1))), bigEndian);
+
+        const std::size_t summary = 128 + 4 + 5 * i;
+        putWord(file, summary, s.start, bigEndian);
+        putWord(file, summary + 1, s.stop, bigEndian);
+        const std::size_t ints = (summary + 1) * 8;
+        const std::int32_t values[6] = {s.target, s.center, 1, 2,
+                                        static_cast<std::int32_t>(begin),
+                                        static_cast<std::int32_t>(address - 1)};
+        for (int k = 0; k < 6; ++k) {
+            putInt(file, ints + 4 * k, values[k], bigEndian);
+        }
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(file.data(), static_cast<std::streamsize>(file.size()));
+}
+
+static double distanceBetween(const double* a, const double* b) {
+    return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) +
+                     (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+int main() {
+    std::cout << "SPK Ephemeris Test\n" << std::endl;
+
+    const fs::path dir = fs::temp_directory_path() / "test_spk_ephemeris";
+    fs::create_directories(dir);
+
+    // 2026-01-01 .. 2026-03-02 in ephemeris time, Moon split at 2026-02-01.
+    const std::time_t startUtc = 1767225600;
+    const double start = std::floor(SpkEphemeris::ephemerisTime(startUtc) / 86400.0) * 86400.0;
+    const double interval = 4.0 * 86400.0;
+    const double split = start + 8 * interval;
+    const double stop = start + 15 * interval;
+
+    auto moonAboutEmb = [](double et, double* r) {
+        double g[3], v[3];
+        geocentric(et, g, v);
+        for (int axis = 0; axis < 3; ++axis) r[axis] = MOON_SHARE * g[axis];
+    };
+    auto earthAboutEmb = [](double et, double* r) {
+        double g[3], v[3];
+        geocentric(et, g, v);
+        for (int axis = 0; axis < 3; ++axis) r[axis] = (MOON_SHARE - 1.0) * g[axis];
+    };
+
+    std::vector<TestSegment> segments = {
+        fitSegment(SpkEphemeris::MOON, SpkEphemeris::EARTH_MOON_BARYCENTER, split, stop, interval, 13, moonAboutEmb),
+        fitSegment(SpkEphemeris::EARTH, SpkEphemeris::EARTH_MOON_BARYCENTER, start, stop, interval, 13, earthAboutEmb),
+        fitSegment(SpkEphemeris::MOON, SpkEphemeris::EARTH_MOON_BARYCENTER, start, split, interval, 13, moonAboutEmb),
+        fitSegment(SpkEphemeris::EARTH_MOON_BARYCENTER, SpkEphemeris::SOLAR_SYSTEM_BARYCENTER,
+                   start, stop, 16.0 * 86400.0, 2, barycenter),
+    };
+    const fs::path little = dir / "little.bsp";
+    const fs::path big = dir / "big.bsp";
+    writeSpk(little, segments, false);
+    writeSpk(big, segments, true);
+
+    SpkEphemeris spk;
+    check(spk.open(little.string()), "little-endian kernel opens");
+    check(spk.getSegmentCount() == 4, "all four segments are indexed");
+    check(spk.getInternalName() == "EME TEST KERNEL", "internal file name is read");
+
+    // Geocentric Moon through the EMB, across records and the segment split.
+    double maxPosErr = 0.0, maxVelErr = 0.0;
+    for (double et = start + 17.0; et < stop; et += 3637.0) {
+        SpkState s;
+        if (!spk.state(SpkEphemeris::MOON, SpkEphemeris::EARTH, et, s)) {
+            check(false, "state inside coverage");
+            break;
+        }
+        double r[3], v[3];
+        geocentric(et, r, v);
+        maxPosErr = std::max(maxPosErr, distanceBetween(s.position, r));
+        maxVelErr = std::max(maxVelErr, distanceBetween(s.velocity, v));
+    }
+    check(maxPosErr < 1e-6, "Chebyshev position matches the orbit");
+    check(maxVelErr < 1e-10, "Chebyshev velocity matches the orbit");
+    std::cout << "  max error: position " << maxPosErr << " km, velocity " << maxVelErr << " km/s" << std::endl;
+
+    SpkState before, after;
+    spk.state(SpkEphemeris::MOON, SpkEphemeris::EARTH, split - 1e-3, before);
+    spk.state(SpkEphemeris::MOON, SpkEphemeris::EARTH, split + 1e-3, after);
+    check(distanceBetween(before.position, after.position) < 1e-2, "continuous across segments");
+
+    SpkState ssb;
+    double emb[3], mAbout[3];
+    check(spk.state(SpkEphemeris::MOON, SpkEphemeris::SOLAR_SYSTEM_BARYCENTER, start + 1e6, ssb),
+          "Moon relative to the SSB chains through the EMB");
+    barycenter(start + 1e6, emb);
+    moonAboutEmb(start + 1e6, mAbout);
+    const double expectedSsb[3] = {emb[0] + mAbout[0], emb[1] + mAbout[1], emb[2] + mAbout[2]};
+    check(distanceBetween(ssb.position, expectedSsb) < 1e-4, "chained state sums the segments");
+
+    SpkState unused;
+    check(!spk.state(SpkEphemeris::MOON, SpkEphemeris::EARTH, start - 10.0, unused), "before coverage fails");
+    check(!spk.state(SpkEphemeris::MOON, SpkEphemeris::EARTH, stop + 10.0, unused), "after coverage fails");
+    check(!spk.state(499, SpkEphemeris::EARTH, start + 10.0, unused), "unknown body fails");
+
+    SpkEphemeris swapped;
+    check(swapped.open(big.string()), "big-endian kernel opens");
+    SpkState a, b;
+    spk.state(SpkEphemeris::MOON, SpkEphemeris::EARTH, start + 5e5, a);
+    swapped.state(SpkEphemeris::MOON, SpkEphemeris::EARTH, start + 5e5, b);
+    check(std::memcmp(&a, &b, sizeof(a)) == 0, "byte order does not change results");
+
+    {
+        std::ofstream junk(dir / "junk.bsp", std::ios::binary);
+        junk << std::string(2048, 'x');
+    }
+    SpkEphemeris bad;
+    check(!bad.open((dir / "junk.bsp").string()) && !bad.getLastError().empty(), "non-SPK file is rejected");
+    check(!bad.open((dir / "missing.bsp").string()), "missing file is rejected");
+
+    // Time scales: TT - UTC = 32.184 s + leap seconds, TDB within 2 ms of TT.
+    check(std::abs(SpkEphemeris::ephemerisTime(startUtc) - (startUtc - 946728000.0 + 69.184)) < 2e-3,
+          "2026 ephemeris time uses 37 leap seconds");
+    check(std::abs(SpkEphemeris::ephemerisTime(1483228799) - (1483228799 - 946728000.0 + 68.184)) < 2e-3,
+          "leap second of 2017-01-01 is applied on time");
+
+    // Apparent place: the J2000 direction moved by precession and nutation.
+    const std::time_t when = startUtc + 20 * 86400;
+    LunarPosition moon;
+    check(spk.calculate(when, moon), "moon position inside coverage");
+    const double et = SpkEphemeris::ephemerisTime(when);
+    double r[3], v[3];
+    geocentric(et - ORBIT_RADIUS / 299792.458, r, v);
+    const double ra0 = std::atan2(r[1], r[0]);
+    const double dec0 = std::asin(r[2] / ORBIT_RADIUS);
+    const double years = et / (365.25 * 86400.0);
+    const double precessionRa = (46.124 + 20.043 * std::sin(ra0) * std::tan(dec0)) * years / 3600.0;
+    const double precessionDec = 20.043 * std::cos(ra0) * years / 3600.0;
+    const double dRa = std::remainder(moon.rightAscension - ra0, 2.0 * M_PI) * 180.0 / M_PI;
+    const double dDec = (moon.declination - dec0) * 180.0 / M_PI;
+    check(std::abs(dRa - precessionRa) < 0.01 && std::abs(dDec - precessionDec) < 0.01,
+          "apparent place is the precessed and nutated J2000 direction");
+    check(std::abs(moon.distance_km - ORBIT_RADIUS) < 1e-5, "distance from the kernel");
+    check(std::abs(moon.rangeRate_km_s) < 1e-9, "circular orbit has no range rate");
+    check(moon.librationLonRate_deg_day != 0.0, "libration comes from the analytic theory");
+    std::cout << "  RA shift " << dRa << " deg (precession " << precessionRa << "), Dec shift "
+              << dDec << " deg (precession " << precessionDec << ")" << std::endl;
+
+    LunarPosition outside;
+    check(!spk.calculate(startUtc + 120 * 86400, outside), "moon position outside coverage fails");
+
+    // Concurrent lookups agree with sequential ones.
+    const int perThread = 20000;
+    std::vector<double> sequential(4 * perThread);
+    for (int i = 0; i < 4 * perThread; ++i) {
+        SpkState s;
+        spk.state(SpkEphemeris::MOON, SpkEphemeris::EARTH, start + 100.0 + 61.0 * i, s);
+        sequential[i] = s.position[0] + s.velocity[2];
+    }
+    std::vector<double> concurrent(4 * perThread);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = t * perThread; i < (t + 1) * perThread; ++i) {
+                SpkState s;
+                spk.state(SpkEphemeris::MOON, SpkEphemeris::EARTH, start + 100.0 + 61.0 * i, s);
+                concurrent[i] = s.position[0] + s.velocity[2];
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    check(concurrent == sequential, "concurrent lookups match sequential ones");
+
+    // The link budget takes the kernel positions per timestep.
+    LinkBudgetParameters params;
+    double lat, lon;
+    MaidenheadGrid::gridToLatLon("FN20xa", lat, lon);
+    params.txSite.latitude = ParameterUtils::deg2rad(lat);
+    params.txSite.longitude = ParameterUtils::deg2rad(lon);
+    MaidenheadGrid::gridToLatLon("JO62qm", lat, lon);
+    params.rxSite.latitude = ParameterUtils::deg2rad(lat);
+    params.rxSite.longitude = ParameterUtils::deg2rad(lon);
+
+    auto shared = std::make_shared<SpkEphemeris>();
+    shared->open(little.string());
+    EMELinkBudget calculator(params);
+    calculator.setSpkEphemeris(shared);
+    LinkBudgetResultsBatch pass = calculator.calculateSeries(when, when + 3 * 3600, 900);
+    check(pass.size() == 13 && pass.string(pass.geometry.ephemerisSourceId[0]) == SpkEphemeris::SOURCE_NAME,
+          "series uses the kernel");
+    check(std::abs(pass.geometry.moonRA_deg[0] - moon.rightAscension * 180.0 / M_PI) < 1e-9 &&
+          std::abs(pass.geometry.moonDistance_km[0] - moon.distance_km) < 1e-9,
+          "series row matches the kernel position");
+
+    // Lookup cost.
+    const int lookups = 200000;
+    double sink = 0.0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; ++i) {
+        SpkState s;
+        spk.state(SpkEphemeris::MOON, SpkEphemeris::EARTH, start + 13.0 * i, s);
+        sink += s.position[0];
+    }
+    const double stateUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / lookups;
+    t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups / 10; ++i) {
+        LunarPosition p;
+        spk.calculate(when + i, p);
+        sink += p.declination;
+    }
+    const double placeUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / (lookups / 10);
+    check(sink != 0.0, "benchmark produced states");
+    std::cout << "  per lookup: state " << stateUs << " us, apparent place " << placeUs << " us" << std::endl;
+
+    fs::remove_all(dir);
+
+    return finishTests("SPK kernels are read and evaluated correctly");
+}
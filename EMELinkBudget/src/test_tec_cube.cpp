@@ -0,0 +1,117 @@
+#include "IonexReader.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+
+static std::tm makeTime(int day, int hour, int minute) {
+    std::tm t = {};
+    t.tm_year = 2026 - 1900;
+    t.tm_mon = 2 - 1;
+    t.tm_mday = day;
+    t.tm_hour = hour;
+    t.tm_min = minute;
+    return t;
+}
+
+int main() {
+    std::cout << "IONEX Preloaded Cube Test\n" << std::endl;
+
+    IonexReader lazy("../data/data.txt");
+    IonexReader cube("../data/data.txt");
+    if (!lazy.isOpen() || !cube.isOpen()) {
+        std::cout << "✗ could not open ../data/data.txt" << std::endl;
+        return 1;
+    }
+
+    check(!cube.isPreloaded(), "reader starts in lazy mode");
+    check(cube.preloadAll() && cube.isPreloaded(), "preload succeeds");
+
+    const TecCube& tec = cube.getCube();
+    check(tec.numTimes() == 25 && tec.numLat == 71 && tec.numLon == 73, "cube dimensions");
+    check(tec.data.size() == 25u * 71u * 73u, "cube is one contiguous block");
+    check(tec.epochs.back() - tec.epochs.front() == 24 * 3600, "epochs are UTC seconds");
+
+    // Scalar parity with the lazy path, including off-grid, clamped and exact epochs.
+    std::vector<std::time_t> times;
+    std::vector<double> lats;
+    std::vector<double> lons;
+    std::vector<double> expected;
+
+    for (int minute = -90; minute <= 24 * 60 + 90; minute += 37) {
+        int day = 9;
+        int m = minute;
+        if (m < 0) { day = 8; m += 24 * 60; }
+        if (m >= 24 * 60) { day = 10; m -= 24 * 60; }
+        std::tm t = makeTime(day, m / 60, m % 60);
+
+        for (double lat = -86.3; lat <= 86.3; lat += 11.9) {
+            for (double lon = -178.7; lon <= 178.7; lon += 23.3) {
+                double a = 0.0;
+                double b = 0.0;
+                bool okA = lazy.getTecValueInterpolated(t, lat, lon, a);
+                bool okB = cube.getTecValueInterpolated(t, lat, lon, b);
+                check(okA == okB && (!okA || a == b), "preloaded lookup matches lazy lookup");
+
+                times.push_back(TecCube::toUtc(t));
+                lats.push_back(lat);
+                lons.push_back(lon);
+                expected.push_back(okA ? a : std::nan(""));
+            }
+        }
+    }
+
+    double exactLazy = 0.0;
+    double exactCube = 0.0;
+    check(lazy.getTecValue(makeTime(9, 6, 0), 30.0, 115.0, exactLazy) &&
+          cube.getTecValue(makeTime(9, 6, 0), 30.0, 115.0, exactCube) &&
+          exactLazy == exactCube, "exact-epoch grid value matches");
+    check(!cube.getTecValue(makeTime(9, 6, 30), 30.0, 115.0, exactCube), "non-epoch exact lookup fails");
+
+    // Batched kernel equals scalar evaluation point for point.
+    std::vector<double> out(times.size());
+    std::size_t valid = tec.interpolate(times.data(), lats.data(), lons.data(), out.data(), out.size());
+    bool batchMatches = valid == out.size();
+    for (std::size_t i = 0; i < out.size(); ++i) {
+        batchMatches = batchMatches && out[i] == expected[i];
+    }
+    check(batchMatches, "batched kernel matches scalar path");
+
+    // Non-uniform epoch spacing falls back to binary search.
+    TecCube irregular;
+    irregular.numLat = 2;
+    irregular.numLon = 2;
+    irregular.lat1 = 10.0;
+    irregular.dlat = -10.0;
+    irregular.lon1 = 0.0;
+    irregular.dlon = 10.0;
+    irregular.epochs = {0, 100, 400};
+    irregular.data = {1, 1, 1, 1,  2, 2, 2, 2,  8, 8, 8, 8};
+    irregular.updateTimeIndex();
+    double v = 0.0;
+    check(irregular.interpolate(250, 5.0, 5.0, v) && std::abs(v - 5.0) < 1e-12, "irregular epochs interpolate");
+    check(irregular.interpolate(-50, 5.0, 5.0, v) && v == 1.0, "clamped before first epoch");
+    check(irregular.interpolate(900, 5.0, 5.0, v) && v == 8.0, "clamped after last epoch");
+    irregular.data[5] = TecCube::MISSING;
+    check(!irregular.interpolate(150, 5.0, 5.0, v), "missing grid value is reported");
+
+    // One pass worth of pierce points (2 stations, 1 s cadence, 8 h).
+    const std::size_t n = 2 * 8 * 3600;
+    std::vector<std::time_t> passTimes(n);
+    std::vector<double> passLat(n);
+    std::vector<double> passLon(n);
+    std::vector<double> passOut(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        passTimes[i] = tec.epochs.front() + static_cast<std::time_t>(i / 2);
+        passLat[i] = (i % 2) ? 50.0 + 1e-4 * static_cast<double>(i) : 30.0;
+        passLon[i] = (i % 2) ? 10.0 : 116.0 + 1e-4 * static_cast<double>(i);
+    }
+    auto start = std::chrono::steady_clock::now();
+    valid = tec.interpolate(passTimes.data(), passLat.data(), passLon.data(), passOut.data(), n);
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    check(valid == n, "pass evaluation has no gaps");
+    std::cout << "  " << n << " pierce points in " << us << " us" << std::endl;
+
+    return finishTests("Preloaded cube matches lazy interpolation");
+}
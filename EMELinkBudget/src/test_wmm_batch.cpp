@@ -0,0 +1,136 @@
+#include "WMMModel.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+struct Points {
+    std::vector<double> lat, lon, height;
+
+    void add(double la, double lo, double h) {
+        lat.push_back(la);
+        lon.push_back(lo);
+        height.push_back(h);
+    }
+};
+
+// Largest component difference between calculateBatch() and calculate().
+static double maxDeviation(const WMMModel& model, const Points& p, double year, const MagneticFieldBatch& batch) {
+    double worst = 0.0;
+    for (std::size_t i = 0; i < p.lat.size(); ++i) {
+        MagneticFieldResult one = model.calculate(p.lat[i], p.lon[i], p.height[i], year);
+        MagneticFieldResult row = batch.row(i);
+        worst = std::max({worst, std::abs(one.X - row.X), std::abs(one.Y - row.Y), std::abs(one.Z - row.Z),
+                          std::abs(one.F - row.F), std::abs(one.H - row.H),
+                          1000.0 * std::abs(one.inclination - row.inclination),
+                          1000.0 * std::abs(one.declination - row.declination)});
+    }
+    return worst;
+}
+
+// 1-degree global grid on one shell, the layout of a pierce-point sweep.
+static Points shellGrid(double height) {
+    Points p;
+    for (int lat = -89; lat <= 89; ++lat) {
+        for (int lon = -180; lon < 180; ++lon) {
+            p.add(lat, lon + 0.5, height);
+        }
+    }
+    return p;
+}
+
+template <typename F>
+static double perPointUs(F&& f, std::size_t points, int repeats) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        f();
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+           (static_cast<double>(points) * repeats);
+}
+
+int main() {
+    std::cout << "WMM Batch Evaluation Test\n" << std::endl;
+
+    WMMModel standard;
+    WMMModel full;
+    MagneticFieldBatch batch;
+
+    Points empty;
+    check(!standard.calculateBatch(empty.lat, empty.lon, empty.height, 2026.0, batch), "unloaded model is reported");
+
+    if (!standard.loadCoefficientFile("../data/WMMHR.COF") ||
+        !full.loadCoefficientFile("../data/WMMHR.COF", WMMConstants::FULL_DEGREE)) {
+        std::cout << "✗ could not load ../data/WMMHR.COF" << std::endl;
+        return 1;
+    }
+
+    // Scattered points: unsorted, repeated latitudes at different heights,
+    // duplicates and the clamped poles.
+    Points scattered;
+    for (int i = 0; i < 300; ++i) {
+        scattered.add(-90.0 + std::fmod(i * 37.3, 180.0), -180.0 + std::fmod(i * 71.9, 360.0), 100.0 * (i % 5));
+    }
+    scattered.add(45.0, 10.0, 350.0);
+    scattered.add(45.0, 10.0, 350.0);
+    scattered.add(45.0, -170.0, 350.0);
+    scattered.add(90.0, 0.0, 0.0);
+    scattered.add(89.95, 120.0, 0.0);
+    scattered.add(-90.0, 45.0, 1000.0);
+
+    check(standard.calculateBatch(scattered.lat, scattered.lon, scattered.height, 2026.4, batch) &&
+          batch.size() == scattered.lat.size(), "scattered batch evaluated");
+    double devScattered = maxDeviation(standard, scattered, 2026.4, batch);
+    check(devScattered < 1e-6, "scattered batch matches calculate()");
+
+    check(full.calculateBatch(scattered.lat, scattered.lon, scattered.height, 2026.4, batch), "high-degree batch evaluated");
+    double devHigh = maxDeviation(full, scattered, 2026.4, batch);
+    check(devHigh < 1e-6, "high-degree batch matches calculate()");
+
+    Points grid = shellGrid(350.0);
+    check(standard.calculateBatch(grid.lat, grid.lon, grid.height, 2026.1, batch), "grid batch evaluated");
+    double devGrid = maxDeviation(standard, grid, 2026.1, batch);
+    check(devGrid < 1e-6, "grid batch matches calculate()");
+
+    std::cout << "  max deviation: scattered " << devScattered << ", degree 133 " << devHigh
+              << ", grid " << devGrid << " nT" << std::endl;
+
+    Points shortLon = scattered;
+    shortLon.lon.pop_back();
+    check(!standard.calculateBatch(shortLon.lat, shortLon.lon, shortLon.height, 2026.4, batch) &&
+          batch.size() == shortLon.lat.size() && batch.F[0] == 0.0, "mismatched columns are rejected");
+
+    // Throughput on the 1-degree shell grid, per point.
+    double sum = 0.0;
+    double single12 = perPointUs([&] {
+        for (std::size_t i = 0; i < grid.lat.size(); ++i) {
+            sum += standard.calculate(grid.lat[i], grid.lon[i], grid.height[i], 2026.1).F;
+        }
+    }, grid.lat.size(), 3);
+    double batch12 = perPointUs([&] {
+        standard.calculateBatch(grid.lat, grid.lon, grid.height, 2026.1, batch);
+        sum += batch.F[0];
+    }, grid.lat.size(), 3);
+
+    Points coarse;
+    for (std::size_t i = 0; i < grid.lat.size(); i += 16) {
+        coarse.add(grid.lat[i], grid.lon[i], grid.height[i]);
+    }
+    double single133 = perPointUs([&] {
+        for (std::size_t i = 0; i < coarse.lat.size(); ++i) {
+            sum += full.calculate(coarse.lat[i], coarse.lon[i], coarse.height[i], 2026.1).F;
+        }
+    }, coarse.lat.size(), 1);
+    double batch133 = perPointUs([&] {
+        full.calculateBatch(grid.lat, grid.lon, grid.height, 2026.1, batch);
+        sum += batch.F[0];
+    }, grid.lat.size(), 1);
+    check(sum > 0.0, "benchmark produced a field");
+
+    std::cout << "  per point, degree 12: calculate " << single12 << " us, batch " << batch12 << " us" << std::endl;
+    std::cout << "  per point, degree 133: calculate " << single133 << " us, batch " << batch133 << " us" << std::endl;
+
+    return finishTests("Batched WMM evaluation matches per-point results");
+}
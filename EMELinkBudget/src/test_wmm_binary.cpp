@@ -0,0 +1,109 @@
+#include "WMMModel.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <vector>
+#include <cmath>
+
+// Bit-for-bit comparison of coefficients and evaluated field.
+static bool sameModel(const WMMModel& a, const WMMModel& b) {
+    std::vector<GaussCoefficient> ca = a.getCoefficients();
+    std::vector<GaussCoefficient> cb = b.getCoefficients();
+    if (ca.size() != cb.size() || a.getEpoch() != b.getEpoch() || a.getModelName() != b.getModelName()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < ca.size(); ++i) {
+        if (ca[i].n != cb[i].n || ca[i].m != cb[i].m || ca[i].gnm != cb[i].gnm || ca[i].hnm != cb[i].hnm ||
+            ca[i].dgnm != cb[i].dgnm || ca[i].dhnm != cb[i].dhnm) {
+            return false;
+        }
+    }
+    for (int i = 0; i < 50; ++i) {
+        double lat = -85.0 + 3.4 * i, lon = -180.0 + 7.2 * i;
+        if (a.calculate(lat, lon, 350.0, 2026.3).F != b.calculate(lat, lon, 350.0, 2026.3).F) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename F>
+static double averageUs(F&& load, int repeats) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; ++i) {
+        load();
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+int main() {
+    std::cout << "WMM Binary Coefficient Test\n" << std::endl;
+
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "test_wmm_binary";
+    fs::create_directories(dir);
+    const std::string binary = (dir / "WMMHR.wmmb").string();
+
+    WMMModel text;
+    if (!text.loadCoefficientFile("../data/WMMHR.COF", WMMConstants::FULL_DEGREE)) {
+        std::cout << "✗ could not load ../data/WMMHR.COF" << std::endl;
+        return 1;
+    }
+    check(text.getModelName() == "WMMHR-2025" && text.getEpoch() == 2025.0, "header epoch and name parsed");
+    check(text.getCoefficients().size() == 134u * 135u / 2u - 1u, "every degree read");
+    check(text.saveBinaryFile(binary), "binary file written");
+    check(fs::file_size(binary) < fs::file_size("../data/WMMHR.COF"), "binary file is smaller than text");
+
+    WMMModel fromBinary;
+    check(fromBinary.loadBinaryFile(binary, WMMConstants::FULL_DEGREE) && sameModel(text, fromBinary),
+          "full-degree binary round-trips exactly");
+
+    WMMModel text12, binary12;
+    check(text12.loadCoefficientFile("../data/WMMHR.COF") && binary12.loadCoefficientFile(binary) &&
+          binary12.getMaxDegree() == 12 && sameModel(text12, binary12),
+          "loadCoefficientFile detects binary and honours maxDegree");
+
+    // Damaged and truncated files are rejected.
+    const std::string damaged = (dir / "damaged.wmmb").string();
+    fs::copy_file(binary, damaged, fs::copy_options::overwrite_existing);
+    {
+        std::fstream f(damaged, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(1000);
+        f.put('\x55');
+    }
+    WMMModel rejected;
+    check(!rejected.loadBinaryFile(damaged), "checksum mismatch rejected");
+    fs::resize_file(damaged, fs::file_size(binary) - 8);
+    check(!rejected.loadCoefficientFile(damaged), "truncated file rejected");
+    check(!rejected.loadBinaryFile("../data/WMMHR.COF"), "text file is not taken as binary");
+    check(!rejected.loadBinaryFile((dir / "missing.wmmb").string()), "missing file reported");
+
+    // Embedded tables (EME_EMBED_WMM) match the text file.
+    WMMModel embedded;
+    if (WMMModel::hasEmbeddedModel()) {
+        check(embedded.loadEmbeddedModel(WMMConstants::FULL_DEGREE) && sameModel(text, embedded),
+              "embedded model matches WMMHR.COF");
+        WMMModel embedded12;
+        check(embedded12.loadEmbeddedModel() && sameModel(text12, embedded12), "embedded model truncates to degree 12");
+    } else {
+        check(!embedded.loadEmbeddedModel(), "no embedded model without EME_EMBED_WMM");
+        std::cout << "  (built without EME_EMBED_WMM)" << std::endl;
+    }
+
+    // Startup cost of each source at full degree.
+    WMMModel model;
+    double textUs = averageUs([&] { model.loadCoefficientFile("../data/WMMHR.COF", WMMConstants::FULL_DEGREE); }, 20);
+    double binaryUs = averageUs([&] { model.loadBinaryFile(binary, WMMConstants::FULL_DEGREE); }, 20);
+    std::cout << "  load degree 133: text " << textUs << " us, binary " << binaryUs << " us";
+    if (WMMModel::hasEmbeddedModel()) {
+        double embeddedUs = averageUs([&] { model.loadEmbeddedModel(WMMConstants::FULL_DEGREE); }, 20);
+        std::cout << ", embedded " << embeddedUs << " us";
+    }
+    std::cout << std::endl;
+
+    fs::remove_all(dir);
+
+    return finishTests("Binary and embedded WMM coefficients load identically to the text model");
+}
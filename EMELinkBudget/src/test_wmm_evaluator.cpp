@@ -0,0 +1,81 @@
+#include "WMMModel.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cmath>
+
+struct ReferencePoint {
+    double lat, lon, height_km, year;
+    double X, Y, Z;
+};
+
+// Output of the previous per-call evaluator (nested vectors, pow per degree).
+static const ReferencePoint REFERENCE[] = {
+    {31.77, 116.87, 0.0, 2026.10, 32832.8299023215, -3334.9554232029, 38378.8947886383},
+    {51.50, -0.10, 400.0, 2025.50, 16450.6639476566, 88.8210998977, 37755.6427235242},
+    {-33.90, 151.20, 300.0, 2027.90, 20583.4025359641, 4644.3285663382, -44573.1576235362},
+    {89.95, 0.00, 0.0, 2025.00, 1799.7774022024, 437.7179004173, 57009.1729804202},
+    {-89.95, 120.00, 100.0, 2026.00, -13982.4475312397, -7376.6201430844, -49528.2216038827},
+    {0.00, 0.00, 350.0, 2029.99, 23108.5356544018, -1505.1263248234, -12156.2622852764},
+    {40.70, -74.00, 450.0, 2026.70, 16424.7694928941, -3348.0461953635, 37365.1278222612},
+    {-60.00, -60.00, 1000.0, 2025.25, 11924.4874921202, 1525.4148824835, -19717.4942776598},
+};
+
+int main() {
+    std::cout << "WMM Evaluator Test\n" << std::endl;
+
+    WMMModel wmm;
+    check(!wmm.loadCoefficientFile("../data/missing.COF"), "missing file is reported");
+    check(wmm.calculate(30.0, 120.0, 0.0, 2026.0).F == 0.0, "unloaded model returns zero field");
+    if (!wmm.loadCoefficientFile("../data/WMMHR.COF")) {
+        std::cout << "✗ could not load ../data/WMMHR.COF" << std::endl;
+        return 1;
+    }
+
+    for (const auto& ref : REFERENCE) {
+        MagneticFieldResult r = wmm.calculate(ref.lat, ref.lon, ref.height_km, ref.year);
+        check(std::abs(r.X - ref.X) < 1e-6 && std::abs(r.Y - ref.Y) < 1e-6 && std::abs(r.Z - ref.Z) < 1e-6,
+              "field matches previous evaluator at lat " + std::to_string(ref.lat));
+    }
+
+    auto a = wmm.getSnapshot(2026.25);
+    auto b = wmm.getSnapshot(2026.25);
+    check(a == b, "snapshot reused for the same decimal year");
+    auto c = wmm.getSnapshot(2027.0);
+    check(c != a && c->decimalYear == 2027.0 && a->decimalYear == 2026.25, "new year builds a new snapshot");
+    check(std::abs(c->g[1] - a->g[1] - 0.75 * 11.9581) < 1e-9, "snapshot applies secular variation to g10");
+
+    // Concurrent evaluation across alternating years gives the serial results.
+    std::vector<double> serial;
+    for (int i = 0; i < 400; ++i) {
+        serial.push_back(wmm.calculate(-60.0 + 0.3 * i, -180.0 + 0.9 * i, 350.0, 2026.0 + (i % 3)).F);
+    }
+    std::vector<std::thread> threads;
+    std::vector<int> mismatches(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 400; ++i) {
+                double F = wmm.calculate(-60.0 + 0.3 * i, -180.0 + 0.9 * i, 350.0, 2026.0 + (i % 3)).F;
+                mismatches[t] += (F != serial[i]);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    check(mismatches == std::vector<int>(4, 0), "concurrent calls match serial results");
+
+    const int n = 200000;
+    double sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) {
+        sum += wmm.calculate(-60.0 + i % 120, (i % 360) - 180.0, 350.0, 2026.1).F;
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / n;
+    check(sum > 0.0, "benchmark produced a field");
+    std::cout << "  calculate(): " << us << " us per point" << std::endl;
+
+    return finishTests("Precomputed WMM evaluator matches the reference field");
+}
@@ -0,0 +1,159 @@
+#include "WMMModel.h"
+#include "TestSupport.h"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+// Direct long double sum over a full Schmidt table, independent of both evaluators.
+static void referenceField(const WMMCoefficientSnapshot& c, int nMax,
+                           double lat_deg, double lon_deg, double height_km,
+                           double& X, double& Y, double& Z) {
+    typedef long double ld;
+    const ld pi = 3.14159265358979323846264338327950288L;
+    const ld a = WMMConstants::WGS84_A;
+    const ld e2 = WMMConstants::WGS84_E2;
+
+    const ld lat = lat_deg * pi / 180.0L;
+    const ld N = a / std::sqrt(1.0L - e2 * std::sin(lat) * std::sin(lat));
+    const ld x = (N + height_km) * std::cos(lat);
+    const ld z = (N * (1.0L - e2) + height_km) * std::sin(lat);
+    const ld r = std::sqrt(x * x + z * z);
+    const ld latGc = std::atan2(z, x);
+    const ld theta = pi / 2.0L - latGc;
+    const ld phi = lon_deg * pi / 180.0L;
+    const ld t = std::cos(theta);
+    const ld s = std::sin(theta);
+
+    auto idx = [](int n, int m) { return static_cast<std::size_t>(n) * (n + 1) / 2 + m; };
+    std::vector<ld> S(idx(nMax, nMax) + 1, 0.0L);
+    S[0] = 1.0L;
+    for (int m = 0; m <= nMax; ++m) {
+        if (m > 0) {
+            S[idx(m, m)] = S[idx(m - 1, m - 1)] * s * (m == 1 ? 1.0L : std::sqrt((2.0L * m - 1) / (2.0L * m)));
+        }
+        for (int n = m + 1; n <= nMax; ++n) {
+            ld prev2 = (n - 2 >= m) ? S[idx(n - 2, m)] : 0.0L;
+            S[idx(n, m)] = ((2.0L * n - 1) * t * S[idx(n - 1, m)] -
+                            std::sqrt(static_cast<ld>((n - 1) * (n - 1) - m * m)) * prev2) /
+                           std::sqrt(static_cast<ld>(n * n - m * m));
+        }
+    }
+
+    ld Br = 0, Bt = 0, Bp = 0;
+    for (int n = 1; n <= nMax; ++n) {
+        const ld ratio = std::pow(a / r, static_cast<ld>(n + 2));
+        for (int m = 0; m <= n; ++m) {
+            const ld Snm = S[idx(n, m)];
+            const ld Sprev = (n - 1 >= m) ? S[idx(n - 1, m)] : 0.0L;
+            const ld dSnm = (n * t * Snm - std::sqrt(static_cast<ld>(n * n - m * m)) * Sprev) / s;
+            const ld g = c.g[idx(n, m)];
+            const ld h = c.h[idx(n, m)];
+            const ld cosTerm = g * std::cos(m * phi) + h * std::sin(m * phi);
+            Br += ratio * (n + 1) * Snm * cosTerm;
+            Bt += ratio * dSnm * cosTerm;
+            Bp += ratio * m * Snm * (h * std::cos(m * phi) - g * std::sin(m * phi)) / s;
+        }
+    }
+
+    const ld psi = lat - latGc;
+    X = static_cast<double>(Bt * std::cos(psi) + Br * std::sin(psi));
+    Y = static_cast<double>(-Bp);
+    Z = static_cast<double>(Bt * std::sin(psi) - Br * std::cos(psi));
+}
+
+template <typename F>
+static double perPointUs(F&& f, int n) {
+    auto start = std::chrono::steady_clock::now();
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i) {
+        sum += f(i);
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / n;
+    check(sum != 0.0, "benchmark produced a field");
+    return us;
+}
+
+int main() {
+    std::cout << "WMMHR High-Degree Test\n" << std::endl;
+
+    WMMModel standard;
+    WMMModel full;
+    if (!standard.loadCoefficientFile("../data/WMMHR.COF") ||
+        !full.loadCoefficientFile("../data/WMMHR.COF", WMMConstants::FULL_DEGREE)) {
+        std::cout << "✗ could not load ../data/WMMHR.COF" << std::endl;
+        return 1;
+    }
+
+    check(standard.getMaxDegree() == 12 && !standard.isHighDegree(), "default load truncates to degree 12");
+    check(full.getMaxDegree() == 133 && full.isHighDegree(), "full load reads degree 133");
+
+    WMMModel partial;
+    check(partial.loadCoefficientFile("../data/WMMHR.COF", 40) && partial.getMaxDegree() == 40,
+          "intermediate degree limit honoured");
+
+    struct Point { double lat, lon, h, year; };
+    const Point points[] = {
+        {31.77, 116.87, 0.0, 2026.1}, {51.5, -0.1, 400.0, 2025.5}, {-33.9, 151.2, 300.0, 2027.9},
+        {89.95, 10.0, 0.0, 2025.0}, {-89.95, 120.0, 100.0, 2026.0}, {0.0, 0.0, 350.0, 2029.9},
+        {64.1, -21.9, 0.0, 2026.3}, {-60.0, -60.0, 1000.0, 2025.25},
+    };
+
+    double maxErr12 = 0.0, maxErr133 = 0.0, maxCrustal = 0.0;
+    for (const auto& p : points) {
+        double lat = std::max(-89.9, std::min(89.9, p.lat));
+        double X, Y, Z;
+
+        MagneticFieldResult low = standard.calculate(p.lat, p.lon, p.h, p.year);
+        referenceField(*standard.getSnapshot(p.year), 12, lat, p.lon, p.h, X, Y, Z);
+        maxErr12 = std::max({maxErr12, std::abs(low.X - X), std::abs(low.Y - Y), std::abs(low.Z - Z)});
+
+        MagneticFieldResult high = full.calculate(p.lat, p.lon, p.h, p.year);
+        referenceField(*full.getSnapshot(p.year), 133, lat, p.lon, p.h, X, Y, Z);
+        maxErr133 = std::max({maxErr133, std::abs(high.X - X), std::abs(high.Y - Y), std::abs(high.Z - Z)});
+
+        maxCrustal = std::max(maxCrustal, std::abs(high.F - low.F));
+    }
+    check(maxErr12 < 1e-6, "degree-12 evaluator matches long double reference");
+    check(maxErr133 < 1e-6, "degree-133 Clenshaw engine matches long double reference");
+    check(maxCrustal > 1.0 && maxCrustal < 2000.0, "crustal terms add a plausible correction");
+    std::cout << "  max |error| degree 12: " << maxErr12 << " nT, degree 133: " << maxErr133
+              << " nT, max crustal |dF|: " << maxCrustal << " nT" << std::endl;
+
+    // Per-point cost on a 350 km shell.
+    const int n = 20000;
+    auto point = [](int i, double& lat, double& lon) {
+        lat = -80.0 + (i % 161);
+        lon = -180.0 + (i * 7 % 360);
+    };
+    double us12 = perPointUs([&](int i) {
+        double lat, lon;
+        point(i, lat, lon);
+        return standard.calculate(lat, lon, 350.0, 2026.1).F;
+    }, n * 5);
+
+    SphericalHarmonicEngine engine12(12);
+    std::vector<double> packed;
+    auto snap = standard.getSnapshot(2026.1);
+    engine12.pack(snap->g.data(), snap->h.data(), packed);
+    double engineUs12 = perPointUs([&](int i) {
+        double lat, lon, cosm[13], sinm[13], Br, Bt, Bp;
+        point(i, lat, lon);
+        engine12.longitudeTerms(lon * M_PI / 180.0, cosm, sinm);
+        const double theta = (90.0 - lat) * M_PI / 180.0;
+        engine12.evaluate(6371.2 / 6721.2, std::cos(theta), std::sin(theta), cosm, sinm, packed.data(), Br, Bt, Bp);
+        return Br;
+    }, n * 5);
+
+    double us133 = perPointUs([&](int i) {
+        double lat, lon;
+        point(i, lat, lon);
+        return full.calculate(lat, lon, 350.0, 2026.1).F;
+    }, n);
+
+    std::cout << "  per point: degree 12 " << us12 << " us (engine " << engineUs12
+              << " us), degree 133 " << us133 << " us" << std::endl;
+
+    return finishTests("Full-resolution WMMHR evaluates through the high-degree engine");
+}
@@ -0,0 +1,68 @@
+#include "WMMModel.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// ========== WMM Coefficient Converter ==========
+// wmm_convert <input> <output.wmmb>       text or binary -> binary
+// wmm_convert --header <input> <output.h> constexpr tables for EME_EMBED_WMM
+
+static bool writeHeader(const WMMModel& model, const std::string& input, const std::string& filename) {
+    std::ofstream out(filename, std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    std::string source = input.substr(input.find_last_of("/\\") + 1);
+    char buf[160];
+
+    out << "// Generated by wmm_convert from " << source << "; do not edit.\n"
+        << "#pragma once\n\n"
+        << "namespace WMMEmbedded {\n"
+        << "    constexpr char MODEL_NAME[] = \"" << model.getModelName() << "\";\n";
+    std::snprintf(buf, sizeof(buf), "    constexpr double EPOCH = %.17g;\n", model.getEpoch());
+    out << buf
+        << "    constexpr int MAX_DEGREE = " << model.getMaxDegree() << ";\n\n"
+        << "    // g, h, dg, dh for n = 1..MAX_DEGREE, m = 0..n\n"
+        << "    constexpr double COEFFICIENTS[] = {\n";
+
+    for (const GaussCoefficient& c : model.getCoefficients()) {
+        std::snprintf(buf, sizeof(buf), "        %.17g, %.17g, %.17g, %.17g,\n",
+                      c.gnm, c.hnm, c.dgnm, c.dhnm);
+        out << buf;
+    }
+
+    out << "    };\n"
+        << "}\n";
+    return static_cast<bool>(out);
+}
+
+int main(int argc, char* argv[]) {
+    const bool header = argc == 4 && std::strcmp(argv[1], "--header") == 0;
+    if (argc != 3 && !header) {
+        std::cerr << "Usage: wmm_convert <input.COF> <output.wmmb>\n"
+                  << "       wmm_convert --header <input.COF> <output.h>\n";
+        return 2;
+    }
+
+    const std::string input = argv[argc - 2];
+    const std::string output = argv[argc - 1];
+
+    WMMModel model;
+    if (!model.loadCoefficientFile(input, WMMConstants::FULL_DEGREE)) {
+        std::cerr << "Error: could not read coefficients from " << input << "\n";
+        return 1;
+    }
+
+    const bool ok = header ? writeHeader(model, input, output) : model.saveBinaryFile(output);
+    if (!ok) {
+        std::cerr << "Error: could not write " << output << "\n";
+        return 1;
+    }
+
+    std::cout << model.getModelName() << " (degree " << model.getMaxDegree() << ", epoch "
+              << model.getEpoch() << ") -> " << output << "\n";
+    return 0;
+}
@@ -3,6 +3,11 @@
 
 int main() {
     WMMModel wmm;
+
+    if (WMMModel::hasEmbeddedModel() && wmm.loadEmbeddedModel()) {
+        std::cout << "Embedded model: " << wmm.getModelName() << std::endl;
+        return 0;
+    }
     
     const char* paths[] = {
         "data/WMMHR.COF",